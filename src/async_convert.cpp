@@ -0,0 +1,345 @@
+// Copyright (c) 2026 Pu Junhan
+// SPDX-License-Identifier: MIT
+// Project: SPZ-ecosystem
+// Repository: https://github.com/spz-ecosystem/spz2glb
+//
+// 异步转换实现
+
+#include "async_convert.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+
+#include "memory_pool.h"
+#include "thread_pool.h"
+#include "trace.h"
+
+namespace spz2glb {
+
+struct AsyncConversionState {
+    std::atomic<bool> cancelRequested{false};
+    std::promise<SpzResult> promise;
+    std::shared_future<SpzResult> future = promise.get_future().share();
+    GlbLayout layout = {};
+
+    // 内存转换的输入：开始前取消时由 cancel() 释放，开始后归任务所有
+    std::mutex inputMutex;
+    bool started = false;
+    std::vector<uint8_t> input;
+};
+
+namespace {
+
+std::atomic<Executor*> g_hostExecutor{nullptr};
+
+Executor& internalExecutor() {
+    static ThreadPool pool;
+    static ThreadPoolExecutor executor(pool);
+    return executor;
+}
+
+SpzResult cancelledResult() {
+    return SpzResult::error(SpzErrorCode::ConversionFailed, kConversionCancelled);
+}
+
+/**
+ * 一次转换的运行上下文：报告进度、检查取消
+ */
+class AsyncRun {
+public:
+    AsyncRun(AsyncConversionState& state, const AsyncConvertOptions& options) : state_(state), options_(options) {}
+
+    bool cancelled() const { return state_.cancelRequested.load(std::memory_order_relaxed); }
+
+    void report(ConversionStage stage, uint64_t done, uint64_t total) const {
+        if (options_.progress) {
+            options_.progress({stage, done, total});
+        }
+    }
+
+    /**
+     * 按 chunkBytes 分块把 bytes 交给 sink，写出阶段的 done 从 offset 累加到 total
+     *
+     * @return 取消或 sink 失败时为 false（cancelled() 区分两者）
+     */
+    template <typename Sink>
+    bool writeChunked(std::span<const uint8_t> bytes, uint64_t& offset, uint64_t total, Sink&& sink) const {
+        size_t chunk = std::max<size_t>(options_.chunkBytes, 1);
+        for (size_t pos = 0; pos < bytes.size();) {
+            if (cancelled()) {
+                return false;
+            }
+            size_t n = std::min(chunk, bytes.size() - pos);
+            if (!sink(bytes.subspan(pos, n))) {
+                return false;
+            }
+            pos += n;
+            offset += n;
+            report(ConversionStage::Write, offset, total);
+        }
+        return true;
+    }
+
+    /**
+     * 解压与生成阶段：校验 SPZ 头，生成压缩模式的前导字节
+     */
+    SpzResult buildPreamble(std::span<const uint8_t> spz) const {
+        report(ConversionStage::Inflate, 0, sizeof(SpzHeader));
+        auto prefix = inflateSpzPrefix(spz, sizeof(SpzHeader));
+        SpzHeader header;
+        if (!prefix.success || !parseSpzHeader(prefix.data, header)) {
+            return prefix.success ? SpzResult::error(SpzErrorCode::ConversionFailed, "Failed to parse SPZ header")
+                                  : prefix;
+        }
+        report(ConversionStage::Inflate, sizeof(SpzHeader), sizeof(SpzHeader));
+        if (cancelled()) {
+            return cancelledResult();
+        }
+
+        report(ConversionStage::Build, 0, 0);
+        auto preamble = buildGlbPreamble(spz, state_.layout, options_.convert);
+        if (preamble.success) {
+            report(ConversionStage::Build, preamble.data.size(), preamble.data.size());
+        }
+        return preamble;
+    }
+
+private:
+    AsyncConversionState& state_;
+    const AsyncConvertOptions& options_;
+};
+
+bool streamsPayload(const ConvertOptions& options) {
+    return options.mode == OutputMode::Compressed && !options.reencodesPayload() && options.cache == nullptr &&
+           options.gzipIndexSpan == 0;
+}
+
+SpzResult runFileConversion(AsyncConversionState& state,
+                            const std::string& inputPath,
+                            const std::string& outputPath,
+                            const AsyncConvertOptions& options) {
+    AsyncRun run(state, options);
+    if (run.cancelled()) {
+        return cancelledResult();
+    }
+
+    if (!streamsPayload(options.convert)) {
+        // 其他模式的读取、解码与写出都在 convertSpzFile 内部完成，只在其前后报告
+        std::error_code ec;
+        uint64_t inputSize = std::filesystem::file_size(inputPath, ec);
+        run.report(ConversionStage::Read, 0, ec ? 0 : inputSize);
+        run.report(ConversionStage::Build, 0, 0);
+        // 取消标志传入重新编码的各段压缩循环；输出一旦写完即保留，之后的取消不再删除它
+        ConvertOptions convert = options.convert;
+        convert.cancel = &state.cancelRequested;
+        auto result = convertSpzFile(inputPath, outputPath, state.layout, convert);
+        if (!result.success) {
+            return run.cancelled() ? cancelledResult() : result;
+        }
+        run.report(ConversionStage::Write, state.layout.totalLength, state.layout.totalLength);
+        return result;
+    }
+
+    // 映射按需读入，真正的磁盘读取发生在写出阶段逐块访问负载时
+    MappedFile spzFile;
+    if (!spzFile.open(inputPath)) {
+        return SpzResult::error(SpzErrorCode::CannotOpenSpzFile, "Cannot open SPZ file: " + inputPath);
+    }
+    run.report(ConversionStage::Read, 0, spzFile.size());
+    run.report(ConversionStage::Read, spzFile.size(), spzFile.size());
+
+    auto preamble = run.buildPreamble(spzFile.bytes());
+    if (!preamble.success) {
+        return preamble;
+    }
+    if (run.cancelled()) {
+        return cancelledResult();
+    }
+
+#ifndef _WIN32
+    // 输出可能与输入是同一文件：写临时文件再 rename，截断不会波及仍在映射中的输入
+    OutputFile out;
+    if (!out.open(outputPath)) {
+        return SpzResult::error(SpzErrorCode::CannotOpenOutputFile, "Failed to write GLB: " + outputPath);
+    }
+#else
+    std::ofstream out(outputPath, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        return SpzResult::error(SpzErrorCode::CannotOpenOutputFile, "Failed to write GLB: " + outputPath);
+    }
+#endif
+    const uint64_t total = state.layout.totalLength;
+    uint64_t written = 0;
+    SPZ2GLB_TRACE_SCOPE(trace, "write");
+    SPZ2GLB_TRACE_BYTES(trace, total);
+    MemoryStageScope memoryStage(MemoryStage::Write);
+    run.report(ConversionStage::Write, 0, total);
+#ifndef _WIN32
+    auto sink = [&out](std::span<const uint8_t> bytes) { return writeBytes(out.fd(), bytes); };
+#else
+    auto sink = [&out](std::span<const uint8_t> bytes) {
+        out.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        return static_cast<bool>(out);
+    };
+#endif
+    const uint8_t padding[3] = {0, 0, 0};
+    bool ok = run.writeChunked(preamble.data, written, total, sink) &&
+              run.writeChunked(spzFile.bytes(), written, total, sink) &&
+              run.writeChunked(std::span(padding, state.layout.binPadding), written, total, sink);
+#ifndef _WIN32
+    ok = ok && out.commit();
+#else
+    out.close();
+    ok = ok && static_cast<bool>(out);
+#endif
+    if (!ok) {
+        // 取消或写失败：立即释放映射与前导字节，不留下不完整的输出
+        // （POSIX 下未 commit 的临时文件由 OutputFile 析构删除，目标保持原样）
+        spzFile.close();
+        preamble = {};
+#ifdef _WIN32
+        std::remove(outputPath.c_str());
+#endif
+        return run.cancelled() ? cancelledResult()
+                               : SpzResult::error(SpzErrorCode::CannotOpenOutputFile,
+                                                  "Failed to write GLB: " + outputPath);
+    }
+    return SpzResult::ok({});
+}
+
+SpzResult runMemoryConversion(AsyncConversionState& state, const AsyncConvertOptions& options) {
+    std::vector<uint8_t> spz;
+    {
+        std::lock_guard<std::mutex> lock(state.inputMutex);
+        state.started = true;
+        spz = std::move(state.input);
+    }
+    AsyncRun run(state, options);
+    if (run.cancelled()) {
+        return cancelledResult();
+    }
+    if (!streamsPayload(options.convert)) {
+        return SpzResult::error(SpzErrorCode::ConversionFailed,
+            "Asynchronous in-memory conversion supports the plain compressed mode only");
+    }
+    run.report(ConversionStage::Read, spz.size(), spz.size());
+
+    auto preamble = run.buildPreamble(spz);
+    if (!preamble.success || run.cancelled()) {
+        return preamble.success ? cancelledResult() : preamble;
+    }
+
+    const uint64_t total = state.layout.totalLength;
+    uint64_t written = 0;
+    std::vector<uint8_t> glb;
+    glb.reserve(total);
+    run.report(ConversionStage::Write, 0, total);
+    auto sink = [&glb](std::span<const uint8_t> bytes) {
+        glb.insert(glb.end(), bytes.begin(), bytes.end());
+        return true;
+    };
+    if (!run.writeChunked(preamble.data, written, total, sink) || !run.writeChunked(spz, written, total, sink)) {
+        return cancelledResult();
+    }
+    glb.resize(total, 0);
+    return SpzResult::ok(std::move(glb));
+}
+
+ConversionHandle submit(std::shared_ptr<AsyncConversionState> state,
+                        const AsyncConvertOptions& options,
+                        std::function<SpzResult(AsyncConversionState&)> body) {
+    Executor& executor = options.executor != nullptr ? *options.executor : defaultExecutor();
+    executor.execute([state, body = std::move(body)] {
+        // 异常不能逃出执行器线程，否则 promise 永不就绪、wait() 一直阻塞；转成失败结果
+        SpzResult result;
+        try {
+            result = body(*state);
+        } catch (const std::exception& e) {
+            result = SpzResult::error(SpzErrorCode::ConversionFailed, std::string("Conversion failed: ") + e.what());
+        } catch (...) {
+            result = SpzResult::error(SpzErrorCode::ConversionFailed, "Conversion failed: unknown exception");
+        }
+        state->promise.set_value(std::move(result));
+    });
+    return ConversionHandle(std::move(state));
+}
+
+}  // anonymous namespace
+
+const char* stageName(ConversionStage stage) {
+    switch (stage) {
+        case ConversionStage::Read: return "read";
+        case ConversionStage::Inflate: return "inflate";
+        case ConversionStage::Build: return "build";
+        case ConversionStage::Write: return "write";
+    }
+    return "unknown";
+}
+
+void ThreadPoolExecutor::execute(std::function<void()> task) {
+    pool_.submit(std::move(task));
+}
+
+Executor& defaultExecutor() {
+    Executor* host = g_hostExecutor.load(std::memory_order_acquire);
+    return host != nullptr ? *host : internalExecutor();
+}
+
+void setDefaultExecutor(Executor* executor) {
+    g_hostExecutor.store(executor, std::memory_order_release);
+}
+
+ConversionHandle::ConversionHandle(std::shared_ptr<AsyncConversionState> state) : state_(std::move(state)) {}
+
+void ConversionHandle::cancel() {
+    state_->cancelRequested.store(true, std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(state_->inputMutex);
+    if (!state_->started) {
+        std::vector<uint8_t>().swap(state_->input);
+    }
+}
+
+bool ConversionHandle::cancelRequested() const {
+    return state_->cancelRequested.load(std::memory_order_relaxed);
+}
+
+bool ConversionHandle::ready() const {
+    return waitFor(std::chrono::milliseconds(0));
+}
+
+bool ConversionHandle::waitFor(std::chrono::milliseconds timeout) const {
+    return state_->future.wait_for(timeout) == std::future_status::ready;
+}
+
+const SpzResult& ConversionHandle::get() const {
+    return state_->future.get();
+}
+
+const GlbLayout& ConversionHandle::layout() const {
+    return state_->layout;
+}
+
+std::shared_future<SpzResult> ConversionHandle::future() const {
+    return state_->future;
+}
+
+ConversionHandle convertSpzFileAsync(std::string inputPath, std::string outputPath, AsyncConvertOptions options) {
+    auto state = std::make_shared<AsyncConversionState>();
+    return submit(state, options,
+                  [inputPath = std::move(inputPath), outputPath = std::move(outputPath), options](
+                      AsyncConversionState& s) { return runFileConversion(s, inputPath, outputPath, options); });
+}
+
+ConversionHandle convertSpzToGlbAsync(std::vector<uint8_t> spzData, AsyncConvertOptions options) {
+    auto state = std::make_shared<AsyncConversionState>();
+    state->input = std::move(spzData);
+    return submit(state, options,
+                  [options](AsyncConversionState& s) { return runMemoryConversion(s, options); });
+}
+
+}  // namespace spz2glb
@@ -0,0 +1,146 @@
+// Copyright (c) 2026 Pu Junhan
+// SPDX-License-Identifier: MIT
+// Project: SPZ-ecosystem
+// Repository: https://github.com/spz-ecosystem/spz2glb
+//
+// 异步转换接口
+// 转换在执行器上运行，立即返回句柄；按阶段与字节报告进度，支持协作式取消
+
+#ifndef SPZ2GLB_ASYNC_CONVERT_H_
+#define SPZ2GLB_ASYNC_CONVERT_H_
+
+#ifndef __EMSCRIPTEN__
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "spz_converter.h"
+
+namespace spz2glb {
+
+class ThreadPool;
+
+/**
+ * 转换阶段，按此顺序出现
+ */
+enum class ConversionStage {
+    Read,     // 映射或接收输入
+    Inflate,  // 解压并校验 SPZ 头
+    Build,    // 生成 GLB 前导字节（属性模式、重新编码等在此阶段完成）
+    Write     // 写出前导字节、负载与填充
+};
+
+const char* stageName(ConversionStage stage);
+
+/**
+ * 进度：每个阶段开始时 bytesDone 为 0，结束时等于 bytesTotal；
+ * 读取与写出阶段之间每处理 chunkBytes 报告一次
+ */
+struct ConversionProgress {
+    ConversionStage stage;
+    uint64_t bytesDone;
+    uint64_t bytesTotal;
+};
+
+// 在执行器线程上调用，应尽快返回
+using ProgressCallback = std::function<void(const ConversionProgress&)>;
+
+/**
+ * 执行器：宿主程序可以实现它，把转换放进自己的线程池或事件循环
+ */
+class Executor {
+public:
+    virtual ~Executor() = default;
+    virtual void execute(std::function<void()> task) = 0;
+};
+
+/**
+ * 把任务提交到已有的 ThreadPool（例如与批量转换或 ConvertOptions::pool 共用的线程池）
+ */
+class ThreadPoolExecutor final : public Executor {
+public:
+    explicit ThreadPoolExecutor(ThreadPool& pool) : pool_(pool) {}
+    void execute(std::function<void()> task) override;
+
+private:
+    ThreadPool& pool_;
+};
+
+/**
+ * 未指定执行器时使用的执行器：默认是首次使用时创建的内部线程池（每个 CPU 一个线程）
+ *
+ * setDefaultExecutor 替换为宿主的执行器，传 nullptr 恢复内部线程池；
+ * 宿主执行器必须比使用它的所有转换活得更久
+ */
+Executor& defaultExecutor();
+void setDefaultExecutor(Executor* executor);
+
+struct AsyncConvertOptions {
+    ConvertOptions convert = {.verbose = false};
+    ProgressCallback progress;      // 可为空
+    Executor* executor = nullptr;   // 为空时使用 defaultExecutor()
+    size_t chunkBytes = 4 << 20;    // 读取与写出的粒度：两次取消检查与进度报告之间的最大字节数
+};
+
+struct AsyncConversionState;
+
+/**
+ * 一次异步转换的句柄（可复制，共享同一次转换）
+ *
+ * 句柄全部销毁后转换仍会完成；需要中止时显式调用 cancel()
+ */
+class ConversionHandle {
+public:
+    ConversionHandle() = default;
+    explicit ConversionHandle(std::shared_ptr<AsyncConversionState> state);
+
+    /**
+     * 请求取消
+     *
+     * 尚未开始的转换立即释放输入；正在运行的转换在下一个块或压缩分段的边界停止，
+     * 释放映射与缓冲区并丢弃不完整的输出（已存在的目标保持原样）。结果为失败，errorMessage 为 "Conversion cancelled"；
+     * 输出已写完之后才到达的取消不再生效，输出保留、结果为成功
+     */
+    void cancel();
+    bool cancelRequested() const;
+
+    bool ready() const;
+    bool waitFor(std::chrono::milliseconds timeout) const;
+
+    // 阻塞直到完成；内存转换成功时 data 为 GLB 字节
+    const SpzResult& get() const;
+    // 完成后有效（get() 返回之后）
+    const GlbLayout& layout() const;
+
+    std::shared_future<SpzResult> future() const;
+
+private:
+    std::shared_ptr<AsyncConversionState> state_;
+};
+
+/**
+ * 异步文件到文件转换
+ *
+ * 默认压缩模式（不重新编码、不用缓存、不写索引）时负载按 chunkBytes 分块写出，
+ * 每块之间报告进度并检查取消；其他模式整体交给 convertSpzFile，只在阶段边界报告进度与检查取消
+ */
+ConversionHandle convertSpzFileAsync(std::string inputPath,
+                                     std::string outputPath,
+                                     AsyncConvertOptions options = {});
+
+/**
+ * 异步内存转换（压缩模式）：接管 spzData，结果的 data 为 GLB 字节
+ */
+ConversionHandle convertSpzToGlbAsync(std::vector<uint8_t> spzData, AsyncConvertOptions options = {});
+
+}  // namespace spz2glb
+
+#endif  // __EMSCRIPTEN__
+
+#endif  // SPZ2GLB_ASYNC_CONVERT_H_
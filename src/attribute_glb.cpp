@@ -0,0 +1,319 @@
+// Copyright (c) 2026 Pu Junhan
+// SPDX-License-Identifier: MIT
+// Project: SPZ-ecosystem
+// Repository: https://github.com/spz-ecosystem/spz2glb
+//
+// 属性模式 GLB 实现
+
+#include "attribute_glb.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iostream>
+#include <limits>
+
+#include <fastgltf/core.hpp>
+
+#include "memory_pool.h"
+#include "sh_degree.h"
+#include "spatial_order.h"
+#include "spz_converter.h"
+#include "spz_decoder.h"
+#include "thread_pool.h"
+#include "trace.h"
+
+namespace spz2glb {
+
+namespace {
+
+constexpr size_t kChunkPoints = 64 * 1024;     // 与解码器相同的分块粒度
+constexpr float kShC0 = 0.28209479177387814f;  // 0 阶球谐基函数常数
+
+// 每个点各属性的 float 个数（交错布局中按此顺序排列，其后是 shDim 个 VEC3）
+constexpr size_t kPositionFloats = 3;
+constexpr size_t kColorFloats = 4;
+constexpr size_t kScaleFloats = 3;
+constexpr size_t kRotationFloats = 4;
+constexpr size_t kFixedFloats = kPositionFloats + kColorFloats + kScaleFloats + kRotationFloats;
+
+// 按点区间 [begin, end) 并行处理
+template <typename Body>
+void forEachChunk(ThreadPool* pool, uint32_t numPoints, const Body& body) {
+    size_t chunks = (static_cast<size_t>(numPoints) + kChunkPoints - 1) / kChunkPoints;
+    parallelFor(pool, chunks, [&](size_t chunk) {
+        size_t begin = chunk * kChunkPoints;
+        size_t end = std::min(begin + kChunkPoints, static_cast<size_t>(numPoints));
+        body(chunk, begin, end);
+    });
+}
+
+template <typename T>
+std::span<const uint8_t> asBytes(const AlignedArray<T>& array) {
+    return {reinterpret_cast<const uint8_t*>(array.data()), array.size() * sizeof(T)};
+}
+
+// 第 coef 个高阶系数（从 0 开始）对应的属性名：1 阶 3 个、2 阶 5 个、3 阶 7 个
+std::string shAttributeName(uint32_t coef) {
+    uint32_t degree = 1;
+    while ((degree + 1) * (degree + 1) - 1 <= coef) {
+        ++degree;
+    }
+    uint32_t index = coef - (degree * degree - 1);
+    return "KHR_gaussian_splatting:SH_DEGREE_" + std::to_string(degree) + "_COEF_" + std::to_string(index);
+}
+
+size_t addBufferView(fastgltf::Asset& asset, size_t byteOffset, size_t byteLength, size_t byteStride) {
+    fastgltf::BufferView view;
+    view.bufferIndex = 0;
+    view.byteOffset = byteOffset;
+    view.byteLength = byteLength;
+    if (byteStride > 0) {
+        view.byteStride = byteStride;
+    }
+    view.target = fastgltf::BufferTarget::ArrayBuffer;
+    asset.bufferViews.emplace_back(std::move(view));
+    return asset.bufferViews.size() - 1;
+}
+
+void addAttribute(fastgltf::Asset& asset, fastgltf::Primitive& primitive, const std::string& name,
+                  size_t bufferView, size_t byteOffset, uint32_t count, fastgltf::AccessorType type) {
+    fastgltf::Accessor accessor;
+    accessor.bufferViewIndex = bufferView;
+    accessor.byteOffset = byteOffset;
+    accessor.count = count;
+    accessor.type = type;
+    accessor.componentType = fastgltf::ComponentType::Float;
+    asset.accessors.emplace_back(std::move(accessor));
+    fastgltf::Attribute attribute;
+    attribute.name.assign(name.data(), name.size());
+    attribute.accessorIndex = asset.accessors.size() - 1;
+    primitive.attributes.emplace_back(std::move(attribute));
+}
+
+// POSITION 的逐分量最小 / 最大值（glTF 要求），分块求出后归并
+void computePositionBounds(const SplatData& splats, ThreadPool* pool,
+                           std::array<float, 3>& minimum, std::array<float, 3>& maximum) {
+    size_t chunks = (static_cast<size_t>(splats.numPoints) + kChunkPoints - 1) / kChunkPoints;
+    std::vector<std::array<float, 6>> partial(chunks);
+    forEachChunk(pool, splats.numPoints, [&](size_t chunk, size_t begin, size_t end) {
+        std::array<float, 6> bounds;
+        for (size_t c = 0; c < 3; ++c) {
+            bounds[c] = std::numeric_limits<float>::max();
+            bounds[3 + c] = std::numeric_limits<float>::lowest();
+        }
+        const float* p = splats.positions.data();
+        for (size_t i = begin; i < end; ++i) {
+            for (size_t c = 0; c < 3; ++c) {
+                bounds[c] = std::min(bounds[c], p[i * 3 + c]);
+                bounds[3 + c] = std::max(bounds[3 + c], p[i * 3 + c]);
+            }
+        }
+        partial[chunk] = bounds;
+    });
+
+    minimum.fill(std::numeric_limits<float>::max());
+    maximum.fill(std::numeric_limits<float>::lowest());
+    for (const auto& bounds : partial) {
+        for (size_t c = 0; c < 3; ++c) {
+            minimum[c] = std::min(minimum[c], bounds[c]);
+            maximum[c] = std::max(maximum[c], bounds[3 + c]);
+        }
+    }
+}
+
+/**
+ * 解码结果转为 accessor 数组（写入 glb 的各段）并生成 glTF 资产
+ *
+ * @return BIN 长度
+ */
+size_t buildAttributeAsset(AttributeGlb& glb, const ConvertOptions& options, fastgltf::Asset& asset) {
+    SPZ2GLB_TRACE_SCOPE(trace, "asset build");
+    MemoryStageScope memoryStage(MemoryStage::Build);
+    SplatData& splats = glb.splats;
+    if (splats.shDegree > options.maxShDegree) {
+        if (options.verbose) {
+            std::cout << "[INFO] Dropping SH bands above degree " << options.maxShDegree << " (input degree "
+                      << splats.shDegree << ")" << std::endl;
+        }
+        truncateSplatShDegree(splats, options.maxShDegree, options.pool);
+    }
+    if (options.spatialCurve != SpatialCurve::None) {
+        std::vector<uint32_t> order;
+        computeSpatialOrder(splats.positions.span(), options.spatialCurve, options.pool, order);
+        permuteSplats(splats, order, options.pool);
+        if (options.verbose) {
+            std::cout << "[INFO] Reordered splats along " << spatialCurveName(options.spatialCurve) << " curve"
+                      << std::endl;
+        }
+    }
+
+    const uint32_t n = splats.numPoints;
+    const uint32_t shDim = splats.shDim();
+    if (options.verbose) {
+        std::cout << "[INFO] Num points: " << n << std::endl;
+        std::cout << "[INFO] SH degree: " << splats.shDegree << std::endl;
+        std::cout << "[INFO] Writing attributes ("
+                  << (options.attributeLayout == AttributeLayout::Interleaved ? "interleaved" : "planar")
+                  << " layout)" << std::endl;
+    }
+
+    std::array<float, 3> minimum;
+    std::array<float, 3> maximum;
+    computePositionBounds(splats, options.pool, minimum, maximum);
+
+    // COLOR_0 与线性尺度：平面布局时单独成数组，交错布局时直接写进顶点块
+    const bool interleaved = options.attributeLayout == AttributeLayout::Interleaved;
+    const size_t strideFloats = kFixedFloats + static_cast<size_t>(shDim) * 3;
+    if (interleaved) {
+        glb.interleaved.resize(static_cast<size_t>(n) * strideFloats * sizeof(float));
+        float* out = reinterpret_cast<float*>(glb.interleaved.data());
+        forEachChunk(options.pool, n, [&](size_t, size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                float* v = out + i * strideFloats;
+                const float* position = splats.positions.data() + i * 3;
+                const float* color = splats.colors.data() + i * 3;
+                const float* scale = splats.scales.data() + i * 3;
+                const float* rotation = splats.rotations.data() + i * 4;
+                v[0] = position[0];
+                v[1] = position[1];
+                v[2] = position[2];
+                v[3] = 0.5f + kShC0 * color[0];
+                v[4] = 0.5f + kShC0 * color[1];
+                v[5] = 0.5f + kShC0 * color[2];
+                v[6] = splats.alphas[i];
+                v[7] = std::exp(scale[0]);
+                v[8] = std::exp(scale[1]);
+                v[9] = std::exp(scale[2]);
+                std::copy_n(rotation, kRotationFloats, v + 10);
+                std::copy_n(splats.sh.data() + i * shDim * 3, shDim * 3, v + kFixedFloats);
+            }
+        });
+        // 数据已全部进入交错块，提前释放解码结果
+        splats = SplatData();
+    } else {
+        glb.colors.resize(static_cast<size_t>(n) * kColorFloats);
+        forEachChunk(options.pool, n, [&](size_t, size_t begin, size_t end) {
+            const float* color = splats.colors.data();
+            float* rgba = glb.colors.data();
+            for (size_t i = begin; i < end; ++i) {
+                rgba[i * 4 + 0] = 0.5f + kShC0 * color[i * 3 + 0];
+                rgba[i * 4 + 1] = 0.5f + kShC0 * color[i * 3 + 1];
+                rgba[i * 4 + 2] = 0.5f + kShC0 * color[i * 3 + 2];
+                rgba[i * 4 + 3] = splats.alphas[i];
+            }
+            // 对数尺度原地转为线性尺度
+            float* scale = splats.scales.data();
+            for (size_t i = begin * 3; i < end * 3; ++i) {
+                scale[i] = std::exp(scale[i]);
+            }
+        });
+    }
+
+    // glTF 资产
+    asset = createSplatAsset(false);
+
+    fastgltf::Primitive primitive;
+    primitive.type = fastgltf::PrimitiveType::Points;
+    primitive.gaussianSplat = std::make_unique<fastgltf::GaussianSplatExtension>();
+
+    glb.segments.clear();
+    size_t binSize = 0;
+    if (interleaved) {
+        const size_t stride = strideFloats * sizeof(float);
+        size_t view = addBufferView(asset, 0, glb.interleaved.size(), stride);
+        addAttribute(asset, primitive, "POSITION", view, 0, n, fastgltf::AccessorType::Vec3);
+        addAttribute(asset, primitive, "COLOR_0", view, 3 * sizeof(float), n, fastgltf::AccessorType::Vec4);
+        addAttribute(asset, primitive, "KHR_gaussian_splatting:SCALE", view, 7 * sizeof(float), n,
+                     fastgltf::AccessorType::Vec3);
+        addAttribute(asset, primitive, "KHR_gaussian_splatting:ROTATION", view, 10 * sizeof(float), n,
+                     fastgltf::AccessorType::Vec4);
+        for (uint32_t j = 0; j < shDim; ++j) {
+            addAttribute(asset, primitive, shAttributeName(j), view, (kFixedFloats + j * 3) * sizeof(float), n,
+                         fastgltf::AccessorType::Vec3);
+        }
+        glb.segments.push_back(asBytes(glb.interleaved));
+        binSize = glb.interleaved.size();
+    } else {
+        // 每个属性一个 bufferView，按顺序紧密排列（各段长度均为 4 的倍数，无需对齐填充）
+        auto addPlanar = [&](const std::string& name, std::span<const uint8_t> bytes, fastgltf::AccessorType type) {
+            size_t view = addBufferView(asset, binSize, bytes.size(), 0);
+            addAttribute(asset, primitive, name, view, 0, n, type);
+            glb.segments.push_back(bytes);
+            binSize += bytes.size();
+        };
+        addPlanar("POSITION", asBytes(splats.positions), fastgltf::AccessorType::Vec3);
+        addPlanar("COLOR_0", asBytes(glb.colors), fastgltf::AccessorType::Vec4);
+        addPlanar("KHR_gaussian_splatting:SCALE", asBytes(splats.scales), fastgltf::AccessorType::Vec3);
+        addPlanar("KHR_gaussian_splatting:ROTATION", asBytes(splats.rotations), fastgltf::AccessorType::Vec4);
+        if (shDim > 0) {
+            // 高阶系数共用一个 bufferView：每个点 shDim 个 VEC3 连续存放，accessor 以 byteOffset 区分
+            auto bytes = asBytes(splats.sh);
+            size_t view = addBufferView(asset, binSize, bytes.size(), shDim * 3 * sizeof(float));
+            for (uint32_t j = 0; j < shDim; ++j) {
+                addAttribute(asset, primitive, shAttributeName(j), view, j * 3 * sizeof(float), n,
+                             fastgltf::AccessorType::Vec3);
+            }
+            glb.segments.push_back(bytes);
+            binSize += bytes.size();
+        }
+    }
+
+    auto& position = asset.accessors[primitive.attributes[0].accessorIndex];
+    position.min = fastgltf::AccessorBoundsArray::ForType<double>(3);
+    position.max = fastgltf::AccessorBoundsArray::ForType<double>(3);
+    for (size_t c = 0; c < 3; ++c) {
+        position.min->set<double>(c, minimum[c]);
+        position.max->set<double>(c, maximum[c]);
+    }
+
+    addGlbBinBuffer(asset, binSize);
+
+    fastgltf::Mesh mesh;
+    mesh.primitives.emplace_back(std::move(primitive));
+    asset.meshes.emplace_back(std::move(mesh));
+
+    fastgltf::Node node;
+    node.meshIndex = 0;
+    asset.nodes.emplace_back(std::move(node));
+
+    fastgltf::Scene scene;
+    scene.nodeIndices.emplace_back(0);
+    asset.scenes.emplace_back(std::move(scene));
+    asset.defaultScene = 0;
+    SPZ2GLB_TRACE_BYTES(trace, binSize);
+    return binSize;
+}
+
+}  // anonymous namespace
+
+SpzResult buildAttributeGlb(std::span<const uint8_t> spzData, AttributeGlb& glb, const ConvertOptions& options) {
+    std::string error;
+    if (!decodeCompressedSpz(spzData, glb.splats, error, options.pool)) {
+        return SpzResult::error(SpzErrorCode::ConversionFailed, error);
+    }
+    if (glb.splats.numPoints == 0) {
+        return SpzResult::error(SpzErrorCode::ConversionFailed,
+            "Attribute mode requires at least one point");
+    }
+    fastgltf::Asset asset;
+    size_t binSize = buildAttributeAsset(glb, options, asset);
+
+    // 解码在 decodeCompressedSpz 内计入 inflate，资产生成与导出计入 build，写出由调用方计入 write
+    SPZ2GLB_TRACE_SCOPE(exportTrace, "export");
+    MemoryStageScope memoryStage(MemoryStage::Build);
+    GlbJsonExporter exporter;
+    std::string json;
+    auto exportError = exporter.writeBinaryJson(asset, json);
+    if (exportError != fastgltf::Error::None) {
+        return SpzResult::error(SpzErrorCode::ConversionFailed,
+            "GLB export failed: " + std::string(fastgltf::getErrorMessage(exportError)));
+    }
+    SPZ2GLB_TRACE_BYTES(exportTrace, json.size());
+    if (!finishGlbPreamble(json, binSize, glb.layout, glb.preamble, error)) {
+        return SpzResult::error(SpzErrorCode::ConversionFailed, error);
+    }
+    return SpzResult::ok({});
+}
+
+}  // namespace spz2glb
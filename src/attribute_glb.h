@@ -0,0 +1,55 @@
+// Copyright (c) 2026 Pu Junhan
+// SPDX-License-Identifier: MIT
+// Project: SPZ-ecosystem
+// Repository: https://github.com/spz-ecosystem/spz2glb
+//
+// 属性模式 GLB（--mode attributes）
+// 解码 SPZ，以未压缩的 KHR_gaussian_splatting accessor 写出，加载端无需 SPZ 解码器
+
+#ifndef SPZ2GLB_ATTRIBUTE_GLB_H_
+#define SPZ2GLB_ATTRIBUTE_GLB_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "glb_writer.h"
+#include "splat_data.h"
+
+struct SpzResult;
+
+namespace spz2glb {
+
+struct ConvertOptions;
+
+/**
+ * 属性模式 GLB 的内存表示：segments 直接指向 splats / colors / interleaved 中的数组
+ */
+struct AttributeGlb : SegmentedGlb {
+    SplatData splats;                   // 平面布局时 POSITION / ROTATION / SH 直接引用这里的数组
+    AlignedArray<float> colors;         // COLOR_0：RGB = 0.5 + C0 * dc，A = 不透明度
+    AlignedArray<uint8_t> interleaved;  // 交错布局时的整块顶点数据
+};
+
+/**
+ * 解码 SPZ 并生成属性模式 GLB
+ *
+ * accessor（均为 float）：
+ * - POSITION（VEC3，含 min/max）
+ * - COLOR_0（VEC4）
+ * - KHR_gaussian_splatting:SCALE（VEC3，线性尺度，已做 exp）
+ * - KHR_gaussian_splatting:ROTATION（VEC4，x y z w）
+ * - KHR_gaussian_splatting:SH_DEGREE_<l>_COEF_<m>（VEC3，每个高阶球谐系数一个）
+ *
+ * 平面布局：每个属性一个 bufferView，SH 共用一个带 byteStride 的 bufferView；
+ * 交错布局：全部属性在一个带 byteStride 的 bufferView 中
+ *
+ * 解码与属性变换按点区间在 options.pool 上并行
+ */
+SpzResult buildAttributeGlb(std::span<const uint8_t> spzData, AttributeGlb& glb, const ConvertOptions& options);
+
+}  // namespace spz2glb
+
+#endif  // SPZ2GLB_ATTRIBUTE_GLB_H_
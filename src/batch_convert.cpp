@@ -0,0 +1,264 @@
+// Copyright (c) 2026 Pu Junhan
+// SPDX-License-Identifier: MIT
+// Project: SPZ-ecosystem
+// Repository: https://github.com/spz-ecosystem/spz2glb
+//
+// 批量转换实现
+
+#include "batch_convert.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+#include "conversion_cache.h"
+#include "glb_extract.h"
+#include "io_pipeline.h"
+#include "spz_converter.h"
+#include "thread_pool.h"
+
+namespace fs = std::filesystem;
+
+namespace spz2glb {
+
+namespace {
+
+bool hasWildcard(const std::string& path) {
+    return path.find_first_of("*?") != std::string::npos;
+}
+
+// 文件名通配：* 匹配任意多个字符，? 匹配单个字符
+bool wildcardMatch(const std::string& pattern, const std::string& name) {
+    size_t p = 0, n = 0;
+    size_t star = std::string::npos, mark = 0;
+    while (n < name.size()) {
+        if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == name[n])) {
+            ++p;
+            ++n;
+        } else if (p < pattern.size() && pattern[p] == '*') {
+            star = p++;
+            mark = n;
+        } else if (star != std::string::npos) {
+            p = star + 1;
+            n = ++mark;
+        } else {
+            return false;
+        }
+    }
+    while (p < pattern.size() && pattern[p] == '*') ++p;
+    return p == pattern.size();
+}
+
+bool hasExtension(const fs::path& path, const char* extension) {
+    std::string ext = path.extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) {
+        return static_cast<char>(std::tolower(c));
+    });
+    return ext == extension;
+}
+
+std::string defaultOutputPath(const fs::path& input, const BatchOptions& options) {
+    const std::string& outputDir = options.outputDir;
+    fs::path output = input;
+    output.replace_extension(options.extract ? ".spz" : ".glb");
+    if (!outputDir.empty()) {
+        output = fs::path(outputDir) / output.filename();
+    }
+    return output.string();
+}
+
+void addJob(std::vector<BatchJob>& jobs, const fs::path& input, std::string output) {
+    std::error_code ec;
+    auto size = fs::file_size(input, ec);
+    jobs.push_back({input.string(), std::move(output), ec ? 0 : static_cast<uint64_t>(size)});
+}
+
+std::string formatMB(uint64_t bytes) {
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(2) << (bytes / 1024.0 / 1024.0) << " MB";
+    return oss.str();
+}
+
+}  // anonymous namespace
+
+bool collectBatchJobs(const BatchOptions& options, std::vector<BatchJob>& jobs, std::string& error) {
+    std::error_code ec;
+    fs::path source(options.source);
+
+    if (hasWildcard(options.source)) {
+        fs::path dir = source.parent_path();
+        if (dir.empty()) dir = ".";
+        std::string pattern = source.filename().string();
+        for (const auto& entry : fs::directory_iterator(dir, ec)) {
+            if (entry.is_regular_file() && wildcardMatch(pattern, entry.path().filename().string())) {
+                addJob(jobs, entry.path(), defaultOutputPath(entry.path(), options));
+            }
+        }
+        if (ec) {
+            error = "Cannot read directory: " + dir.string();
+            return false;
+        }
+        return true;
+    }
+
+    if (fs::is_directory(source, ec)) {
+        for (const auto& entry : fs::directory_iterator(source, ec)) {
+            if (entry.is_regular_file() && hasExtension(entry.path(), options.extract ? ".glb" : ".spz")) {
+                addJob(jobs, entry.path(), defaultOutputPath(entry.path(), options));
+            }
+        }
+        if (ec) {
+            error = "Cannot read directory: " + source.string();
+            return false;
+        }
+        return true;
+    }
+
+    // 清单文件：每行 "input" 或 "input<TAB>output"
+    std::ifstream manifest(source);
+    if (!manifest) {
+        error = "Cannot open batch source: " + options.source;
+        return false;
+    }
+    std::string line;
+    while (std::getline(manifest, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty() || line[0] == '#') continue;
+
+        size_t tab = line.find('\t');
+        if (tab == std::string::npos) {
+            addJob(jobs, line, defaultOutputPath(line, options));
+        } else {
+            addJob(jobs, line.substr(0, tab), line.substr(tab + 1));
+        }
+    }
+    return true;
+}
+
+BatchSummary runBatch(std::vector<BatchJob> jobs, const BatchOptions& options) {
+    // 最大的文件最先开始
+    std::stable_sort(jobs.begin(), jobs.end(), [](const BatchJob& a, const BatchJob& b) {
+        return a.inputBytes > b.inputBytes;
+    });
+
+    if (!options.outputDir.empty()) {
+        std::error_code ec;
+        fs::create_directories(options.outputDir, ec);
+    }
+
+    std::mutex outputMutex;
+    std::atomic<size_t> failed{0};
+    std::atomic<uint64_t> inputBytes{0};
+    std::atomic<uint64_t> outputBytes{0};
+
+    auto report = [&](const BatchJob& job, bool success, const std::string& error,
+                      uint64_t glbBytes, double ms) {
+        std::lock_guard<std::mutex> lock(outputMutex);
+        if (success) {
+            inputBytes += job.inputBytes;
+            outputBytes += glbBytes;
+            std::cout << "[OK] " << job.inputPath << " -> " << job.outputPath
+                      << " (" << formatMB(glbBytes) << ", "
+                      << std::fixed << std::setprecision(1) << ms << " ms)\n";
+        } else {
+            failed++;
+            std::cout << "[FAIL] " << job.inputPath << ": " << error << "\n";
+        }
+    };
+
+    ConvertOptions convertOptions = options.convert;
+    convertOptions.verbose = false;
+
+    auto start = std::chrono::steady_clock::now();
+    {
+        // 不启动多于文件数的线程
+        size_t threads = options.jobs != 0 ? options.jobs : std::thread::hardware_concurrency();
+        ThreadPool pool(std::max<size_t>(1, std::min(threads, jobs.size())));
+        // 属性模式下单个文件的解码也在同一个池上分块并行（空闲线程协助大文件，避免长尾）
+        convertOptions.pool = &pool;
+
+#ifndef _WIN32
+        // 流水线只原样搬运压缩流；属性模式、gzip 索引与重新压缩都要解压整个流，走逐文件转换
+        bool pipelined = options.io != BatchIo::Splice && !options.extract &&
+                         options.convert.mode == OutputMode::Compressed &&
+                         options.convert.gzipIndexSpan == 0 && !options.convert.reencodesPayload();
+        if (options.io != BatchIo::Splice && !pipelined) {
+            std::cout << "[INFO] --io " << (options.io == BatchIo::IoUring ? "uring" : "posix")
+                      << " only passes SPZ streams through unchanged, using splice" << std::endl;
+        }
+        if (pipelined) {
+            // 每个线程一条流水线（各自一个 io_uring），共享同一个领取游标
+            PipelineOptions pipelineOptions;
+            pipelineOptions.backend = options.io == BatchIo::IoUring ? IoBackendKind::IoUring : IoBackendKind::Posix;
+            pipelineOptions.cache = options.convert.cache;
+            std::atomic<size_t> cursor{0};
+            std::atomic<const char*> backendName{nullptr};
+
+            std::cout << "[INFO] Batch: " << jobs.size() << " files on " << pool.size()
+                      << " I/O pipelines" << std::endl;
+            for (size_t i = 0; i < pool.size(); ++i) {
+                pool.submit([&] {
+                    backendName = runIoPipeline(jobs, cursor, pipelineOptions, [&](const PipelineResult& r) {
+                        report(*r.job, r.success, r.errorMessage, r.outputBytes, r.milliseconds);
+                    });
+                });
+            }
+            pool.wait();
+            if (backendName.load() != nullptr) {
+                std::cout << "[INFO] I/O backend: " << backendName.load() << "\n";
+            }
+        } else
+#endif
+        {
+            std::cout << "[INFO] Batch: " << jobs.size() << " files on " << pool.size() << " threads" << std::endl;
+
+            for (const auto& job : jobs) {
+                pool.submit([&, job] {
+                    auto fileStart = std::chrono::steady_clock::now();
+                    GlbLayout layout = {};
+                    uint64_t outputBytes = 0;
+                    SpzResult result;
+                    if (options.extract) {
+                        std::vector<ExtractedSpz> outputs;
+                        result = extractSpzFile(job.inputPath, job.outputPath, outputs);
+                        for (const auto& output : outputs) {
+                            outputBytes += output.bytes;
+                        }
+                    } else {
+                        result = convertSpzFile(job.inputPath, job.outputPath, layout, convertOptions);
+                        outputBytes = layout.totalLength;
+                    }
+                    double ms = std::chrono::duration<double, std::milli>(
+                        std::chrono::steady_clock::now() - fileStart).count();
+                    report(job, result.success, result.errorMessage, outputBytes, ms);
+                });
+            }
+            pool.wait();
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    BatchSummary summary = {jobs.size(), failed.load(), inputBytes.load(), outputBytes.load(), seconds};
+
+    double safeSeconds = seconds > 0 ? seconds : 1e-9;
+    std::cout << "[INFO] Batch done: " << summary.files << " files, " << summary.failed << " failed, "
+              << std::fixed << std::setprecision(2) << seconds << " s, "
+              << (summary.files / safeSeconds) << " files/s, "
+              << (summary.inputBytes / 1024.0 / 1024.0 / safeSeconds) << " MB/s" << std::endl;
+    if (options.convert.cache != nullptr) {
+        auto stats = options.convert.cache->stats();
+        std::cout << "[INFO] Cache: " << stats.hits << " hits, " << stats.misses << " misses, "
+                  << stats.evictions << " evictions" << std::endl;
+    }
+    return summary;
+}
+
+}  // namespace spz2glb
@@ -0,0 +1,75 @@
+// Copyright (c) 2026 Pu Junhan
+// SPDX-License-Identifier: MIT
+// Project: SPZ-ecosystem
+// Repository: https://github.com/spz-ecosystem/spz2glb
+//
+// 批量转换
+// 一个进程内转换整个目录 / glob / 清单文件中的 SPZ 文件
+
+#ifndef SPZ2GLB_BATCH_CONVERT_H_
+#define SPZ2GLB_BATCH_CONVERT_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "spz_converter.h"
+
+namespace spz2glb {
+
+struct BatchJob {
+    std::string inputPath;
+    std::string outputPath;
+    uint64_t inputBytes;
+};
+
+/**
+ * 批量转换的 I/O 方式
+ */
+enum class BatchIo {
+    Splice,   // mmap 输入 + copy_file_range / writev（每个文件同步完成）
+    IoUring,  // io_uring 流水线，多个文件的读写同时在途（Linux）
+    Posix     // 同一流水线，使用阻塞 pread/pwrite
+};
+
+struct BatchOptions {
+    std::string source;     // 目录、glob（如 captures/*.spz）或清单文件
+    std::string outputDir;  // 为空时输出到输入文件旁边
+    size_t jobs = 0;        // 工作线程数，0 表示使用全部 CPU
+    BatchIo io = BatchIo::Splice;
+    bool extract = false;   // 反向：收集 .glb 文件，取出其中的 SPZ 流（extract 命令）
+    ConvertOptions convert;  // 每个文件的转换选项（输出模式、缓存等）；verbose 与 pool 由批量模式自行设置
+};
+
+struct BatchSummary {
+    size_t files;
+    size_t failed;
+    uint64_t inputBytes;
+    uint64_t outputBytes;
+    double seconds;
+};
+
+/**
+ * 收集批量任务
+ *
+ * source 的解析规则：
+ * - 目录：目录下所有 .spz 文件（不递归；extract 时为 .glb 文件）
+ * - 含 * 或 ? 的路径：在其所在目录中按文件名通配
+ * - 其他普通文件：清单，每行一个输入；可用 Tab 分隔指定输出路径，# 开头为注释
+ *
+ * @return false 如果 source 不存在或无法读取，error 中为原因
+ */
+bool collectBatchJobs(const BatchOptions& options, std::vector<BatchJob>& jobs, std::string& error);
+
+/**
+ * 在工作窃取线程池上执行批量转换
+ *
+ * 任务按输入大小降序提交，最大的文件最先开始，避免单个大文件拖成长尾；
+ * 每个文件完成时打印一行状态，结束时打印总吞吐（files/s、MB/s）
+ */
+BatchSummary runBatch(std::vector<BatchJob> jobs, const BatchOptions& options);
+
+}  // namespace spz2glb
+
+#endif  // SPZ2GLB_BATCH_CONVERT_H_
@@ -0,0 +1,502 @@
+// Copyright (c) 2026 Pu Junhan
+// SPDX-License-Identifier: MIT
+// Project: SPZ-ecosystem
+// Repository: https://github.com/spz-ecosystem/spz2glb
+//
+// 内置整块 inflate 实现
+//
+// 与 zlib inflate 的区别：
+// - 输出缓冲区一次分配好，解码循环里没有“输出满了 -> 返回 -> 扩容 -> 再进入”的往返
+// - 64 位位缓冲，一次补充 7 个字节，足够解出一个完整的 长度 + 距离 对
+// - 一级查表解出大部分符号（字面量/长度 11 位，距离 8 位），更长的码走二级子表
+// - 距离 >= 16 的匹配按 16 字节整块拷贝（编译为 SSE / NEON / WASM SIMD 的非对齐读写）
+
+#include "builtin_inflate.h"
+
+#include <algorithm>
+#include <bit>
+#include <climits>
+#include <cstring>
+
+#include <zlib.h>
+
+namespace spz2glb {
+
+namespace {
+
+constexpr unsigned kLitlenTableBits = 11;
+constexpr unsigned kDistTableBits = 8;
+constexpr unsigned kPrecodeTableBits = 7;
+constexpr unsigned kMaxCodeLength = 15;
+constexpr unsigned kNumLitlenSymbols = 288;
+constexpr unsigned kNumDistSymbols = 32;
+constexpr unsigned kNumPrecodeSymbols = 19;
+
+constexpr uint16_t kLengthBase[29] = {3,  4,  5,  6,  7,  8,  9,  10, 11,  13,  15,  17,  19,  23, 27,
+                                      31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+constexpr uint8_t kLengthExtra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2,
+                                      2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+constexpr uint16_t kDistBase[30] = {1,   2,   3,   4,   5,   7,    9,    13,   17,   25,   33,   49,    65,    97,    129,
+                                    193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+constexpr uint8_t kDistExtra[30] = {0, 0, 0, 0, 1, 1, 2, 2,  3,  3,  4,  4,  5,  5,  6,
+                                    6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+constexpr uint8_t kPrecodeOrder[kNumPrecodeSymbols] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+
+// 解码表项：[3:0] 消耗的位数 | [7:4] 类型 | [15:8] 额外位数（子表指针为子表位数） | [31:16] 值
+enum EntryKind : uint32_t {
+    kLiteral = 0,     // 值为字面量（码长表中为码长符号）
+    kMatch = 1,       // 值为长度或距离的基数，之后再读额外位
+    kEndOfBlock = 2,
+    kSubtable = 3,    // 值为子表在表中的起点
+    kInvalid = 4
+};
+
+constexpr uint32_t makeEntry(uint32_t length, uint32_t kind, uint32_t extra, uint32_t value) {
+    return length | (kind << 4) | (extra << 8) | (value << 16);
+}
+inline uint32_t entryLength(uint32_t entry) { return entry & 15; }
+inline uint32_t entryKind(uint32_t entry) { return (entry >> 4) & 15; }
+inline uint32_t entryExtra(uint32_t entry) { return (entry >> 8) & 255; }
+inline uint32_t entryValue(uint32_t entry) { return entry >> 16; }
+
+constexpr uint32_t kInvalidEntry = makeEntry(0, kInvalid, 0, 0);
+
+uint32_t litlenSymbolEntry(unsigned symbol) {
+    if (symbol < 256) return makeEntry(0, kLiteral, 0, symbol);
+    if (symbol == 256) return makeEntry(0, kEndOfBlock, 0, 0);
+    if (symbol < 286) return makeEntry(0, kMatch, kLengthExtra[symbol - 257], kLengthBase[symbol - 257]);
+    return kInvalidEntry;
+}
+
+uint32_t distSymbolEntry(unsigned symbol) {
+    return symbol < 30 ? makeEntry(0, kMatch, kDistExtra[symbol], kDistBase[symbol]) : kInvalidEntry;
+}
+
+uint32_t precodeSymbolEntry(unsigned symbol) {
+    return makeEntry(0, kLiteral, 0, symbol);
+}
+
+/**
+ * 由码长构建解码表
+ *
+ * 码长 <= tableBits 的码字在一级表中按 2^len 的步长重复填写；
+ * 更长的码字按低 tableBits 位分组，每组一个 2^(maxLength - tableBits) 项的子表
+ *
+ * @param allowIncomplete 字面量/距离表允许只有一个码字的不完整码（与 zlib 一致）
+ */
+bool buildTable(const uint8_t* lengths, unsigned count, unsigned tableBits, bool allowIncomplete,
+                uint32_t (*symbolEntry)(unsigned), std::vector<uint32_t>& table) {
+    unsigned lengthCount[kMaxCodeLength + 1] = {};
+    for (unsigned i = 0; i < count; ++i) {
+        lengthCount[lengths[i]]++;
+    }
+    lengthCount[0] = 0;
+
+    // Kraft 不等式：码字不能超额，不完整的码只在只有一个 1 位码字时允许
+    int left = 1;
+    unsigned maxLength = 0;
+    for (unsigned len = 1; len <= kMaxCodeLength; ++len) {
+        left = (left << 1) - static_cast<int>(lengthCount[len]);
+        if (left < 0) return false;
+        if (lengthCount[len] != 0) maxLength = len;
+    }
+    if (left > 0 && (!allowIncomplete || maxLength > 1)) {
+        return false;
+    }
+
+    uint32_t nextCode[kMaxCodeLength + 2] = {};
+    uint32_t code = 0;
+    for (unsigned len = 1; len <= kMaxCodeLength; ++len) {
+        code = (code + lengthCount[len - 1]) << 1;
+        nextCode[len] = code;
+    }
+
+    table.assign(size_t{1} << tableBits, kInvalidEntry);
+    const uint32_t mainMask = (1u << tableBits) - 1;
+    for (unsigned symbol = 0; symbol < count; ++symbol) {
+        unsigned len = lengths[symbol];
+        if (len == 0) continue;
+
+        // deflate 码字从高位开始发送，位缓冲从低位读取：按位反转后查表
+        uint32_t reversed = 0;
+        for (uint32_t c = nextCode[len]++, i = 0; i < len; ++i, c >>= 1) {
+            reversed = (reversed << 1) | (c & 1);
+        }
+
+        uint32_t entry = symbolEntry(symbol);
+        if (len <= tableBits) {
+            for (uint32_t i = reversed; i < (1u << tableBits); i += 1u << len) {
+                table[i] = entry | len;
+            }
+            continue;
+        }
+
+        uint32_t subBits = maxLength - tableBits;
+        uint32_t& pointer = table[reversed & mainMask];
+        if (entryKind(pointer) != kSubtable) {
+            pointer = makeEntry(tableBits, kSubtable, subBits, static_cast<uint32_t>(table.size()));
+            table.resize(table.size() + (size_t{1} << subBits), kInvalidEntry);
+        }
+        uint32_t offset = entryValue(table[reversed & mainMask]);
+        uint32_t subLength = len - tableBits;
+        for (uint32_t i = reversed >> tableBits; i < (1u << subBits); i += 1u << subLength) {
+            table[offset + i] = entry | subLength;
+        }
+    }
+    return true;
+}
+
+inline uint64_t loadLittleEndian64(const uint8_t* p) {
+    uint64_t value;
+    std::memcpy(&value, p, sizeof(value));
+    if constexpr (std::endian::native == std::endian::big) {
+        value = __builtin_bswap64(value);
+    }
+    return value;
+}
+
+/**
+ * 64 位位缓冲读取器
+ *
+ * refill() 之后至少有 56 位可用。缓冲中 count_ 之上的位要么为 0，要么就是后续输入的正确数据，
+ * 所以快速路径可以整字读取、只前进完整消耗的字节数。输入末尾之后补 0 并记入 overrun_
+ */
+class BitReader {
+public:
+    explicit BitReader(std::span<const uint8_t> input)
+        : begin_(input.data()), next_(input.data()), end_(input.data() + input.size()) {}
+
+    void refill() {
+        if (end_ - next_ >= 8) {
+            bits_ |= loadLittleEndian64(next_) << count_;
+            next_ += (63 - count_) >> 3;
+            count_ |= 56;
+            return;
+        }
+        while (count_ <= 56) {
+            if (next_ < end_) {
+                bits_ |= uint64_t{*next_++} << count_;
+            } else {
+                overrun_++;
+            }
+            count_ += 8;
+        }
+    }
+
+    uint32_t peek(unsigned n) const { return static_cast<uint32_t>(bits_ & ((uint64_t{1} << n) - 1)); }
+    void consume(unsigned n) {
+        bits_ >>= n;
+        count_ -= n;
+    }
+    uint32_t take(unsigned n) {
+        uint32_t value = peek(n);
+        consume(n);
+        return value;
+    }
+
+    // 解一个符号，调用前需保证至少 15 位可用
+    uint32_t decode(const std::vector<uint32_t>& table, unsigned tableBits) {
+        uint32_t entry = table[peek(tableBits)];
+        if (entryKind(entry) == kSubtable) {
+            consume(tableBits);
+            entry = table[entryValue(entry) + peek(entryExtra(entry))];
+        }
+        consume(entryLength(entry));
+        return entry;
+    }
+
+    // 读过输入末尾太多说明数据被截断
+    bool truncated() const { return overrun_ > 8; }
+
+    /**
+     * 丢弃到字节边界，返回下一个未消耗字节的位置（相对输入起点）
+     *
+     * @return 已消耗的位超过输入末尾时返回 false
+     */
+    bool bytePosition(size_t& position) {
+        consume(count_ & 7);
+        size_t buffered = count_ >> 3;
+        if (overrun_ > buffered) return false;
+        position = static_cast<size_t>(next_ - begin_) - (buffered - overrun_);
+        return true;
+    }
+
+    void seek(size_t position) {
+        next_ = begin_ + position;
+        bits_ = 0;
+        count_ = 0;
+        overrun_ = 0;
+    }
+
+private:
+    const uint8_t* begin_;
+    const uint8_t* next_;
+    const uint8_t* end_;
+    uint64_t bits_ = 0;
+    unsigned count_ = 0;
+    size_t overrun_ = 0;
+};
+
+// 读取动态哈夫曼块的码表定义（RFC 1951 3.2.7）
+bool readDynamicTables(BitReader& reader, std::vector<uint32_t>& litlen, std::vector<uint32_t>& dist,
+                       std::vector<uint32_t>& precode) {
+    reader.refill();
+    unsigned numLitlen = reader.take(5) + 257;
+    unsigned numDist = reader.take(5) + 1;
+    unsigned numPrecode = reader.take(4) + 4;
+    if (numLitlen > 286 || numDist > 30) {
+        return false;
+    }
+
+    uint8_t precodeLengths[kNumPrecodeSymbols] = {};
+    for (unsigned i = 0; i < numPrecode; ++i) {
+        reader.refill();
+        precodeLengths[kPrecodeOrder[i]] = static_cast<uint8_t>(reader.take(3));
+    }
+    if (!buildTable(precodeLengths, kNumPrecodeSymbols, kPrecodeTableBits, false, precodeSymbolEntry, precode)) {
+        return false;
+    }
+
+    uint8_t lengths[286 + 30] = {};
+    unsigned total = numLitlen + numDist;
+    for (unsigned i = 0; i < total;) {
+        reader.refill();
+        if (reader.truncated()) return false;
+        uint32_t entry = reader.decode(precode, kPrecodeTableBits);
+        if (entryKind(entry) != kLiteral) return false;
+
+        unsigned symbol = entryValue(entry);
+        if (symbol < 16) {
+            lengths[i++] = static_cast<uint8_t>(symbol);
+            continue;
+        }
+        uint8_t value = 0;
+        unsigned repeat;
+        if (symbol == 16) {
+            if (i == 0) return false;
+            value = lengths[i - 1];
+            repeat = 3 + reader.take(2);
+        } else if (symbol == 17) {
+            repeat = 3 + reader.take(3);
+        } else {
+            repeat = 11 + reader.take(7);
+        }
+        if (repeat > total - i) return false;
+        std::memset(lengths + i, value, repeat);
+        i += repeat;
+    }
+    if (lengths[256] == 0) {
+        return false;  // 没有块结束符
+    }
+
+    return buildTable(lengths, numLitlen, kLitlenTableBits, true, litlenSymbolEntry, litlen) &&
+           buildTable(lengths + numLitlen, numDist, kDistTableBits, true, distSymbolEntry, dist);
+}
+
+void buildFixedTables(std::vector<uint32_t>& litlen, std::vector<uint32_t>& dist) {
+    uint8_t lengths[kNumLitlenSymbols];
+    std::fill(lengths, lengths + 144, 8);
+    std::fill(lengths + 144, lengths + 256, 9);
+    std::fill(lengths + 256, lengths + 280, 7);
+    std::fill(lengths + 280, lengths + kNumLitlenSymbols, 8);
+    buildTable(lengths, kNumLitlenSymbols, kLitlenTableBits, true, litlenSymbolEntry, litlen);
+
+    uint8_t distLengths[kNumDistSymbols];
+    std::fill(distLengths, distLengths + kNumDistSymbols, 5);
+    buildTable(distLengths, kNumDistSymbols, kDistTableBits, true, distSymbolEntry, dist);
+}
+
+/**
+ * 把 out - distance 处的 length 字节拷贝到 out
+ *
+ * fast 为 true 时调用方保证 out 之后至少还有 length + 15 字节可写
+ */
+inline void copyMatch(uint8_t* out, size_t distance, size_t length, bool fast) {
+    const uint8_t* src = out - distance;
+    uint8_t* end = out + length;
+    if (fast && distance >= 16) {
+        do {
+            std::memcpy(out, src, 16);
+            out += 16;
+            src += 16;
+        } while (out < end);
+    } else if (distance == 1) {
+        std::memset(out, *src, length);
+    } else if (fast && distance >= 8) {
+        do {
+            std::memcpy(out, src, 8);
+            out += 8;
+            src += 8;
+        } while (out < end);
+    } else {
+        // 距离小于拷贝宽度时源与目标重叠，必须逐字节拷贝以复制重复模式
+        while (out < end) *out++ = *src++;
+    }
+}
+
+}  // anonymous namespace
+
+InflateStatus inflateRawBuffer(std::span<const uint8_t> input, std::span<uint8_t> out, size_t& consumed,
+                               size_t& produced) {
+    BitReader reader(input);
+    uint8_t* const outBegin = out.data();
+    uint8_t* const outEnd = out.data() + out.size();
+    uint8_t* dst = outBegin;
+
+    std::vector<uint32_t> litlen;
+    std::vector<uint32_t> dist;
+    std::vector<uint32_t> precode;
+    litlen.reserve((size_t{1} << kLitlenTableBits) * 2);
+    dist.reserve((size_t{1} << kDistTableBits) * 2);
+
+    bool last = false;
+    while (!last) {
+        reader.refill();
+        last = reader.take(1) != 0;
+        uint32_t type = reader.take(2);
+
+        if (type == 0) {
+            // 存储块：字节对齐后 LEN / NLEN，再原样拷贝 LEN 字节
+            size_t position = 0;
+            if (!reader.bytePosition(position) || input.size() - position < 4) {
+                return InflateStatus::Corrupt;
+            }
+            const uint8_t* p = input.data() + position;
+            size_t length = p[0] | (p[1] << 8);
+            size_t inverse = p[2] | (p[3] << 8);
+            if (length != (~inverse & 0xffff) || input.size() - position - 4 < length) {
+                return InflateStatus::Corrupt;
+            }
+            if (static_cast<size_t>(outEnd - dst) < length) {
+                return InflateStatus::OutputFull;
+            }
+            std::memcpy(dst, p + 4, length);
+            dst += length;
+            reader.seek(position + 4 + length);
+            continue;
+        }
+
+        if (type == 1) {
+            buildFixedTables(litlen, dist);
+        } else if (type != 2 || !readDynamicTables(reader, litlen, dist, precode)) {
+            return InflateStatus::Corrupt;
+        }
+
+        for (;;) {
+            // 一次补充后至少 56 位：字面量/长度码 15 + 额外 5 + 距离码 15 + 额外 13 = 48 位
+            reader.refill();
+            if (reader.truncated()) {
+                return InflateStatus::Corrupt;
+            }
+            uint32_t entry = reader.decode(litlen, kLitlenTableBits);
+            uint32_t kind = entryKind(entry);
+            if (kind == kLiteral) {
+                if (dst == outEnd) return InflateStatus::OutputFull;
+                *dst++ = static_cast<uint8_t>(entryValue(entry));
+                continue;
+            }
+            if (kind == kEndOfBlock) {
+                break;
+            }
+            if (kind != kMatch) {
+                return InflateStatus::Corrupt;
+            }
+            size_t length = entryValue(entry) + reader.take(entryExtra(entry));
+
+            entry = reader.decode(dist, kDistTableBits);
+            if (entryKind(entry) != kMatch) {
+                return InflateStatus::Corrupt;
+            }
+            size_t distance = entryValue(entry) + reader.take(entryExtra(entry));
+            if (distance > static_cast<size_t>(dst - outBegin)) {
+                return InflateStatus::Corrupt;
+            }
+            size_t room = static_cast<size_t>(outEnd - dst);
+            if (room < length) {
+                return InflateStatus::OutputFull;
+            }
+            copyMatch(dst, distance, length, room + kInflateSlack >= length + 15);
+            dst += length;
+        }
+    }
+
+    if (!reader.bytePosition(consumed)) {
+        return InflateStatus::Corrupt;
+    }
+    produced = static_cast<size_t>(dst - outBegin);
+    return InflateStatus::Ok;
+}
+
+bool builtinGunzip(std::span<const uint8_t> compressed, std::vector<uint8_t>& out, std::string& error) {
+    // gzip 头（RFC 1952）：ID1 ID2 CM FLG MTIME(4) XFL OS，之后按 FLG 跟可选字段
+    enum : uint8_t { kFlagHcrc = 2, kFlagExtra = 4, kFlagName = 8, kFlagComment = 16, kFlagReserved = 0xe0 };
+    const size_t size = compressed.size();
+    if (size < 18 || compressed[0] != 0x1f || compressed[1] != 0x8b || compressed[2] != 8 ||
+        (compressed[3] & kFlagReserved) != 0) {
+        error = "Not a gzip stream";
+        return false;
+    }
+    uint8_t flags = compressed[3];
+    size_t pos = 10;
+    if (flags & kFlagExtra) {
+        size_t extra = compressed[pos] | (compressed[pos + 1] << 8);
+        pos += 2 + extra;
+    }
+    for (uint8_t flag : {kFlagName, kFlagComment}) {
+        if (flags & flag) {
+            while (pos < size && compressed[pos] != 0) ++pos;
+            ++pos;
+        }
+    }
+    if (flags & kFlagHcrc) {
+        pos += 2;
+    }
+    if (pos + 8 > size) {
+        error = "Truncated gzip header";
+        return false;
+    }
+
+    // 流末尾的 ISIZE 是解压长度 mod 2^32，只作为初始容量；deflate 的压缩比不超过 1032:1
+    const uint8_t* tail = compressed.data() + size - 4;
+    uint64_t capacity = tail[0] | (tail[1] << 8) | (tail[2] << 16) | (uint64_t{tail[3]} << 24);
+    capacity = std::min<uint64_t>(capacity, uint64_t{size} * 1032);
+
+    std::span<const uint8_t> deflated = compressed.subspan(pos);
+    size_t consumed = 0;
+    size_t produced = 0;
+    for (;;) {
+        out.resize(static_cast<size_t>(capacity) + kInflateSlack);
+        auto status = inflateRawBuffer(deflated, std::span(out.data(), static_cast<size_t>(capacity)), consumed,
+                                       produced);
+        if (status == InflateStatus::Ok) break;
+        if (status == InflateStatus::Corrupt) {
+            error = "Corrupt deflate data";
+            return false;
+        }
+        // 多成员或带尾随数据时 ISIZE 不是这个成员的长度，加倍重试
+        capacity = std::max<uint64_t>(capacity * 2, 1 << 16);
+    }
+    out.resize(produced);
+
+    if (deflated.size() - consumed < 8) {
+        error = "Truncated gzip trailer";
+        return false;
+    }
+    const uint8_t* trailer = deflated.data() + consumed;
+    uint32_t expectedCrc = trailer[0] | (trailer[1] << 8) | (trailer[2] << 16) | (uint32_t{trailer[3]} << 24);
+    uint32_t expectedSize = trailer[4] | (trailer[5] << 8) | (trailer[6] << 16) | (uint32_t{trailer[7]} << 24);
+
+    uLong crc = ::crc32(0L, Z_NULL, 0);
+    for (size_t offset = 0; offset < out.size();) {
+        uInt chunk = static_cast<uInt>(std::min<size_t>(out.size() - offset, UINT_MAX));
+        crc = ::crc32(crc, out.data() + offset, chunk);
+        offset += chunk;
+    }
+    if (static_cast<uint32_t>(crc) != expectedCrc || static_cast<uint32_t>(out.size()) != expectedSize) {
+        error = "Gzip CRC-32 or length mismatch";
+        return false;
+    }
+    return true;
+}
+
+}  // namespace spz2glb
@@ -0,0 +1,54 @@
+// Copyright (c) 2026 Pu Junhan
+// SPDX-License-Identifier: MIT
+// Project: SPZ-ecosystem
+// Repository: https://github.com/spz-ecosystem/spz2glb
+//
+// 内置整块 inflate（libdeflate 的做法）
+// 输入、输出都是完整的内存缓冲区，不需要 zlib 流式接口的逐次调用与状态机
+
+#ifndef SPZ2GLB_BUILTIN_INFLATE_H_
+#define SPZ2GLB_BUILTIN_INFLATE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace spz2glb {
+
+/**
+ * raw deflate 整块解压结果
+ */
+enum class InflateStatus {
+    Ok,
+    OutputFull,  // 输出缓冲区不够
+    Corrupt      // 数据格式错误或输入被截断
+};
+
+/**
+ * 解压一段 raw deflate 到 out
+ *
+ * 解码到最终块（BFINAL）结束；out 的容量之后保留至少 kInflateSlack 字节可写空间时，
+ * 匹配拷贝按 16 字节整块进行（可能写过实际输出末尾，调用方随后覆盖或截断）
+ *
+ * @param consumed 输出：消耗的输入字节数（最终块之后按字节对齐）
+ * @param produced 输出：写入 out 的字节数
+ */
+InflateStatus inflateRawBuffer(std::span<const uint8_t> input, std::span<uint8_t> out, size_t& consumed,
+                               size_t& produced);
+
+// 匹配拷贝允许写过输出末尾的字节数
+constexpr size_t kInflateSlack = 32;
+
+/**
+ * 解压单成员 gzip 流
+ *
+ * 输出按尾部 ISIZE 一次分配（ISIZE 只是 mod 2^32 的提示，不够时加倍重试），
+ * 解压后校验 CRC-32 与 ISIZE
+ */
+bool builtinGunzip(std::span<const uint8_t> compressed, std::vector<uint8_t>& out, std::string& error);
+
+}  // namespace spz2glb
+
+#endif  // SPZ2GLB_BUILTIN_INFLATE_H_
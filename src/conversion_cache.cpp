@@ -0,0 +1,359 @@
+// Copyright (c) 2026 Pu Junhan
+// SPDX-License-Identifier: MIT
+// Project: SPZ-ecosystem
+// Repository: https://github.com/spz-ecosystem/spz2glb
+//
+// 内容寻址转换缓存实现
+
+#include "conversion_cache.h"
+
+#ifndef __EMSCRIPTEN__
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <random>
+#include <vector>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#endif
+
+#include "glb_writer.h"
+#include "spz_converter.h"
+
+namespace fs = std::filesystem;
+
+namespace spz2glb {
+
+namespace {
+
+// GLB 输出格式变化（JSON 结构、扩展字段等）时递增，使旧条目自然失效
+constexpr const char* kCacheFormat = "spz2glb-glb-1";
+
+constexpr uint64_t kPrime1 = 0x9E3779B185EBCA87ull;
+constexpr uint64_t kPrime2 = 0xC2B2AE3D27D4EB4Full;
+constexpr uint64_t kPrime3 = 0x165667B19E3779F9ull;
+constexpr uint64_t kPrime4 = 0x85EBCA77C2B2AE63ull;
+constexpr uint64_t kPrime5 = 0x27D4EB2F165667C5ull;
+
+inline uint64_t rotl(uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+inline uint64_t read64(const uint8_t* p) {
+    uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline uint32_t read32(const uint8_t* p) {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline uint64_t round64(uint64_t acc, uint64_t input) {
+    acc += input * kPrime2;
+    acc = rotl(acc, 31);
+    return acc * kPrime1;
+}
+
+inline uint64_t mergeRound(uint64_t acc, uint64_t value) {
+    acc ^= round64(0, value);
+    return acc * kPrime1 + kPrime4;
+}
+
+#ifdef __linux__
+// 写时复制克隆（btrfs / XFS 等），不支持时返回 false
+bool cloneFd(int in, int out) {
+#ifdef FICLONE
+    return ::ioctl(out, FICLONE, in) == 0;
+#else
+    (void)in;
+    (void)out;
+    return false;
+#endif
+}
+
+bool cloneFile(const std::string& from, const std::string& to) {
+#ifdef FICLONE
+    int in = ::open(from.c_str(), O_RDONLY | O_CLOEXEC);
+    if (in < 0) {
+        return false;
+    }
+    int out = ::open(to.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (out < 0) {
+        ::close(in);
+        return false;
+    }
+    bool ok = cloneFd(in, out);
+    ::close(in);
+    ::close(out);
+    if (!ok) {
+        ::unlink(to.c_str());
+    }
+    return ok;
+#else
+    (void)from;
+    (void)to;
+    return false;
+#endif
+}
+#else
+bool cloneFd(int, int) {
+    return false;
+}
+
+bool cloneFile(const std::string&, const std::string&) {
+    return false;
+}
+#endif
+
+}  // anonymous namespace
+
+uint64_t hashBytes(std::span<const uint8_t> data, uint64_t seed) {
+    const uint8_t* p = data.data();
+    const uint8_t* end = p + data.size();
+    uint64_t h;
+
+    if (data.size() >= 32) {
+        uint64_t v1 = seed + kPrime1 + kPrime2;
+        uint64_t v2 = seed + kPrime2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - kPrime1;
+        const uint8_t* limit = end - 32;
+        do {
+            v1 = round64(v1, read64(p));
+            v2 = round64(v2, read64(p + 8));
+            v3 = round64(v3, read64(p + 16));
+            v4 = round64(v4, read64(p + 24));
+            p += 32;
+        } while (p <= limit);
+
+        h = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+        h = mergeRound(h, v1);
+        h = mergeRound(h, v2);
+        h = mergeRound(h, v3);
+        h = mergeRound(h, v4);
+    } else {
+        h = seed + kPrime5;
+    }
+
+    h += static_cast<uint64_t>(data.size());
+
+    while (p + 8 <= end) {
+        h ^= round64(0, read64(p));
+        h = rotl(h, 27) * kPrime1 + kPrime4;
+        p += 8;
+    }
+    if (p + 4 <= end) {
+        h ^= static_cast<uint64_t>(read32(p)) * kPrime1;
+        h = rotl(h, 23) * kPrime2 + kPrime3;
+        p += 4;
+    }
+    while (p < end) {
+        h ^= (*p) * kPrime5;
+        h = rotl(h, 11) * kPrime1;
+        ++p;
+    }
+
+    h ^= h >> 33;
+    h *= kPrime2;
+    h ^= h >> 29;
+    h *= kPrime3;
+    h ^= h >> 32;
+    return h;
+}
+
+bool ConversionCache::open(const std::string& directory, uint64_t maxBytes, std::string& error) {
+    std::error_code ec;
+    fs::create_directories(directory, ec);
+    if (ec || !fs::is_directory(directory, ec)) {
+        error = "Cannot create cache directory: " + directory;
+        return false;
+    }
+
+    directory_ = directory;
+    maxBytes_ = maxBytes;
+
+    uint64_t total = 0;
+    for (auto it = fs::recursive_directory_iterator(directory_, ec); !ec && it != fs::recursive_directory_iterator();
+         it.increment(ec)) {
+        if (it->is_regular_file(ec) && it->path().extension() == ".glb") {
+            total += it->file_size(ec);
+        }
+    }
+    totalBytes_ = total;
+    evictIfNeeded();
+    return true;
+}
+
+std::string ConversionCache::keyFor(std::span<const uint8_t> input, const ConvertOptions& options) {
+    // 只有影响输出字节的选项参与指纹；verbose、pool 等不参与
+    // 默认的压缩模式不追加任何内容，已有缓存条目保持有效
+    std::string fingerprint = kCacheFormat;
+    if (options.mode == OutputMode::Attributes) {
+        fingerprint += options.attributeLayout == AttributeLayout::Interleaved
+            ? "|attributes-interleaved" : "|attributes-planar";
+    } else {
+        if (options.repackBlockBytes > 0) {
+            fingerprint += "|repack-" + std::to_string(options.repackBlockBytes);
+        }
+        if (options.recompress) {
+            fingerprint += "|recompress";
+        }
+        if (options.tilePoints > 0) {
+            fingerprint += "|tile-" + std::to_string(options.tilePoints);
+        }
+        if (options.lodLevels > 0) {
+            fingerprint += "|lod-" + std::to_string(options.lodLevels);
+        }
+    }
+    if (options.maxShDegree < kMaxShDegree) {
+        fingerprint += "|sh-" + std::to_string(options.maxShDegree);
+    }
+    if (options.spatialCurve != SpatialCurve::None) {
+        fingerprint += std::string("|order-") + spatialCurveName(options.spatialCurve);
+    }
+    uint64_t seed = hashBytes(std::span<const uint8_t>(
+        reinterpret_cast<const uint8_t*>(fingerprint.data()), fingerprint.size()));
+
+    char key[40];
+    std::snprintf(key, sizeof(key), "%016llx-%llu",
+                  static_cast<unsigned long long>(hashBytes(input, seed)),
+                  static_cast<unsigned long long>(input.size()));
+    return key;
+}
+
+std::string ConversionCache::entryPath(const std::string& key) const {
+    return (fs::path(directory_) / key.substr(0, 2) / (key + ".glb")).string();
+}
+
+bool ConversionCache::fetch(const std::string& key, const std::string& outputPath, uint64_t& outputBytes) {
+    std::string entry = entryPath(key);
+    std::error_code ec;
+    uint64_t size = fs::file_size(entry, ec);
+    if (ec) {
+        misses_++;
+        return false;
+    }
+
+    // 不用硬链接：输出与条目共享 inode 时，之后对输出的任何原地写入都会改坏缓存条目。
+    // 先写临时文件再 rename，中途失败时不留下不完整的输出，原有输出保持原样
+#ifndef _WIN32
+    MappedFile source;
+    OutputFile out;
+    bool produced = source.open(entry) && out.open(outputPath) &&
+                    // 不支持 reflink 或跨文件系统：退化为拷贝
+                    (cloneFd(source.fd(), out.fd()) || writeFileAt(out.fd(), source, 0)) && out.commit();
+    size = source.size();
+#else
+    fs::path temp = outputPath + ".tmp-" + std::to_string(tempCounter_++);
+    fs::copy_file(entry, temp, fs::copy_options::overwrite_existing, ec);
+    bool produced = !ec;
+    if (produced) {
+        fs::rename(temp, outputPath, ec);
+        produced = !ec;
+    }
+    if (!produced) {
+        fs::remove(temp, ec);
+    }
+#endif
+    if (!produced) {
+        // 条目可能刚被其他进程淘汰
+        misses_++;
+        return false;
+    }
+
+    fs::last_write_time(entry, fs::file_time_type::clock::now(), ec);
+    outputBytes = size;
+    hits_++;
+    return true;
+}
+
+void ConversionCache::store(const std::string& key, const std::string& outputPath) {
+    std::error_code ec;
+    fs::path entry = entryPath(key);
+    fs::create_directories(entry.parent_path(), ec);
+
+    // 临时文件名带随机前缀，多个进程共享缓存目录时不冲突
+    static const uint64_t processToken = std::random_device{}();
+    fs::path temp = fs::path(directory_) /
+        ("tmp-" + std::to_string(processToken) + "-" + std::to_string(tempCounter_++));
+
+    bool copied = cloneFile(outputPath, temp.string());
+    if (!copied) {
+        ec.clear();
+        fs::copy_file(outputPath, temp, fs::copy_options::overwrite_existing, ec);
+        copied = !ec;
+    }
+    if (!copied) {
+        fs::remove(temp, ec);
+        return;
+    }
+
+    uint64_t size = fs::file_size(temp, ec);
+    fs::rename(temp, entry, ec);
+    if (ec) {
+        fs::remove(temp, ec);
+        return;
+    }
+
+    stores_++;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        totalBytes_ += size;
+    }
+    evictIfNeeded();
+}
+
+void ConversionCache::evictIfNeeded() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (maxBytes_ == 0 || totalBytes_ <= maxBytes_) {
+        return;
+    }
+
+    struct Entry {
+        fs::file_time_type mtime;
+        uint64_t size;
+        fs::path path;
+    };
+    std::vector<Entry> entries;
+    uint64_t total = 0;
+    std::error_code ec;
+    for (auto it = fs::recursive_directory_iterator(directory_, ec); !ec && it != fs::recursive_directory_iterator();
+         it.increment(ec)) {
+        if (!it->is_regular_file(ec) || it->path().extension() != ".glb") {
+            continue;
+        }
+        Entry e{it->last_write_time(ec), it->file_size(ec), it->path()};
+        total += e.size;
+        entries.push_back(std::move(e));
+    }
+
+    // 降到上限的 90%，避免每次写入都触发一次全目录扫描
+    uint64_t target = maxBytes_ / 10 * 9;
+    std::sort(entries.begin(), entries.end(),
+              [](const Entry& a, const Entry& b) { return a.mtime < b.mtime; });
+    for (const auto& e : entries) {
+        if (total <= target) break;
+        if (fs::remove(e.path, ec)) {
+            total -= e.size;
+            evictions_++;
+        }
+    }
+    totalBytes_ = total;
+}
+
+CacheStats ConversionCache::stats() const {
+    return {hits_.load(), misses_.load(), stores_.load(), evictions_.load()};
+}
+
+}  // namespace spz2glb
+
+#endif  // __EMSCRIPTEN__
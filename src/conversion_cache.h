@@ -0,0 +1,88 @@
+// Copyright (c) 2026 Pu Junhan
+// SPDX-License-Identifier: MIT
+// Project: SPZ-ecosystem
+// Repository: https://github.com/spz-ecosystem/spz2glb
+//
+// 内容寻址转换缓存
+// 以 (输入字节, 转换选项) 的哈希为键缓存 GLB，命中时通过 reflink / 拷贝产出输出文件
+
+#ifndef SPZ2GLB_CONVERSION_CACHE_H_
+#define SPZ2GLB_CONVERSION_CACHE_H_
+
+#ifndef __EMSCRIPTEN__
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <span>
+#include <string>
+
+namespace spz2glb {
+
+struct ConvertOptions;
+
+/**
+ * XXH64 哈希（小端读取），用于缓存键
+ */
+uint64_t hashBytes(std::span<const uint8_t> data, uint64_t seed = 0);
+
+struct CacheStats {
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t stores;
+    uint64_t evictions;
+};
+
+/**
+ * 磁盘转换缓存（线程安全；多个进程可共享同一目录）
+ *
+ * 目录结构：<dir>/<前两位>/<16 位哈希>-<输入字节数>.glb
+ * - 写入先落到临时文件再 rename，其他进程不会看到半个条目
+ * - 命中时按 reflink（FICLONE）→ 拷贝的顺序产出输出文件，
+ *   并刷新条目的 mtime 作为 LRU 时间戳；输出从不与条目共享 inode，可以随意改写
+ * - 总大小超过上限时按 mtime 从旧到新淘汰，直到降到上限的 90%
+ */
+class ConversionCache {
+public:
+    ConversionCache() = default;
+
+    ConversionCache(const ConversionCache&) = delete;
+    ConversionCache& operator=(const ConversionCache&) = delete;
+
+    // 创建（如需要）缓存目录并统计现有条目大小
+    bool open(const std::string& directory, uint64_t maxBytes, std::string& error);
+
+    // 输入内容 + 影响输出的选项 → 缓存键
+    static std::string keyFor(std::span<const uint8_t> input, const ConvertOptions& options);
+
+    // 命中时把缓存条目产出到 outputPath，返回 true；outputBytes 为 GLB 大小
+    bool fetch(const std::string& key, const std::string& outputPath, uint64_t& outputBytes);
+
+    // 把刚生成的 outputPath 存入缓存（失败只影响缓存，不影响转换结果）
+    void store(const std::string& key, const std::string& outputPath);
+
+    CacheStats stats() const;
+
+private:
+    std::string entryPath(const std::string& key) const;
+    void evictIfNeeded();
+
+    std::string directory_;
+    uint64_t maxBytes_ = 0;
+
+    std::mutex mutex_;          // 保护 totalBytes_ 与淘汰过程
+    uint64_t totalBytes_ = 0;   // 本进程视角的缓存总大小（淘汰时重新扫描校正）
+    std::atomic<uint64_t> tempCounter_{0};
+
+    std::atomic<uint64_t> hits_{0};
+    std::atomic<uint64_t> misses_{0};
+    std::atomic<uint64_t> stores_{0};
+    std::atomic<uint64_t> evictions_{0};
+};
+
+}  // namespace spz2glb
+
+#endif  // __EMSCRIPTEN__
+
+#endif  // SPZ2GLB_CONVERSION_CACHE_H_
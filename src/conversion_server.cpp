@@ -0,0 +1,571 @@
+// Copyright (c) 2026 Pu Junhan
+// SPDX-License-Identifier: MIT
+// Project: SPZ-ecosystem
+// Repository: https://github.com/spz-ecosystem/spz2glb
+//
+// 常驻转换服务实现
+
+#include "conversion_server.h"
+
+#ifndef _WIN32
+
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "attribute_glb.h"
+#include "conversion_cache.h"
+#include "glb_writer.h"
+#include "splat_lod.h"
+#include "spz_converter.h"
+#include "thread_pool.h"
+#include "tiled_glb.h"
+
+namespace spz2glb {
+
+namespace {
+
+constexpr size_t kMaxFdsPerMessage = 8;
+constexpr size_t kMaxLineLength = 64 * 1024;
+constexpr size_t kLatencyWindow = 4096;  // 分位数基于最近的这么多个请求
+
+volatile std::sig_atomic_t g_stopRequested = 0;
+
+void onStopSignal(int) {
+    g_stopRequested = 1;
+}
+
+/**
+ * 请求计数与延迟统计（环形窗口）
+ */
+class ServerStats {
+public:
+    void record(uint64_t micros, bool success) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        requests_++;
+        if (!success) failed_++;
+        maxMicros_ = std::max(maxMicros_, micros);
+        if (latencies_.size() < kLatencyWindow) {
+            latencies_.push_back(micros);
+        } else {
+            latencies_[next_] = micros;
+        }
+        next_ = (next_ + 1) % kLatencyWindow;
+    }
+
+    std::string summary() {
+        std::vector<uint64_t> sorted;
+        uint64_t maxMicros;
+        std::ostringstream out;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            sorted = latencies_;
+            maxMicros = maxMicros_;
+            out << "requests=" << requests_ << " failed=" << failed_;
+        }
+        std::sort(sorted.begin(), sorted.end());
+        auto percentile = [&](double p) -> uint64_t {
+            if (sorted.empty()) return 0;
+            return sorted[std::min(sorted.size() - 1, static_cast<size_t>(p * static_cast<double>(sorted.size())))];
+        };
+        out << " p50_us=" << percentile(0.50) << " p99_us=" << percentile(0.99)
+            << " max_us=" << maxMicros;
+        return out.str();
+    }
+
+private:
+    std::mutex mutex_;
+    uint64_t requests_ = 0;
+    uint64_t failed_ = 0;
+    uint64_t maxMicros_ = 0;
+    std::vector<uint64_t> latencies_;
+    size_t next_ = 0;
+};
+
+/**
+ * 每个工作线程复用的输入映射：非普通文件 fd 读入的缓冲区在请求之间保留，
+ * 常驻进程处理完前几个请求后不再为输入分配内存
+ */
+thread_local MappedFile t_input;
+
+/**
+ * 一个客户端连接：主线程非阻塞地收取字节与随消息到达的 SCM_RIGHTS fd，切出完整的请求行
+ *
+ * 同一时刻每个连接最多一个请求在线程池中处理（busy），期间主线程不再读取它，
+ * 工作线程独占地取 fd、发送响应
+ *
+ * fd 按到达时所在的字节位置归属到请求行：只有随本行一起发送的 fd 才能被 takeFd 取到，
+ * 随其他命令（PING、STATS、CONVERT）到达或 CONVERT_FD 多余的 fd 在请求处理完后关闭，
+ * 不会被下一个 CONVERT_FD 误用
+ */
+class Connection {
+public:
+    explicit Connection(int fd) : lastActive(std::chrono::steady_clock::now()), fd_(fd) {}
+    ~Connection() {
+        for (const auto& pending : fds_) ::close(pending.fd);
+        closeLineFds();
+        ::close(fd_);
+    }
+
+    bool fill();
+    bool nextLine(std::string& line);
+    bool takeFd(int& fd);
+    void closeLineFds();
+    bool send(const std::string& response);
+
+    int fd() const { return fd_; }
+
+    bool busy = false;
+    bool eof = false;  // 对端已关闭写端：处理完缓冲区中的请求后关闭连接
+    std::chrono::steady_clock::time_point lastActive;
+
+private:
+    struct PendingFd {
+        uint64_t offset;  // 随之到达的数据在字节流中的位置
+        int fd;
+    };
+
+    int fd_;
+    std::string buffer_;
+    uint64_t received_ = 0;  // 已收到的字节数
+    uint64_t consumed_ = 0;  // 已切出的请求行字节数（含换行）
+    std::deque<PendingFd> fds_;
+    std::deque<int> lineFds_;  // 当前请求行携带的 fd
+};
+
+// 读一次套接字（不阻塞）；出错或一行超长时返回 false，对端关闭时置 eof
+bool Connection::fill() {
+    char data[4096];
+    alignas(struct cmsghdr) char control[CMSG_SPACE(sizeof(int) * kMaxFdsPerMessage)];
+    struct iovec iov = {data, sizeof(data)};
+    struct msghdr msg;
+    std::memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+
+    int flags = MSG_DONTWAIT;
+#ifdef MSG_CMSG_CLOEXEC
+    flags |= MSG_CMSG_CLOEXEC;
+#endif
+    ssize_t n;
+    do {
+        n = ::recvmsg(fd_, &msg, flags);
+    } while (n < 0 && errno == EINTR);
+    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return true;
+    if (n < 0) return false;
+    if (n == 0) {
+        eof = true;
+        return true;
+    }
+
+    // 流套接字上带 fd 的消息是一次 recvmsg 读到的最后一段，本次读到的末字节一定属于它
+    const uint64_t offset = received_ + static_cast<uint64_t>(n) - 1;
+    for (struct cmsghdr* c = CMSG_FIRSTHDR(&msg); c != nullptr; c = CMSG_NXTHDR(&msg, c)) {
+        if (c->cmsg_level != SOL_SOCKET || c->cmsg_type != SCM_RIGHTS) continue;
+        size_t count = (c->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+        for (size_t i = 0; i < count; ++i) {
+            int fd;
+            std::memcpy(&fd, CMSG_DATA(c) + i * sizeof(int), sizeof(int));
+            fds_.push_back({offset, fd});
+        }
+    }
+    buffer_.append(data, static_cast<size_t>(n));
+    received_ += static_cast<uint64_t>(n);
+    lastActive = std::chrono::steady_clock::now();
+    return buffer_.size() <= kMaxLineLength || buffer_.find('\n') != std::string::npos;
+}
+
+bool Connection::nextLine(std::string& line) {
+    size_t newline = buffer_.find('\n');
+    if (newline == std::string::npos) {
+        return false;
+    }
+    line.assign(buffer_, 0, newline);
+    buffer_.erase(0, newline + 1);
+    if (!line.empty() && line.back() == '\r') line.pop_back();
+
+    // 上一行没有取走的 fd（例如跳过的空行）先关闭，再认领随本行到达的 fd
+    closeLineFds();
+    const uint64_t lineEnd = consumed_ + newline;
+    consumed_ += newline + 1;
+    while (!fds_.empty() && fds_.front().offset <= lineEnd) {
+        lineFds_.push_back(fds_.front().fd);
+        fds_.pop_front();
+    }
+    return true;
+}
+
+bool Connection::takeFd(int& fd) {
+    if (lineFds_.empty()) return false;
+    fd = lineFds_.front();
+    lineFds_.pop_front();
+    return true;
+}
+
+void Connection::closeLineFds() {
+    for (int fd : lineFds_) ::close(fd);
+    lineFds_.clear();
+}
+
+bool Connection::send(const std::string& response) {
+    size_t sent = 0;
+    while (sent < response.size()) {
+#ifdef MSG_NOSIGNAL
+        ssize_t n = ::send(fd_, response.data() + sent, response.size() - sent, MSG_NOSIGNAL);
+#else
+        ssize_t n = ::send(fd_, response.data() + sent, response.size() - sent, 0);
+#endif
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        sent += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+std::vector<std::string> splitTabs(const std::string& line) {
+    std::vector<std::string> fields;
+    size_t start = 0;
+    for (;;) {
+        size_t tab = line.find('\t', start);
+        fields.push_back(line.substr(start, tab - start));
+        if (tab == std::string::npos) break;
+        start = tab + 1;
+    }
+    return fields;
+}
+
+// 按 fd 转换：输入可以是普通文件（mmap + copy_file_range）或管道
+SpzResult convertFds(int inputFd, int outputFd, GlbLayout& layout, const ConvertOptions& options) {
+    if (!t_input.adopt(inputFd)) {
+        return SpzResult::error(SpzErrorCode::CannotOpenSpzFile, "Cannot read input fd");
+    }
+    bool written = false;
+    SpzResult preamble;
+    if (options.mode == OutputMode::Attributes) {
+        AttributeGlb attributes;
+        preamble = buildAttributeGlb(t_input.bytes(), attributes, options);
+        layout = attributes.layout;
+        written = preamble.success &&
+                  writeGlbSegmentsToFd(outputFd, attributes.preamble, attributes.segments, layout);
+    } else if (options.tilePoints > 0) {
+        // 只有输出 fd、没有路径，分块清单（--tileset）不写
+        TiledGlb tiled;
+        preamble = buildTiledGlb(t_input.bytes(), tiled, options);
+        layout = tiled.layout;
+        written = preamble.success && writeGlbSegmentsToFd(outputFd, tiled.preamble, tiled.segments, layout);
+    } else if (options.lodLevels > 0) {
+        LodGlb lod;
+        preamble = buildLodGlb(t_input.bytes(), lod, options);
+        layout = lod.layout;
+        written = preamble.success && writeGlbSegmentsToFd(outputFd, lod.preamble, lod.segments, layout);
+    } else if (options.reencodesPayload()) {
+        std::vector<uint8_t> repacked;
+        std::string extras;
+        preamble = reencodeSpzPayload(t_input.bytes(), options, repacked, extras);
+        if (preamble.success) {
+            preamble = buildGlbPreamble(repacked, layout, options, extras);
+        }
+        std::span<const uint8_t> segment(repacked);
+        written = preamble.success &&
+                  writeGlbSegmentsToFd(outputFd, preamble.data, std::span(&segment, 1), layout);
+    } else {
+        preamble = buildGlbPreamble(t_input.bytes(), layout, options);
+        written = preamble.success && writeGlbToFd(outputFd, preamble.data, t_input, layout);
+    }
+    t_input.close();
+
+    if (!preamble.success) {
+        return preamble;
+    }
+    if (!written) {
+        return SpzResult::error(SpzErrorCode::CannotOpenOutputFile, "Failed to write GLB to output fd");
+    }
+    return SpzResult::ok({});
+}
+
+class Server {
+public:
+    explicit Server(const ServerOptions& options) : options_(options) {}
+
+    int run();
+
+private:
+    void dispatch(Connection& connection, ThreadPool& pool);
+    std::string handleRequest(Connection& connection, const std::string& line);
+
+    ServerOptions options_;
+    ServerStats stats_;
+    std::mutex logMutex_;
+
+    int wakeFds_[2] = {-1, -1};  // 工作线程处理完请求后写入连接 fd（发送失败时写 ~fd），唤醒主线程的 poll
+};
+
+std::string Server::handleRequest(Connection& connection, const std::string& line) {
+    auto fields = splitTabs(line);
+    const std::string& command = fields[0];
+
+    if (command == "PING") {
+        return "OK\n";
+    }
+    if (command == "STATS") {
+        std::string summary = stats_.summary();
+        if (options_.convert.cache != nullptr) {
+            auto cacheStats = options_.convert.cache->stats();
+            summary += " cache_hits=" + std::to_string(cacheStats.hits) +
+                       " cache_misses=" + std::to_string(cacheStats.misses);
+        }
+        return "OK " + summary + "\n";
+    }
+    if (command != "CONVERT" && command != "CONVERT_FD") {
+        return "ERR 0 Unknown command: " + command + "\n";
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    // 并发来自多个连接，单个请求内不再并行解码
+    ConvertOptions convertOptions = options_.convert;
+    convertOptions.verbose = false;
+    convertOptions.cache = nullptr;
+    convertOptions.pool = nullptr;
+    GlbLayout layout = {};
+    SpzResult result = SpzResult::ok({});
+    std::string source;
+    std::string target;
+
+    if (command == "CONVERT") {
+        if (fields.size() != 3 || fields[1].empty() || fields[2].empty()) {
+            result = SpzResult::error(SpzErrorCode::CannotOpenSpzFile, "Usage: CONVERT\\t<input>\\t<output>");
+        } else {
+            source = fields[1];
+            target = fields[2];
+            convertOptions.cache = options_.convert.cache;
+            result = convertSpzFile(source, target, layout, convertOptions);
+        }
+    } else {
+        int inputFd = -1;
+        int outputFd = -1;
+        if (!connection.takeFd(inputFd) || !connection.takeFd(outputFd)) {
+            if (inputFd >= 0) ::close(inputFd);
+            result = SpzResult::error(SpzErrorCode::CannotOpenSpzFile,
+                "CONVERT_FD requires two file descriptors (input, output)");
+        } else {
+            source = "fd:" + std::to_string(inputFd);
+            target = "fd:" + std::to_string(outputFd);
+            result = convertFds(inputFd, outputFd, layout, convertOptions);
+            ::close(outputFd);
+        }
+    }
+
+    uint64_t micros = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count());
+    stats_.record(micros, result.success);
+
+    {
+        std::lock_guard<std::mutex> lock(logMutex_);
+        if (result.success) {
+            std::cout << "[OK] " << source << " -> " << target << " ("
+                      << std::fixed << std::setprecision(2) << layout.totalLength / (1024.0 * 1024.0) << " MB, "
+                      << std::setprecision(3) << micros / 1000.0 << " ms)" << std::endl;
+        } else {
+            std::cout << "[FAIL] " << (source.empty() ? command : source) << ": "
+                      << result.errorMessage << std::endl;
+        }
+    }
+
+    if (!result.success) {
+        return "ERR " + std::to_string(micros) + " " + result.errorMessage + "\n";
+    }
+    return "OK " + std::to_string(layout.totalLength) + " " + std::to_string(micros) + "\n";
+}
+
+// 取出一个完整的请求交给线程池
+void Server::dispatch(Connection& connection, ThreadPool& pool) {
+    std::string line;
+    while (connection.nextLine(line)) {
+        if (line.empty()) continue;
+        connection.busy = true;
+        Connection* target = &connection;
+        pool.submit([this, target, line = std::move(line)] {
+            std::string response = handleRequest(*target, line);
+            target->closeLineFds();
+            bool sent = target->send(response);
+            int message = sent ? target->fd() : ~target->fd();
+            while (::write(wakeFds_[1], &message, sizeof(message)) < 0 && errno == EINTR) {}
+        });
+        return;
+    }
+}
+
+int Server::run() {
+    struct sockaddr_un addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (options_.socketPath.empty() || options_.socketPath.size() >= sizeof(addr.sun_path)) {
+        std::cerr << "[ERROR] Invalid socket path: " << options_.socketPath << std::endl;
+        return 1;
+    }
+    std::memcpy(addr.sun_path, options_.socketPath.c_str(), options_.socketPath.size());
+
+    // 上次异常退出留下的套接字文件
+    struct stat st;
+    if (::lstat(options_.socketPath.c_str(), &st) == 0 && S_ISSOCK(st.st_mode)) {
+        ::unlink(options_.socketPath.c_str());
+    }
+
+    int listenFd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenFd < 0 ||
+        ::bind(listenFd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        ::listen(listenFd, SOMAXCONN) != 0) {
+        std::cerr << "[ERROR] Cannot listen on " << options_.socketPath << ": " << std::strerror(errno) << std::endl;
+        if (listenFd >= 0) ::close(listenFd);
+        return 1;
+    }
+    ::fcntl(listenFd, F_SETFD, FD_CLOEXEC);
+
+    // 工作线程继承屏蔽的信号掩码，SIGINT / SIGTERM 只会打断主线程的 poll
+    sigset_t stopSignals;
+    sigemptyset(&stopSignals);
+    sigaddset(&stopSignals, SIGINT);
+    sigaddset(&stopSignals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &stopSignals, nullptr);
+
+    if (::pipe(wakeFds_) != 0) {
+        std::cerr << "[ERROR] Cannot create wake-up pipe: " << std::strerror(errno) << std::endl;
+        ::close(listenFd);
+        return 1;
+    }
+    for (int fd : wakeFds_) ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+    ::fcntl(wakeFds_[0], F_SETFL, O_NONBLOCK);
+
+    {
+        size_t threads = options_.jobs != 0 ? options_.jobs : std::thread::hardware_concurrency();
+        ThreadPool pool(std::max<size_t>(1, threads));
+        std::map<int, std::unique_ptr<Connection>> connections;
+
+        struct sigaction action;
+        std::memset(&action, 0, sizeof(action));
+        action.sa_handler = onStopSignal;  // 不设 SA_RESTART，poll 返回 EINTR
+        sigaction(SIGINT, &action, nullptr);
+        sigaction(SIGTERM, &action, nullptr);
+        std::signal(SIGPIPE, SIG_IGN);
+        pthread_sigmask(SIG_UNBLOCK, &stopSignals, nullptr);
+
+        std::cout << "[INFO] Serving on " << options_.socketPath << " with " << pool.size() << " threads" << std::endl;
+
+        // 主线程 poll 监听套接字、唤醒管道与所有空闲连接；线程池只处理单个请求，不被空闲连接占住
+        const auto idleTimeout = std::chrono::seconds(options_.idleTimeoutSeconds);
+        std::vector<struct pollfd> polled;
+        while (!g_stopRequested) {
+            polled.clear();
+            polled.push_back({listenFd, POLLIN, 0});
+            polled.push_back({wakeFds_[0], POLLIN, 0});
+            for (const auto& [fd, connection] : connections) {
+                if (!connection->busy && !connection->eof) polled.push_back({fd, POLLIN, 0});
+            }
+            int timeoutMs = options_.idleTimeoutSeconds > 0 ? 1000 : -1;
+            if (::poll(polled.data(), polled.size(), timeoutMs) < 0) {
+                if (errno == EINTR) continue;
+                std::cerr << "[ERROR] poll failed: " << std::strerror(errno) << std::endl;
+                break;
+            }
+
+            // 新到的字节：切出完整请求提交给线程池
+            for (size_t i = 2; i < polled.size(); ++i) {
+                if (polled[i].revents == 0) continue;
+                auto it = connections.find(polled[i].fd);
+                bool open = it->second->fill();
+                if (open) dispatch(*it->second, pool);
+                if (!open || (it->second->eof && !it->second->busy)) {
+                    connections.erase(it);
+                }
+            }
+
+            // 处理完的请求：连接重新参与 poll，缓冲区中已有的下一行立即提交
+            if (polled[1].revents != 0) {
+                int message;
+                while (::read(wakeFds_[0], &message, sizeof(message)) == sizeof(message)) {
+                    auto it = connections.find(message >= 0 ? message : ~message);
+                    if (it == connections.end()) continue;
+                    it->second->busy = false;
+                    it->second->lastActive = std::chrono::steady_clock::now();
+                    if (message >= 0) dispatch(*it->second, pool);
+                    if (message < 0 || (it->second->eof && !it->second->busy)) {
+                        connections.erase(it);
+                    }
+                }
+            }
+
+            if (polled[0].revents != 0) {
+                int fd = ::accept(listenFd, nullptr, nullptr);
+                if (fd < 0) {
+                    if (errno != EINTR && errno != ECONNABORTED && errno != EAGAIN) {
+                        std::cerr << "[ERROR] accept failed: " << std::strerror(errno) << std::endl;
+                        break;
+                    }
+                } else {
+                    ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+                    if (options_.idleTimeoutSeconds > 0) {
+                        // 客户端不读响应时，工作线程的 send 最多阻塞这么久
+                        struct timeval sendTimeout = {static_cast<time_t>(options_.idleTimeoutSeconds), 0};
+                        ::setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &sendTimeout, sizeof(sendTimeout));
+                    }
+                    connections.emplace(fd, std::make_unique<Connection>(fd));
+                }
+            }
+
+            // 关闭空闲超时的连接（处理中的请求不计入空闲时间）
+            if (options_.idleTimeoutSeconds > 0) {
+                auto now = std::chrono::steady_clock::now();
+                for (auto it = connections.begin(); it != connections.end();) {
+                    if (!it->second->busy && now - it->second->lastActive > idleTimeout) {
+                        it = connections.erase(it);
+                    } else {
+                        ++it;
+                    }
+                }
+            }
+        }
+
+        // 停止：不再接受连接，等待进行中的请求完成后关闭所有连接
+        ::close(listenFd);
+        ::unlink(options_.socketPath.c_str());
+        pool.wait();
+    }
+    ::close(wakeFds_[0]);
+    ::close(wakeFds_[1]);
+
+    std::cout << "[INFO] Server stopped: " << stats_.summary() << std::endl;
+    return 0;
+}
+
+}  // anonymous namespace
+
+int runServer(const ServerOptions& options) {
+    Server server(options);
+    return server.run();
+}
+
+}  // namespace spz2glb
+
+#endif  // _WIN32
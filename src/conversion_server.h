@@ -0,0 +1,55 @@
+// Copyright (c) 2026 Pu Junhan
+// SPDX-License-Identifier: MIT
+// Project: SPZ-ecosystem
+// Repository: https://github.com/spz-ecosystem/spz2glb
+//
+// 常驻转换服务（spz2glb --serve）
+// 通过 Unix 域套接字接收转换请求，省去每次调用的 fork/exec、动态链接与冷页缺失
+
+#ifndef SPZ2GLB_CONVERSION_SERVER_H_
+#define SPZ2GLB_CONVERSION_SERVER_H_
+
+#ifndef _WIN32
+
+#include <cstddef>
+#include <string>
+
+#include "spz_converter.h"
+
+namespace spz2glb {
+
+struct ServerOptions {
+    std::string socketPath;
+    size_t jobs = 0;  // 工作线程数（即同时处理的请求数），0 表示使用全部 CPU
+    unsigned idleTimeoutSeconds = 300;  // 连接空闲超过该时长即关闭，0 表示不超时
+    ConvertOptions convert;  // 每个请求的转换选项；convert.cache 只用于 CONVERT（CONVERT_FD 的输出无法链接）
+};
+
+/**
+ * 运行转换服务，直到收到 SIGINT / SIGTERM
+ *
+ * 协议：每个请求一行（\n 结尾），每个请求对应一行响应，一个连接上可连续发送多个请求
+ *
+ * 主线程用 poll 等待所有连接，只把读到的完整请求行交给线程池，空闲连接不占用工作线程；
+ * 同一连接上的请求按顺序逐个处理
+ *
+ *   CONVERT\t<input.spz>\t<output.glb>   按路径转换
+ *   CONVERT_FD                           按 fd 转换：随该行用 SCM_RIGHTS 传入两个 fd（输入、输出），
+ *                                        输出从 fd 的当前位置开始写
+ *   STATS                                请求数、失败数与延迟分位数
+ *   PING
+ *
+ * 响应：
+ *   OK <glb 字节数> <延迟 us>
+ *   ERR <延迟 us> <错误信息>
+ *   OK requests=<n> failed=<n> p50_us=<n> p99_us=<n> max_us=<n> [cache_hits=<n> cache_misses=<n>]   （STATS）
+ *
+ * @return 进程退出码
+ */
+int runServer(const ServerOptions& options);
+
+}  // namespace spz2glb
+
+#endif  // _WIN32
+
+#endif  // SPZ2GLB_CONVERSION_SERVER_H_
@@ -0,0 +1,186 @@
+// Copyright (c) 2026 Pu Junhan
+// SPDX-License-Identifier: MIT
+// Project: SPZ-ecosystem
+// Repository: https://github.com/spz-ecosystem/spz2glb
+//
+// deflate 编解码器实现与注册表
+
+#include "deflate_codec.h"
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+
+#include <zlib.h>
+
+#if SPZ2GLB_BUILTIN_INFLATE
+#include "builtin_inflate.h"
+#endif
+
+// 编译期默认编解码器（CMake 选项 SPZ2GLB_DEFAULT_CODEC）
+#ifndef SPZ2GLB_DEFAULT_CODEC
+#define SPZ2GLB_DEFAULT_CODEC "zlib"
+#endif
+
+namespace spz2glb {
+
+namespace {
+
+// zlib 压缩一段数据；ZlibCodec 与 BuiltinCodec 共用
+// history 非空时以其最后 32 KB 为预置字典，非最后一段以 sync flush 结束（之后的段仍可引用本段）；
+// 否则非最后一段以 full flush 结束
+bool zlibDeflateRaw(std::span<const uint8_t> history, std::span<const uint8_t> input, int level, bool last,
+                    std::vector<uint8_t>& out, std::string& error) {
+    if (input.size() > UINT_MAX / 2) {
+        error = "Deflate input too large";
+        return false;
+    }
+    z_stream strm = {};
+    if (deflateInit2(&strm, level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        error = "Failed to initialize zlib compression";
+        return false;
+    }
+    if (!history.empty()) {
+        auto window = history.last(std::min<size_t>(history.size(), size_t{1} << MAX_WBITS));
+        deflateSetDictionary(&strm, window.data(), static_cast<uInt>(window.size()));
+    }
+    // deflateBound 按 Z_FINISH 估算，Z_FULL_FLUSH / Z_SYNC_FLUSH 额外有一个空的存储块（5 字节）
+    size_t begin = out.size();
+    out.resize(begin + deflateBound(&strm, static_cast<uLong>(input.size())) + 16);
+    strm.next_in = const_cast<Bytef*>(input.data());
+    strm.avail_in = static_cast<uInt>(input.size());
+    strm.next_out = out.data() + begin;
+    strm.avail_out = static_cast<uInt>(out.size() - begin);
+    int ret = deflate(&strm, last ? Z_FINISH : (history.empty() ? Z_FULL_FLUSH : Z_SYNC_FLUSH));
+    bool ok = last ? ret == Z_STREAM_END : (ret == Z_OK && strm.avail_in == 0 && strm.avail_out > 0);
+    out.resize(out.size() - strm.avail_out);
+    deflateEnd(&strm);
+    if (!ok) {
+        error = "Failed to compress block";
+    }
+    return ok;
+}
+
+class ZlibCodec : public DeflateCodec {
+public:
+    const char* name() const override { return "zlib"; }
+
+    /**
+     * 流式解压：先按 10 倍压缩率分配，输出满了就扩容 2 倍继续
+     */
+    bool gunzip(std::span<const uint8_t> compressed, std::vector<uint8_t>& out,
+                std::string& error) const override {
+        out.resize(compressed.size() * 10);
+
+        z_stream strm = {};
+        strm.next_in = const_cast<uint8_t*>(compressed.data());
+        strm.avail_in = static_cast<uInt>(compressed.size());
+        strm.next_out = out.data();
+        strm.avail_out = static_cast<uInt>(out.size());
+
+        // 16 + MAX_WBITS 表示使用 gzip 格式（而不是 zlib）
+        if (inflateInit2(&strm, 16 + MAX_WBITS) != Z_OK) {
+            error = "Failed to initialize zlib decompression";
+            return false;
+        }
+
+        int ret;
+        do {
+            if (strm.avail_out == 0) {
+                size_t oldSize = out.size();
+                out.resize(oldSize * 2);
+                strm.next_out = out.data() + oldSize;
+                strm.avail_out = static_cast<uInt>(oldSize);
+            }
+            ret = inflate(&strm, Z_NO_FLUSH);
+        } while (ret == Z_OK);
+
+        out.resize(strm.total_out);
+        inflateEnd(&strm);
+        if (ret != Z_STREAM_END) {
+            error = "Failed to decompress SPZ file";
+            return false;
+        }
+        return true;
+    }
+
+    bool deflateRaw(std::span<const uint8_t> input, int level, bool last, std::vector<uint8_t>& out,
+                    std::string& error) const override {
+        return zlibDeflateRaw({}, input, level, last, out, error);
+    }
+
+    bool deflateRawContinued(std::span<const uint8_t> history, std::span<const uint8_t> input, int level,
+                             bool last, std::vector<uint8_t>& out, std::string& error) const override {
+        return zlibDeflateRaw(history, input, level, last, out, error);
+    }
+};
+
+#if SPZ2GLB_BUILTIN_INFLATE
+class BuiltinCodec : public DeflateCodec {
+public:
+    const char* name() const override { return "builtin"; }
+
+    bool gunzip(std::span<const uint8_t> compressed, std::vector<uint8_t>& out,
+                std::string& error) const override {
+        return builtinGunzip(compressed, out, error);
+    }
+
+    bool deflateRaw(std::span<const uint8_t> input, int level, bool last, std::vector<uint8_t>& out,
+                    std::string& error) const override {
+        return zlibDeflateRaw({}, input, level, last, out, error);
+    }
+
+    bool deflateRawContinued(std::span<const uint8_t> history, std::span<const uint8_t> input, int level,
+                             bool last, std::vector<uint8_t>& out, std::string& error) const override {
+        return zlibDeflateRaw(history, input, level, last, out, error);
+    }
+};
+#endif
+
+std::atomic<const DeflateCodec*> g_activeCodec{nullptr};
+
+}  // anonymous namespace
+
+const DeflateCodec& zlibCodec() {
+    static const ZlibCodec codec;
+    return codec;
+}
+
+#if SPZ2GLB_BUILTIN_INFLATE
+const DeflateCodec& builtinCodec() {
+    static const BuiltinCodec codec;
+    return codec;
+}
+#endif
+
+std::vector<const DeflateCodec*> availableCodecs() {
+    std::vector<const DeflateCodec*> codecs = {&zlibCodec()};
+#if SPZ2GLB_BUILTIN_INFLATE
+    codecs.push_back(&builtinCodec());
+#endif
+    for (size_t i = 1; i < codecs.size(); ++i) {
+        if (std::string_view(codecs[i]->name()) == SPZ2GLB_DEFAULT_CODEC) {
+            std::swap(codecs[0], codecs[i]);
+        }
+    }
+    return codecs;
+}
+
+const DeflateCodec* findCodec(std::string_view name) {
+    for (const DeflateCodec* codec : availableCodecs()) {
+        if (name == codec->name()) return codec;
+    }
+    return nullptr;
+}
+
+const DeflateCodec& activeCodec() {
+    static const DeflateCodec* const defaultCodec = availableCodecs().front();
+    const DeflateCodec* codec = g_activeCodec.load(std::memory_order_acquire);
+    return codec != nullptr ? *codec : *defaultCodec;
+}
+
+void setActiveCodec(const DeflateCodec& codec) {
+    g_activeCodec.store(&codec, std::memory_order_release);
+}
+
+}  // namespace spz2glb
@@ -0,0 +1,83 @@
+// Copyright (c) 2026 Pu Junhan
+// SPDX-License-Identifier: MIT
+// Project: SPZ-ecosystem
+// Repository: https://github.com/spz-ecosystem/spz2glb
+//
+// 可替换的 deflate 编解码器
+// 整个 SPZ gzip 流的解压（decompressSpzData）与分段压缩（--repack、重新压缩负载）都经过这里，
+// 默认实现在编译期选择（SPZ2GLB_DEFAULT_CODEC），运行时可用 --codec 切换
+
+#ifndef SPZ2GLB_DEFLATE_CODEC_H_
+#define SPZ2GLB_DEFLATE_CODEC_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace spz2glb {
+
+/**
+ * deflate 编解码器接口
+ *
+ * 实现必须是无状态的，可以在多个线程上同时调用
+ */
+class DeflateCodec {
+public:
+    virtual ~DeflateCodec() = default;
+
+    virtual const char* name() const = 0;
+
+    /**
+     * 解压单成员 gzip 流（遇到第一个成员结尾即停止，之后的数据忽略）
+     *
+     * @param compressed 完整的 gzip 流
+     * @param out 输出，调整为解压后的实际大小
+     */
+    virtual bool gunzip(std::span<const uint8_t> compressed, std::vector<uint8_t>& out,
+                        std::string& error) const = 0;
+
+    /**
+     * 把一段数据压缩为 raw deflate，追加到 out
+     *
+     * @param level zlib 压缩级别（Z_DEFAULT_COMPRESSION 或 1~9）
+     * @param last true 时以最终块结束（Z_FINISH）；false 时以 full flush 结束：
+     *             字节对齐，且之后的数据不会引用这一段（--repack 的块边界）
+     */
+    virtual bool deflateRaw(std::span<const uint8_t> input, int level, bool last, std::vector<uint8_t>& out,
+                            std::string& error) const = 0;
+
+    /**
+     * 同 deflateRaw，但以 history（input 之前的数据）的最后 32 KB 为预置字典，可以引用之前的数据；
+     * last 为 false 时以 sync flush 结束：字节对齐，之后的段可以继续引用这一段。
+     * 各段按顺序拼接即为一条连续的 deflate 流，压缩率与整段压缩几乎相同
+     */
+    virtual bool deflateRawContinued(std::span<const uint8_t> history, std::span<const uint8_t> input, int level,
+                                     bool last, std::vector<uint8_t>& out, std::string& error) const = 0;
+};
+
+// zlib 的流式 inflate / deflate
+const DeflateCodec& zlibCodec();
+
+#if SPZ2GLB_BUILTIN_INFLATE
+// 内置整块解压：按 gzip 尾部的 ISIZE 一次分配输出，查表解码 + 宽字节拷贝；压缩仍使用 zlib
+const DeflateCodec& builtinCodec();
+#endif
+
+// 编译进来的全部编解码器，第一个是编译期默认值
+std::vector<const DeflateCodec*> availableCodecs();
+
+// 按名称查找，不存在时返回 nullptr
+const DeflateCodec* findCodec(std::string_view name);
+
+// 当前使用的编解码器；进程启动时为编译期默认值
+const DeflateCodec& activeCodec();
+
+// 切换当前编解码器，应在开始转换之前调用（不与正在进行的转换同步）
+void setActiveCodec(const DeflateCodec& codec);
+
+}  // namespace spz2glb
+
+#endif  // SPZ2GLB_DEFLATE_CODEC_H_
@@ -0,0 +1,163 @@
+// Copyright (c) 2026 Pu Junhan
+// SPDX-License-Identifier: MIT
+// Project: SPZ-ecosystem
+// Repository: https://github.com/spz-ecosystem/spz2glb
+//
+// GLB 到 SPZ 提取实现
+
+#include "glb_extract.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+
+#include <simdjson.h>
+
+#include "glb_writer.h"
+#include "spz_converter.h"
+
+namespace spz2glb {
+
+namespace {
+
+constexpr uint32_t kGlbMagic = 0x46546C67;      // "glTF"
+constexpr uint32_t kJsonChunkType = 0x4E4F534A;  // "JSON"
+constexpr uint32_t kBinChunkType = 0x004E4942;   // "BIN\0"
+
+uint32_t readU32(std::span<const uint8_t> bytes, size_t offset) {
+    uint32_t value;
+    std::memcpy(&value, bytes.data() + offset, 4);
+    return value;
+}
+
+// 可选的非负整数字段，缺省为 0
+bool optionalIndex(simdjson::dom::object object, const char* key, uint64_t& value) {
+    auto error = object[key].get(value);
+    return error == simdjson::SUCCESS || error == simdjson::NO_SUCH_FIELD;
+}
+
+// primitive.extensions.KHR_gaussian_splatting.extensions.KHR_gaussian_splatting_compression_spz_2.bufferView
+bool spzBufferViewIndex(simdjson::dom::object primitive, uint64_t& index) {
+    return primitive.at_pointer("/extensions/KHR_gaussian_splatting/extensions/"
+                                "KHR_gaussian_splatting_compression_spz_2/bufferView").get(index) == simdjson::SUCCESS;
+}
+
+}  // anonymous namespace
+
+bool findSpzBufferViews(std::span<const uint8_t> glb, std::vector<SpzBufferView>& views, std::string& error) {
+    views.clear();
+    if (glb.size() < 20 || readU32(glb, 0) != kGlbMagic || readU32(glb, 4) != 2) {
+        error = "Not a glTF 2.0 binary file";
+        return false;
+    }
+    const uint64_t jsonLength = readU32(glb, 12);
+    if (readU32(glb, 16) != kJsonChunkType || 20 + jsonLength > glb.size()) {
+        error = "Missing or truncated JSON chunk";
+        return false;
+    }
+    // BIN Chunk 可选；没有时 binLength 为 0，任何 bufferView 都会越界
+    const uint64_t binHeader = 20 + jsonLength;
+    uint64_t binData = binHeader + 8;
+    uint64_t binLength = 0;
+    if (binHeader + 8 <= glb.size() && readU32(glb, static_cast<size_t>(binHeader) + 4) == kBinChunkType) {
+        binLength = std::min<uint64_t>(readU32(glb, static_cast<size_t>(binHeader)), glb.size() - binData);
+    }
+
+    // 只复制 JSON Chunk（simdjson 需要尾部填充），BIN 数据不读
+    simdjson::padded_string json(reinterpret_cast<const char*>(glb.data() + 20), static_cast<size_t>(jsonLength));
+    simdjson::dom::parser parser;
+    simdjson::dom::element root;
+    if (parser.parse(json).get(root) != simdjson::SUCCESS) {
+        error = "Invalid glTF JSON";
+        return false;
+    }
+
+    simdjson::dom::array meshes;
+    simdjson::dom::array bufferViews;
+    if (root["meshes"].get(meshes) != simdjson::SUCCESS || root["bufferViews"].get(bufferViews) != simdjson::SUCCESS) {
+        error = "No KHR_gaussian_splatting_compression_spz_2 primitive";
+        return false;
+    }
+
+    size_t meshIndex = 0;
+    for (simdjson::dom::element mesh : meshes) {
+        simdjson::dom::array primitives;
+        if (mesh["primitives"].get(primitives) == simdjson::SUCCESS) {
+            size_t primitiveIndex = 0;
+            for (simdjson::dom::element element : primitives) {
+                simdjson::dom::object primitive;
+                uint64_t index = 0;
+                if (element.get(primitive) == simdjson::SUCCESS && spzBufferViewIndex(primitive, index)) {
+                    bool seen = false;
+                    for (const auto& view : views) {
+                        seen = seen || view.bufferView == index;
+                    }
+                    if (!seen) {
+                        simdjson::dom::object view;
+                        uint64_t buffer = 0;
+                        uint64_t byteOffset = 0;
+                        uint64_t byteLength = 0;
+                        if (bufferViews.at(static_cast<size_t>(index)).get(view) != simdjson::SUCCESS ||
+                            view["byteLength"].get(byteLength) != simdjson::SUCCESS ||
+                            !optionalIndex(view, "buffer", buffer) || !optionalIndex(view, "byteOffset", byteOffset)) {
+                            error = "Invalid bufferView " + std::to_string(index);
+                            return false;
+                        }
+                        if (buffer != 0 || byteOffset > binLength || byteLength > binLength - byteOffset) {
+                            error = "bufferView " + std::to_string(index) + " is outside the GLB BIN chunk";
+                            return false;
+                        }
+                        views.push_back({meshIndex, primitiveIndex, static_cast<size_t>(index),
+                                         binData + byteOffset, byteLength});
+                    }
+                }
+                ++primitiveIndex;
+            }
+        }
+        ++meshIndex;
+    }
+    if (views.empty()) {
+        error = "No KHR_gaussian_splatting_compression_spz_2 primitive";
+        return false;
+    }
+    return true;
+}
+
+std::vector<std::string> extractOutputPaths(const std::string& outputPath, size_t count) {
+    if (count == 1) {
+        return {outputPath};
+    }
+    std::filesystem::path path(outputPath);
+    std::string stem = path.stem().string();
+    std::string extension = path.extension().string();
+    std::vector<std::string> paths;
+    for (size_t i = 0; i < count; ++i) {
+        paths.push_back(path.parent_path().append(stem + "_" + std::to_string(i) + extension).string());
+    }
+    return paths;
+}
+
+SpzResult extractSpzFile(const std::string& glbPath, const std::string& outputPath,
+                         std::vector<ExtractedSpz>& outputs) {
+    outputs.clear();
+    MappedFile glb;
+    if (!glb.open(glbPath)) {
+        return SpzResult::error(SpzErrorCode::CannotOpenSpzFile, "Cannot open GLB file: " + glbPath);
+    }
+    std::vector<SpzBufferView> views;
+    std::string error;
+    if (!findSpzBufferViews(glb.bytes(), views, error)) {
+        return SpzResult::error(SpzErrorCode::ConversionFailed, error + ": " + glbPath);
+    }
+
+    auto paths = extractOutputPaths(outputPath, views.size());
+    for (size_t i = 0; i < views.size(); ++i) {
+        if (!writeFileRange(paths[i], glb, views[i].fileOffset, views[i].length)) {
+            return SpzResult::error(SpzErrorCode::CannotOpenOutputFile, "Failed to write SPZ: " + paths[i]);
+        }
+        outputs.push_back({paths[i], views[i].length});
+    }
+    return SpzResult::ok({});
+}
+
+}  // namespace spz2glb
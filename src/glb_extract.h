@@ -0,0 +1,69 @@
+// Copyright (c) 2026 Pu Junhan
+// SPDX-License-Identifier: MIT
+// Project: SPZ-ecosystem
+// Repository: https://github.com/spz-ecosystem/spz2glb
+//
+// GLB 到 SPZ 提取（extract）
+// 从 GLB 中取回嵌入的 SPZ 流，供重新训练工具或其他查看器使用：
+// 按 JSON 中 KHR_gaussian_splatting_compression_spz_2 引用的 bufferView 定位，
+// 直接从映射的 GLB 文件把这段字节拷贝到输出文件
+
+#ifndef SPZ2GLB_GLB_EXTRACT_H_
+#define SPZ2GLB_GLB_EXTRACT_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+struct SpzResult;
+
+namespace spz2glb {
+
+/**
+ * GLB 中一段 SPZ 流的位置
+ */
+struct SpzBufferView {
+    size_t mesh;          // 第一个引用它的 mesh
+    size_t primitive;     // 该 mesh 中的 primitive 序号
+    size_t bufferView;    // bufferView 序号
+    uint64_t fileOffset;  // 在 GLB 文件中的字节偏移（BIN Chunk 数据起点 + byteOffset）
+    uint64_t length;      // bufferView 的 byteLength（不含 BIN 填充）
+};
+
+/**
+ * 解析 GLB 头与 JSON Chunk，列出所有 SPZ 压缩 primitive 引用的 bufferView
+ *
+ * 按 mesh、primitive 顺序遍历；多个 primitive 引用同一个 bufferView 时只列出一次。
+ * bufferView 必须位于 GLB 自带的 BIN Chunk（buffer 0，无 uri）之内
+ *
+ * @return false 如果不是合法的 GLB 或没有 SPZ 压缩的 primitive，error 中为原因
+ */
+bool findSpzBufferViews(std::span<const uint8_t> glb, std::vector<SpzBufferView>& views, std::string& error);
+
+/**
+ * 各 SPZ 流的输出路径：只有一个时即 outputPath，
+ * 多个时在扩展名前加序号（scene.spz -> scene_0.spz、scene_1.spz ...）
+ */
+std::vector<std::string> extractOutputPaths(const std::string& outputPath, size_t count);
+
+struct ExtractedSpz {
+    std::string path;
+    uint64_t bytes;
+};
+
+/**
+ * 从 GLB 文件取出所有 SPZ 流
+ *
+ * mmap 输入，按 findSpzBufferViews 的结果用 writeFileRange 逐段写出（copy_file_range / sendfile），
+ * 字节不经过用户态缓冲区；输出与嵌入时的 SPZ 流逐字节相同
+ *
+ * @param outputs 写出的文件及其大小
+ */
+SpzResult extractSpzFile(const std::string& glbPath, const std::string& outputPath,
+                         std::vector<ExtractedSpz>& outputs);
+
+}  // namespace spz2glb
+
+#endif  // SPZ2GLB_GLB_EXTRACT_H_
@@ -0,0 +1,617 @@
+// Copyright (c) 2026 Pu Junhan
+// SPDX-License-Identifier: MIT
+// Project: SPZ-ecosystem
+// Repository: https://github.com/spz-ecosystem/spz2glb
+//
+// GLB 零拷贝写出实现
+
+#include "glb_writer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <limits>
+
+#ifndef __EMSCRIPTEN__
+#include <fstream>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#ifdef __linux__
+#include <sys/sendfile.h>
+#endif
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+#endif
+
+namespace spz2glb {
+
+namespace {
+
+constexpr uint32_t kGlbMagic = 0x46546C67;       // "glTF"
+constexpr uint32_t kJsonChunkType = 0x4E4F534A;  // "JSON"
+constexpr uint32_t kBinChunkType = 0x004E4942;   // "BIN\0"
+constexpr size_t kGlbHeaderSize = 12;
+constexpr size_t kChunkHeaderSize = 8;
+
+size_t paddingFor(size_t size) {
+    return (4 - (size % 4)) % 4;
+}
+
+// GLB 字段固定为小端序
+void appendU32(std::vector<uint8_t>& out, uint32_t value) {
+    out.push_back(static_cast<uint8_t>(value));
+    out.push_back(static_cast<uint8_t>(value >> 8));
+    out.push_back(static_cast<uint8_t>(value >> 16));
+    out.push_back(static_cast<uint8_t>(value >> 24));
+}
+
+}  // anonymous namespace
+
+bool computeGlbLayout(size_t jsonSize, size_t binSize, GlbLayout& layout) {
+    layout.jsonPadding = paddingFor(jsonSize);
+    layout.binPadding = paddingFor(binSize);
+
+    const size_t jsonChunk = jsonSize + layout.jsonPadding;
+    const size_t binChunk = binSize + layout.binPadding;
+    const size_t total = kGlbHeaderSize + kChunkHeaderSize + jsonChunk + kChunkHeaderSize + binChunk;
+
+    // GLB 头的 length 是 32 位，整个文件必须小于 4 GB
+    if (total >= static_cast<size_t>(std::numeric_limits<uint32_t>::max())) {
+        return false;
+    }
+
+    layout.jsonChunkLength = static_cast<uint32_t>(jsonChunk);
+    layout.binChunkLength = static_cast<uint32_t>(binChunk);
+    layout.totalLength = static_cast<uint32_t>(total);
+    layout.preambleSize = kGlbHeaderSize + kChunkHeaderSize + jsonChunk + kChunkHeaderSize;
+    return true;
+}
+
+std::vector<uint8_t> writeGlbPreamble(const std::string& json, const GlbLayout& layout) {
+    std::vector<uint8_t> out;
+    out.reserve(layout.preambleSize);
+
+    // GLB 头
+    appendU32(out, kGlbMagic);
+    appendU32(out, 2);
+    appendU32(out, layout.totalLength);
+
+    // JSON Chunk（空格填充）
+    appendU32(out, layout.jsonChunkLength);
+    appendU32(out, kJsonChunkType);
+    out.insert(out.end(), json.begin(), json.end());
+    out.insert(out.end(), layout.jsonPadding, static_cast<uint8_t>(0x20));
+
+    // BIN Chunk 头（负载由调用方写出）
+    appendU32(out, layout.binChunkLength);
+    appendU32(out, kBinChunkType);
+
+    return out;
+}
+
+fastgltf::Error GlbJsonExporter::writeBinaryJson(const fastgltf::Asset& asset, std::string& json) {
+    bufferPaths.clear();
+    imagePaths.clear();
+    errorCode = fastgltf::Error::None;
+    options = fastgltf::ExportOptions::None;
+    exportingBinary = true;
+
+    json = writeJson(asset);
+    return errorCode;
+}
+
+fastgltf::Asset createSplatAsset(bool spzCompression) {
+    fastgltf::Asset asset;
+    asset.extensionsUsed.emplace_back("KHR_gaussian_splatting");
+    asset.extensionsRequired.emplace_back("KHR_gaussian_splatting");
+    if (spzCompression) {
+        asset.extensionsUsed.emplace_back("KHR_gaussian_splatting_compression_spz_2");
+        asset.extensionsRequired.emplace_back("KHR_gaussian_splatting_compression_spz_2");
+    }
+    asset.assetInfo.emplace();
+    asset.assetInfo->gltfVersion = "2.0";
+    asset.assetInfo->copyright = "";
+    asset.assetInfo->generator = "spz_to_glb_fastgltf";
+    return asset;
+}
+
+void addGlbBinBuffer(fastgltf::Asset& asset, uint64_t byteLength) {
+    fastgltf::Buffer buffer;
+    buffer.data = fastgltf::sources::ByteView{};
+    buffer.byteLength = byteLength;
+    asset.buffers.emplace_back(std::move(buffer));
+}
+
+bool finishGlbPreamble(const std::string& json, uint64_t binSize, GlbLayout& layout,
+                       std::vector<uint8_t>& preamble, std::string& error) {
+    if (binSize > std::numeric_limits<uint32_t>::max() ||
+        !computeGlbLayout(json.size(), static_cast<size_t>(binSize), layout)) {
+        error = kGlbSizeLimitError;
+        return false;
+    }
+    preamble = writeGlbPreamble(json, layout);
+    return true;
+}
+
+#ifndef __EMSCRIPTEN__
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open(const std::string& path) {
+    close();
+
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) {
+        return false;
+    }
+    auto size = file.tellg();
+    file.seekg(0, std::ios::beg);
+    fallback_.resize(static_cast<size_t>(size));
+    if (!file.read(reinterpret_cast<char*>(fallback_.data()), static_cast<std::streamsize>(size))) {
+        fallback_.clear();
+        return false;
+    }
+    data_ = fallback_.data();
+    size_ = fallback_.size();
+    return true;
+}
+
+void MappedFile::close() {
+    fallback_.clear();
+    fallback_.shrink_to_fit();
+    data_ = nullptr;
+    size_ = 0;
+}
+
+#else  // _WIN32
+
+bool MappedFile::open(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        close();
+        return false;
+    }
+    return adopt(fd);
+}
+
+bool MappedFile::adopt(int fd) {
+    close();
+    fd_ = fd;
+
+    struct stat st;
+    if (::fstat(fd_, &st) != 0) {
+        close();
+        return false;
+    }
+
+    if (!S_ISREG(st.st_mode)) {
+        // 管道 / socket 无法 mmap：读到 EOF，缓冲区容量在多次 adopt 之间保留
+        size_t used = 0;
+        for (;;) {
+            if (fallback_.size() < used + 65536) {
+                fallback_.resize(std::max(fallback_.size() * 2, used + 65536));
+            }
+            ssize_t n = ::read(fd_, fallback_.data() + used, fallback_.size() - used);
+            if (n < 0 && errno == EINTR) continue;
+            if (n < 0) {
+                close();
+                return false;
+            }
+            if (n == 0) break;
+            used += static_cast<size_t>(n);
+        }
+        ::close(fd_);
+        fd_ = -1;  // 没有可供 copy_file_range 使用的源文件
+        data_ = fallback_.data();
+        size_ = used;
+        return true;
+    }
+
+    size_ = static_cast<size_t>(st.st_size);
+    if (size_ == 0) {
+        return true;
+    }
+
+    void* addr = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+    if (addr == MAP_FAILED) {
+        close();
+        return false;
+    }
+    // 负载是顺序读取的，提示内核预读
+    ::madvise(addr, size_, MADV_SEQUENTIAL);
+
+    data_ = static_cast<const uint8_t*>(addr);
+    mapped_ = true;
+    return true;
+}
+
+void MappedFile::close() {
+    if (mapped_) {
+        ::munmap(const_cast<uint8_t*>(data_), size_);
+        mapped_ = false;
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+    data_ = nullptr;
+    size_ = 0;
+}
+
+#endif  // _WIN32
+
+namespace {
+
+#ifndef _WIN32
+
+// writev 可能只写出一部分，按已写字节推进 iovec 直到全部写完
+bool writevAll(int fd, struct iovec* iov, int count) {
+    while (count > 0) {
+        ssize_t written = ::writev(fd, iov, count);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        size_t remaining = static_cast<size_t>(written);
+        while (count > 0 && remaining >= iov->iov_len) {
+            remaining -= iov->iov_len;
+            ++iov;
+            --count;
+        }
+        if (count > 0) {
+            iov->iov_base = static_cast<char*>(iov->iov_base) + remaining;
+            iov->iov_len -= remaining;
+        }
+    }
+    return true;
+}
+
+#ifdef __linux__
+// 在内核内把输入文件拷贝到输出 fd；文件系统支持时会直接 reflink
+// 返回已拷贝的字节数，失败时由调用方用 writev 补完剩余部分
+size_t copyFileRange(int inFd, int outFd, size_t length) {
+    loff_t inOffset = 0;
+    size_t copied = 0;
+    while (copied < length) {
+        ssize_t n = ::copy_file_range(inFd, &inOffset, outFd, nullptr, length - copied, 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        copied += static_cast<size_t>(n);
+    }
+    return copied;
+}
+#endif
+
+// 进程的 umask：umask() 只能以设置的方式读取，启动时读一次，避免与其他线程并发改写
+mode_t readUmask() {
+    mode_t mask = ::umask(0);
+    ::umask(mask);
+    return mask;
+}
+
+const mode_t g_umask = readUmask();
+
+#endif  // _WIN32
+
+}  // anonymous namespace
+
+#ifndef _WIN32
+
+OutputFile::~OutputFile() {
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+    if (!temp_.empty()) {
+        ::unlink(temp_.c_str());
+    }
+}
+
+bool OutputFile::open(const std::string& path) {
+    path_ = path;
+    struct stat st;
+    const bool exists = ::stat(path.c_str(), &st) == 0;
+    if (exists && !S_ISREG(st.st_mode)) {
+        fd_ = ::open(path.c_str(), O_WRONLY | O_TRUNC);
+        return fd_ >= 0;
+    }
+    struct stat link;
+    if (exists && ::lstat(path.c_str(), &link) == 0 && S_ISLNK(link.st_mode)) {
+        // 目标是符号链接：写穿到链接指向的文件，临时文件建在它所在的目录
+        char* resolved = ::realpath(path.c_str(), nullptr);
+        if (resolved == nullptr) {
+            return false;
+        }
+        path_ = resolved;
+        ::free(resolved);
+    }
+
+    std::string temp = path_ + ".tmp-XXXXXX";
+    fd_ = ::mkstemp(temp.data());
+    if (fd_ < 0) {
+        return false;
+    }
+    temp_ = std::move(temp);
+    // mkstemp 创建的文件是 0600：新建时与 open(..., 0666) 一样受 umask 约束，
+    // 覆盖已有文件时沿用它的权限与属主（改属主需要权限，失败时忽略）
+    if (exists) {
+        ::fchmod(fd_, st.st_mode & 07777);
+        if (::fchown(fd_, st.st_uid, st.st_gid) != 0) {
+            ::fchmod(fd_, st.st_mode & 0777);
+        }
+    } else {
+        ::fchmod(fd_, 0666 & ~g_umask);
+    }
+    return true;
+}
+
+bool OutputFile::commit() {
+    int fd = fd_;
+    fd_ = -1;
+    if (fd < 0 || ::close(fd) != 0) {
+        return false;
+    }
+    if (temp_.empty()) {
+        return true;
+    }
+    if (::rename(temp_.c_str(), path_.c_str()) != 0) {
+        return false;
+    }
+    temp_.clear();
+    return true;
+}
+
+#endif  // _WIN32
+
+bool writeGlbFile(const std::string& path,
+                  const std::vector<uint8_t>& preamble,
+                  const MappedFile& payload,
+                  const GlbLayout& layout) {
+#ifdef _WIN32
+    static const uint8_t zeros[4] = {0, 0, 0, 0};
+    auto bytes = payload.bytes();
+
+    std::ofstream file(path, std::ios::binary);
+    if (!file) {
+        std::cerr << "[ERROR] Cannot open output file: " << path << std::endl;
+        return false;
+    }
+    file.write(reinterpret_cast<const char*>(preamble.data()), static_cast<std::streamsize>(preamble.size()));
+    file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    file.write(reinterpret_cast<const char*>(zeros), static_cast<std::streamsize>(layout.binPadding));
+    if (!file) {
+        std::cerr << "[ERROR] Failed to write GLB: " << path << std::endl;
+        return false;
+    }
+    return true;
+#else
+    OutputFile out;
+    if (!out.open(path)) {
+        std::cerr << "[ERROR] Cannot open output file: " << path << std::endl;
+        return false;
+    }
+
+    bool ok = writeGlbToFd(out.fd(), preamble, payload, layout) && out.commit();
+    if (!ok) {
+        std::cerr << "[ERROR] Failed to write GLB: " << path << std::endl;
+    }
+    return ok;
+#endif
+}
+
+bool writeFileRange(const std::string& path, const MappedFile& source, uint64_t offset, uint64_t length) {
+    if (offset > source.size() || length > source.size() - offset) {
+        std::cerr << "[ERROR] Byte range outside source file: " << path << std::endl;
+        return false;
+    }
+    auto bytes = source.bytes().subspan(static_cast<size_t>(offset), static_cast<size_t>(length));
+#ifdef _WIN32
+    std::ofstream file(path, std::ios::binary);
+    if (!file) {
+        std::cerr << "[ERROR] Cannot open output file: " << path << std::endl;
+        return false;
+    }
+    file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    if (!file) {
+        std::cerr << "[ERROR] Failed to write file: " << path << std::endl;
+        return false;
+    }
+    return true;
+#else
+    // 输出路径可能就是 source（提取到输入文件本身）：写临时文件再 rename，映射中的源保持完整
+    OutputFile file;
+    if (!file.open(path)) {
+        std::cerr << "[ERROR] Cannot open output file: " << path << std::endl;
+        return false;
+    }
+    const int out = file.fd();
+
+    size_t copied = 0;
+#ifdef __linux__
+    if (source.fd() >= 0) {
+        loff_t inOffset = static_cast<loff_t>(offset);
+        while (copied < bytes.size()) {
+            ssize_t n = ::copy_file_range(source.fd(), &inOffset, out, nullptr, bytes.size() - copied, 0);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) break;
+            copied += static_cast<size_t>(n);
+        }
+        // 跨文件系统等 copy_file_range 不支持的情况下改用 sendfile（同样不经过用户态）
+        off_t sendOffset = static_cast<off_t>(offset + copied);
+        while (copied < bytes.size()) {
+            ssize_t n = ::sendfile(out, source.fd(), &sendOffset, bytes.size() - copied);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) break;
+            copied += static_cast<size_t>(n);
+        }
+    }
+#endif
+
+    struct iovec rest = {const_cast<uint8_t*>(bytes.data() + copied), bytes.size() - copied};
+    bool ok = writevAll(out, &rest, rest.iov_len > 0 ? 1 : 0) && file.commit();
+    if (!ok) {
+        std::cerr << "[ERROR] Failed to write file: " << path << std::endl;
+    }
+    return ok;
+#endif
+}
+
+#ifndef _WIN32
+
+bool writeGlbToFd(int out,
+                  const std::vector<uint8_t>& preamble,
+                  const MappedFile& payload,
+                  const GlbLayout& layout) {
+    static const uint8_t zeros[4] = {0, 0, 0, 0};
+    auto bytes = payload.bytes();
+
+    bool preambleWritten = false;
+    size_t payloadOffset = 0;
+#ifdef __linux__
+    if (payload.fd() >= 0 && !bytes.empty()) {
+        struct iovec head = {const_cast<uint8_t*>(preamble.data()), preamble.size()};
+        if (!writevAll(out, &head, 1)) {
+            return false;
+        }
+        preambleWritten = true;
+        payloadOffset = copyFileRange(payload.fd(), out, bytes.size());
+    }
+#endif
+
+    // copy_file_range 不可用（或非 Linux）时，剩余的前导 + 负载 + 填充一次 writev
+    struct iovec iov[3];
+    int count = 0;
+    if (!preambleWritten) {
+        iov[count++] = {const_cast<uint8_t*>(preamble.data()), preamble.size()};
+    }
+    if (payloadOffset < bytes.size()) {
+        iov[count++] = {const_cast<uint8_t*>(bytes.data() + payloadOffset), bytes.size() - payloadOffset};
+    }
+    if (layout.binPadding > 0) {
+        iov[count++] = {const_cast<uint8_t*>(zeros), layout.binPadding};
+    }
+
+    return writevAll(out, iov, count);
+}
+
+#endif  // _WIN32
+
+bool writeGlbSegments(const std::string& path,
+                      const std::vector<uint8_t>& preamble,
+                      std::span<const std::span<const uint8_t>> segments,
+                      const GlbLayout& layout) {
+#ifdef _WIN32
+    static const uint8_t zeros[4] = {0, 0, 0, 0};
+
+    std::ofstream file(path, std::ios::binary);
+    if (!file) {
+        std::cerr << "[ERROR] Cannot open output file: " << path << std::endl;
+        return false;
+    }
+    file.write(reinterpret_cast<const char*>(preamble.data()), static_cast<std::streamsize>(preamble.size()));
+    for (auto segment : segments) {
+        file.write(reinterpret_cast<const char*>(segment.data()), static_cast<std::streamsize>(segment.size()));
+    }
+    file.write(reinterpret_cast<const char*>(zeros), static_cast<std::streamsize>(layout.binPadding));
+    if (!file) {
+        std::cerr << "[ERROR] Failed to write GLB: " << path << std::endl;
+        return false;
+    }
+    return true;
+#else
+    OutputFile out;
+    if (!out.open(path)) {
+        std::cerr << "[ERROR] Cannot open output file: " << path << std::endl;
+        return false;
+    }
+
+    bool ok = writeGlbSegmentsToFd(out.fd(), preamble, segments, layout) && out.commit();
+    if (!ok) {
+        std::cerr << "[ERROR] Failed to write GLB: " << path << std::endl;
+    }
+    return ok;
+#endif
+}
+
+#ifndef _WIN32
+
+bool writeGlbSegmentsToFd(int out,
+                          const std::vector<uint8_t>& preamble,
+                          std::span<const std::span<const uint8_t>> segments,
+                          const GlbLayout& layout) {
+    static const uint8_t zeros[4] = {0, 0, 0, 0};
+
+    std::vector<struct iovec> iov;
+    iov.reserve(segments.size() + 2);
+    iov.push_back({const_cast<uint8_t*>(preamble.data()), preamble.size()});
+    for (auto segment : segments) {
+        if (!segment.empty()) {
+            iov.push_back({const_cast<uint8_t*>(segment.data()), segment.size()});
+        }
+    }
+    if (layout.binPadding > 0) {
+        iov.push_back({const_cast<uint8_t*>(zeros), layout.binPadding});
+    }
+
+    // 段数超过 IOV_MAX 时分批写出
+    for (size_t i = 0; i < iov.size(); i += IOV_MAX) {
+        int count = static_cast<int>(std::min<size_t>(IOV_MAX, iov.size() - i));
+        if (!writevAll(out, iov.data() + i, count)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool writeBytes(int out, std::span<const uint8_t> bytes) {
+    struct iovec iov = {const_cast<uint8_t*>(bytes.data()), bytes.size()};
+    return writevAll(out, &iov, bytes.empty() ? 0 : 1);
+}
+
+bool writeBytesAt(int out, std::span<const uint8_t> bytes, uint64_t offset) {
+    size_t written = 0;
+    while (written < bytes.size()) {
+        ssize_t n = ::pwrite(out, bytes.data() + written, bytes.size() - written,
+                             static_cast<off_t>(offset + written));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        written += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool writeFileAt(int out, const MappedFile& payload, uint64_t offset) {
+    auto bytes = payload.bytes();
+    size_t copied = 0;
+#ifdef __linux__
+    if (payload.fd() >= 0) {
+        // 显式给出两端偏移，不使用也不改变 fd 的文件位置
+        loff_t inOffset = 0;
+        loff_t outOffset = static_cast<loff_t>(offset);
+        while (copied < bytes.size()) {
+            ssize_t n = ::copy_file_range(payload.fd(), &inOffset, out, &outOffset, bytes.size() - copied, 0);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) break;
+            copied += static_cast<size_t>(n);
+        }
+    }
+#endif
+    return writeBytesAt(out, bytes.subspan(copied), offset + copied);
+}
+
+#endif  // _WIN32
+
+#endif  // __EMSCRIPTEN__
+
+}  // namespace spz2glb
@@ -0,0 +1,236 @@
+// Copyright (c) 2026 Pu Junhan
+// SPDX-License-Identifier: MIT
+// Project: SPZ-ecosystem
+// Repository: https://github.com/spz-ecosystem/spz2glb
+//
+// GLB 零拷贝写出
+// 预先计算 GLB 头、JSON Chunk 与 BIN Chunk 长度，只在内存中生成很小的前导部分，
+// SPZ 负载直接从输入文件拼接到输出文件（copy_file_range / writev）
+
+#ifndef SPZ2GLB_GLB_WRITER_H_
+#define SPZ2GLB_GLB_WRITER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <fastgltf/core.hpp>
+
+namespace spz2glb {
+
+/**
+ * GLB 布局（所有长度均已按 4 字节对齐）
+ */
+struct GlbLayout {
+    uint32_t totalLength;      // GLB 头中的 length 字段（整个文件长度）
+    uint32_t jsonChunkLength;  // JSON Chunk 数据长度（含空格填充）
+    uint32_t binChunkLength;   // BIN Chunk 数据长度（含零填充）
+    size_t jsonPadding;        // JSON 末尾空格填充字节数
+    size_t binPadding;         // BIN 末尾零填充字节数
+    size_t preambleSize;       // GLB 头 + JSON Chunk + BIN Chunk 头
+};
+
+/**
+ * 计算 GLB 布局
+ *
+ * @param jsonSize glTF JSON 字节数（未填充）
+ * @param binSize BIN 负载字节数（未填充）
+ * @param layout 输出参数
+ * @return false 如果超过 GLB 的 2^32 字节上限
+ */
+bool computeGlbLayout(size_t jsonSize, size_t binSize, GlbLayout& layout);
+
+/**
+ * 生成 GLB 前导字节：GLB 头 + JSON Chunk（含填充）+ BIN Chunk 头
+ *
+ * 与 fastgltf::Exporter::writeGltfBinary 的输出逐字节一致，
+ * 只是不包含 BIN 负载本身
+ */
+std::vector<uint8_t> writeGlbPreamble(const std::string& json, const GlbLayout& layout);
+
+/**
+ * 只导出 GLB 的 JSON 部分
+ *
+ * fastgltf 的 writeGltfBinary 会把 buffer 0 整个复制进输出 vector，
+ * 这里复用它的 JSON 序列化（以 GLB 模式，buffer 0 不写 uri），负载由调用方自行写出
+ */
+class GlbJsonExporter : public fastgltf::Exporter {
+public:
+    fastgltf::Error writeBinaryJson(const fastgltf::Asset& asset, std::string& json);
+};
+
+// 超过 GLB 的 4 GB 上限时各导出路径统一使用的错误信息
+inline constexpr char kGlbSizeLimitError[] = "GLB export failed: output exceeds 4 GB GLB limit";
+
+/**
+ * BIN 由若干内存段组成的 GLB（属性模式、分块、LOD 共用）
+ *
+ * 完整 GLB = preamble + segments 依次拼接 + layout.binPadding 个零字节；
+ * segments 指向派生结构体自己持有的数组，写出时不再拼接复制
+ */
+struct SegmentedGlb {
+    std::vector<uint8_t> preamble;
+    GlbLayout layout = {};
+    std::vector<std::span<const uint8_t>> segments;
+};
+
+/**
+ * 新建高斯泼溅资产：assetInfo（glTF 2.0，generator "spz_to_glb_fastgltf"）与扩展声明
+ *
+ * @param spzCompression 同时声明 KHR_gaussian_splatting_compression_spz_2（属性模式为 false）
+ */
+fastgltf::Asset createSplatAsset(bool spzCompression);
+
+/**
+ * 添加 buffer 0 作为 BIN Chunk：GLB 模式下 JSON 只需要 byteLength，数据由调用方按段写出
+ */
+void addGlbBinBuffer(fastgltf::Asset& asset, uint64_t byteLength);
+
+/**
+ * 计算布局并生成前导字节
+ *
+ * @return false 如果超过 GLB 的 4 GB 上限（error 为 kGlbSizeLimitError）
+ */
+bool finishGlbPreamble(const std::string& json, uint64_t binSize, GlbLayout& layout,
+                       std::vector<uint8_t>& preamble, std::string& error);
+
+#ifndef __EMSCRIPTEN__
+
+/**
+ * 只读文件映射（RAII）
+ *
+ * POSIX 下使用 mmap，保留 fd 以便 copy_file_range 在内核内拷贝；
+ * 其他平台退化为一次性读入内存
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& path);
+#ifndef _WIN32
+    // 接管已打开的 fd（例如通过 SCM_RIGHTS 收到的）：普通文件 mmap，管道等读入内部缓冲区
+    bool adopt(int fd);
+#endif
+    void close();
+
+    std::span<const uint8_t> bytes() const { return {data_, size_}; }
+    size_t size() const { return size_; }
+    int fd() const { return fd_; }
+
+private:
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    int fd_ = -1;
+    bool mapped_ = false;
+    std::vector<uint8_t> fallback_;
+};
+
+#ifndef _WIN32
+/**
+ * 输出文件（RAII）：先写同目录下的临时文件，commit() 时 rename 覆盖目标
+ *
+ * 输出路径与某个输入相同（或是它的硬链接）时，直接 O_TRUNC 会截断仍在 mmap / 读取中的输入；
+ * 写临时文件再 rename 只替换目录项，旧 inode 在映射关闭前保持完整。
+ * 目标已存在且不是普通文件（/dev/null、FIFO 等）时直接打开写入；
+ * 目标是指向已有文件的符号链接时替换它指向的文件，链接本身保留。
+ * 新文件的权限为 0666 & ~umask，覆盖已有文件时沿用其权限（与属主，权限允许时）。
+ * 未 commit 即析构时删除临时文件，目标保持原样
+ */
+class OutputFile {
+public:
+    OutputFile() = default;
+    ~OutputFile();
+
+    OutputFile(const OutputFile&) = delete;
+    OutputFile& operator=(const OutputFile&) = delete;
+
+    bool open(const std::string& path);
+    bool commit();
+
+    int fd() const { return fd_; }
+
+private:
+    std::string path_;
+    std::string temp_;  // 为空表示直接写目标
+    int fd_ = -1;
+};
+#endif
+
+/**
+ * 写出 GLB 文件：前导字节 + SPZ 负载 + BIN 填充
+ *
+ * Linux 下优先 copy_file_range（内核内拷贝，支持 reflink），
+ * 不可用时退化为 writev 分散写，负载不经过用户态缓冲区
+ */
+bool writeGlbFile(const std::string& path,
+                  const std::vector<uint8_t>& preamble,
+                  const MappedFile& payload,
+                  const GlbLayout& layout);
+
+/**
+ * 把映射文件中 [offset, offset + length) 这一段写成新文件 path（如从 GLB 中取出 SPZ 负载）
+ *
+ * Linux 下优先 copy_file_range（显式输入偏移，支持 reflink），其次 sendfile，
+ * 都不可用时直接写出映射中的字节；POSIX 下经 OutputFile 写出，path 可以就是 source 本身
+ */
+bool writeFileRange(const std::string& path, const MappedFile& source, uint64_t offset, uint64_t length);
+
+#ifndef _WIN32
+/**
+ * 同 writeGlbFile，但写入已打开的 fd（从当前位置开始写，不关闭 fd）
+ */
+bool writeGlbToFd(int fd,
+                  const std::vector<uint8_t>& preamble,
+                  const MappedFile& payload,
+                  const GlbLayout& layout);
+#endif
+
+/**
+ * 写出 GLB 文件：前导字节 + 若干内存段依次拼接 + BIN 填充
+ *
+ * 用于 BIN 内容由多段内存数组组成的情况（如属性模式的各 accessor 数组），
+ * POSIX 下一次 writev 分散写，各段不先拼接到中间缓冲区
+ */
+bool writeGlbSegments(const std::string& path,
+                      const std::vector<uint8_t>& preamble,
+                      std::span<const std::span<const uint8_t>> segments,
+                      const GlbLayout& layout);
+
+#ifndef _WIN32
+/**
+ * 同 writeGlbSegments，但写入已打开的 fd
+ */
+bool writeGlbSegmentsToFd(int fd,
+                          const std::vector<uint8_t>& preamble,
+                          std::span<const std::span<const uint8_t>> segments,
+                          const GlbLayout& layout);
+
+/**
+ * 把 bytes 从 fd 的当前位置顺序写出（管道、FIFO 也可以）
+ */
+bool writeBytes(int fd, std::span<const uint8_t> bytes);
+
+/**
+ * 把 bytes 写到 fd 的 offset 处（pwrite，不改变文件位置）
+ *
+ * 各区间互不重叠时可以多线程对同一 fd 并发调用
+ */
+bool writeBytesAt(int fd, std::span<const uint8_t> bytes, uint64_t offset);
+
+/**
+ * 同 writeBytesAt，写出整个映射文件：Linux 下优先 copy_file_range（显式输出偏移），其余部分 pwrite
+ */
+bool writeFileAt(int fd, const MappedFile& payload, uint64_t offset);
+#endif
+
+#endif  // __EMSCRIPTEN__
+
+}  // namespace spz2glb
+
+#endif  // SPZ2GLB_GLB_WRITER_H_
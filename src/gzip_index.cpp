@@ -0,0 +1,588 @@
+// Copyright (c) 2026 Pu Junhan
+// SPDX-License-Identifier: MIT
+// Project: SPZ-ecosystem
+// Repository: https://github.com/spz-ecosystem/spz2glb
+//
+// SPZ gzip 流随机访问索引实现
+
+#include "gzip_index.h"
+
+#include <algorithm>
+#include <charconv>
+#include <climits>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#include <zlib.h>
+
+#include "deflate_codec.h"
+#include "optimal_deflate.h"
+#include "thread_pool.h"
+
+namespace spz2glb {
+
+namespace {
+
+constexpr uint32_t kIndexMagic = 0x58495A53;  // "SZIX"
+constexpr uint32_t kIndexVersion = 1;
+
+// zlib 的 avail_in / avail_out 是 32 位，大于 4 GB 的区间分段喂入
+uInt clampAvail(uint64_t remaining) {
+    return static_cast<uInt>(std::min<uint64_t>(remaining, UINT_MAX));
+}
+
+void appendU32(std::vector<uint8_t>& out, uint32_t value) {
+    for (int i = 0; i < 4; ++i) out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+}
+
+void appendU64(std::vector<uint8_t>& out, uint64_t value) {
+    for (int i = 0; i < 8; ++i) out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+}
+
+// 带边界检查的小端序读取
+class Reader {
+public:
+    explicit Reader(std::span<const uint8_t> data) : data_(data) {}
+
+    bool u8(uint8_t& value) { return read(&value, 1); }
+    bool u32(uint32_t& value) {
+        uint8_t b[4];
+        if (!read(b, 4)) return false;
+        value = 0;
+        for (int i = 3; i >= 0; --i) value = (value << 8) | b[i];
+        return true;
+    }
+    bool u64(uint64_t& value) {
+        uint8_t b[8];
+        if (!read(b, 8)) return false;
+        value = 0;
+        for (int i = 7; i >= 0; --i) value = (value << 8) | b[i];
+        return true;
+    }
+    bool bytes(size_t size, std::span<const uint8_t>& out) {
+        if (data_.size() - pos_ < size) return false;
+        out = data_.subspan(pos_, size);
+        pos_ += size;
+        return true;
+    }
+
+private:
+    bool read(uint8_t* out, size_t size) {
+        if (data_.size() - pos_ < size) return false;
+        std::memcpy(out, data_.data() + pos_, size);
+        pos_ += size;
+        return true;
+    }
+
+    std::span<const uint8_t> data_;
+    size_t pos_ = 0;
+};
+
+// 在 object 中找 "key": 之后的无符号整数
+bool findUnsigned(std::string_view object, std::string_view key, uint64_t& value) {
+    for (size_t pos = object.find(key); pos != std::string_view::npos; pos = object.find(key, pos + 1)) {
+        size_t end = pos + key.size();
+        if (pos == 0 || object[pos - 1] != '"' || end >= object.size() || object[end] != '"') {
+            continue;  // 只是某个更长的键或字符串的一部分
+        }
+        size_t begin = object.find_first_not_of(" \t\r\n:", end + 1);
+        if (begin == std::string_view::npos) return false;
+        return std::from_chars(object.data() + begin, object.data() + object.size(), value).ec == std::errc();
+    }
+    return false;
+}
+
+// 任意长度数据的 CRC-32（zlib 的长度参数是 32 位，分段累加）
+uLong crc32Of(uLong crc, std::span<const uint8_t> data) {
+    for (uint64_t done = 0; done < data.size();) {
+        uInt n = clampAvail(data.size() - done);
+        crc = ::crc32(crc, data.data() + done, n);
+        done += n;
+    }
+    return crc;
+}
+
+void storeU32(uint8_t* out, uint32_t value) {
+    for (int i = 0; i < 4; ++i) out[i] = static_cast<uint8_t>(value >> (8 * i));
+}
+
+/**
+ * 按 partBytes 切分 inflated，在线程池上并行压缩各段，拼成单成员 gzip 写入 out
+ *
+ * compress(begin, size, last, part, error) 把 inflated[begin, begin + size) 压缩后追加到 part；
+ * 非最后一段的输出必须字节对齐。offsets 返回各段在 out 中的偏移，crc 返回整个解压数据的 CRC-32。
+ * cancel 置位后尚未开始的段不再压缩
+ */
+template <typename CompressPart>
+bool deflateParts(std::span<const uint8_t> inflated, uint64_t partBytes, ThreadPool* pool, CompressPart&& compress,
+                  std::vector<uint8_t>& out, std::vector<uint64_t>& offsets, uint32_t& crc, std::string& error,
+                  const std::atomic<bool>* cancel) {
+    size_t count = std::max<size_t>(1, static_cast<size_t>((inflated.size() + partBytes - 1) / partBytes));
+    auto partSize = [&](size_t i) {
+        return static_cast<size_t>(std::min<uint64_t>(partBytes, inflated.size() - i * partBytes));
+    };
+    std::vector<std::vector<uint8_t>> packed(count);
+    std::vector<uLong> crcs(count, 0);
+    std::vector<std::string> errors(count);
+    parallelFor(pool, count, [&](size_t i) {
+        if (cancel != nullptr && cancel->load(std::memory_order_relaxed)) {
+            errors[i] = "Conversion cancelled";
+            return;
+        }
+        size_t begin = static_cast<size_t>(i * partBytes);
+        size_t size = partSize(i);
+        if (!compress(begin, size, i + 1 == count, packed[i], errors[i]) && errors[i].empty()) {
+            errors[i] = "Failed to compress block " + std::to_string(i);
+        }
+        crcs[i] = crc32Of(::crc32(0L, Z_NULL, 0), inflated.subspan(begin, size));
+    });
+    for (const auto& message : errors) {
+        if (!message.empty()) {
+            error = message;
+            return false;
+        }
+    }
+
+    // gzip 头：无文件名、mtime 为 0、OS 未知，保证同样的输入得到同样的输出
+    static constexpr uint8_t kGzipHeader[10] = {0x1f, 0x8b, 8, 0, 0, 0, 0, 0, 0, 0xff};
+    size_t total = sizeof(kGzipHeader) + 8;
+    for (const auto& part : packed) total += part.size();
+    out.resize(total);
+    uint8_t* p = out.data();
+    std::memcpy(p, kGzipHeader, sizeof(kGzipHeader));
+    p += sizeof(kGzipHeader);
+
+    uLong combined = ::crc32(0L, Z_NULL, 0);
+    offsets.assign(count, 0);
+    for (size_t i = 0; i < count; ++i) {
+        offsets[i] = static_cast<uint64_t>(p - out.data());
+        if (!packed[i].empty()) {
+            std::memcpy(p, packed[i].data(), packed[i].size());
+            p += packed[i].size();
+        }
+        std::vector<uint8_t>().swap(packed[i]);
+        combined = crc32_combine(combined, crcs[i], static_cast<z_off_t>(partSize(i)));
+    }
+    crc = static_cast<uint32_t>(combined);
+
+    // gzip 尾：CRC-32 与 ISIZE（解压长度 mod 2^32），小端序
+    storeU32(p, crc);
+    storeU32(p + 4, static_cast<uint32_t>(inflated.size()));
+    return true;
+}
+
+}  // anonymous namespace
+
+bool buildGzipIndex(std::span<const uint8_t> compressed, uint64_t spanBytes, GzipIndex& index,
+                    std::string& error) {
+    if (spanBytes < GzipIndex::kWindowSize) {
+        error = "Index span must be at least 32 KB";
+        return false;
+    }
+
+    z_stream strm = {};
+    if (inflateInit2(&strm, 16 + MAX_WBITS) != Z_OK) {  // 只接受 gzip 封装
+        error = "Failed to initialize zlib";
+        return false;
+    }
+
+    index = GzipIndex();
+    index.spanBytes = spanBytes;
+    index.compressedSize = compressed.size();
+
+    // 输出循环写入 32 KB 窗口，窗口内容即最近的 32 KB 解压数据
+    std::vector<uint8_t> window(GzipIndex::kWindowSize, 0);
+    uint64_t fed = 0;
+    uint64_t totalIn = 0;
+    uint64_t totalOut = 0;
+    uint64_t last = 0;
+    int ret = Z_OK;
+    do {
+        if (strm.avail_in == 0) {
+            strm.next_in = const_cast<Bytef*>(compressed.data() + fed);
+            strm.avail_in = clampAvail(compressed.size() - fed);
+            fed += strm.avail_in;
+        }
+        if (strm.avail_out == 0) {
+            strm.next_out = window.data();
+            strm.avail_out = static_cast<uInt>(window.size());
+        }
+
+        uInt inBefore = strm.avail_in;
+        uInt outBefore = strm.avail_out;
+        // Z_BLOCK：在每个 deflate 块边界返回，只有块边界才能作为访问点
+        ret = inflate(&strm, Z_BLOCK);
+        totalIn += inBefore - strm.avail_in;
+        totalOut += outBefore - strm.avail_out;
+
+        if (ret == Z_NEED_DICT || ret == Z_DATA_ERROR || ret == Z_MEM_ERROR ||
+            (ret == Z_BUF_ERROR && strm.avail_in == 0 && fed == compressed.size())) {
+            inflateEnd(&strm);
+            error = ret == Z_BUF_ERROR ? "Truncated gzip stream" : "Corrupt gzip stream";
+            return false;
+        }
+
+        // bit 7：刚好位于块边界；bit 6：位于最后一个块之后（不再需要访问点）
+        bool atBoundary = (strm.data_type & 128) != 0 && (strm.data_type & 64) == 0;
+        if (atBoundary && (index.points.empty() || totalOut - last >= spanBytes)) {
+            GzipAccessPoint point;
+            point.uncompressedOffset = totalOut;
+            point.compressedOffset = totalIn;
+            point.bits = static_cast<uint8_t>(strm.data_type & 7);
+            if (totalOut > 0) {
+                // 按时间顺序展开循环窗口
+                size_t left = strm.avail_out;
+                point.window.resize(GzipIndex::kWindowSize);
+                std::memcpy(point.window.data(), window.data() + window.size() - left, left);
+                std::memcpy(point.window.data() + left, window.data(), window.size() - left);
+            }
+            index.points.push_back(std::move(point));
+            last = totalOut;
+        }
+    } while (ret != Z_STREAM_END);
+
+    index.uncompressedSize = totalOut;
+    index.crc32 = static_cast<uint32_t>(strm.adler);  // gzip 模式下 adler 字段为 CRC-32
+    inflateEnd(&strm);
+
+    if (totalIn != compressed.size()) {
+        error = "Multi-member gzip streams are not supported";
+        return false;
+    }
+    return true;
+}
+
+bool writeGzipIndex(const std::string& path, const GzipIndex& index, std::string& error) {
+    std::vector<uint8_t> out;
+    appendU32(out, kIndexMagic);
+    appendU32(out, kIndexVersion);
+    appendU64(out, index.spanBytes);
+    appendU64(out, index.uncompressedSize);
+    appendU64(out, index.compressedSize);
+    appendU64(out, index.payloadOffset);
+    appendU32(out, index.crc32);
+    appendU32(out, static_cast<uint32_t>(index.points.size()));
+
+    std::vector<uint8_t> packed(compressBound(GzipIndex::kWindowSize));
+    for (const auto& point : index.points) {
+        appendU64(out, point.uncompressedOffset);
+        appendU64(out, point.compressedOffset);
+        out.push_back(point.bits);
+        out.insert(out.end(), 3, 0);
+
+        uLongf packedSize = 0;
+        if (!point.window.empty()) {
+            packedSize = static_cast<uLongf>(packed.size());
+            if (compress2(packed.data(), &packedSize, point.window.data(),
+                          static_cast<uLong>(point.window.size()), Z_BEST_SPEED) != Z_OK) {
+                error = "Failed to compress index window";
+                return false;
+            }
+        }
+        appendU32(out, static_cast<uint32_t>(packedSize));
+        out.insert(out.end(), packed.begin(), packed.begin() + static_cast<std::ptrdiff_t>(packedSize));
+    }
+
+    std::ofstream file(path, std::ios::binary);
+    file.write(reinterpret_cast<const char*>(out.data()), static_cast<std::streamsize>(out.size()));
+    if (!file) {
+        error = "Failed to write index: " + path;
+        return false;
+    }
+    return true;
+}
+
+bool readGzipIndex(const std::string& path, GzipIndex& index, std::string& error) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        error = "Cannot open index: " + path;
+        return false;
+    }
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    Reader reader(data);
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    uint32_t count = 0;
+    index = GzipIndex();
+    if (!reader.u32(magic) || magic != kIndexMagic || !reader.u32(version) || version != kIndexVersion) {
+        error = "Not a gzip index file: " + path;
+        return false;
+    }
+    if (!reader.u64(index.spanBytes) || !reader.u64(index.uncompressedSize) ||
+        !reader.u64(index.compressedSize) || !reader.u64(index.payloadOffset) ||
+        !reader.u32(index.crc32) || !reader.u32(count)) {
+        error = "Truncated gzip index: " + path;
+        return false;
+    }
+
+    index.points.resize(count);
+    for (auto& point : index.points) {
+        uint8_t reserved = 0;
+        uint32_t packedSize = 0;
+        std::span<const uint8_t> packed;
+        if (!reader.u64(point.uncompressedOffset) || !reader.u64(point.compressedOffset) ||
+            !reader.u8(point.bits) || !reader.u8(reserved) || !reader.u8(reserved) || !reader.u8(reserved) ||
+            !reader.u32(packedSize) || !reader.bytes(packedSize, packed)) {
+            error = "Truncated gzip index: " + path;
+            return false;
+        }
+        if (point.bits > 7) {
+            error = "Corrupt gzip index: " + path;
+            return false;
+        }
+        if (packedSize > 0) {
+            point.window.resize(GzipIndex::kWindowSize);
+            uLongf windowSize = static_cast<uLongf>(point.window.size());
+            if (uncompress(point.window.data(), &windowSize, packed.data(), packedSize) != Z_OK ||
+                windowSize != GzipIndex::kWindowSize) {
+                error = "Corrupt gzip index window: " + path;
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool inflateRange(std::span<const uint8_t> compressed, const GzipIndex& index, uint64_t offset,
+                  std::span<uint8_t> out, std::string& error) {
+    if (index.points.empty() || compressed.size() != index.compressedSize) {
+        error = "Index does not match this gzip stream";
+        return false;
+    }
+    if (offset > index.uncompressedSize || out.size() > index.uncompressedSize - offset) {
+        error = "Requested range is past the end of the stream";
+        return false;
+    }
+    if (out.empty()) {
+        return true;
+    }
+
+    // offset 之前最近的访问点
+    auto it = std::upper_bound(index.points.begin(), index.points.end(), offset,
+        [](uint64_t value, const GzipAccessPoint& point) { return value < point.uncompressedOffset; });
+    const GzipAccessPoint& point = *std::prev(it);
+
+    uint64_t in = point.compressedOffset - (point.bits != 0 ? 1 : 0);
+    if (in >= compressed.size()) {
+        error = "Corrupt gzip index";
+        return false;
+    }
+
+    z_stream strm = {};
+    if (inflateInit2(&strm, -MAX_WBITS) != Z_OK) {  // 访问点处没有 gzip 头，按原始 deflate 解压
+        error = "Failed to initialize zlib";
+        return false;
+    }
+    bool ok = true;
+    if (point.bits != 0) {
+        ok = inflatePrime(&strm, point.bits, compressed[in] >> (8 - point.bits)) == Z_OK;
+        in++;
+    }
+    if (ok && !point.window.empty()) {
+        ok = inflateSetDictionary(&strm, point.window.data(), static_cast<uInt>(point.window.size())) == Z_OK;
+    }
+
+    // 先解压并丢弃访问点到 offset 之间的数据，再直接解压到输出
+    std::vector<uint8_t> discard;
+    uint64_t skip = offset - point.uncompressedOffset;
+    if (skip > 0) {
+        discard.resize(static_cast<size_t>(std::min<uint64_t>(skip, 256 * 1024)));
+    }
+    uint64_t produced = 0;
+    while (ok && produced < out.size()) {
+        if (strm.avail_in == 0) {
+            strm.next_in = const_cast<Bytef*>(compressed.data() + in);
+            strm.avail_in = clampAvail(compressed.size() - in);
+            in += strm.avail_in;
+        }
+        bool skipping = skip > 0;
+        if (skipping) {
+            strm.next_out = discard.data();
+            strm.avail_out = clampAvail(std::min<uint64_t>(skip, discard.size()));
+        } else {
+            strm.next_out = out.data() + produced;
+            strm.avail_out = clampAvail(out.size() - produced);
+        }
+
+        uInt outBefore = strm.avail_out;
+        int ret = inflate(&strm, Z_NO_FLUSH);
+        uint64_t n = outBefore - strm.avail_out;
+        if (skipping) {
+            skip -= n;
+        } else {
+            produced += n;
+        }
+        if (ret == Z_STREAM_END && produced < out.size()) {
+            ok = false;
+        } else if (ret != Z_OK && ret != Z_STREAM_END && !(ret == Z_BUF_ERROR && n > 0)) {
+            ok = false;
+        }
+    }
+    inflateEnd(&strm);
+
+    if (!ok) {
+        error = "Failed to inflate from access point at " + std::to_string(point.uncompressedOffset);
+    }
+    return ok;
+}
+
+bool inflateWithIndex(std::span<const uint8_t> compressed, const GzipIndex& index, std::span<uint8_t> out,
+                      ThreadPool* pool, std::string& error) {
+    if (out.size() != index.uncompressedSize) {
+        error = "Output size does not match the index";
+        return false;
+    }
+
+    size_t count = index.points.size();
+    std::vector<std::string> errors(count);
+    std::vector<uLong> crcs(count, 0);
+    parallelFor(pool, count, [&](size_t i) {
+        uint64_t begin = index.points[i].uncompressedOffset;
+        uint64_t end = i + 1 < count ? index.points[i + 1].uncompressedOffset : index.uncompressedSize;
+        auto range = out.subspan(begin, end - begin);
+        if (!inflateRange(compressed, index, begin, range, errors[i])) {
+            return;
+        }
+        // 各区间的 CRC 顺带算出，最后合并，与 gzip 尾部比对
+        crcs[i] = crc32Of(::crc32(0L, Z_NULL, 0), range);
+    });
+
+    for (const auto& message : errors) {
+        if (!message.empty()) {
+            error = message;
+            return false;
+        }
+    }
+
+    uLong crc = ::crc32(0L, Z_NULL, 0);
+    for (size_t i = 0; i < count; ++i) {
+        uint64_t begin = index.points[i].uncompressedOffset;
+        uint64_t end = i + 1 < count ? index.points[i + 1].uncompressedOffset : index.uncompressedSize;
+        crc = crc32_combine(crc, crcs[i], static_cast<z_off_t>(end - begin));
+    }
+    if (static_cast<uint32_t>(crc) != index.crc32) {
+        error = "CRC-32 mismatch after parallel inflate";
+        return false;
+    }
+    return true;
+}
+
+bool repackGzipBlocks(std::span<const uint8_t> inflated, uint64_t blockBytes, int level, ThreadPool* pool,
+                      std::vector<uint8_t>& out, GzipIndex& blocks, std::string& error,
+                      const std::atomic<bool>* cancel) {
+    if (blockBytes < GzipIndex::kWindowSize || blockBytes > UINT_MAX / 2) {
+        error = "Block size must be between 32 KB and 2 GB";
+        return false;
+    }
+
+    std::vector<uint64_t> offsets;
+    uint32_t crc = 0;
+    auto compress = [&](size_t begin, size_t size, bool last, std::vector<uint8_t>& part, std::string& partError) {
+        auto block = inflated.subspan(begin, size);
+        if (level == kMaxRatioLevel) {
+            return optimalDeflate(block, 0, last, kOptimalDeflateIterations, part, partError);
+        }
+        return activeCodec().deflateRaw(block, level, last, part, partError);
+    };
+    if (!deflateParts(inflated, blockBytes, pool, compress, out, offsets, crc, error, cancel)) {
+        return false;
+    }
+
+    blocks = GzipIndex();
+    blocks.spanBytes = blockBytes;
+    blocks.uncompressedSize = inflated.size();
+    blocks.compressedSize = out.size();
+    blocks.crc32 = crc;
+    for (size_t i = 0; i < offsets.size(); ++i) {
+        blocks.points.push_back({i * blockBytes, offsets[i], 0, {}});
+    }
+    return true;
+}
+
+bool recompressGzip(std::span<const uint8_t> inflated, ThreadPool* pool, std::vector<uint8_t>& out,
+                    std::string& error, const std::atomic<bool>* cancel) {
+    std::vector<uint64_t> offsets;
+    uint32_t crc = 0;
+    // 每段把之前的数据作为匹配历史（optimalDeflate 只用最后 32 KB），段尾同步刷新，拼接后仍是一条连续的流
+    auto compress = [&](size_t begin, size_t size, bool last, std::vector<uint8_t>& part, std::string& partError) {
+        return optimalDeflate(inflated.first(begin + size), begin, last, kOptimalDeflateIterations, part, partError);
+    };
+    return deflateParts(inflated, kRecompressChunkBytes, pool, compress, out, offsets, crc, error, cancel);
+}
+
+bool compressGzip(std::span<const uint8_t> inflated, int level, ThreadPool* pool, std::vector<uint8_t>& out,
+                  std::string& error, const std::atomic<bool>* cancel) {
+    if (level == kMaxRatioLevel) {
+        return recompressGzip(inflated, pool, out, error, cancel);
+    }
+    std::vector<uint64_t> offsets;
+    uint32_t crc = 0;
+    auto compress = [&](size_t begin, size_t size, bool last, std::vector<uint8_t>& part, std::string& partError) {
+        return activeCodec().deflateRawContinued(inflated.first(begin), inflated.subspan(begin, size), level, last,
+                                                 part, partError);
+    };
+    return deflateParts(inflated, kCompressChunkBytes, pool, compress, out, offsets, crc, error, cancel);
+}
+
+std::string formatGzipBlockTable(const GzipIndex& blocks) {
+    std::string json = "\"spz2glb:blocks\":{\"blockSize\":" + std::to_string(blocks.spanBytes) +
+                       ",\"uncompressedSize\":" + std::to_string(blocks.uncompressedSize) +
+                       ",\"crc32\":" + std::to_string(blocks.crc32) + ",\"offsets\":[";
+    for (size_t i = 0; i < blocks.points.size(); ++i) {
+        if (i > 0) json += ',';
+        json += std::to_string(blocks.points[i].compressedOffset);
+    }
+    json += "]}";
+    return json;
+}
+
+bool parseGzipBlockTable(std::string_view json, GzipIndex& blocks, std::string& error) {
+    size_t begin = json.find("\"spz2glb:blocks\"");
+    if (begin == std::string_view::npos) {
+        error = "No spz2glb:blocks table";
+        return false;
+    }
+    size_t end = json.find('}', begin);
+    if (end == std::string_view::npos) {
+        error = "Truncated spz2glb:blocks table";
+        return false;
+    }
+    std::string_view object = json.substr(begin, end - begin);
+
+    blocks = GzipIndex();
+    uint64_t crc = 0;
+    if (!findUnsigned(object, "blockSize", blocks.spanBytes) ||
+        !findUnsigned(object, "uncompressedSize", blocks.uncompressedSize) ||
+        !findUnsigned(object, "crc32", crc) || blocks.spanBytes == 0) {
+        error = "Malformed spz2glb:blocks table";
+        return false;
+    }
+    blocks.crc32 = static_cast<uint32_t>(crc);
+
+    size_t pos = object.find("\"offsets\"");
+    pos = pos == std::string_view::npos ? pos : object.find('[', pos);
+    if (pos == std::string_view::npos) {
+        error = "Malformed spz2glb:blocks offsets";
+        return false;
+    }
+    uint64_t expected = (blocks.uncompressedSize + blocks.spanBytes - 1) / blocks.spanBytes;
+    for (++pos; pos < object.size() && object[pos] != ']';) {
+        uint64_t offset = 0;
+        auto [next, ec] = std::from_chars(object.data() + pos, object.data() + object.size(), offset);
+        if (ec != std::errc() || blocks.points.size() >= std::max<uint64_t>(1, expected)) {
+            error = "Malformed spz2glb:blocks offsets";
+            return false;
+        }
+        blocks.points.push_back({blocks.points.size() * blocks.spanBytes, offset, 0, {}});
+        pos = object.find_first_not_of(" \t\r\n,", static_cast<size_t>(next - object.data()));
+    }
+    if (blocks.points.size() != std::max<uint64_t>(1, expected)) {
+        error = "spz2glb:blocks offsets do not cover the payload";
+        return false;
+    }
+    return true;
+}
+
+}  // namespace spz2glb
@@ -0,0 +1,143 @@
+// Copyright (c) 2026 Pu Junhan
+// SPDX-License-Identifier: MIT
+// Project: SPZ-ecosystem
+// Repository: https://github.com/spz-ecosystem/spz2glb
+//
+// SPZ gzip 流随机访问索引（zlib 示例 zran 的做法）
+// 每隔 spanBytes 字节解压输出记录一个访问点：压缩流中的位置 + 之前 32 KB 的解压窗口，
+// 之后可以从任意访问点开始解压，多个区间并行解压或直接定位到某个属性段
+
+#ifndef SPZ2GLB_GZIP_INDEX_H_
+#define SPZ2GLB_GZIP_INDEX_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace spz2glb {
+
+class ThreadPool;
+
+/**
+ * 访问点
+ *
+ * compressedOffset 是访问点之后第一个完整字节在 gzip 流中的偏移；
+ * bits 非 0 时，访问点位于 compressedOffset - 1 字节的高 bits 位处
+ */
+struct GzipAccessPoint {
+    uint64_t uncompressedOffset;
+    uint64_t compressedOffset;
+    uint8_t bits;
+    std::vector<uint8_t> window;  // 访问点之前的 32 KB 解压数据；流起点处为空
+};
+
+/**
+ * gzip 流索引
+ *
+ * 侧车文件（.zidx）以小端序保存：
+ *   "SZIX" | u32 版本 | u64 spanBytes | u64 uncompressedSize | u64 compressedSize |
+ *   u64 payloadOffset | u32 crc32 | u32 访问点数 |
+ *   每个访问点：u64 uncompressedOffset | u64 compressedOffset | u8 bits | 3 字节保留 |
+ *              u32 窗口压缩长度 | zlib 压缩的窗口
+ */
+struct GzipIndex {
+    static constexpr size_t kWindowSize = 32768;
+
+    uint64_t spanBytes = 0;
+    uint64_t uncompressedSize = 0;
+    uint64_t compressedSize = 0;  // 建索引时的 gzip 流长度，读取时用于校验是否对应同一个流
+    uint64_t payloadOffset = 0;   // gzip 流在所在文件中的偏移（GLB 中即 BIN 负载起点）
+    uint32_t crc32 = 0;           // 整个解压输出的 CRC-32（gzip 尾部）
+    std::vector<GzipAccessPoint> points;
+};
+
+/**
+ * 顺序解压一遍 gzip 流，每 spanBytes 字节解压输出在 deflate 块边界处记录一个访问点
+ *
+ * 只支持单成员 gzip（SPZ 的标准格式）
+ */
+bool buildGzipIndex(std::span<const uint8_t> compressed, uint64_t spanBytes, GzipIndex& index,
+                    std::string& error);
+
+bool writeGzipIndex(const std::string& path, const GzipIndex& index, std::string& error);
+bool readGzipIndex(const std::string& path, GzipIndex& index, std::string& error);
+
+/**
+ * 解压 [offset, offset + out.size()) 区间：从 offset 之前最近的访问点开始解压，丢弃之前的部分
+ */
+bool inflateRange(std::span<const uint8_t> compressed, const GzipIndex& index, uint64_t offset,
+                  std::span<uint8_t> out, std::string& error);
+
+/**
+ * 按访问点切分，在线程池上并行解压整个流
+ *
+ * out 必须为 index.uncompressedSize 字节；各区间的 CRC-32 合并后与 gzip 尾部比对
+ */
+bool inflateWithIndex(std::span<const uint8_t> compressed, const GzipIndex& index, std::span<uint8_t> out,
+                      ThreadPool* pool, std::string& error);
+
+/**
+ * 把解压后的数据重新压缩为可并行解压的 gzip 流
+ *
+ * 每 blockBytes 字节解压数据压成一个独立块（raw deflate，块尾 Z_FULL_FLUSH：字节对齐，且不引用之前的数据），
+ * 各块用 activeCodec() 在线程池上并行压缩后拼接，外层仍是普通的单成员 gzip，任何 gzip 解码器都能顺序读取。
+ *
+ * blocks 返回各块起点（bits 为 0、窗口为空的访问点），可直接用于 inflateRange / inflateWithIndex
+ *
+ * @param level zlib 压缩级别（1~9），或 kMaxRatioLevel 表示各块用 optimalDeflate 压缩
+ */
+bool repackGzipBlocks(std::span<const uint8_t> inflated, uint64_t blockBytes, int level, ThreadPool* pool,
+                      std::vector<uint8_t>& out, GzipIndex& blocks, std::string& error,
+                      const std::atomic<bool>* cancel = nullptr);
+
+// recompressGzip 每段的解压字节数
+constexpr uint64_t kRecompressChunkBytes = 1 << 20;
+
+/**
+ * 把解压后的数据用 optimalDeflate 重新压缩为单成员 gzip，追求最小体积
+ *
+ * 每 kRecompressChunkBytes 字节一段在线程池上并行压缩；每段以之前 32 KB 为匹配历史，
+ * 段尾同步刷新后直接拼接，所以输出是一条普通的连续 deflate 流，与串行压缩只差段边界处的几个字节
+ */
+bool recompressGzip(std::span<const uint8_t> inflated, ThreadPool* pool, std::vector<uint8_t>& out,
+                    std::string& error, const std::atomic<bool>* cancel = nullptr);
+
+// compressGzip 每段的解压字节数
+constexpr uint64_t kCompressChunkBytes = 1 << 20;
+
+/**
+ * 把解压后的数据压缩为单成员 gzip
+ *
+ * 每 kCompressChunkBytes 字节一段，用 activeCodec() 在线程池上并行压缩：每段以之前 32 KB 为预置字典、
+ * 段尾同步刷新，拼接后是一条连续的 deflate 流。单段长度有界，超过 2 GB 的数据也能压缩
+ *
+ * @param level zlib 压缩级别（1~9），或 kMaxRatioLevel（同 recompressGzip）
+ * @param cancel 非空时每段开始前检查（repackGzipBlocks / recompressGzip 相同），置位后跳过剩余的段，
+ *               返回 false，error 为 "Conversion cancelled"
+ */
+bool compressGzip(std::span<const uint8_t> inflated, int level, ThreadPool* pool, std::vector<uint8_t>& out,
+                  std::string& error, const std::atomic<bool>* cancel = nullptr);
+
+/**
+ * 块表的 JSON 成员，写入 KHR_gaussian_splatting_compression_spz_2 的 extras 对象：
+ *   "spz2glb:blocks":{"blockSize":B,"uncompressedSize":U,"crc32":C,"offsets":[...]}
+ * offsets 是各块在 gzip 流中的字节偏移，第 i 块解压后对应 [i * B, min((i + 1) * B, U))
+ */
+std::string formatGzipBlockTable(const GzipIndex& blocks);
+
+/**
+ * 从 glTF JSON 文本中找出 "spz2glb:blocks" 并还原块表
+ *
+ * payloadOffset / compressedSize 不在块表中，由调用方按 bufferView 填写
+ *
+ * @return 没有块表或格式错误时返回 false
+ */
+bool parseGzipBlockTable(std::string_view json, GzipIndex& blocks, std::string& error);
+
+}  // namespace spz2glb
+
+#endif  // SPZ2GLB_GZIP_INDEX_H_
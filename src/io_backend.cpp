@@ -0,0 +1,243 @@
+// Copyright (c) 2026 Pu Junhan
+// SPDX-License-Identifier: MIT
+// Project: SPZ-ecosystem
+// Repository: https://github.com/spz-ecosystem/spz2glb
+//
+// 异步 I/O 后端实现
+// io_uring 直接使用系统调用（不依赖 liburing），保持一键编译无额外依赖
+
+#include "io_backend.h"
+
+#ifndef _WIN32
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+
+#if defined(__linux__) && defined(SPZ2GLB_ENABLE_IO_URING) && __has_include(<linux/io_uring.h>)
+#define SPZ2GLB_HAVE_IO_URING 1
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#else
+#define SPZ2GLB_HAVE_IO_URING 0
+#endif
+
+namespace spz2glb {
+
+bool PosixIoBackend::submit(const IoRequest& request) {
+    ssize_t n;
+    do {
+        n = request.write
+            ? ::pwrite(request.fd, request.buffer, request.length, static_cast<off_t>(request.offset))
+            : ::pread(request.fd, request.buffer, request.length, static_cast<off_t>(request.offset));
+    } while (n < 0 && errno == EINTR);
+
+    completed_.push_back({request.tag, n < 0 ? -static_cast<int64_t>(errno) : static_cast<int64_t>(n)});
+    return true;
+}
+
+bool PosixIoBackend::wait(IoCompletion& completion) {
+    if (completed_.empty()) {
+        return false;
+    }
+    completion = completed_.front();
+    completed_.pop_front();
+    return true;
+}
+
+#if SPZ2GLB_HAVE_IO_URING
+
+namespace {
+
+/**
+ * io_uring 后端
+ *
+ * 提交队列（SQ）与完成队列（CQ）都是与内核共享的环形缓冲区：
+ * - submit 只填写 SQE 并推进 SQ tail，不进入内核
+ * - wait 时一次 io_uring_enter 同时提交所有新请求并等待完成
+ * 这样多个读写在一次系统调用中进入内核，NVMe 队列保持满载
+ */
+class IoUringBackend : public IoBackend {
+public:
+    ~IoUringBackend() override;
+
+    bool init(unsigned queueDepth);
+
+    bool submit(const IoRequest& request) override;
+    bool wait(IoCompletion& completion) override;
+    const char* name() const override { return "io_uring"; }
+
+private:
+    static unsigned load(const unsigned* p) {
+        return std::atomic_ref<unsigned>(*const_cast<unsigned*>(p)).load(std::memory_order_acquire);
+    }
+    static void store(unsigned* p, unsigned value) {
+        std::atomic_ref<unsigned>(*p).store(value, std::memory_order_release);
+    }
+
+    int ringFd_ = -1;
+    void* sqRing_ = nullptr;
+    void* cqRing_ = nullptr;
+    size_t sqRingSize_ = 0;
+    size_t cqRingSize_ = 0;
+    io_uring_sqe* sqes_ = nullptr;
+    size_t sqesSize_ = 0;
+
+    unsigned* sqHead_ = nullptr;
+    unsigned* sqTail_ = nullptr;
+    unsigned sqMask_ = 0;
+    unsigned sqEntries_ = 0;
+    unsigned* sqArray_ = nullptr;
+
+    unsigned* cqHead_ = nullptr;
+    unsigned* cqTail_ = nullptr;
+    unsigned cqMask_ = 0;
+    io_uring_cqe* cqes_ = nullptr;
+
+    unsigned toSubmit_ = 0;  // 已填写但尚未交给内核的 SQE
+    unsigned inFlight_ = 0;  // 已提交但尚未收割的请求
+};
+
+IoUringBackend::~IoUringBackend() {
+    if (sqes_) ::munmap(sqes_, sqesSize_);
+    if (cqRing_ && cqRing_ != sqRing_) ::munmap(cqRing_, cqRingSize_);
+    if (sqRing_) ::munmap(sqRing_, sqRingSize_);
+    if (ringFd_ >= 0) ::close(ringFd_);
+}
+
+bool IoUringBackend::init(unsigned queueDepth) {
+    io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+
+    ringFd_ = static_cast<int>(::syscall(__NR_io_uring_setup, queueDepth, &params));
+    if (ringFd_ < 0) {
+        return false;  // 内核不支持或被 seccomp 禁用
+    }
+
+    sqRingSize_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cqRingSize_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    bool singleMmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (singleMmap) {
+        sqRingSize_ = cqRingSize_ = std::max(sqRingSize_, cqRingSize_);
+    }
+
+    sqRing_ = ::mmap(nullptr, sqRingSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                     ringFd_, IORING_OFF_SQ_RING);
+    if (sqRing_ == MAP_FAILED) {
+        sqRing_ = nullptr;
+        return false;
+    }
+
+    if (singleMmap) {
+        cqRing_ = sqRing_;
+    } else {
+        cqRing_ = ::mmap(nullptr, cqRingSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                         ringFd_, IORING_OFF_CQ_RING);
+        if (cqRing_ == MAP_FAILED) {
+            cqRing_ = nullptr;
+            return false;
+        }
+    }
+
+    sqesSize_ = params.sq_entries * sizeof(io_uring_sqe);
+    void* sqes = ::mmap(nullptr, sqesSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                        ringFd_, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+        return false;
+    }
+    sqes_ = static_cast<io_uring_sqe*>(sqes);
+
+    auto* sq = static_cast<char*>(sqRing_);
+    sqHead_ = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+    sqTail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    sqMask_ = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    sqEntries_ = params.sq_entries;
+    sqArray_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+
+    auto* cq = static_cast<char*>(cqRing_);
+    cqHead_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    cqTail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    cqMask_ = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+    return true;
+}
+
+bool IoUringBackend::submit(const IoRequest& request) {
+    // 在途请求不超过 SQ 容量，CQ（默认 2 倍 SQ）就不会溢出
+    if (inFlight_ >= sqEntries_) {
+        return false;
+    }
+
+    unsigned tail = *sqTail_;
+    unsigned index = tail & sqMask_;
+    io_uring_sqe* sqe = &sqes_[index];
+    std::memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = request.write ? IORING_OP_WRITE : IORING_OP_READ;
+    sqe->fd = request.fd;
+    sqe->addr = reinterpret_cast<uint64_t>(request.buffer);
+    sqe->len = request.length;
+    sqe->off = request.offset;
+    sqe->user_data = request.tag;
+
+    sqArray_[index] = index;
+    store(sqTail_, tail + 1);
+
+    toSubmit_++;
+    inFlight_++;
+    return true;
+}
+
+bool IoUringBackend::wait(IoCompletion& completion) {
+    if (inFlight_ == 0) {
+        return false;
+    }
+
+    unsigned head = *cqHead_;
+    while (head == load(cqTail_) || toSubmit_ > 0) {
+        // 提交所有新请求；CQ 为空时同时等待至少一个完成事件
+        unsigned minComplete = head == load(cqTail_) ? 1 : 0;
+        int ret = static_cast<int>(::syscall(__NR_io_uring_enter, ringFd_, toSubmit_, minComplete,
+                                             minComplete ? IORING_ENTER_GETEVENTS : 0, nullptr, 0));
+        if (ret < 0) {
+            if (errno == EINTR || errno == EAGAIN || errno == EBUSY) continue;
+            return false;
+        }
+        toSubmit_ -= std::min(toSubmit_, static_cast<unsigned>(ret));
+        if (minComplete == 0) break;
+    }
+
+    const io_uring_cqe& cqe = cqes_[head & cqMask_];
+    completion.tag = cqe.user_data;
+    completion.result = cqe.res;
+    store(cqHead_, head + 1);
+
+    inFlight_--;
+    return true;
+}
+
+}  // anonymous namespace
+
+#endif  // SPZ2GLB_HAVE_IO_URING
+
+std::unique_ptr<IoBackend> IoBackend::create(IoBackendKind kind, unsigned queueDepth) {
+#if SPZ2GLB_HAVE_IO_URING
+    if (kind == IoBackendKind::IoUring) {
+        auto ring = std::make_unique<IoUringBackend>();
+        if (ring->init(queueDepth)) {
+            return ring;
+        }
+    }
+#else
+    (void)kind;
+    (void)queueDepth;
+#endif
+    return std::make_unique<PosixIoBackend>();
+}
+
+}  // namespace spz2glb
+
+#endif  // _WIN32
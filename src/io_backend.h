@@ -0,0 +1,75 @@
+// Copyright (c) 2026 Pu Junhan
+// SPDX-License-Identifier: MIT
+// Project: SPZ-ecosystem
+// Repository: https://github.com/spz-ecosystem/spz2glb
+//
+// 异步 I/O 后端
+// Linux 下通过 io_uring 保持大量读写请求在途；其他情况退化为阻塞的 pread/pwrite
+
+#ifndef SPZ2GLB_IO_BACKEND_H_
+#define SPZ2GLB_IO_BACKEND_H_
+
+#ifndef _WIN32
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+
+namespace spz2glb {
+
+enum class IoBackendKind {
+    Posix,    // 阻塞 pread/pwrite，submit 时立即完成
+    IoUring   // io_uring（不可用时 create 自动退化为 Posix）
+};
+
+struct IoRequest {
+    int fd;
+    void* buffer;
+    uint32_t length;
+    uint64_t offset;
+    bool write;
+    uint64_t tag;  // 调用方自定义，原样出现在完成事件中
+};
+
+struct IoCompletion {
+    uint64_t tag;
+    int64_t result;  // 传输的字节数，或 -errno
+};
+
+/**
+ * I/O 后端接口（单线程使用：同一实例只能由一个线程提交和收割）
+ *
+ * 读写都可能只完成一部分，调用方负责为剩余部分重新提交
+ */
+class IoBackend {
+public:
+    virtual ~IoBackend() = default;
+
+    // 排队一个请求；队列满时返回 false（先收割完成事件再重试）
+    virtual bool submit(const IoRequest& request) = 0;
+
+    // 等待至少一个完成事件；没有在途请求时返回 false
+    virtual bool wait(IoCompletion& completion) = 0;
+
+    virtual const char* name() const = 0;
+
+    // queueDepth 为最多同时在途的请求数
+    static std::unique_ptr<IoBackend> create(IoBackendKind kind, unsigned queueDepth);
+};
+
+class PosixIoBackend : public IoBackend {
+public:
+    bool submit(const IoRequest& request) override;
+    bool wait(IoCompletion& completion) override;
+    const char* name() const override { return "posix"; }
+
+private:
+    std::deque<IoCompletion> completed_;
+};
+
+}  // namespace spz2glb
+
+#endif  // _WIN32
+
+#endif  // SPZ2GLB_IO_BACKEND_H_
@@ -0,0 +1,398 @@
+// Copyright (c) 2026 Pu Junhan
+// SPDX-License-Identifier: MIT
+// Project: SPZ-ecosystem
+// Repository: https://github.com/spz-ecosystem/spz2glb
+//
+// 有界 读取 → 转换 → 写出 流水线实现
+
+#include "io_pipeline.h"
+
+#ifndef _WIN32
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "conversion_cache.h"
+#include "glb_writer.h"
+#include "spz_converter.h"
+
+namespace spz2glb {
+
+namespace {
+
+// 单个请求的最大长度（SQE 的 len 为 32 位，Linux 单次读写也不超过约 2 GB）
+constexpr uint64_t kMaxChunk = 1ull << 30;
+
+enum Op : uint64_t {
+    OpRead = 0,
+    OpWritePreamble = 1,
+    OpWritePayload = 2,
+    OpWritePadding = 3,
+    OpCount = 4
+};
+
+/**
+ * 一个在途文件的状态
+ *
+ * 输入缓冲区在文件之间复用（只在容量不足时重新分配），
+ * 批量转换时分配器只在开始阶段预热一次；
+ * 复用的缓冲区只增不减，因此内存上限按容量计，超出时先释放空闲 slot 的缓冲区
+ */
+struct Slot {
+    const BatchJob* job = nullptr;
+    int inFd = -1;
+    std::unique_ptr<OutputFile> out;  // 临时文件，成功时 commit 为输出路径
+
+    std::unique_ptr<uint8_t[]> buffer;
+    size_t capacity = 0;
+    size_t size = 0;
+
+    SpzResult preamble;
+    GlbLayout layout = {};
+
+    uint64_t done[OpCount] = {};  // 每个操作已完成的字节数
+    unsigned pending = 0;         // 在途请求数
+    std::string cacheKey;         // 为空表示未启用缓存或已命中
+    bool failed = false;
+    std::string error;
+    std::chrono::steady_clock::time_point start;
+};
+
+class Pipeline {
+public:
+    Pipeline(const std::vector<BatchJob>& jobs, std::atomic<size_t>& cursor,
+             const PipelineOptions& options, const PipelineCallback& onFileDone)
+        : jobs_(jobs), cursor_(cursor), options_(options), onFileDone_(onFileDone),
+          slots_(std::max(1u, options.filesInFlight)) {
+        // 每个文件最多 3 个写请求同时在途
+        io_ = IoBackend::create(options.backend, static_cast<unsigned>(slots_.size() * 3));
+    }
+
+    const char* run();
+
+private:
+    static uint64_t tagFor(size_t slot, Op op) { return slot * OpCount + op; }
+
+    bool admit();
+    void releaseIdleBuffers();
+    void startFile(size_t index, const BatchJob* job);
+    void submitOp(size_t index, Op op);
+    void onCompletion(const IoCompletion& completion);
+    void onReadComplete(size_t index);
+    void fail(size_t index, std::string error);
+    void finish(size_t index);
+
+    // 各操作对应的 (缓冲区, 长度, 文件偏移)
+    const uint8_t* opData(const Slot& slot, Op op) const;
+    uint64_t opLength(const Slot& slot, Op op) const;
+    uint64_t opOffset(const Slot& slot, Op op) const;
+
+    const std::vector<BatchJob>& jobs_;
+    std::atomic<size_t>& cursor_;
+    PipelineOptions options_;
+    const PipelineCallback& onFileDone_;
+
+    std::unique_ptr<IoBackend> io_;
+    std::vector<Slot> slots_;
+    size_t active_ = 0;
+    uint64_t bufferedBytes_ = 0;  // 各 slot 输入缓冲区容量之和（包括空闲 slot 保留的）
+    bool exhausted_ = false;
+};
+
+const uint8_t* Pipeline::opData(const Slot& slot, Op op) const {
+    static const uint8_t zeros[4] = {0, 0, 0, 0};
+    switch (op) {
+        case OpRead: return slot.buffer.get();
+        case OpWritePreamble: return slot.preamble.data.data();
+        case OpWritePayload: return slot.buffer.get();
+        default: return zeros;
+    }
+}
+
+uint64_t Pipeline::opLength(const Slot& slot, Op op) const {
+    switch (op) {
+        case OpRead: return slot.size;
+        case OpWritePreamble: return slot.preamble.data.size();
+        case OpWritePayload: return slot.size;
+        default: return slot.layout.binPadding;
+    }
+}
+
+uint64_t Pipeline::opOffset(const Slot& slot, Op op) const {
+    switch (op) {
+        case OpRead: return 0;
+        case OpWritePreamble: return 0;
+        case OpWritePayload: return slot.preamble.data.size();
+        default: return slot.preamble.data.size() + slot.size;
+    }
+}
+
+void Pipeline::submitOp(size_t index, Op op) {
+    Slot& slot = slots_[index];
+    uint64_t done = slot.done[op];
+    uint64_t length = std::min(opLength(slot, op) - done, kMaxChunk);
+
+    IoRequest request;
+    request.fd = op == OpRead ? slot.inFd : slot.out->fd();
+    request.buffer = const_cast<uint8_t*>(opData(slot, op)) + done;
+    request.length = static_cast<uint32_t>(length);
+    request.offset = opOffset(slot, op) + done;
+    request.write = op != OpRead;
+    request.tag = tagFor(index, op);
+
+    // 队列满时先收割一个完成事件腾出位置
+    while (!io_->submit(request)) {
+        IoCompletion completion;
+        if (!io_->wait(completion)) break;
+        onCompletion(completion);
+    }
+    slot.pending++;
+}
+
+bool Pipeline::admit() {
+    if (exhausted_ || active_ == slots_.size()) {
+        return false;
+    }
+
+    size_t free = 0;
+    while (slots_[free].job != nullptr) ++free;
+
+    size_t next = cursor_.load(std::memory_order_relaxed);
+    if (next >= jobs_.size()) {
+        exhausted_ = true;
+        return false;
+    }
+    // 内存上限：按这个文件装入 free 后的缓冲区总容量计；超出时先释放空闲 slot 的缓冲区，
+    // 仍然超出且已有文件在途时，留给后面（或其他流水线）
+    auto overBudget = [&] {
+        uint64_t capacity = slots_[free].capacity;
+        return bufferedBytes_ - capacity + std::max<uint64_t>(capacity, jobs_[next].inputBytes) >
+               options_.maxInflightBytes;
+    };
+    if (overBudget()) {
+        releaseIdleBuffers();
+        if (active_ > 0 && overBudget()) {
+            return false;
+        }
+    }
+    next = cursor_.fetch_add(1, std::memory_order_relaxed);
+    if (next >= jobs_.size()) {
+        exhausted_ = true;
+        return false;
+    }
+
+    startFile(free, &jobs_[next]);
+    return true;
+}
+
+void Pipeline::releaseIdleBuffers() {
+    for (auto& slot : slots_) {
+        if (slot.job == nullptr && slot.capacity > 0) {
+            bufferedBytes_ -= slot.capacity;
+            slot.buffer.reset();
+            slot.capacity = 0;
+        }
+    }
+}
+
+void Pipeline::startFile(size_t index, const BatchJob* job) {
+    Slot& slot = slots_[index];
+    slot.job = job;
+    slot.failed = false;
+    slot.error.clear();
+    slot.pending = 0;
+    slot.size = 0;
+    slot.cacheKey.clear();
+    std::fill(std::begin(slot.done), std::end(slot.done), 0);
+    slot.layout = {};
+    slot.start = std::chrono::steady_clock::now();
+    active_++;
+
+    slot.inFd = ::open(job->inputPath.c_str(), O_RDONLY);
+    struct stat st;
+    if (slot.inFd < 0 || ::fstat(slot.inFd, &st) != 0) {
+        fail(index, "Cannot open SPZ file: " + job->inputPath);
+        finish(index);
+        return;
+    }
+    slot.size = static_cast<size_t>(st.st_size);
+
+    if (slot.capacity < slot.size) {
+        slot.buffer.reset();
+        bufferedBytes_ += slot.size - slot.capacity;
+        slot.buffer.reset(new uint8_t[slot.size]);
+        slot.capacity = slot.size;
+    }
+
+    if (slot.size == 0) {
+        onReadComplete(index);
+        return;
+    }
+    submitOp(index, OpRead);
+}
+
+void Pipeline::onReadComplete(size_t index) {
+    Slot& slot = slots_[index];
+    ::close(slot.inFd);
+    slot.inFd = -1;
+
+    // CPU 阶段：解析头并生成前导；io_uring 后端下其他文件的读写此时仍在内核中进行
+    ConvertOptions convertOptions;
+    convertOptions.verbose = false;
+    std::span<const uint8_t> input(slot.buffer.get(), slot.size);
+
+    if (options_.cache != nullptr) {
+        std::string key = ConversionCache::keyFor(input, convertOptions);
+        uint64_t glbBytes = 0;
+        if (options_.cache->fetch(key, slot.job->outputPath, glbBytes)) {
+            slot.layout.totalLength = static_cast<uint32_t>(glbBytes);
+            finish(index);
+            return;
+        }
+        slot.cacheKey = std::move(key);
+    }
+
+    slot.preamble = buildGlbPreamble(input, slot.layout, convertOptions);
+    if (!slot.preamble.success) {
+        fail(index, slot.preamble.errorMessage);
+        finish(index);
+        return;
+    }
+
+    slot.out = std::make_unique<OutputFile>();
+    if (!slot.out->open(slot.job->outputPath)) {
+        slot.out.reset();
+        fail(index, "Cannot open output file: " + slot.job->outputPath);
+        finish(index);
+        return;
+    }
+
+    // 提交期间多占一个 pending，避免 submitOp 收割到本文件的完成事件时提前收尾
+    slot.pending++;
+    submitOp(index, OpWritePreamble);
+    if (slot.size > 0) submitOp(index, OpWritePayload);
+    if (slot.layout.binPadding > 0) submitOp(index, OpWritePadding);
+    if (--slot.pending == 0) {
+        finish(index);
+    }
+}
+
+void Pipeline::onCompletion(const IoCompletion& completion) {
+    size_t index = static_cast<size_t>(completion.tag / OpCount);
+    Op op = static_cast<Op>(completion.tag % OpCount);
+    Slot& slot = slots_[index];
+    slot.pending--;
+
+    if (completion.result == -EINTR || completion.result == -EAGAIN) {
+        if (!slot.failed) submitOp(index, op);
+    } else if (completion.result < 0) {
+        fail(index, std::string(op == OpRead ? "Read failed: " : "Write failed: ") +
+                        std::strerror(static_cast<int>(-completion.result)));
+    } else if (completion.result == 0 && slot.done[op] < opLength(slot, op)) {
+        fail(index, op == OpRead ? "Unexpected end of SPZ file" : "Write returned no progress");
+    } else if (!slot.failed) {
+        slot.done[op] += static_cast<uint64_t>(completion.result);
+        if (slot.done[op] < opLength(slot, op)) {
+            submitOp(index, op);  // 部分完成，继续提交剩余部分
+        } else if (op == OpRead) {
+            onReadComplete(index);
+            return;
+        }
+    }
+
+    if (slot.pending == 0 && slot.job != nullptr && slot.inFd < 0) {
+        finish(index);
+    }
+}
+
+void Pipeline::fail(size_t index, std::string error) {
+    Slot& slot = slots_[index];
+    if (!slot.failed) {
+        slot.failed = true;
+        slot.error = std::move(error);
+    }
+    if (slot.inFd >= 0 && slot.pending == 0) {
+        ::close(slot.inFd);
+        slot.inFd = -1;
+    }
+}
+
+void Pipeline::finish(size_t index) {
+    Slot& slot = slots_[index];
+    if (slot.job == nullptr) {
+        return;
+    }
+
+    bool ok = !slot.failed;
+    if (slot.out != nullptr) {
+        if (ok && !slot.out->commit()) {
+            ok = false;
+            slot.error = "Failed to write GLB: " + slot.job->outputPath;
+        }
+        // 写失败或未提交时析构删除临时文件，用户已有的输出保持原样
+        slot.out.reset();
+    }
+    if (ok && !slot.cacheKey.empty()) {
+        options_.cache->store(slot.cacheKey, slot.job->outputPath);
+    }
+
+    PipelineResult result;
+    result.job = slot.job;
+    result.success = ok;
+    result.errorMessage = slot.error;
+    result.outputBytes = ok ? slot.layout.totalLength : 0;
+    result.milliseconds = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - slot.start).count();
+    onFileDone_(result);
+
+    slot.job = nullptr;
+    slot.preamble = {};
+    active_--;
+}
+
+const char* Pipeline::run() {
+    for (;;) {
+        while (admit()) {}
+        if (active_ == 0) {
+            break;
+        }
+
+        IoCompletion completion;
+        if (!io_->wait(completion)) {
+            // 没有在途请求但仍有活动文件：只可能是失败后等待收尾的文件
+            for (size_t i = 0; i < slots_.size(); ++i) {
+                if (slots_[i].job != nullptr && slots_[i].pending == 0) {
+                    if (slots_[i].inFd >= 0) {
+                        ::close(slots_[i].inFd);
+                        slots_[i].inFd = -1;
+                    }
+                    if (!slots_[i].failed) fail(i, "I/O backend error");
+                    finish(i);
+                }
+            }
+            continue;
+        }
+        onCompletion(completion);
+    }
+    return io_->name();
+}
+
+}  // anonymous namespace
+
+const char* runIoPipeline(const std::vector<BatchJob>& jobs,
+                          std::atomic<size_t>& cursor,
+                          const PipelineOptions& options,
+                          const PipelineCallback& onFileDone) {
+    Pipeline pipeline(jobs, cursor, options, onFileDone);
+    return pipeline.run();
+}
+
+}  // namespace spz2glb
+
+#endif  // _WIN32
@@ -0,0 +1,67 @@
+// Copyright (c) 2026 Pu Junhan
+// SPDX-License-Identifier: MIT
+// Project: SPZ-ecosystem
+// Repository: https://github.com/spz-ecosystem/spz2glb
+//
+// 有界 读取 → 转换 → 写出 流水线（批量转换使用）
+
+#ifndef SPZ2GLB_IO_PIPELINE_H_
+#define SPZ2GLB_IO_PIPELINE_H_
+
+#ifndef _WIN32
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "batch_convert.h"
+#include "io_backend.h"
+
+namespace spz2glb {
+
+class ConversionCache;
+
+struct PipelineOptions {
+    IoBackendKind backend = IoBackendKind::IoUring;
+    ConversionCache* cache = nullptr;
+    unsigned filesInFlight = 8;                       // 每个流水线同时处理的文件数
+    uint64_t maxInflightBytes = 512ull * 1024 * 1024;  // 每个流水线输入缓冲区的总容量上限
+};
+
+struct PipelineResult {
+    const BatchJob* job;
+    bool success;
+    std::string errorMessage;
+    uint64_t outputBytes;
+    double milliseconds;
+};
+
+using PipelineCallback = std::function<void(const PipelineResult&)>;
+
+/**
+ * 运行一条流水线，直到 jobs 全部被领取并完成
+ *
+ * 多条流水线（每个线程一条，各自一个 io_uring）可共享同一个 cursor，
+ * 按 jobs 的顺序领取文件（调用方按大小降序排好即为大文件优先）
+ *
+ * 每个文件：读入整个输入 → 解析头并生成 GLB 前导 → 写出前导、负载与填充。
+ * io_uring 后端下读写是异步的，某个文件在转换时其余文件的读写仍在内核中进行；
+ * posix 后端在 submit 时同步完成读写，各文件实际上依次处理，没有重叠。
+ * 在途文件数与输入缓冲区总容量都有上限（缓冲区在文件间复用，按容量而不是文件大小计），
+ * 单个文件超过上限时独占流水线处理，内存占用有界
+ *
+ * @return 实际使用的后端名（io_uring 不可用时为 posix）
+ */
+const char* runIoPipeline(const std::vector<BatchJob>& jobs,
+                          std::atomic<size_t>& cursor,
+                          const PipelineOptions& options,
+                          const PipelineCallback& onFileDone);
+
+}  // namespace spz2glb
+
+#endif  // _WIN32
+
+#endif  // SPZ2GLB_IO_PIPELINE_H_
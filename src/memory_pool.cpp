@@ -0,0 +1,206 @@
+// Copyright (c) 2026 Pu Junhan
+// SPDX-License-Identifier: MIT
+// Project: SPZ-ecosystem
+// Repository: https://github.com/spz-ecosystem/spz2glb
+//
+// 内存记账实现
+
+#include "memory_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+
+namespace spz2glb {
+
+namespace {
+
+// 长度头：16 字节，保证返回地址仍满足 malloc 的基本对齐
+constexpr size_t kHeaderBytes = 16;
+
+struct StageCounters {
+    std::atomic<size_t> peak{0};
+    std::atomic<size_t> allocations{0};
+    std::atomic<size_t> bytes{0};
+};
+
+std::atomic<size_t> g_current{0};
+std::atomic<size_t> g_peak{0};
+std::atomic<size_t> g_allocations{0};
+std::atomic<size_t> g_frees{0};
+std::atomic<size_t> g_failed{0};
+std::atomic<ptrdiff_t> g_workUsed{0};
+std::atomic<ptrdiff_t> g_workCapacity{0};
+std::atomic<ptrdiff_t> g_hotAllocations{0};
+std::atomic<ptrdiff_t> g_hotAvailable{0};
+StageCounters g_stages[kMemoryStageCount];
+
+thread_local MemoryStage t_stage = MemoryStage::None;
+
+void raise(std::atomic<size_t>& peak, size_t value) {
+    size_t seen = peak.load(std::memory_order_relaxed);
+    while (value > seen && !peak.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {
+    }
+}
+
+void recordAllocation(size_t size) {
+    size_t current = g_current.fetch_add(size, std::memory_order_relaxed) + size;
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    raise(g_peak, current);
+    if (t_stage != MemoryStage::None) {
+        StageCounters& stage = g_stages[static_cast<size_t>(t_stage)];
+        stage.allocations.fetch_add(1, std::memory_order_relaxed);
+        stage.bytes.fetch_add(size, std::memory_order_relaxed);
+        raise(stage.peak, current);
+    }
+}
+
+void recordFree(size_t size) {
+    g_current.fetch_sub(size, std::memory_order_relaxed);
+    g_frees.fetch_add(1, std::memory_order_relaxed);
+}
+
+size_t nonNegative(ptrdiff_t value) {
+    return value > 0 ? static_cast<size_t>(value) : 0;
+}
+
+}  // anonymous namespace
+
+const char* memoryStageName(MemoryStage stage) {
+    switch (stage) {
+        case MemoryStage::None: return "none";
+        case MemoryStage::Read: return "read";
+        case MemoryStage::Inflate: return "inflate";
+        case MemoryStage::Build: return "build";
+        case MemoryStage::Write: return "write";
+        case MemoryStage::Verify: return "verify";
+    }
+    return "unknown";
+}
+
+void* trackedAlloc(size_t size) {
+    if (size > SIZE_MAX - kHeaderBytes) {
+        g_failed.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    auto* base = static_cast<unsigned char*>(std::malloc(size + kHeaderBytes));
+    if (base == nullptr) {
+        g_failed.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    std::memcpy(base, &size, sizeof(size));
+    recordAllocation(size);
+    return base + kHeaderBytes;
+}
+
+void trackedFree(void* ptr) {
+    if (ptr == nullptr) return;
+    auto* base = static_cast<unsigned char*>(ptr) - kHeaderBytes;
+    size_t size = 0;
+    std::memcpy(&size, base, sizeof(size));
+    recordFree(size);
+    std::free(base);
+}
+
+void* trackedAlignedAlloc(size_t size, size_t alignment) {
+    size_t header = std::max(alignment, kHeaderBytes);
+    if (size > SIZE_MAX - 2 * header) {
+        g_failed.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    // aligned_alloc 要求长度是对齐的整数倍；MSVC 没有 aligned_alloc
+#if defined(_WIN32)
+    auto* base = static_cast<unsigned char*>(_aligned_malloc(size + header, alignment));
+#else
+    auto* base = static_cast<unsigned char*>(
+        std::aligned_alloc(alignment, (size + header + alignment - 1) / alignment * alignment));
+#endif
+    if (base == nullptr) {
+        g_failed.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    // 长度写在返回地址之前的 16 字节中
+    std::memcpy(base + header - kHeaderBytes, &size, sizeof(size));
+    recordAllocation(size);
+    return base + header;
+}
+
+void trackedAlignedFree(void* ptr, size_t alignment) {
+    if (ptr == nullptr) return;
+    size_t header = std::max(alignment, kHeaderBytes);
+    auto* base = static_cast<unsigned char*>(ptr) - header;
+    size_t size = 0;
+    std::memcpy(&size, base + header - kHeaderBytes, sizeof(size));
+    recordFree(size);
+#if defined(_WIN32)
+    _aligned_free(base);
+#else
+    std::free(base);
+#endif
+}
+
+MemoryStats getMemoryStats() {
+    MemoryStats stats = {};
+    stats.peak_usage = g_peak.load(std::memory_order_relaxed);
+    stats.current_usage = g_current.load(std::memory_order_relaxed);
+    stats.hot_allocations = nonNegative(g_hotAllocations.load(std::memory_order_relaxed));
+    stats.hot_available = nonNegative(g_hotAvailable.load(std::memory_order_relaxed));
+    ptrdiff_t workUsed = g_workUsed.load(std::memory_order_relaxed);
+    stats.work_used = nonNegative(workUsed);
+    stats.work_remaining = nonNegative(g_workCapacity.load(std::memory_order_relaxed) - workUsed);
+    stats.total_allocations = g_allocations.load(std::memory_order_relaxed);
+    stats.total_frees = g_frees.load(std::memory_order_relaxed);
+    stats.failed_allocations = g_failed.load(std::memory_order_relaxed);
+    return stats;
+}
+
+StageMemoryStats getStageMemoryStats(MemoryStage stage) {
+    const StageCounters& counters = g_stages[static_cast<size_t>(stage)];
+    return {counters.peak.load(std::memory_order_relaxed), counters.allocations.load(std::memory_order_relaxed),
+            counters.bytes.load(std::memory_order_relaxed)};
+}
+
+void resetMemoryStats() {
+    g_peak.store(g_current.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    g_allocations.store(0, std::memory_order_relaxed);
+    g_frees.store(0, std::memory_order_relaxed);
+    g_failed.store(0, std::memory_order_relaxed);
+    for (auto& stage : g_stages) {
+        stage.peak.store(0, std::memory_order_relaxed);
+        stage.allocations.store(0, std::memory_order_relaxed);
+        stage.bytes.store(0, std::memory_order_relaxed);
+    }
+}
+
+MemoryStage currentMemoryStage() {
+    return t_stage;
+}
+
+MemoryStageScope::MemoryStageScope(MemoryStage stage) : previous_(t_stage) {
+    t_stage = stage;
+    if (stage != MemoryStage::None) {
+        // 进入阶段时已有的用量也算在阶段峰值内
+        raise(g_stages[static_cast<size_t>(stage)].peak, g_current.load(std::memory_order_relaxed));
+    }
+}
+
+MemoryStageScope::~MemoryStageScope() {
+    t_stage = previous_;
+}
+
+namespace detail {
+
+void adjustWorkMemory(ptrdiff_t usedDelta, ptrdiff_t capacityDelta) {
+    g_workUsed.fetch_add(usedDelta, std::memory_order_relaxed);
+    g_workCapacity.fetch_add(capacityDelta, std::memory_order_relaxed);
+}
+
+void adjustHotObjects(ptrdiff_t allocationsDelta, ptrdiff_t availableDelta) {
+    g_hotAllocations.fetch_add(allocationsDelta, std::memory_order_relaxed);
+    g_hotAvailable.fetch_add(availableDelta, std::memory_order_relaxed);
+}
+
+}  // namespace detail
+
+}  // namespace spz2glb
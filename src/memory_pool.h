@@ -11,15 +11,86 @@
 
 namespace spz2glb {
 
+/**
+ * 内存统计
+ *
+ * 堆用量来自带长度头的分配记账（trackedAlloc / trackedFree）：spz2glb_alloc 总是经过它；
+ * 链接了 memory_tracking.cpp 的程序（spz2glb、spz2glb_bench、WASM 模块）的全部 operator new 也经过它，
+ * 否则只统计 spz2glb_alloc 的缓冲区。工作区与热对象池统计所有存活的 BumpAllocator / HotObjectPool
+ */
 struct MemoryStats {
+    size_t peak_usage;       // 堆用量峰值（字节，resetMemoryStats 后从当前用量重新开始）
+    size_t current_usage;    // 当前堆用量（字节，不含长度头）
+    size_t hot_allocations;  // HotObjectPool 累计分配次数
+    size_t hot_available;    // HotObjectPool 空闲对象数
+    size_t work_used;        // BumpAllocator 已用字节数
+    size_t work_remaining;   // BumpAllocator 剩余字节数
+    size_t total_allocations;   // 累计分配次数
+    size_t total_frees;         // 累计释放次数
+    size_t failed_allocations;  // 失败的分配次数
+};
+
+/**
+ * 转换阶段，与 ConversionStage 同名（多一个 verify）；None 表示不在任何阶段中
+ */
+enum class MemoryStage : uint8_t { None, Read, Inflate, Build, Write, Verify };
+constexpr size_t kMemoryStageCount = 6;
+
+const char* memoryStageName(MemoryStage stage);
+
+/**
+ * 一个阶段的内存统计：阶段内（包括 parallelFor 派给工作线程的部分）的分配次数与字节数，
+ * 以及阶段进行期间观察到的进程堆用量峰值
+ */
+struct StageMemoryStats {
     size_t peak_usage;
-    size_t current_usage;
-    size_t hot_allocations;
-    size_t hot_available;
-    size_t work_used;
-    size_t work_remaining;
+    size_t allocations;
+    size_t allocated_bytes;
+};
+
+/**
+ * 分配一块记账内存：实际分配 size + 16 字节，长度写在头部，返回头部之后（16 字节对齐）的地址
+ *
+ * @return 失败时为 nullptr（计入 failed_allocations）
+ */
+void* trackedAlloc(size_t size);
+
+// 释放 trackedAlloc 返回的内存（nullptr 为空操作），按头部记录的长度减少当前用量
+void trackedFree(void* ptr);
+
+// 对齐版本：头部占 max(alignment, 16) 字节，释放时必须给出相同的 alignment
+void* trackedAlignedAlloc(size_t size, size_t alignment);
+void trackedAlignedFree(void* ptr, size_t alignment);
+
+MemoryStats getMemoryStats();
+StageMemoryStats getStageMemoryStats(MemoryStage stage);
+
+// 清零计数与各阶段统计，峰值从当前用量重新开始；当前用量保留（仍有存活的分配）
+void resetMemoryStats();
+
+MemoryStage currentMemoryStage();
+
+/**
+ * 作用域内当前线程的分配计入 stage，析构时恢复外层阶段
+ */
+class MemoryStageScope {
+public:
+    explicit MemoryStageScope(MemoryStage stage);
+    ~MemoryStageScope();
+
+    MemoryStageScope(const MemoryStageScope&) = delete;
+    MemoryStageScope& operator=(const MemoryStageScope&) = delete;
+
+private:
+    MemoryStage previous_;
 };
 
+namespace detail {
+// BumpAllocator / HotObjectPool 的用量变化，汇总到 getMemoryStats
+void adjustWorkMemory(ptrdiff_t usedDelta, ptrdiff_t capacityDelta);
+void adjustHotObjects(ptrdiff_t allocationsDelta, ptrdiff_t availableDelta);
+}  // namespace detail
+
 class BumpAllocator {
 private:
     char* pool_;
@@ -31,20 +102,24 @@ private:
 public:
     BumpAllocator() : pool_(nullptr), current_(nullptr), end_(nullptr), peak_usage_(0), allocations_(0) {}
 
-    BumpAllocator(size_t size) : pool_(new char[size]), current_(pool_), end_(pool_ + size), peak_usage_(0), allocations_(0) {}
+    BumpAllocator(size_t size) : pool_(new char[size]), current_(pool_), end_(pool_ + size), peak_usage_(0), allocations_(0) {
+        detail::adjustWorkMemory(0, static_cast<ptrdiff_t>(size));
+    }
 
     bool init(size_t size) {
+        release();
         pool_ = new char[size];
         if (!pool_) return false;
         current_ = pool_;
         end_ = pool_ + size;
         peak_usage_ = 0;
         allocations_ = 0;
+        detail::adjustWorkMemory(0, static_cast<ptrdiff_t>(size));
         return true;
     }
 
     ~BumpAllocator() {
-        delete[] pool_;
+        release();
     }
 
     void* alloc(size_t size) {
@@ -53,6 +128,7 @@ public:
         }
         void* ptr = current_;
         current_ += size;
+        detail::adjustWorkMemory(static_cast<ptrdiff_t>(size), 0);
         size_t used = static_cast<size_t>(current_ - pool_);
         if (used > peak_usage_) {
             peak_usage_ = used;
@@ -62,6 +138,7 @@ public:
     }
 
     void reset() {
+        detail::adjustWorkMemory(-static_cast<ptrdiff_t>(used()), 0);
         current_ = pool_;
     }
 
@@ -69,6 +146,15 @@ public:
     size_t peak_usage() const { return peak_usage_; }
     size_t remaining() const { return static_cast<size_t>(end_ - current_); }
     size_t allocations() const { return allocations_; }
+
+private:
+    void release() {
+        if (pool_) {
+            detail::adjustWorkMemory(-static_cast<ptrdiff_t>(used()), -static_cast<ptrdiff_t>(end_ - pool_));
+        }
+        delete[] pool_;
+        pool_ = current_ = end_ = nullptr;
+    }
 };
 
 template<size_t ObjectSize, uint32_t PoolSize>
@@ -91,6 +177,11 @@ public:
             node->next = freeList_;
             freeList_ = node;
         }
+        detail::adjustHotObjects(0, PoolSize);
+    }
+
+    ~HotObjectPool() {
+        detail::adjustHotObjects(-static_cast<ptrdiff_t>(allocations_), -static_cast<ptrdiff_t>(available()));
     }
 
     void* alloc() {
@@ -98,6 +189,7 @@ public:
         auto* node = freeList_;
         freeList_ = freeList_->next;
         allocations_++;
+        detail::adjustHotObjects(1, -1);
         return node;
     }
 
@@ -105,6 +197,7 @@ public:
         auto* node = reinterpret_cast<FreeNode*>(ptr);
         node->next = freeList_;
         freeList_ = node;
+        detail::adjustHotObjects(0, 1);
     }
 
     uint32_t available() const {
@@ -116,10 +209,6 @@ public:
     uint32_t allocations() const { return allocations_; }
 };
 
-inline MemoryStats getMemoryStats() {
-    return {0, 0, 0, 0, 0, 0};
-}
-
 }
 
 #endif
@@ -0,0 +1,62 @@
+// Copyright (c) 2026 Pu Junhan
+// SPDX-License-Identifier: MIT
+// Project: SPZ-ecosystem
+// Repository: https://github.com/spz-ecosystem/spz2glb
+//
+// 全局 operator new / delete 替换：所有堆分配经 trackedAlloc 记账（getMemoryStats）
+//
+// 只链接进可执行文件（spz2glb、spz2glb_bench、WASM 模块），不放进 spz2glb_core：
+// 库不替换宿主程序的分配器，宿主需要完整的统计时把本文件加入自己的可执行文件
+
+#include <cstdlib>
+#include <new>
+
+#include "memory_pool.h"
+
+namespace {
+
+void* allocateOrThrow(size_t size) {
+    if (void* ptr = spz2glb::trackedAlloc(size == 0 ? 1 : size)) return ptr;
+#if defined(__cpp_exceptions)
+    throw std::bad_alloc();
+#else
+    std::abort();
+#endif
+}
+
+void* allocateAlignedOrThrow(size_t size, std::align_val_t alignment) {
+    if (void* ptr = spz2glb::trackedAlignedAlloc(size == 0 ? 1 : size, static_cast<size_t>(alignment))) return ptr;
+#if defined(__cpp_exceptions)
+    throw std::bad_alloc();
+#else
+    std::abort();
+#endif
+}
+
+}  // anonymous namespace
+
+void* operator new(size_t size) { return allocateOrThrow(size); }
+void* operator new[](size_t size) { return allocateOrThrow(size); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return spz2glb::trackedAlloc(size == 0 ? 1 : size); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return spz2glb::trackedAlloc(size == 0 ? 1 : size); }
+void* operator new(size_t size, std::align_val_t alignment) { return allocateAlignedOrThrow(size, alignment); }
+void* operator new[](size_t size, std::align_val_t alignment) { return allocateAlignedOrThrow(size, alignment); }
+
+void operator delete(void* ptr) noexcept { spz2glb::trackedFree(ptr); }
+void operator delete[](void* ptr) noexcept { spz2glb::trackedFree(ptr); }
+void operator delete(void* ptr, size_t) noexcept { spz2glb::trackedFree(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { spz2glb::trackedFree(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { spz2glb::trackedFree(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { spz2glb::trackedFree(ptr); }
+void operator delete(void* ptr, std::align_val_t alignment) noexcept {
+    spz2glb::trackedAlignedFree(ptr, static_cast<size_t>(alignment));
+}
+void operator delete[](void* ptr, std::align_val_t alignment) noexcept {
+    spz2glb::trackedAlignedFree(ptr, static_cast<size_t>(alignment));
+}
+void operator delete(void* ptr, size_t, std::align_val_t alignment) noexcept {
+    spz2glb::trackedAlignedFree(ptr, static_cast<size_t>(alignment));
+}
+void operator delete[](void* ptr, size_t, std::align_val_t alignment) noexcept {
+    spz2glb::trackedAlignedFree(ptr, static_cast<size_t>(alignment));
+}
@@ -0,0 +1,630 @@
+// Copyright (c) 2026 Pu Junhan
+// SPDX-License-Identifier: MIT
+// Project: SPZ-ecosystem
+// Repository: https://github.com/spz-ecosystem/spz2glb
+//
+// 最高压缩比 deflate 编码器实现
+//
+// 每个 deflate 块（64 KB 输入）：
+// 1. 哈希链穷举窗口内的候选，记录每个位置“每种长度的最近距离”（按长度递增的断点）
+// 2. 按当前代价模型（每个符号的位数）在位置图上求最短路径，得到 LZ77 解析
+// 3. 用解析结果的符号频率重新估计代价（熵），回到 2；保留实际编码最小的一次
+// 4. 在动态哈夫曼、固定哈夫曼和存储块中选最小的写出
+
+#include "optimal_deflate.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace spz2glb {
+
+namespace {
+
+constexpr size_t kWindowSize = 32768;
+constexpr size_t kBlockBytes = 65536;  // 每个 deflate 块的输入字节数
+constexpr unsigned kMinMatch = 3;
+constexpr unsigned kMaxMatch = 258;
+constexpr unsigned kMaxChain = 1024;   // 每个位置最多检查的候选数
+constexpr unsigned kHashBits = 15;
+constexpr unsigned kNumLitlen = 288;
+constexpr unsigned kNumDist = 30;
+constexpr unsigned kNumPrecode = 19;
+constexpr unsigned kEndOfBlock = 256;
+
+constexpr uint16_t kLengthBase[29] = {3,  4,  5,  6,  7,  8,  9,  10, 11,  13,  15,  17,  19,  23, 27,
+                                      31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+constexpr uint8_t kLengthExtra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2,
+                                      2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+constexpr uint16_t kDistBase[30] = {1,   2,   3,   4,   5,   7,    9,    13,   17,   25,   33,   49,    65,    97,    129,
+                                    193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+constexpr uint8_t kDistExtra[30] = {0, 0, 0, 0, 1, 1, 2, 2,  3,  3,  4,  4,  5,  5,  6,
+                                    6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+constexpr uint8_t kPrecodeOrder[kNumPrecode] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+
+// 长度 -> 长度符号、距离 -> 距离符号的查找表
+struct SymbolTables {
+    uint16_t lengthSymbol[kMaxMatch + 1] = {};
+    uint8_t distSmall[256] = {};  // 距离 1..256
+    uint8_t distLarge[256] = {};  // 距离 257..32768，按 (d - 1) >> 7 索引
+
+    SymbolTables() {
+        for (unsigned s = 0; s < 29; ++s) {
+            unsigned end = s == 28 ? kMaxMatch + 1 : kLengthBase[s + 1];
+            for (unsigned len = kLengthBase[s]; len < end; ++len) lengthSymbol[len] = static_cast<uint16_t>(s);
+        }
+        for (unsigned s = 0; s < kNumDist; ++s) {
+            unsigned first = kDistBase[s];
+            unsigned last = first + (1u << kDistExtra[s]) - 1;
+            for (unsigned d = first; d <= last; ++d) {
+                if (d <= 256) {
+                    distSmall[d - 1] = static_cast<uint8_t>(s);
+                } else {
+                    distLarge[(d - 1) >> 7] = static_cast<uint8_t>(s);
+                }
+            }
+        }
+    }
+
+    unsigned distSymbol(unsigned distance) const {
+        return distance <= 256 ? distSmall[distance - 1] : distLarge[(distance - 1) >> 7];
+    }
+};
+
+const SymbolTables& tables() {
+    static const SymbolTables instance;
+    return instance;
+}
+
+// LZ77 符号：字面量 {byte, 0}，匹配 {length, distance}
+struct Lz77Symbol {
+    uint16_t lengthOrLiteral;
+    uint16_t distance;
+};
+
+inline size_t matchLength(const uint8_t* a, const uint8_t* b, size_t maxLength) {
+    size_t len = 0;
+    while (len + 8 <= maxLength) {
+        uint64_t x;
+        uint64_t y;
+        std::memcpy(&x, a + len, 8);
+        std::memcpy(&y, b + len, 8);
+        if (x != y) {
+            uint64_t diff = x ^ y;
+            unsigned bits = std::endian::native == std::endian::little ? std::countr_zero(diff)
+                                                                        : std::countl_zero(diff);
+            return len + bits / 8;
+        }
+        len += 8;
+    }
+    while (len < maxLength && a[len] == b[len]) ++len;
+    return len;
+}
+
+/**
+ * 哈希链匹配查找
+ *
+ * 对每个位置，从最近的候选开始沿链向前：长度每创出新高就记一个断点 (length, distance)，
+ * 于是 (上一断点长度, length] 区间内的每个长度都以这个 distance 为最近距离
+ */
+class MatchFinder {
+public:
+    explicit MatchFinder(std::span<const uint8_t> data)
+        : data_(data), head_(size_t{1} << kHashBits, -1), prev_(kWindowSize, -1) {}
+
+    void insert(size_t pos) {
+        if (pos + kMinMatch > data_.size()) return;
+        uint32_t h = hash(pos);
+        prev_[pos & (kWindowSize - 1)] = head_[h];
+        head_[h] = static_cast<int64_t>(pos);
+    }
+
+    // 断点打包为 (length << 16) | distance，按长度递增追加到 out
+    void find(size_t pos, size_t maxLength, std::vector<uint32_t>& out) const {
+        if (maxLength < kMinMatch || pos + kMinMatch > data_.size()) return;
+        const uint8_t* cur = data_.data() + pos;
+        size_t best = kMinMatch - 1;
+        int64_t candidate = head_[hash(pos)];
+        for (unsigned chain = 0; candidate >= 0 && chain < kMaxChain; ++chain) {
+            size_t distance = pos - static_cast<size_t>(candidate);
+            if (distance > kWindowSize) break;
+            const uint8_t* match = data_.data() + candidate;
+            if (match[best] == cur[best]) {
+                size_t len = matchLength(match, cur, maxLength);
+                if (len > best) {
+                    out.push_back(static_cast<uint32_t>(len << 16 | distance));
+                    best = len;
+                    if (len >= maxLength) break;
+                }
+            }
+            // 环形 prev_ 中的旧项可能已被更新的位置覆盖，此时链断开
+            int64_t next = prev_[static_cast<size_t>(candidate) & (kWindowSize - 1)];
+            if (next >= candidate) break;
+            candidate = next;
+        }
+    }
+
+private:
+    uint32_t hash(size_t pos) const {
+        const uint8_t* p = data_.data() + pos;
+        uint32_t v = p[0] | (p[1] << 8) | (p[2] << 16);
+        return (v * 2654435761u) >> (32 - kHashBits);
+    }
+
+    std::span<const uint8_t> data_;
+    std::vector<int64_t> head_;
+    std::vector<int64_t> prev_;
+};
+
+/**
+ * 由频率构建不超过 limit 位的哈夫曼码长
+ *
+ * 先按标准哈夫曼构建；超过 limit 时把频率减半（非零的保持 >= 1）重建，直到满足限制
+ */
+void buildCodeLengths(const uint32_t* frequencies, unsigned count, unsigned limit, uint8_t* lengths) {
+    std::fill(lengths, lengths + count, 0);
+    std::vector<uint32_t> freq(frequencies, frequencies + count);
+    for (;;) {
+        std::vector<unsigned> symbols;
+        for (unsigned s = 0; s < count; ++s) {
+            if (freq[s] != 0) symbols.push_back(s);
+        }
+        if (symbols.empty()) return;
+        if (symbols.size() == 1) {
+            lengths[symbols[0]] = 1;
+            return;
+        }
+        std::stable_sort(symbols.begin(), symbols.end(),
+                         [&](unsigned a, unsigned b) { return freq[a] < freq[b]; });
+
+        // 两队列法：叶子按频率升序，内部节点按生成顺序天然升序
+        size_t leaves = symbols.size();
+        std::vector<uint64_t> weight(2 * leaves - 1);
+        std::vector<size_t> parent(2 * leaves - 1, 0);
+        for (size_t i = 0; i < leaves; ++i) weight[i] = freq[symbols[i]];
+        size_t nextLeaf = 0;
+        size_t nextInternal = leaves;
+        for (size_t node = leaves; node < 2 * leaves - 1; ++node) {
+            size_t children[2];
+            for (size_t& child : children) {
+                if (nextLeaf < leaves && (nextInternal >= node || weight[nextLeaf] <= weight[nextInternal])) {
+                    child = nextLeaf++;
+                } else {
+                    child = nextInternal++;
+                }
+            }
+            weight[node] = weight[children[0]] + weight[children[1]];
+            parent[children[0]] = node;
+            parent[children[1]] = node;
+        }
+
+        std::vector<unsigned> depth(2 * leaves - 1, 0);
+        unsigned maxDepth = 0;
+        for (size_t node = 2 * leaves - 2; node-- > 0;) {
+            depth[node] = depth[parent[node]] + 1;
+            if (node < leaves) maxDepth = std::max(maxDepth, depth[node]);
+        }
+        if (maxDepth <= limit) {
+            for (size_t i = 0; i < leaves; ++i) lengths[symbols[i]] = static_cast<uint8_t>(depth[i]);
+            return;
+        }
+        for (uint32_t& f : freq) {
+            if (f != 0) f = (f + 1) / 2;
+        }
+    }
+}
+
+// 码长 -> 规范哈夫曼码（已按位反转，可直接低位先写）
+void buildCodes(const uint8_t* lengths, unsigned count, uint16_t* codes) {
+    unsigned lengthCount[16] = {};
+    for (unsigned s = 0; s < count; ++s) lengthCount[lengths[s]]++;
+    lengthCount[0] = 0;
+    uint32_t next[16] = {};
+    uint32_t code = 0;
+    for (unsigned len = 1; len < 16; ++len) {
+        code = (code + lengthCount[len - 1]) << 1;
+        next[len] = code;
+    }
+    for (unsigned s = 0; s < count; ++s) {
+        unsigned len = lengths[s];
+        uint32_t c = len != 0 ? next[len]++ : 0;
+        uint32_t reversed = 0;
+        for (unsigned i = 0; i < len; ++i, c >>= 1) reversed = (reversed << 1) | (c & 1);
+        codes[s] = static_cast<uint16_t>(reversed);
+    }
+}
+
+class BitWriter {
+public:
+    explicit BitWriter(std::vector<uint8_t>& out) : out_(out) {}
+
+    void put(uint32_t value, unsigned bits) {
+        buffer_ |= uint64_t{value} << count_;
+        count_ += bits;
+        while (count_ >= 8) {
+            out_.push_back(static_cast<uint8_t>(buffer_));
+            buffer_ >>= 8;
+            count_ -= 8;
+        }
+    }
+
+    void alignToByte() {
+        if (count_ > 0) put(0, 8 - count_);
+    }
+
+    void bytes(const uint8_t* data, size_t size) { out_.insert(out_.end(), data, data + size); }
+
+private:
+    std::vector<uint8_t>& out_;
+    uint64_t buffer_ = 0;
+    unsigned count_ = 0;
+};
+
+struct HuffmanTrees {
+    uint8_t litlen[kNumLitlen] = {};
+    uint8_t dist[32] = {};
+};
+
+struct BlockStats {
+    uint32_t litlen[kNumLitlen] = {};
+    uint32_t dist[32] = {};
+};
+
+BlockStats countSymbols(const std::vector<Lz77Symbol>& symbols) {
+    const auto& t = tables();
+    BlockStats stats;
+    for (const auto& s : symbols) {
+        if (s.distance == 0) {
+            stats.litlen[s.lengthOrLiteral]++;
+        } else {
+            stats.litlen[257 + t.lengthSymbol[s.lengthOrLiteral]]++;
+            stats.dist[t.distSymbol(s.distance)]++;
+        }
+    }
+    stats.litlen[kEndOfBlock] = 1;
+    return stats;
+}
+
+HuffmanTrees buildTrees(const BlockStats& stats) {
+    HuffmanTrees trees;
+    buildCodeLengths(stats.litlen, kNumLitlen, 15, trees.litlen);
+    buildCodeLengths(stats.dist, kNumDist, 15, trees.dist);
+    // 没有或只有一个距离码时补成两个 1 位码，兼容对不完整距离码处理有误的旧解码器
+    unsigned used = 0;
+    for (unsigned s = 0; s < kNumDist; ++s) used += trees.dist[s] != 0;
+    if (used == 0) {
+        trees.dist[0] = 1;
+        trees.dist[1] = 1;
+    } else if (used == 1) {
+        trees.dist[trees.dist[0] != 0 ? 1 : 0] = 1;
+    }
+    return trees;
+}
+
+HuffmanTrees fixedTrees() {
+    HuffmanTrees trees;
+    std::fill(trees.litlen, trees.litlen + 144, 8);
+    std::fill(trees.litlen + 144, trees.litlen + 256, 9);
+    std::fill(trees.litlen + 256, trees.litlen + 280, 7);
+    std::fill(trees.litlen + 280, trees.litlen + kNumLitlen, 8);
+    std::fill(trees.dist, trees.dist + 32, 5);
+    return trees;
+}
+
+/**
+ * 动态块的码表头（RFC 1951 3.2.7）：码长序列做游程编码后再用码长码编码
+ *
+ * writer 为空时只计算位数
+ */
+size_t writeTreeHeader(const HuffmanTrees& trees, BitWriter* writer) {
+    unsigned numLitlen = 286;
+    while (numLitlen > 257 && trees.litlen[numLitlen - 1] == 0) --numLitlen;
+    unsigned numDist = 30;
+    while (numDist > 1 && trees.dist[numDist - 1] == 0) --numDist;
+
+    uint8_t lengths[286 + 30];
+    std::memcpy(lengths, trees.litlen, numLitlen);
+    std::memcpy(lengths + numLitlen, trees.dist, numDist);
+    unsigned total = numLitlen + numDist;
+
+    // 游程编码：{符号, 额外位值}
+    std::vector<std::pair<uint8_t, uint8_t>> items;
+    for (unsigned i = 0; i < total;) {
+        uint8_t value = lengths[i];
+        unsigned run = 1;
+        while (i + run < total && lengths[i + run] == value) ++run;
+        i += run;
+        if (value == 0) {
+            while (run >= 11) {
+                unsigned r = std::min(run, 138u);
+                items.push_back({18, static_cast<uint8_t>(r - 11)});
+                run -= r;
+            }
+            if (run >= 3) {
+                items.push_back({17, static_cast<uint8_t>(run - 3)});
+                run = 0;
+            }
+        } else {
+            items.push_back({value, 0});
+            --run;
+            while (run >= 3) {
+                unsigned r = std::min(run, 6u);
+                items.push_back({16, static_cast<uint8_t>(r - 3)});
+                run -= r;
+            }
+        }
+        while (run-- > 0) items.push_back({value, 0});
+    }
+
+    uint32_t precodeFreq[kNumPrecode] = {};
+    for (const auto& item : items) precodeFreq[item.first]++;
+    uint8_t precodeLengths[kNumPrecode];
+    buildCodeLengths(precodeFreq, kNumPrecode, 7, precodeLengths);
+    uint16_t precodeCodes[kNumPrecode];
+    buildCodes(precodeLengths, kNumPrecode, precodeCodes);
+
+    unsigned numPrecode = kNumPrecode;
+    while (numPrecode > 4 && precodeLengths[kPrecodeOrder[numPrecode - 1]] == 0) --numPrecode;
+
+    static constexpr uint8_t kRepeatBits[3] = {2, 3, 7};
+    size_t bits = 5 + 5 + 4 + 3 * numPrecode;
+    for (const auto& item : items) {
+        bits += precodeLengths[item.first] + (item.first >= 16 ? kRepeatBits[item.first - 16] : 0);
+    }
+    if (writer != nullptr) {
+        writer->put(numLitlen - 257, 5);
+        writer->put(numDist - 1, 5);
+        writer->put(numPrecode - 4, 4);
+        for (unsigned i = 0; i < numPrecode; ++i) writer->put(precodeLengths[kPrecodeOrder[i]], 3);
+        for (const auto& item : items) {
+            writer->put(precodeCodes[item.first], precodeLengths[item.first]);
+            if (item.first >= 16) writer->put(item.second, kRepeatBits[item.first - 16]);
+        }
+    }
+    return bits;
+}
+
+// 用给定码表编码符号的位数（不含块头）
+size_t symbolBits(const std::vector<Lz77Symbol>& symbols, const HuffmanTrees& trees) {
+    const auto& t = tables();
+    size_t bits = trees.litlen[kEndOfBlock];
+    for (const auto& s : symbols) {
+        if (s.distance == 0) {
+            bits += trees.litlen[s.lengthOrLiteral];
+        } else {
+            unsigned ls = t.lengthSymbol[s.lengthOrLiteral];
+            unsigned ds = t.distSymbol(s.distance);
+            bits += trees.litlen[257 + ls] + kLengthExtra[ls] + trees.dist[ds] + kDistExtra[ds];
+        }
+    }
+    return bits;
+}
+
+void writeSymbols(const std::vector<Lz77Symbol>& symbols, const HuffmanTrees& trees, BitWriter& writer) {
+    const auto& t = tables();
+    uint16_t litlenCodes[kNumLitlen];
+    uint16_t distCodes[32];
+    buildCodes(trees.litlen, kNumLitlen, litlenCodes);
+    buildCodes(trees.dist, 32, distCodes);
+    for (const auto& s : symbols) {
+        if (s.distance == 0) {
+            writer.put(litlenCodes[s.lengthOrLiteral], trees.litlen[s.lengthOrLiteral]);
+            continue;
+        }
+        unsigned ls = t.lengthSymbol[s.lengthOrLiteral];
+        unsigned ds = t.distSymbol(s.distance);
+        writer.put(litlenCodes[257 + ls], trees.litlen[257 + ls]);
+        writer.put(s.lengthOrLiteral - kLengthBase[ls], kLengthExtra[ls]);
+        writer.put(distCodes[ds], trees.dist[ds]);
+        writer.put(s.distance - kDistBase[ds], kDistExtra[ds]);
+    }
+    writer.put(litlenCodes[kEndOfBlock], trees.litlen[kEndOfBlock]);
+}
+
+void writeStored(const uint8_t* data, size_t size, bool final, BitWriter& writer) {
+    do {
+        size_t chunk = std::min<size_t>(size, 65535);
+        size -= chunk;
+        writer.put(final && size == 0 ? 1 : 0, 1);
+        writer.put(0, 2);
+        writer.alignToByte();
+        writer.put(static_cast<uint32_t>(chunk), 16);
+        writer.put(static_cast<uint32_t>(~chunk & 0xffff), 16);
+        writer.bytes(data, chunk);
+        data += chunk;
+    } while (size > 0);
+}
+
+/**
+ * 一个 deflate 块的迭代最优解析
+ *
+ * @param block 块内数据
+ * @param offsets / breakpoints 每个位置的匹配断点（offsets[i] .. offsets[i + 1]）
+ */
+std::vector<Lz77Symbol> optimalParse(std::span<const uint8_t> block, const std::vector<uint32_t>& offsets,
+                                     const std::vector<uint32_t>& breakpoints, int iterations) {
+    const auto& t = tables();
+    const size_t n = block.size();
+
+    // 首轮代价取固定哈夫曼码的码长
+    float litlenCost[kNumLitlen];
+    float distCost[kNumDist];
+    HuffmanTrees fixed = fixedTrees();
+    for (unsigned s = 0; s < kNumLitlen; ++s) litlenCost[s] = fixed.litlen[s];
+    for (unsigned s = 0; s < kNumDist; ++s) distCost[s] = fixed.dist[s];
+
+    std::vector<float> cost(n + 1);
+    std::vector<uint16_t> linkLength(n + 1);
+    std::vector<uint16_t> linkDistance(n + 1);
+    std::vector<Lz77Symbol> symbols;
+    std::vector<Lz77Symbol> best;
+    size_t bestBits = std::numeric_limits<size_t>::max();
+    size_t lastBits = 0;
+
+    for (int iteration = 0; iteration < std::max(1, iterations); ++iteration) {
+        float lengthCost[kMaxMatch + 1] = {};
+        for (unsigned len = kMinMatch; len <= kMaxMatch; ++len) {
+            unsigned ls = t.lengthSymbol[len];
+            lengthCost[len] = litlenCost[257 + ls] + kLengthExtra[ls];
+        }
+
+        std::fill(cost.begin(), cost.end(), std::numeric_limits<float>::infinity());
+        cost[0] = 0;
+        for (size_t i = 0; i < n; ++i) {
+            float base = cost[i];
+            float literal = base + litlenCost[block[i]];
+            if (literal < cost[i + 1]) {
+                cost[i + 1] = literal;
+                linkLength[i + 1] = 1;
+                linkDistance[i + 1] = 0;
+            }
+
+            uint32_t first = offsets[i];
+            uint32_t last = offsets[i + 1];
+            if (first == last) continue;
+
+            // 最长匹配已到 258：长重复区直接取整段匹配并跳过，避免在全零段上逐位置枚举
+            uint32_t longest = breakpoints[last - 1];
+            if ((longest >> 16) == kMaxMatch) {
+                unsigned distance = longest & 0xffff;
+                unsigned ds = t.distSymbol(distance);
+                float c = base + lengthCost[kMaxMatch] + distCost[ds] + kDistExtra[ds];
+                if (c < cost[i + kMaxMatch]) {
+                    cost[i + kMaxMatch] = c;
+                    linkLength[i + kMaxMatch] = kMaxMatch;
+                    linkDistance[i + kMaxMatch] = static_cast<uint16_t>(distance);
+                }
+                i += kMaxMatch - 1;
+                continue;
+            }
+
+            unsigned previous = kMinMatch - 1;
+            for (uint32_t b = first; b < last; ++b) {
+                unsigned length = breakpoints[b] >> 16;
+                unsigned distance = breakpoints[b] & 0xffff;
+                unsigned ds = t.distSymbol(distance);
+                float matchBase = base + distCost[ds] + kDistExtra[ds];
+                for (unsigned len = previous + 1; len <= length; ++len) {
+                    float c = matchBase + lengthCost[len];
+                    if (c < cost[i + len]) {
+                        cost[i + len] = c;
+                        linkLength[i + len] = static_cast<uint16_t>(len);
+                        linkDistance[i + len] = static_cast<uint16_t>(distance);
+                    }
+                }
+                previous = length;
+            }
+        }
+
+        // 回溯最短路径
+        symbols.clear();
+        for (size_t pos = n; pos > 0;) {
+            unsigned len = linkLength[pos];
+            if (linkDistance[pos] == 0) {
+                symbols.push_back({block[pos - 1], 0});
+            } else {
+                symbols.push_back({static_cast<uint16_t>(len), linkDistance[pos]});
+            }
+            pos -= len;
+        }
+        std::reverse(symbols.begin(), symbols.end());
+
+        BlockStats stats = countSymbols(symbols);
+        HuffmanTrees trees = buildTrees(stats);
+        size_t bits = writeTreeHeader(trees, nullptr) + symbolBits(symbols, trees);
+        if (bits < bestBits) {
+            bestBits = bits;
+            best = symbols;
+        }
+        if (bits == lastBits) {
+            break;  // 解析不再变化
+        }
+        lastBits = bits;
+
+        // 下一轮代价：按本轮频率的熵（未出现的符号按 log2(总数) 计）
+        auto updateCosts = [](const uint32_t* freq, unsigned count, float* costs) {
+            uint64_t total = 0;
+            for (unsigned s = 0; s < count; ++s) total += freq[s];
+            float logTotal = total > 0 ? std::log2(static_cast<float>(total)) : 0.0f;
+            for (unsigned s = 0; s < count; ++s) {
+                costs[s] = freq[s] == 0 ? logTotal : logTotal - std::log2(static_cast<float>(freq[s]));
+            }
+        };
+        updateCosts(stats.litlen, kNumLitlen, litlenCost);
+        updateCosts(stats.dist, kNumDist, distCost);
+    }
+    return best;
+}
+
+}  // anonymous namespace
+
+bool optimalDeflate(std::span<const uint8_t> data, size_t start, bool last, int iterations,
+                    std::vector<uint8_t>& out, std::string& error) {
+    if (start > data.size()) {
+        error = "Deflate start past end of data";
+        return false;
+    }
+    BitWriter writer(out);
+    MatchFinder finder(data);
+    for (size_t pos = start > kWindowSize ? start - kWindowSize : 0; pos < start; ++pos) {
+        finder.insert(pos);
+    }
+
+    if (start == data.size() && last) {
+        // 空输入：一个只有块结束符的固定哈夫曼块
+        writer.put(1, 1);
+        writer.put(1, 2);
+        writer.put(0, 7);
+    }
+
+    std::vector<uint32_t> offsets;
+    std::vector<uint32_t> breakpoints;
+    for (size_t blockStart = start; blockStart < data.size(); blockStart += kBlockBytes) {
+        size_t blockEnd = std::min(data.size(), blockStart + kBlockBytes);
+        bool final = last && blockEnd == data.size();
+
+        offsets.assign(1, 0);
+        breakpoints.clear();
+        for (size_t pos = blockStart; pos < blockEnd; ++pos) {
+            finder.find(pos, std::min<size_t>(kMaxMatch, blockEnd - pos), breakpoints);
+            finder.insert(pos);
+            offsets.push_back(static_cast<uint32_t>(breakpoints.size()));
+        }
+
+        std::span<const uint8_t> block = data.subspan(blockStart, blockEnd - blockStart);
+        std::vector<Lz77Symbol> symbols = optimalParse(block, offsets, breakpoints, iterations);
+
+        HuffmanTrees dynamic = buildTrees(countSymbols(symbols));
+        HuffmanTrees fixed = fixedTrees();
+        size_t dynamicBits = writeTreeHeader(dynamic, nullptr) + symbolBits(symbols, dynamic);
+        size_t fixedBits = symbolBits(symbols, fixed);
+        size_t storedBits = (block.size() / 65535 + 1) * 48 + block.size() * 8;
+
+        if (storedBits < dynamicBits && storedBits < fixedBits) {
+            writeStored(block.data(), block.size(), final, writer);
+        } else if (fixedBits <= dynamicBits) {
+            writer.put(final ? 1 : 0, 1);
+            writer.put(1, 2);
+            writeSymbols(symbols, fixed, writer);
+        } else {
+            writer.put(final ? 1 : 0, 1);
+            writer.put(2, 2);
+            writeTreeHeader(dynamic, &writer);
+            writeSymbols(symbols, dynamic, writer);
+        }
+    }
+
+    if (!last) {
+        // 空存储块：对齐到字节边界（Z_SYNC_FLUSH）
+        writer.put(0, 3);
+        writer.alignToByte();
+        writer.put(0, 16);
+        writer.put(0xffff, 16);
+    }
+    writer.alignToByte();
+    return true;
+}
+
+}  // namespace spz2glb
@@ -0,0 +1,42 @@
+// Copyright (c) 2026 Pu Junhan
+// SPDX-License-Identifier: MIT
+// Project: SPZ-ecosystem
+// Repository: https://github.com/spz-ecosystem/spz2glb
+//
+// 最高压缩比 deflate 编码器（zopfli 的做法）
+// 穷举每个位置的全部匹配，按当前符号代价做最短路径解析，再用解析结果的符号统计更新代价，反复迭代。
+// 输出是标准 deflate，任何解码器都能读取；比 zlib 9 级小几个百分点，速度慢两个数量级
+
+#ifndef SPZ2GLB_OPTIMAL_DEFLATE_H_
+#define SPZ2GLB_OPTIMAL_DEFLATE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace spz2glb {
+
+// 传给 repackGzipBlocks 等接受 zlib 压缩级别的函数时，表示改用 optimalDeflate
+constexpr int kMaxRatioLevel = 10;
+
+// 默认迭代次数（与 zopfli 相同）
+constexpr int kOptimalDeflateIterations = 15;
+
+/**
+ * 把 data[start, data.size()) 压缩为 raw deflate，追加到 out
+ *
+ * data[0, start) 是之前的数据（最多用到最后 32 KB），只作为匹配的历史，不输出；
+ * start 为 0 时输出不引用任何之前的数据。
+ *
+ * @param last true 时最后一个块带 BFINAL 并补齐到字节边界；
+ *             false 时以空的存储块结尾（同 zlib 的 Z_SYNC_FLUSH），输出字节对齐，可以直接拼接下一段
+ * @param iterations 代价模型迭代次数，越多越慢、通常越小
+ */
+bool optimalDeflate(std::span<const uint8_t> data, size_t start, bool last, int iterations,
+                    std::vector<uint8_t>& out, std::string& error);
+
+}  // namespace spz2glb
+
+#endif  // SPZ2GLB_OPTIMAL_DEFLATE_H_
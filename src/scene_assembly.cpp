@@ -0,0 +1,178 @@
+// Copyright (c) 2026 Pu Junhan
+// SPDX-License-Identifier: MIT
+// Project: SPZ-ecosystem
+// Repository: https://github.com/spz-ecosystem/spz2glb
+//
+// 多输入场景拼装实现
+
+#include "scene_assembly.h"
+
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include <fastgltf/core.hpp>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "spz_converter.h"
+#include "thread_pool.h"
+
+namespace spz2glb {
+
+namespace {
+
+// 文件名去掉目录与扩展名，作为 node 名
+std::string nodeName(const std::string& path) {
+    std::string name = path.substr(path.find_last_of("/\\") + 1);
+    size_t dot = name.find_last_of('.');
+    return dot == std::string::npos || dot == 0 ? name : name.substr(0, dot);
+}
+
+}  // anonymous namespace
+
+SpzResult assembleScene(std::span<const SceneInput> inputs, const std::string& outputPath, GlbLayout& layout,
+                        const ConvertOptions& options) {
+    if (inputs.empty()) {
+        return SpzResult::error(SpzErrorCode::ConversionFailed, "Scene requires at least one input");
+    }
+
+    // 步骤 1: 并行映射输入并校验头部
+    const size_t n = inputs.size();
+    std::vector<MappedFile> files(n);
+    std::vector<SpzHeader> headers(n);
+    std::vector<std::string> errors(n);
+    parallelFor(options.pool, n, [&](size_t i) {
+        if (!files[i].open(inputs[i].path)) {
+            errors[i] = "Cannot open SPZ file: " + inputs[i].path;
+            return;
+        }
+        auto prefix = inflateSpzPrefix(files[i].bytes(), sizeof(SpzHeader));
+        if (!prefix.success || !parseSpzHeader(prefix.data, headers[i])) {
+            errors[i] = "Failed to parse SPZ header: " + inputs[i].path;
+            return;
+        }
+        auto checked = checkSpzLength(files[i].bytes(), files[i].bytes(), files[i].size(), headers[i]);
+        if (!checked.success) {
+            errors[i] = checked.errorMessage + ": " + inputs[i].path;
+        }
+    });
+    for (const auto& message : errors) {
+        if (!message.empty()) {
+            return SpzResult::error(SpzErrorCode::ConversionFailed, message);
+        }
+    }
+
+    // 步骤 2: 预先计算偏移，生成 JSON
+    std::vector<uint64_t> offsets(n);
+    uint64_t binSize = 0;
+    uint64_t totalPoints = 0;
+    for (size_t i = 0; i < n; ++i) {
+        binSize = (binSize + 3) & ~uint64_t{3};
+        offsets[i] = binSize;
+        binSize += files[i].size();
+        totalPoints += headers[i].numPoints;
+        if (options.verbose) {
+            std::cout << "[INFO] Scene input " << i << ": " << inputs[i].path << " (" << headers[i].numPoints
+                      << " points, SH degree " << static_cast<int>(headers[i].shDegree) << ", " << files[i].size()
+                      << " bytes)" << std::endl;
+        }
+    }
+
+    // 各输入文件直接写到 BIN 中对应的偏移
+    fastgltf::Asset asset = createSplatAsset(true);
+    addGlbBinBuffer(asset, binSize);
+
+    fastgltf::Scene scene;
+    for (size_t i = 0; i < n; ++i) {
+        fastgltf::BufferView view;
+        view.bufferIndex = 0;
+        view.byteOffset = offsets[i];
+        view.byteLength = files[i].size();
+        asset.bufferViews.emplace_back(std::move(view));
+
+        fastgltf::Primitive primitive;
+        primitive.type = fastgltf::PrimitiveType::Points;
+        auto gaussianSplat = std::make_unique<fastgltf::GaussianSplatExtension>();
+        auto spzCompression = std::make_unique<fastgltf::GaussianSplatSpzCompression>();
+        spzCompression->bufferView = i;
+        gaussianSplat->spzCompression = std::move(spzCompression);
+        primitive.gaussianSplat = std::move(gaussianSplat);
+
+        fastgltf::Mesh mesh;
+        mesh.primitives.emplace_back(std::move(primitive));
+        asset.meshes.emplace_back(std::move(mesh));
+
+        const SceneInput& input = inputs[i];
+        fastgltf::Node node;
+        node.meshIndex = i;
+        std::string name = nodeName(input.path);
+        node.name.assign(name.data(), name.size());
+        fastgltf::TRS trs;
+        trs.translation = fastgltf::math::fvec3(input.translation[0], input.translation[1], input.translation[2]);
+        trs.rotation = fastgltf::math::fquat(input.rotation[0], input.rotation[1], input.rotation[2], input.rotation[3]);
+        trs.scale = fastgltf::math::fvec3(input.scale[0], input.scale[1], input.scale[2]);
+        node.transform = trs;
+        asset.nodes.emplace_back(std::move(node));
+        scene.nodeIndices.emplace_back(i);
+    }
+    asset.scenes.emplace_back(std::move(scene));
+    asset.defaultScene = 0;
+
+    GlbJsonExporter exporter;
+    std::string json;
+    auto exportError = exporter.writeBinaryJson(asset, json);
+    if (exportError != fastgltf::Error::None) {
+        return SpzResult::error(SpzErrorCode::ConversionFailed,
+            "GLB export failed: " + std::string(fastgltf::getErrorMessage(exportError)));
+    }
+    std::vector<uint8_t> preamble;
+    std::string error;
+    if (!finishGlbPreamble(json, binSize, layout, preamble, error)) {
+        return SpzResult::error(SpzErrorCode::ConversionFailed, error);
+    }
+    if (options.verbose) {
+        std::cout << "[INFO] Scene: " << n << " inputs, " << totalPoints << " points, " << binSize
+                  << " bytes of SPZ data" << std::endl;
+    }
+
+    // 步骤 3: 各输入写到预先算好的偏移
+#ifdef _WIN32
+    static const uint8_t zeros[4] = {0, 0, 0, 0};
+    std::vector<std::span<const uint8_t>> segments;
+    for (size_t i = 0; i < n; ++i) {
+        uint64_t end = i + 1 < n ? offsets[i + 1] : offsets[i] + files[i].size();
+        segments.push_back(files[i].bytes());
+        segments.emplace_back(zeros, static_cast<size_t>(end - offsets[i] - files[i].size()));
+    }
+    bool written = writeGlbSegments(outputPath, preamble, segments, layout);
+#else
+    // 输出路径可能是某个输入：写临时文件再 rename，仍在映射中的输入不被截断
+    OutputFile out;
+    bool written = out.open(outputPath);
+    if (written) {
+        // 先扩展到最终长度：输入之间与 BIN 末尾的填充字节即为零
+        written = ::ftruncate(out.fd(), static_cast<off_t>(layout.totalLength)) == 0 &&
+                  writeBytesAt(out.fd(), preamble, 0);
+        std::vector<char> ok(n, 0);
+        if (written) {
+            parallelFor(options.pool, n, [&](size_t i) {
+                ok[i] = writeFileAt(out.fd(), files[i], layout.preambleSize + offsets[i]);
+            });
+        }
+        for (char fileWritten : ok) {
+            written = written && fileWritten;
+        }
+        written = written && out.commit();
+    }
+#endif
+    if (!written) {
+        return SpzResult::error(SpzErrorCode::CannotOpenOutputFile, "Failed to write GLB: " + outputPath);
+    }
+    return SpzResult::ok({});
+}
+
+}  // namespace spz2glb
@@ -0,0 +1,51 @@
+// Copyright (c) 2026 Pu Junhan
+// SPDX-License-Identifier: MIT
+// Project: SPZ-ecosystem
+// Repository: https://github.com/spz-ecosystem/spz2glb
+//
+// 多输入场景拼装（--scene）
+// 把若干独立采集的 SPZ 资产（例如房间与其中的道具）放进同一个 GLB：每个输入一个 node，
+// 查看器一次请求拿到整个场景，各资产仍是原样的 SPZ 流
+
+#ifndef SPZ2GLB_SCENE_ASSEMBLY_H_
+#define SPZ2GLB_SCENE_ASSEMBLY_H_
+
+#include <array>
+#include <span>
+#include <string>
+
+#include "glb_writer.h"
+
+struct SpzResult;
+
+namespace spz2glb {
+
+struct ConvertOptions;
+
+/**
+ * 场景中的一个输入及其 node 变换（glTF TRS，旋转为四元数 x y z w）
+ */
+struct SceneInput {
+    std::string path;
+    std::array<float, 3> translation = {0.0f, 0.0f, 0.0f};
+    std::array<float, 4> rotation = {0.0f, 0.0f, 0.0f, 1.0f};
+    std::array<float, 3> scale = {1.0f, 1.0f, 1.0f};
+};
+
+/**
+ * 把多个 SPZ 文件拼装成一个 GLB
+ *
+ * 1. 在 options.pool 上并行映射各输入，只解压头 16 字节校验
+ * 2. 按文件大小预先算出每个输入在 BIN 中的偏移（各自补零到 4 字节对齐），生成 JSON：
+ *    输入 i 对应 bufferView / mesh / node i，node 带变换、以文件名（不含扩展名）命名，场景列出所有 node
+ * 3. 写出前导字节并把文件扩展到最终长度，各输入并行写到各自的偏移处
+ *    （copy_file_range / pwrite），不经过拼接缓冲区；填充字节由扩展文件时补的零充当
+ *
+ * 输入的 SPZ 流原样保留，解压后与各输入逐字节相同
+ */
+SpzResult assembleScene(std::span<const SceneInput> inputs, const std::string& outputPath, GlbLayout& layout,
+                        const ConvertOptions& options);
+
+}  // namespace spz2glb
+
+#endif  // SPZ2GLB_SCENE_ASSEMBLY_H_
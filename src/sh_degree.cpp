@@ -0,0 +1,110 @@
+// Copyright (c) 2026 Pu Junhan
+// SPDX-License-Identifier: MIT
+// Project: SPZ-ecosystem
+// Repository: https://github.com/spz-ecosystem/spz2glb
+//
+// 球谐阶数截断实现
+
+#include "sh_degree.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "splat_data.h"
+#include "spz_decoder.h"
+#include "thread_pool.h"
+
+namespace spz2glb {
+
+namespace {
+
+constexpr size_t kChunkPoints = 64 * 1024;  // 与解码器相同的分块粒度
+
+/**
+ * 每点保留前 dstStride 个元素：两个步长都是编译期常量，内层循环展开为定长拷贝、可向量化
+ */
+template <typename T, uint32_t From, uint32_t To>
+void repackSh(const T* src, T* dst, size_t count) {
+    static_assert(To < From && From <= kMaxShDegree);
+    constexpr size_t srcStride = SplatData::shDimForDegree(From) * 3;
+    constexpr size_t dstStride = SplatData::shDimForDegree(To) * 3;
+    if constexpr (dstStride > 0) {
+        for (size_t i = 0; i < count; ++i) {
+            for (size_t c = 0; c < dstStride; ++c) {
+                dst[i * dstStride + c] = src[i * srcStride + c];
+            }
+        }
+    }
+}
+
+template <typename T>
+using RepackFn = void (*)(const T*, T*, size_t);
+
+// 按（源阶数, 目标阶数）选择特化版本，To >= From 时为空
+template <typename T>
+RepackFn<T> selectRepack(uint32_t from, uint32_t to) {
+    static constexpr RepackFn<T> kTable[kMaxShDegree + 1][kMaxShDegree + 1] = {
+        {nullptr, nullptr, nullptr, nullptr},
+        {&repackSh<T, 1, 0>, nullptr, nullptr, nullptr},
+        {&repackSh<T, 2, 0>, &repackSh<T, 2, 1>, nullptr, nullptr},
+        {&repackSh<T, 3, 0>, &repackSh<T, 3, 1>, &repackSh<T, 3, 2>, nullptr},
+    };
+    return kTable[from][to];
+}
+
+// 按点分块并行重排：src / dst 指向球谐段开头
+template <typename T>
+void repackChunks(const T* src, T* dst, uint32_t numPoints, uint32_t from, uint32_t to, ThreadPool* pool) {
+    const RepackFn<T> repack = selectRepack<T>(from, to);
+    const size_t srcStride = SplatData::shDimForDegree(from) * 3;
+    const size_t dstStride = SplatData::shDimForDegree(to) * 3;
+    const size_t chunks = (static_cast<size_t>(numPoints) + kChunkPoints - 1) / kChunkPoints;
+    parallelFor(pool, chunks, [&](size_t chunk) {
+        size_t begin = chunk * kChunkPoints;
+        size_t end = std::min(begin + kChunkPoints, static_cast<size_t>(numPoints));
+        repack(src + begin * srcStride, dst + begin * dstStride, end - begin);
+    });
+}
+
+}  // anonymous namespace
+
+bool truncateSpzShDegree(std::vector<uint8_t>& inflated, uint32_t maxDegree, ThreadPool* pool,
+                         uint32_t& fromDegree, std::string& error) {
+    SpzLayout layout;
+    if (!parseSpzLayout(inflated, layout, error)) {
+        return false;
+    }
+    fromDegree = layout.shDegree;
+    if (fromDegree <= maxDegree) {
+        return true;
+    }
+
+    // 球谐段是最后一个属性段：位置、不透明度、颜色、尺度、旋转之后
+    const uint32_t numPoints = layout.numPoints;
+    const size_t n = numPoints;
+    const size_t srcStride = layout.stride(SpzSection::Sh);
+    const size_t dstStride = SplatData::shDimForDegree(maxDegree) * 3;
+    const uint64_t shOffset = layout.offset(SpzSection::Sh);
+    const uint64_t shEnd = layout.end;
+
+    std::vector<uint8_t> out(inflated.size() - n * (srcStride - dstStride));
+    std::memcpy(out.data(), inflated.data(), static_cast<size_t>(shOffset));
+    out[12] = static_cast<uint8_t>(maxDegree);
+    repackChunks(inflated.data() + shOffset, out.data() + shOffset, numPoints, fromDegree, maxDegree, pool);
+    std::memcpy(out.data() + shOffset + n * dstStride, inflated.data() + shEnd,
+                inflated.size() - static_cast<size_t>(shEnd));
+    inflated.swap(out);
+    return true;
+}
+
+void truncateSplatShDegree(SplatData& splats, uint32_t maxDegree, ThreadPool* pool) {
+    if (splats.shDegree <= maxDegree) {
+        return;
+    }
+    AlignedArray<float> sh(static_cast<size_t>(splats.numPoints) * SplatData::shDimForDegree(maxDegree) * 3);
+    repackChunks(splats.sh.data(), sh.data(), splats.numPoints, splats.shDegree, maxDegree, pool);
+    splats.sh = std::move(sh);
+    splats.shDegree = maxDegree;
+}
+
+}  // namespace spz2glb
@@ -0,0 +1,44 @@
+// Copyright (c) 2026 Pu Junhan
+// SPDX-License-Identifier: MIT
+// Project: SPZ-ecosystem
+// Repository: https://github.com/spz-ecosystem/spz2glb
+//
+// 球谐阶数截断（--max-sh-degree）
+// 3 阶场景中高阶球谐系数占 SPZ 数据的大部分（每点 45 字节，其余属性共 19 ~ 20 字节），
+// 也是解码的主要开销；丢掉高阶带可以大幅缩小文件，只损失视角相关的高频颜色变化
+
+#ifndef SPZ2GLB_SH_DEGREE_H_
+#define SPZ2GLB_SH_DEGREE_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace spz2glb {
+
+class ThreadPool;
+struct SplatData;
+
+// SPZ 支持的最高球谐阶数；--max-sh-degree 取此值表示不截断
+constexpr uint32_t kMaxShDegree = 3;
+
+/**
+ * 把已解压的 SPZ 数据截断到最多 maxDegree 阶球谐，原地替换 inflated
+ *
+ * 每个点的系数按阶从低到高排列（1 阶 3 个、2 阶 5 个、3 阶 7 个，每个 RGB 三字节），
+ * 截断即保留每点的前缀：球谐段按（源阶数, 目标阶数）编译期特化的定长拷贝重新排列，
+ * 其他属性段与段后的字节原样保留，头中的 shDegree 改为 maxDegree。按点分块在 pool 上并行。
+ *
+ * @param fromDegree 返回输入的阶数；不高于 maxDegree 时 inflated 不变
+ */
+bool truncateSpzShDegree(std::vector<uint8_t>& inflated, uint32_t maxDegree, ThreadPool* pool,
+                         uint32_t& fromDegree, std::string& error);
+
+/**
+ * 把解码后的 splats.sh 截断到最多 maxDegree 阶（属性模式），阶数不高于 maxDegree 时不变
+ */
+void truncateSplatShDegree(SplatData& splats, uint32_t maxDegree, ThreadPool* pool);
+
+}  // namespace spz2glb
+
+#endif  // SPZ2GLB_SH_DEGREE_H_
@@ -0,0 +1,368 @@
+// Copyright (c) 2026 Pu Junhan
+// SPDX-License-Identifier: MIT
+// Project: SPZ-ecosystem
+// Repository: https://github.com/spz-ecosystem/spz2glb
+//
+// 空间填充曲线重排实现
+
+#include "spatial_order.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <numeric>
+
+#include "splat_data.h"
+#include "spz_decoder.h"
+#include "thread_pool.h"
+
+namespace spz2glb {
+
+namespace {
+
+constexpr unsigned kAxisBits = 21;  // 3 × 21 = 63 位键
+constexpr uint32_t kAxisMax = (1u << kAxisBits) - 1;
+constexpr size_t kMinPointsPerPart = 64 * 1024;
+
+// 线程池分段数：每段至少 kMinPointsPerPart 个元素
+size_t partCount(ThreadPool* pool, size_t n) {
+    size_t parts = pool != nullptr ? pool->size() : 1;
+    return std::max<size_t>(1, std::min(parts, n / kMinPointsPerPart));
+}
+
+// 21 位整数的各位隔两位展开：b20..b0 -> b20 0 0 b19 0 0 ... b0
+uint64_t spreadBits(uint32_t v) {
+    uint64_t x = v & kAxisMax;
+    x = (x | x << 32) & 0x1f00000000ffffull;
+    x = (x | x << 16) & 0x1f0000ff0000ffull;
+    x = (x | x << 8) & 0x100f00f00f00f00full;
+    x = (x | x << 4) & 0x10c30c30c30c30c3ull;
+    x = (x | x << 2) & 0x1249249249249249ull;
+    return x;
+}
+
+uint64_t mortonKey(uint32_t x, uint32_t y, uint32_t z) {
+    return spreadBits(x) << 2 | spreadBits(y) << 1 | spreadBits(z);
+}
+
+/**
+ * Hilbert 键（Skilling, "Programming the Hilbert curve", 2004）
+ *
+ * 先把坐标就地变换为“转置”形式的 Hilbert 下标，再按位交错成 63 位整数
+ */
+uint64_t hilbertKey(uint32_t x, uint32_t y, uint32_t z) {
+    uint32_t v[3] = {x, y, z};
+    const uint32_t top = 1u << (kAxisBits - 1);
+    for (uint32_t q = top; q > 1; q >>= 1) {
+        uint32_t p = q - 1;
+        for (int i = 0; i < 3; ++i) {
+            if (v[i] & q) {
+                v[0] ^= p;
+            } else {
+                uint32_t t = (v[0] ^ v[i]) & p;
+                v[0] ^= t;
+                v[i] ^= t;
+            }
+        }
+    }
+    // 格雷编码
+    v[1] ^= v[0];
+    v[2] ^= v[1];
+    uint32_t t = 0;
+    for (uint32_t q = top; q > 1; q >>= 1) {
+        if (v[2] & q) t ^= q - 1;
+    }
+    for (uint32_t& c : v) c ^= t;
+    return mortonKey(v[0], v[1], v[2]);
+}
+
+// 按 order 收集定长元素：dst[i] = src[order[i]]
+template <typename T>
+void gather(const T* src, T* dst, size_t stride, std::span<const uint32_t> order, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+        std::memcpy(dst + i * stride, src + static_cast<size_t>(order[i]) * stride, stride * sizeof(T));
+    }
+}
+
+uint64_t hashBytes(const uint8_t* data, size_t size, uint64_t h) {
+    // FNV-1a，每次吸收一个字节
+    for (size_t i = 0; i < size; ++i) {
+        h = (h ^ data[i]) * 0x100000001b3ull;
+    }
+    return h;
+}
+
+// 每个点全部属性字节的哈希，排序后返回
+std::vector<uint64_t> pointHashes(std::span<const uint8_t> inflated, const SpzLayout& sections) {
+    std::vector<uint64_t> hashes(sections.numPoints);
+    for (size_t i = 0; i < sections.numPoints; ++i) {
+        uint64_t h = 0xcbf29ce484222325ull;
+        for (size_t s = 0; s < kSpzSectionCount; ++s) {
+            h = hashBytes(inflated.data() + sections.offsets[s] + i * sections.strides[s], sections.strides[s], h);
+        }
+        hashes[i] = h;
+    }
+    std::sort(hashes.begin(), hashes.end());
+    return hashes;
+}
+
+}  // anonymous namespace
+
+const char* spatialCurveName(SpatialCurve curve) {
+    switch (curve) {
+        case SpatialCurve::Morton:
+            return "morton";
+        case SpatialCurve::Hilbert:
+            return "hilbert";
+        default:
+            return "none";
+    }
+}
+
+bool parseSpatialCurve(std::string_view name, SpatialCurve& curve) {
+    for (SpatialCurve c : {SpatialCurve::None, SpatialCurve::Morton, SpatialCurve::Hilbert}) {
+        if (name == spatialCurveName(c)) {
+            curve = c;
+            return true;
+        }
+    }
+    return false;
+}
+
+void parallelRadixSort(std::vector<uint64_t>& keys, std::vector<uint32_t>& values, unsigned keyBits,
+                       ThreadPool* pool) {
+    const size_t n = keys.size();
+    if (n < 2) return;
+    const size_t parts = partCount(pool, n);
+    auto partBegin = [&](size_t p) { return n * p / parts; };
+
+    std::vector<uint64_t> keyBuffer(n);
+    std::vector<uint32_t> valueBuffer(n);
+    std::vector<std::array<size_t, 256>> counts(parts);
+    for (unsigned shift = 0; shift < keyBits; shift += 8) {
+        parallelFor(pool, parts, [&](size_t p) {
+            auto& count = counts[p];
+            count.fill(0);
+            for (size_t i = partBegin(p); i < partBegin(p + 1); ++i) {
+                count[(keys[i] >> shift) & 0xff]++;
+            }
+        });
+
+        // 前缀和：桶 d 内按段号依次排列，保证稳定
+        size_t offset = 0;
+        bool trivial = false;
+        for (size_t d = 0; d < 256; ++d) {
+            size_t bucket = 0;
+            for (size_t p = 0; p < parts; ++p) {
+                size_t c = counts[p][d];
+                counts[p][d] = offset + bucket;
+                bucket += c;
+            }
+            trivial = trivial || bucket == n;
+            offset += bucket;
+        }
+        if (trivial) continue;
+
+        parallelFor(pool, parts, [&](size_t p) {
+            auto position = counts[p];
+            for (size_t i = partBegin(p); i < partBegin(p + 1); ++i) {
+                size_t target = position[(keys[i] >> shift) & 0xff]++;
+                keyBuffer[target] = keys[i];
+                valueBuffer[target] = values[i];
+            }
+        });
+        keys.swap(keyBuffer);
+        values.swap(valueBuffer);
+    }
+}
+
+void computeSpatialOrder(std::span<const float> positions, SpatialCurve curve, ThreadPool* pool,
+                         std::vector<uint32_t>& order, std::vector<uint64_t>* sortedKeys) {
+    const size_t n = positions.size() / 3;
+    order.resize(n);
+    std::iota(order.begin(), order.end(), 0u);
+    if (curve == SpatialCurve::None || n < 2) {
+        if (sortedKeys != nullptr) sortedKeys->assign(n, 0);
+        return;
+    }
+
+    // 包围盒
+    const size_t parts = partCount(pool, n);
+    std::vector<std::array<float, 6>> partBounds(parts);
+    parallelFor(pool, parts, [&](size_t p) {
+        std::array<float, 6> b = {positions[0], positions[1], positions[2], positions[0], positions[1], positions[2]};
+        for (size_t i = n * p / parts; i < n * (p + 1) / parts; ++i) {
+            for (size_t c = 0; c < 3; ++c) {
+                b[c] = std::min(b[c], positions[i * 3 + c]);
+                b[3 + c] = std::max(b[3 + c], positions[i * 3 + c]);
+            }
+        }
+        partBounds[p] = b;
+    });
+    std::array<float, 6> bounds = partBounds[0];
+    for (const auto& b : partBounds) {
+        for (size_t c = 0; c < 3; ++c) {
+            bounds[c] = std::min(bounds[c], b[c]);
+            bounds[3 + c] = std::max(bounds[3 + c], b[3 + c]);
+        }
+    }
+    float extent = std::max({bounds[3] - bounds[0], bounds[4] - bounds[1], bounds[5] - bounds[2]});
+    const float scale = extent > 0 ? static_cast<float>(kAxisMax) / extent : 0.0f;
+
+    std::vector<uint64_t> keys(n);
+    parallelFor(pool, parts, [&](size_t p) {
+        for (size_t i = n * p / parts; i < n * (p + 1) / parts; ++i) {
+            uint32_t q[3];
+            for (size_t c = 0; c < 3; ++c) {
+                float v = (positions[i * 3 + c] - bounds[c]) * scale;
+                v = v > 0 ? std::min(v, static_cast<float>(kAxisMax)) : 0.0f;  // 同时挡住 NaN
+                q[c] = static_cast<uint32_t>(v);
+            }
+            keys[i] = curve == SpatialCurve::Hilbert ? hilbertKey(q[0], q[1], q[2]) : mortonKey(q[0], q[1], q[2]);
+        }
+    });
+    parallelRadixSort(keys, order, 3 * kAxisBits, pool);
+    if (sortedKeys != nullptr) *sortedKeys = std::move(keys);
+}
+
+bool extractSpzPoints(std::span<const uint8_t> inflated, std::span<const uint32_t> indices,
+                      std::vector<uint8_t>& out, std::string& error) {
+    SpzLayout sections;
+    if (!parseSpzLayout(inflated, sections, error)) {
+        return false;
+    }
+    const size_t n = indices.size();
+    const size_t trailing = inflated.size() - sections.end;
+    size_t perPoint = 0;
+    for (size_t stride : sections.strides) {
+        perPoint += stride;
+    }
+
+    out.resize(kSpzHeaderBytes + n * perPoint + trailing);
+    std::memcpy(out.data(), inflated.data(), kSpzHeaderBytes);
+    const uint32_t count = static_cast<uint32_t>(n);
+    std::memcpy(out.data() + 8, &count, 4);
+    size_t offset = kSpzHeaderBytes;
+    for (size_t s = 0; s < kSpzSectionCount; ++s) {
+        gather(inflated.data() + sections.offsets[s], out.data() + offset, sections.strides[s], indices, 0, n);
+        offset += n * sections.strides[s];
+    }
+    std::memcpy(out.data() + offset, inflated.data() + sections.end, trailing);
+    return true;
+}
+
+bool permuteSpzBody(std::span<const uint8_t> inflated, std::span<const uint32_t> order, std::vector<uint8_t>& out,
+                    std::string& error) {
+    SpzLayout sections;
+    if (!parseSpzLayout(inflated, sections, error)) {
+        return false;
+    }
+    if (order.size() != sections.numPoints) {
+        error = "Point order does not match SPZ point count";
+        return false;
+    }
+    return extractSpzPoints(inflated, order, out, error);
+}
+
+void permuteSplats(SplatData& splats, std::span<const uint32_t> order, ThreadPool* pool) {
+    const size_t n = splats.numPoints;
+    const size_t parts = partCount(pool, n);
+    auto apply = [&](AlignedArray<float>& attribute, size_t stride) {
+        if (stride == 0) return;
+        AlignedArray<float> permuted(n * stride);
+        parallelFor(pool, parts, [&](size_t p) {
+            gather(attribute.data(), permuted.data(), stride, order, n * p / parts, n * (p + 1) / parts);
+        });
+        attribute = std::move(permuted);
+    };
+    apply(splats.positions, 3);
+    apply(splats.scales, 3);
+    apply(splats.rotations, 4);
+    apply(splats.alphas, 1);
+    apply(splats.colors, 3);
+    apply(splats.sh, static_cast<size_t>(splats.shDim()) * 3);
+}
+
+bool isSpzPermutation(std::span<const uint8_t> a, std::span<const uint8_t> b, std::string& error) {
+    SpzLayout sa;
+    SpzLayout sb;
+    if (!parseSpzLayout(a, sa, error) || !parseSpzLayout(b, sb, error)) {
+        return false;
+    }
+    if (a.size() != b.size() || std::memcmp(a.data(), b.data(), kSpzHeaderBytes) != 0 ||
+        std::memcmp(a.data() + sa.end, b.data() + sb.end, a.size() - sa.end) != 0) {
+        error = "SPZ header or trailing bytes differ";
+        return false;
+    }
+    if (pointHashes(a, sa) != pointHashes(b, sb)) {
+        error = "Splat records differ";
+        return false;
+    }
+    return true;
+}
+
+bool isSpzPartition(std::span<const uint8_t> whole, const std::vector<std::vector<uint8_t>>& parts,
+                    std::string& error) {
+    SpzLayout sw;
+    if (!parseSpzLayout(whole, sw, error)) {
+        return false;
+    }
+    std::vector<uint64_t> hashes;
+    hashes.reserve(sw.numPoints);
+    for (const auto& part : parts) {
+        SpzLayout sp;
+        if (!parseSpzLayout(part, sp, error)) {
+            return false;
+        }
+        // 头中只有 numPoints（偏移 8~11）允许不同
+        if (std::memcmp(part.data(), whole.data(), 8) != 0 ||
+            std::memcmp(part.data() + 12, whole.data() + 12, kSpzHeaderBytes - 12) != 0 ||
+            part.size() - sp.end != whole.size() - sw.end ||
+            std::memcmp(part.data() + sp.end, whole.data() + sw.end, whole.size() - sw.end) != 0) {
+            error = "SPZ header or trailing bytes differ";
+            return false;
+        }
+        auto partHashes = pointHashes(part, sp);
+        hashes.insert(hashes.end(), partHashes.begin(), partHashes.end());
+    }
+    std::sort(hashes.begin(), hashes.end());
+    if (hashes != pointHashes(whole, sw)) {
+        error = "Splat records differ";
+        return false;
+    }
+    return true;
+}
+
+double measureDepthSortMs(std::span<const float> positions) {
+    static constexpr float kDirections[4][3] = {
+        {0.577f, 0.577f, 0.577f}, {-0.873f, 0.436f, 0.218f}, {0.253f, -0.843f, 0.475f}, {0.183f, 0.365f, -0.913f}};
+    const size_t n = positions.size() / 3;
+    std::vector<uint64_t> keys(n);
+    std::vector<uint32_t> indices(n);
+    std::vector<float> sorted(n * 3);
+    float checksum = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& dir : kDirections) {
+        for (size_t i = 0; i < n; ++i) {
+            float depth = positions[i * 3] * dir[0] + positions[i * 3 + 1] * dir[1] + positions[i * 3 + 2] * dir[2];
+            uint32_t bits;
+            std::memcpy(&bits, &depth, sizeof(bits));
+            keys[i] = bits ^ ((bits >> 31) != 0 ? 0xffffffffu : 0x80000000u);  // 浮点数转为可按无符号排序
+            indices[i] = static_cast<uint32_t>(i);
+        }
+        parallelRadixSort(keys, indices, 32, nullptr);
+        for (size_t i = 0; i < n; ++i) {
+            std::memcpy(&sorted[i * 3], &positions[static_cast<size_t>(indices[i]) * 3], 3 * sizeof(float));
+        }
+        checksum += n > 0 ? sorted[(n / 2) * 3] : 0.0f;
+    }
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    // 防止收集结果被优化掉
+    volatile float sink = checksum;
+    (void)sink;
+    return ms / std::size(kDirections);
+}
+
+}  // namespace spz2glb
@@ -0,0 +1,105 @@
+// Copyright (c) 2026 Pu Junhan
+// SPDX-License-Identifier: MIT
+// Project: SPZ-ecosystem
+// Repository: https://github.com/spz-ecosystem/spz2glb
+//
+// 按空间填充曲线（Morton / Hilbert）重排泼溅点
+// 不同训练器导出的 SPZ 点顺序任意：空间上相邻的点在各属性段里也相邻后，gzip 能找到更多重复，
+// 查看器剔除与深度排序时访问内存的局部性也更好
+
+#ifndef SPZ2GLB_SPATIAL_ORDER_H_
+#define SPZ2GLB_SPATIAL_ORDER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace spz2glb {
+
+class ThreadPool;
+struct SplatData;
+
+/**
+ * 重排所用的空间填充曲线
+ */
+enum class SpatialCurve {
+    None,     // 保持输入顺序，默认
+    Morton,   // Z 序：坐标按位交错
+    Hilbert   // Hilbert 曲线：相邻键在空间上总是相邻，局部性更好，键计算稍慢
+};
+
+// 曲线名（"none" / "morton" / "hilbert"），用于命令行、extras 与缓存指纹
+const char* spatialCurveName(SpatialCurve curve);
+
+// 按名字查找曲线，未知名字返回 false
+bool parseSpatialCurve(std::string_view name, SpatialCurve& curve);
+
+/**
+ * 并行 LSD 基数排序：按 keys 的低 keyBits 位升序稳定排序，values 随之移动
+ *
+ * 每趟 8 位：各线程统计自己那段的直方图，前缀和得到每段每个桶的写入位置，再各自分散写出；
+ * 所有键在某一位段上都相同时跳过该趟
+ */
+void parallelRadixSort(std::vector<uint64_t>& keys, std::vector<uint32_t>& values, unsigned keyBits,
+                       ThreadPool* pool);
+
+/**
+ * 计算重排顺序
+ *
+ * 位置按整体包围盒统一量化为每轴 21 位（保持立方体网格），算出 63 位曲线键后基数排序
+ *
+ * @param positions 每个点 xyz
+ * @param order 输出：order[i] 为重排后第 i 个点在原数据中的下标
+ * @param sortedKeys 可选输出：排序后的曲线键，sortedKeys[i] 对应 order[i]。
+ *        Morton 键每 3 位是一层八叉树的子节点序号（最高 3 位为第一层），键前缀相同的点构成一个八叉树节点
+ */
+void computeSpatialOrder(std::span<const float> positions, SpatialCurve curve, ThreadPool* pool,
+                         std::vector<uint32_t>& order, std::vector<uint64_t>* sortedKeys = nullptr);
+
+/**
+ * 按 order 重排已解压的 SPZ 数据：头不变，每个属性段按点搬移，段后的多余字节原样保留
+ *
+ * 只搬移量化后的字节，不重新量化，重排是无损的
+ */
+bool permuteSpzBody(std::span<const uint8_t> inflated, std::span<const uint32_t> order, std::vector<uint8_t>& out,
+                    std::string& error);
+
+/**
+ * 取出 indices 中的点组成一份独立的 SPZ 数据：头只改 numPoints，各属性段按 indices 收集，段后字节原样保留
+ */
+bool extractSpzPoints(std::span<const uint8_t> inflated, std::span<const uint32_t> indices,
+                      std::vector<uint8_t>& out, std::string& error);
+
+/**
+ * 按 order 重排已解码的点集（属性模式）
+ */
+void permuteSplats(SplatData& splats, std::span<const uint32_t> order, ThreadPool* pool);
+
+/**
+ * 判断两份已解压的 SPZ 数据是否只是点的顺序不同
+ *
+ * 头与段后字节必须相同；每个点的全部属性字节算一个 64 位哈希，两边排序后比较
+ */
+bool isSpzPermutation(std::span<const uint8_t> a, std::span<const uint8_t> b, std::string& error);
+
+/**
+ * 判断 parts 是否恰好把 whole 的点分成几份（分块输出的校验）
+ *
+ * 每份的头除 numPoints 外与 whole 相同、段后字节相同；所有份的点哈希合并后与 whole 的相同
+ */
+bool isSpzPartition(std::span<const uint8_t> whole, const std::vector<std::vector<uint8_t>>& parts,
+                    std::string& error);
+
+/**
+ * 模拟查看器每帧的深度排序：沿几个固定视线方向算深度，基数排序后按排序结果收集位置
+ *
+ * 返回每个方向的平均耗时（毫秒，单线程）；用于比较重排前后的内存局部性
+ */
+double measureDepthSortMs(std::span<const float> positions);
+
+}  // namespace spz2glb
+
+#endif  // SPZ2GLB_SPATIAL_ORDER_H_
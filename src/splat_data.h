@@ -0,0 +1,130 @@
+// Copyright (c) 2026 Pu Junhan
+// SPDX-License-Identifier: MIT
+// Project: SPZ-ecosystem
+// Repository: https://github.com/spz-ecosystem/spz2glb
+//
+// 解码后的高斯泼溅数据（结构数组 SoA）
+// 每个属性一段连续、64 字节对齐的 float 数组，便于 SIMD 处理与整段写出
+
+#ifndef SPZ2GLB_SPLAT_DATA_H_
+#define SPZ2GLB_SPLAT_DATA_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <span>
+#include <utility>
+
+namespace spz2glb {
+
+/**
+ * 64 字节（缓存行）对齐的定长数组
+ *
+ * 与 std::vector 不同，resize 不做零初始化：解码器会写满每个元素，
+ * 几千万个点时省掉一遍对整块内存的写入
+ */
+template <typename T>
+class AlignedArray {
+public:
+    static constexpr size_t kAlignment = 64;
+
+    AlignedArray() = default;
+    explicit AlignedArray(size_t size) { resize(size); }
+    ~AlignedArray() { release(); }
+
+    AlignedArray(const AlignedArray&) = delete;
+    AlignedArray& operator=(const AlignedArray&) = delete;
+
+    AlignedArray(AlignedArray&& other) noexcept
+        : data_(std::exchange(other.data_, nullptr)), size_(std::exchange(other.size_, 0)) {}
+    AlignedArray& operator=(AlignedArray&& other) noexcept {
+        if (this != &other) {
+            release();
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+        }
+        return *this;
+    }
+
+    // 重新分配（旧内容不保留）
+    void resize(size_t size) {
+        if (size == size_) return;
+        release();
+        if (size > 0) {
+            data_ = static_cast<T*>(::operator new(size * sizeof(T), std::align_val_t(kAlignment)));
+            size_ = size;
+        }
+    }
+
+    T* data() { return data_; }
+    const T* data() const { return data_; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    T& operator[](size_t i) { return data_[i]; }
+    const T& operator[](size_t i) const { return data_[i]; }
+
+    std::span<T> span() { return {data_, size_}; }
+    std::span<const T> span() const { return {data_, size_}; }
+
+private:
+    void release() {
+        if (data_ != nullptr) {
+            ::operator delete(data_, std::align_val_t(kAlignment));
+            data_ = nullptr;
+            size_ = 0;
+        }
+    }
+
+    T* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+/**
+ * 高斯泼溅点集（SoA）
+ *
+ * 每个属性按点顺序连续存放，分量交错在点内（位置为 x0 y0 z0 x1 y1 z1 ...），
+ * 与 SPZ 流内的顺序以及 glTF accessor 的 VEC3/VEC4 布局一致
+ *
+ * 数值约定（与 SPZ 参考实现的解包结果一致，除不透明度外）：
+ * - positions：世界坐标
+ * - scales：对数尺度（实际尺度为 exp(scale)）
+ * - rotations：单位四元数，分量顺序 x y z w
+ * - alphas：不透明度 [0, 1]（已过 sigmoid；SPZ 参考实现解包为 logit）
+ * - colors：0 阶球谐系数（DC），颜色 = 0.5 + 0.282095 * dc
+ * - sh：1~3 阶球谐系数，每个点 shDim 个系数，每个系数 RGB 三个分量
+ */
+struct SplatData {
+    uint32_t numPoints = 0;
+    uint32_t shDegree = 0;
+    bool antialiased = false;
+
+    AlignedArray<float> positions;  // numPoints * 3
+    AlignedArray<float> scales;     // numPoints * 3
+    AlignedArray<float> rotations;  // numPoints * 4
+    AlignedArray<float> alphas;     // numPoints
+    AlignedArray<float> colors;     // numPoints * 3
+    AlignedArray<float> sh;         // numPoints * shDim * 3
+
+    // 每个点的高阶球谐系数个数：0 / 3 / 8 / 15
+    static constexpr uint32_t shDimForDegree(uint32_t degree) {
+        return degree == 0 ? 0 : (degree + 1) * (degree + 1) - 1;
+    }
+    uint32_t shDim() const { return shDimForDegree(shDegree); }
+
+    void allocate(uint32_t points, uint32_t degree) {
+        numPoints = points;
+        shDegree = degree;
+        size_t n = points;
+        positions.resize(n * 3);
+        scales.resize(n * 3);
+        rotations.resize(n * 4);
+        alphas.resize(n);
+        colors.resize(n * 3);
+        sh.resize(n * shDimForDegree(degree) * 3);
+    }
+};
+
+}  // namespace spz2glb
+
+#endif  // SPZ2GLB_SPLAT_DATA_H_
@@ -0,0 +1,583 @@
+// Copyright (c) 2026 Pu Junhan
+// SPDX-License-Identifier: MIT
+// Project: SPZ-ecosystem
+// Repository: https://github.com/spz-ecosystem/spz2glb
+//
+// 细节层次金字塔实现
+
+#include "splat_lod.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <optional>
+#include <zlib.h>
+
+#include <fastgltf/core.hpp>
+
+#include "gzip_index.h"
+#include "optimal_deflate.h"
+#include "spatial_order.h"
+#include "spz_converter.h"
+#include "spz_decoder.h"
+#include "thread_pool.h"
+
+namespace spz2glb {
+
+namespace {
+
+constexpr uint32_t kKeyDigits = 21;    // Morton 键的八叉树层数
+constexpr size_t kMaxShFloats = 45;    // 3 阶球谐：15 个系数 × RGB
+constexpr float kColorScale = 0.15f;   // 与解码器一致
+constexpr float kMinLogScale = -10.0f;  // 尺度字节 0 ~ 255 对应的对数尺度范围
+constexpr float kMaxLogScale = 255.0f / 16.0f - 10.0f;
+
+// 键 key 在深度 depth 的八叉树单元
+inline uint64_t cellOf(uint64_t key, uint32_t depth) {
+    return depth == 0 ? 0 : key >> (3 * (kKeyDigits - depth));
+}
+
+/**
+ * 各深度的不同单元数：相邻两键的公共前缀层数 l 决定它们从第 l + 1 层起分属不同单元
+ */
+std::array<size_t, kKeyDigits + 1> countCells(const std::vector<uint64_t>& keys) {
+    std::array<size_t, kKeyDigits + 1> common = {};
+    for (size_t i = 1; i < keys.size(); ++i) {
+        uint64_t x = keys[i] ^ keys[i - 1];
+        size_t digits = x == 0 ? kKeyDigits : static_cast<size_t>(std::countl_zero(x) - 1) / 3;  // 键只有 63 位
+        common[digits]++;
+    }
+    std::array<size_t, kKeyDigits + 1> cells = {};
+    size_t boundaries = 0;
+    for (uint32_t d = 0; d <= kKeyDigits; ++d) {
+        cells[d] = 1 + boundaries;
+        boundaries += common[d];
+    }
+    return cells;
+}
+
+/**
+ * 一个单元内泼溅点的加权累加量（double，可跨段相加）
+ */
+struct Cluster {
+    uint64_t cell = 0;
+    uint32_t count = 0;
+    uint32_t first = 0;                 // 第一个点在输入中的下标（只有一个点时原样复制）
+    double weight = 0;                  // sum(w)
+    std::array<double, 3> position = {};  // sum(w × p)
+    std::array<double, 6> moment = {};    // sum(w × (Σ_i + p pᵀ))：xx yy zz xy xz yz
+    double coverage = 0;                // sum(a × A)
+    std::array<double, 3> color = {};
+    std::array<double, kMaxShFloats> sh = {};
+
+    void add(const Cluster& other) {
+        count += other.count;
+        weight += other.weight;
+        coverage += other.coverage;
+        for (size_t c = 0; c < 3; ++c) position[c] += other.position[c];
+        for (size_t c = 0; c < 6; ++c) moment[c] += other.moment[c];
+        for (size_t c = 0; c < 3; ++c) color[c] += other.color[c];
+        for (size_t c = 0; c < kMaxShFloats; ++c) sh[c] += other.sh[c];
+    }
+};
+
+// 已解码的第 j 个点累加进 cluster
+void accumulate(Cluster& cluster, const SplatData& splats, size_t j, size_t shFloats) {
+    const float* p = splats.positions.data() + j * 3;
+    const float* s = splats.scales.data() + j * 3;
+    const float* q = splats.rotations.data() + j * 4;
+    const double alpha = splats.alphas[j];
+    const double sx = std::exp(s[0]), sy = std::exp(s[1]), sz = std::exp(s[2]);
+    const double w = alpha * sx * sy * sz + 1e-30;  // 全透明的单元退化为等权平均
+
+    // R diag(s²) Rᵀ
+    const double x = q[0], y = q[1], z = q[2], qw = q[3];
+    const double r[3][3] = {{1 - 2 * (y * y + z * z), 2 * (x * y - qw * z), 2 * (x * z + qw * y)},
+                            {2 * (x * y + qw * z), 1 - 2 * (x * x + z * z), 2 * (y * z - qw * x)},
+                            {2 * (x * z - qw * y), 2 * (y * z + qw * x), 1 - 2 * (x * x + y * y)}};
+    const double d[3] = {sx * sx, sy * sy, sz * sz};
+    auto cov = [&](int a, int b) { return r[a][0] * r[b][0] * d[0] + r[a][1] * r[b][1] * d[1] + r[a][2] * r[b][2] * d[2]; };
+    static constexpr int kPairs[6][2] = {{0, 0}, {1, 1}, {2, 2}, {0, 1}, {0, 2}, {1, 2}};
+
+    cluster.count++;
+    cluster.weight += w;
+    cluster.coverage += alpha * (sx * sy + sy * sz + sx * sz);
+    for (size_t c = 0; c < 3; ++c) {
+        cluster.position[c] += w * p[c];
+        cluster.color[c] += w * splats.colors[j * 3 + c];
+    }
+    for (size_t c = 0; c < 6; ++c) {
+        int a = kPairs[c][0];
+        int b = kPairs[c][1];
+        cluster.moment[c] += w * (cov(a, b) + static_cast<double>(p[a]) * p[b]);
+    }
+    for (size_t c = 0; c < shFloats; ++c) {
+        cluster.sh[c] += w * splats.sh[j * shFloats + c];
+    }
+}
+
+/**
+ * 3×3 对称矩阵的 Jacobi 特征分解：a 的对角线变为特征值，v 的列为对应特征向量
+ */
+void symmetricEigen(double a[3][3], double v[3][3]) {
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) v[i][j] = i == j ? 1.0 : 0.0;
+    }
+    for (int sweep = 0; sweep < 32; ++sweep) {
+        double off = a[0][1] * a[0][1] + a[0][2] * a[0][2] + a[1][2] * a[1][2];
+        if (off < 1e-30 * (a[0][0] * a[0][0] + a[1][1] * a[1][1] + a[2][2] * a[2][2]) || off == 0) break;
+        for (int p = 0; p < 2; ++p) {
+            for (int q = p + 1; q < 3; ++q) {
+                if (a[p][q] == 0) continue;
+                double theta = (a[q][q] - a[p][p]) / (2 * a[p][q]);
+                double t = (theta >= 0 ? 1.0 : -1.0) / (std::fabs(theta) + std::sqrt(theta * theta + 1));
+                double c = 1 / std::sqrt(t * t + 1);
+                double s = t * c;
+                for (int k = 0; k < 3; ++k) {  // A ← A J
+                    double akp = a[k][p];
+                    double akq = a[k][q];
+                    a[k][p] = c * akp - s * akq;
+                    a[k][q] = s * akp + c * akq;
+                }
+                for (int k = 0; k < 3; ++k) {  // A ← Jᵀ A
+                    double apk = a[p][k];
+                    double aqk = a[q][k];
+                    a[p][k] = c * apk - s * aqk;
+                    a[q][k] = s * apk + c * aqk;
+                }
+                for (int k = 0; k < 3; ++k) {
+                    double vkp = v[k][p];
+                    double vkq = v[k][q];
+                    v[k][p] = c * vkp - s * vkq;
+                    v[k][q] = s * vkp + c * vkq;
+                }
+            }
+        }
+    }
+}
+
+uint8_t toByte(double value) {
+    return static_cast<uint8_t>(std::clamp(std::lround(value), 0L, 255L));
+}
+
+uint16_t floatToHalf(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    uint32_t sign = (bits >> 16) & 0x8000;
+    int32_t exponent = static_cast<int32_t>((bits >> 23) & 0xFF) - 127 + 15;
+    uint32_t mantissa = bits & 0x7FFFFF;
+    if (exponent >= 31) return static_cast<uint16_t>(sign | 0x7C00);
+    if (exponent <= 0) {
+        if (exponent < -10) return static_cast<uint16_t>(sign);
+        mantissa |= 0x800000;
+        uint32_t shift = static_cast<uint32_t>(14 - exponent);
+        return static_cast<uint16_t>(sign | ((mantissa + (1u << (shift - 1))) >> shift));
+    }
+    // 进位可能溢出到指数，结果仍正确（最大进到无穷）
+    return static_cast<uint16_t>(sign | ((static_cast<uint32_t>(exponent) << 10) + ((mantissa + 0x1000) >> 13)));
+}
+
+/**
+ * 把单元合并为一个点并量化，追加到各属性段
+ */
+void emitCluster(const Cluster& cluster, const SpzLayout& body, std::span<const uint8_t> inflated,
+                 std::array<std::vector<uint8_t>, kSpzSectionCount>& out) {
+    if (cluster.count == 1) {
+        for (size_t s = 0; s < kSpzSectionCount; ++s) {
+            const uint8_t* src = inflated.data() + body.offsets[s] + static_cast<size_t>(cluster.first) * body.strides[s];
+            out[s].insert(out[s].end(), src, src + body.strides[s]);
+        }
+        return;
+    }
+
+    const double w = cluster.weight;
+    double mean[3];
+    for (size_t c = 0; c < 3; ++c) mean[c] = cluster.position[c] / w;
+    double cov[3][3];
+    cov[0][0] = cluster.moment[0] / w - mean[0] * mean[0];
+    cov[1][1] = cluster.moment[1] / w - mean[1] * mean[1];
+    cov[2][2] = cluster.moment[2] / w - mean[2] * mean[2];
+    cov[0][1] = cov[1][0] = cluster.moment[3] / w - mean[0] * mean[1];
+    cov[0][2] = cov[2][0] = cluster.moment[4] / w - mean[0] * mean[2];
+    cov[1][2] = cov[2][1] = cluster.moment[5] / w - mean[1] * mean[2];
+    double v[3][3];
+    symmetricEigen(cov, v);
+
+    // 特征向量构成右手系旋转矩阵，再转为四元数
+    double det = v[0][0] * (v[1][1] * v[2][2] - v[1][2] * v[2][1]) - v[0][1] * (v[1][0] * v[2][2] - v[1][2] * v[2][0]) +
+                 v[0][2] * (v[1][0] * v[2][1] - v[1][1] * v[2][0]);
+    if (det < 0) {
+        for (int k = 0; k < 3; ++k) v[k][2] = -v[k][2];
+    }
+    double q[4];  // x y z w
+    double trace = v[0][0] + v[1][1] + v[2][2];
+    if (trace > 0) {
+        double s = 2 * std::sqrt(trace + 1);
+        q[3] = s / 4;
+        q[0] = (v[2][1] - v[1][2]) / s;
+        q[1] = (v[0][2] - v[2][0]) / s;
+        q[2] = (v[1][0] - v[0][1]) / s;
+    } else if (v[0][0] > v[1][1] && v[0][0] > v[2][2]) {
+        double s = 2 * std::sqrt(1 + v[0][0] - v[1][1] - v[2][2]);
+        q[3] = (v[2][1] - v[1][2]) / s;
+        q[0] = s / 4;
+        q[1] = (v[0][1] + v[1][0]) / s;
+        q[2] = (v[0][2] + v[2][0]) / s;
+    } else if (v[1][1] > v[2][2]) {
+        double s = 2 * std::sqrt(1 + v[1][1] - v[0][0] - v[2][2]);
+        q[3] = (v[0][2] - v[2][0]) / s;
+        q[0] = (v[0][1] + v[1][0]) / s;
+        q[1] = s / 4;
+        q[2] = (v[1][2] + v[2][1]) / s;
+    } else {
+        double s = 2 * std::sqrt(1 + v[2][2] - v[0][0] - v[1][1]);
+        q[3] = (v[1][0] - v[0][1]) / s;
+        q[0] = (v[0][2] + v[2][0]) / s;
+        q[1] = (v[1][2] + v[2][1]) / s;
+        q[2] = s / 4;
+    }
+    double norm = std::sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+    for (double& c : q) c /= norm;
+
+    double logScale[3];
+    double scale[3];
+    for (int c = 0; c < 3; ++c) {
+        logScale[c] = std::clamp(0.5 * std::log(std::max(cov[c][c], 1e-30)), static_cast<double>(kMinLogScale),
+                                 static_cast<double>(kMaxLogScale));
+        scale[c] = std::exp(logScale[c]);
+    }
+    double area = scale[0] * scale[1] + scale[1] * scale[2] + scale[0] * scale[2];
+    double alpha = std::min(1.0, cluster.coverage / area);
+
+    // 位置
+    if (body.version == 1) {
+        for (int c = 0; c < 3; ++c) {
+            uint16_t h = floatToHalf(static_cast<float>(mean[c]));
+            out[0].push_back(static_cast<uint8_t>(h & 0xFF));
+            out[0].push_back(static_cast<uint8_t>(h >> 8));
+        }
+    } else {
+        const double fixedScale = static_cast<double>(1u << std::min<uint32_t>(body.fractionalBits, 31));
+        for (int c = 0; c < 3; ++c) {
+            long fixed = std::clamp(std::lround(mean[c] * fixedScale), -0x800000L, 0x7FFFFFL);
+            uint32_t bits = static_cast<uint32_t>(fixed) & 0xFFFFFF;
+            out[0].push_back(static_cast<uint8_t>(bits & 0xFF));
+            out[0].push_back(static_cast<uint8_t>((bits >> 8) & 0xFF));
+            out[0].push_back(static_cast<uint8_t>(bits >> 16));
+        }
+    }
+    out[1].push_back(toByte(alpha * 255.0));
+    for (int c = 0; c < 3; ++c) {
+        out[2].push_back(toByte((cluster.color[c] / w * kColorScale + 0.5) * 255.0));
+    }
+    for (int c = 0; c < 3; ++c) {
+        out[3].push_back(toByte((logScale[c] + 10.0) * 16.0));
+    }
+    if (body.version >= 3) {
+        // “最小三分量”：最大分量取正，其余三个分量从下标大到小依次放在低位起的 10 位字段
+        int largest = 0;
+        for (int c = 1; c < 4; ++c) {
+            if (std::fabs(q[c]) > std::fabs(q[largest])) largest = c;
+        }
+        double sign = q[largest] < 0 ? -1.0 : 1.0;
+        uint32_t packed = static_cast<uint32_t>(largest) << 30;
+        uint32_t shift = 0;
+        for (int c = 3; c >= 0; --c) {
+            if (c == largest) continue;
+            double value = q[c] * sign;
+            uint32_t magnitude = static_cast<uint32_t>(
+                std::min(511L, std::lround(std::fabs(value) * 511.0 / 0.70710678118654752)));
+            packed |= (magnitude | (value < 0 ? 0x200u : 0u)) << shift;
+            shift += 10;
+        }
+        for (int b = 0; b < 4; ++b) out[4].push_back(static_cast<uint8_t>(packed >> (8 * b)));
+    } else {
+        double sign = q[3] < 0 ? -1.0 : 1.0;  // w 由 xyz 推出，取非负
+        for (int c = 0; c < 3; ++c) {
+            out[4].push_back(toByte((q[c] * sign + 1.0) * 127.5));
+        }
+    }
+    for (size_t c = 0; c < body.stride(SpzSection::Sh); ++c) {
+        out[5].push_back(toByte(cluster.sh[c] / w * 128.0 + 128.0));
+    }
+}
+
+/**
+ * 一段已排序点的合并结果
+ *
+ * 段首、段尾的单元可能延续到相邻段，保留为累加量由调用方串行拼接；
+ * 中间的单元已完整，直接量化到 interior
+ */
+struct PartResult {
+    Cluster head;
+    std::optional<Cluster> tail;  // 段内只有一个单元时为空（head 即整段）
+    std::array<std::vector<uint8_t>, kSpzSectionCount> interior;
+    uint32_t interiorPoints = 0;
+    std::string error;
+};
+
+void mergePart(std::span<const uint8_t> inflated, const SpzLayout& body, std::span<const uint32_t> order,
+               std::span<const uint64_t> keys, uint32_t depth, PartResult& result) {
+    std::vector<uint8_t> extracted;
+    SplatData splats;
+    if (!extractSpzPoints(inflated, order, extracted, result.error) ||
+        !decodeSpz(extracted, splats, result.error)) {
+        return;
+    }
+    Cluster current;
+    bool first = true;
+    for (size_t j = 0; j < order.size(); ++j) {
+        uint64_t cell = cellOf(keys[j], depth);
+        if (j == 0 || cell != current.cell) {
+            if (j > 0) {
+                if (first) {
+                    result.head = current;
+                    first = false;
+                } else {
+                    emitCluster(current, body, inflated, result.interior);
+                    result.interiorPoints++;
+                }
+            }
+            current = Cluster();
+            current.cell = cell;
+            current.first = order[j];
+        }
+        accumulate(current, splats, j, body.stride(SpzSection::Sh));
+    }
+    if (first) {
+        result.head = current;
+    } else {
+        result.tail = current;
+    }
+}
+
+/**
+ * 按深度 depth 的单元合并所有点，生成一份完整的 SPZ 数据
+ */
+bool buildLevel(std::span<const uint8_t> inflated, const SpzLayout& body, const std::vector<uint32_t>& order,
+                const std::vector<uint64_t>& keys, uint32_t depth, ThreadPool* pool, std::vector<uint8_t>& out,
+                uint32_t& numPoints, std::string& error) {
+    const size_t n = order.size();
+    const size_t parts = (n + kLodPartPoints - 1) / kLodPartPoints;
+    std::vector<PartResult> results(parts);
+    parallelFor(pool, parts, [&](size_t p) {
+        size_t begin = p * kLodPartPoints;
+        size_t count = std::min(kLodPartPoints, n - begin);
+        mergePart(inflated, body, std::span(order).subspan(begin, count), std::span(keys).subspan(begin, count), depth,
+                  results[p]);
+    });
+
+    // 串行拼接：跨段的单元相加后量化，段内完整的单元按原顺序接上
+    std::array<std::vector<uint8_t>, kSpzSectionCount> sections;
+    numPoints = 0;
+    std::optional<Cluster> pending;
+    auto flush = [&] {
+        if (pending) {
+            emitCluster(*pending, body, inflated, sections);
+            numPoints++;
+            pending.reset();
+        }
+    };
+    for (auto& part : results) {
+        if (!part.error.empty()) {
+            error = part.error;
+            return false;
+        }
+        if (pending && pending->cell == part.head.cell) {
+            pending->add(part.head);
+        } else {
+            flush();
+            pending = part.head;
+        }
+        if (part.tail) {
+            flush();
+            for (size_t s = 0; s < kSpzSectionCount; ++s) {
+                sections[s].insert(sections[s].end(), part.interior[s].begin(), part.interior[s].end());
+                part.interior[s] = std::vector<uint8_t>();
+            }
+            numPoints += part.interiorPoints;
+            pending = part.tail;
+        }
+    }
+    flush();
+
+    out.assign(inflated.begin(), inflated.begin() + sizeof(SpzHeader));
+    std::memcpy(out.data() + 8, &numPoints, 4);
+    for (const auto& section : sections) {
+        out.insert(out.end(), section.begin(), section.end());
+    }
+    out.insert(out.end(), inflated.begin() + body.end, inflated.end());
+    return true;
+}
+
+std::optional<std::string> writeLodExtras(std::size_t index, fastgltf::Category category, void* userPointer) {
+    const auto* glb = static_cast<const LodGlb*>(userPointer);
+    if (category != fastgltf::Category::Nodes || index >= glb->levels.size()) {
+        return std::nullopt;
+    }
+    const LodLevel& level = glb->levels[index];
+    return "{\"spz2glb:lod\":{\"level\":" + std::to_string(level.level) + ",\"points\":" +
+           std::to_string(level.numPoints) + "}}";
+}
+
+}  // anonymous namespace
+
+SpzResult buildLodGlb(std::span<const uint8_t> spzData, LodGlb& glb, const ConvertOptions& options) {
+    auto inflated = decompressSpzData(spzData);
+    if (!inflated.success) {
+        return inflated;
+    }
+    std::string error;
+    SpzLayout body;
+    AlignedArray<float> positions;
+    if (!parseSpzLayout(inflated.data, body, error) ||
+        !decodeSpzPositions(inflated.data, positions, error, options.pool)) {
+        return SpzResult::error(SpzErrorCode::ConversionFailed, "LOD: " + error);
+    }
+    const size_t n = body.numPoints;
+    if (n == 0) {
+        return SpzResult::error(SpzErrorCode::ConversionFailed, "LOD requires at least one point");
+    }
+
+    std::vector<uint32_t> order;
+    std::vector<uint64_t> keys;
+    computeSpatialOrder(positions.span(), SpatialCurve::Morton, options.pool, order, &keys);
+    positions = AlignedArray<float>();
+    auto cells = countCells(keys);
+
+    glb.levels.clear();
+    LodLevel finest;
+    finest.numPoints = body.numPoints;
+    finest.byteLength = spzData.size();
+    glb.levels.push_back(std::move(finest));
+
+    // 每层取不同单元数不超过目标的最深一层八叉树；点数不再减少时停止
+    std::vector<std::vector<uint8_t>> bodies;
+    double target = static_cast<double>(n);
+    for (uint32_t k = 1; k <= std::min(options.lodLevels, kMaxLodLevels); ++k) {
+        target /= kLodRatio;
+        uint32_t depth = 0;
+        while (depth < kKeyDigits && static_cast<double>(cells[depth + 1]) <= target) {
+            ++depth;
+        }
+        if (cells[depth] >= glb.levels.back().numPoints) {
+            break;
+        }
+        LodLevel level;
+        level.level = k;
+        level.cellDepth = depth;
+        std::vector<uint8_t> merged;
+        if (!buildLevel(inflated.data, body, order, keys, depth, options.pool, merged, level.numPoints, error)) {
+            return SpzResult::error(SpzErrorCode::ConversionFailed, "LOD: " + error);
+        }
+        bodies.push_back(std::move(merged));
+        glb.levels.push_back(std::move(level));
+    }
+    order = std::vector<uint32_t>();
+    keys = std::vector<uint64_t>();
+
+    // 各粗层互不依赖，并行压缩
+    const int compressionLevel = options.recompress ? kMaxRatioLevel : Z_BEST_COMPRESSION;
+    std::vector<std::string> errors(bodies.size());
+    parallelFor(options.pool, bodies.size(), [&](size_t i) {
+        LodLevel& level = glb.levels[i + 1];
+        if (compressGzip(bodies[i], compressionLevel, nullptr, level.payload, errors[i], options.cancel)) {
+            level.byteLength = level.payload.size();
+            level.payload.resize((level.payload.size() + 3) & ~size_t{3}, 0);
+        }
+        bodies[i] = std::vector<uint8_t>();
+    });
+    for (const auto& message : errors) {
+        if (!message.empty()) {
+            return SpzResult::error(SpzErrorCode::ConversionFailed, "LOD: " + message);
+        }
+    }
+
+    // BIN：最粗的层在前，第 0 层（输入原样）在最后
+    glb.segments.clear();
+    uint64_t binSize = 0;
+    for (size_t k = glb.levels.size(); k-- > 1;) {
+        glb.levels[k].byteOffset = binSize;
+        binSize += glb.levels[k].payload.size();
+        glb.segments.push_back(glb.levels[k].payload);
+    }
+    glb.levels[0].byteOffset = binSize;
+    binSize += spzData.size();
+    glb.segments.push_back(spzData);
+    if (options.verbose) {
+        for (const auto& level : glb.levels) {
+            std::cout << "[INFO] LOD " << level.level << ": " << level.numPoints << " points, " << level.byteLength
+                      << " bytes" << (level.level == 0 ? " (input stream)" : "") << std::endl;
+        }
+    }
+
+    fastgltf::Asset asset = createSplatAsset(true);
+    if (glb.levels.size() > 1) {
+        asset.extensionsUsed.emplace_back("MSFT_lod");
+    }
+    addGlbBinBuffer(asset, binSize);
+
+    for (size_t k = 0; k < glb.levels.size(); ++k) {
+        fastgltf::BufferView view;
+        view.bufferIndex = 0;
+        view.byteOffset = glb.levels[k].byteOffset;
+        view.byteLength = glb.levels[k].byteLength;
+        asset.bufferViews.emplace_back(std::move(view));
+
+        fastgltf::Primitive primitive;
+        primitive.type = fastgltf::PrimitiveType::Points;
+        auto gaussianSplat = std::make_unique<fastgltf::GaussianSplatExtension>();
+        auto spzCompression = std::make_unique<fastgltf::GaussianSplatSpzCompression>();
+        spzCompression->bufferView = k;
+        gaussianSplat->spzCompression = std::move(spzCompression);
+        primitive.gaussianSplat = std::move(gaussianSplat);
+
+        fastgltf::Mesh mesh;
+        mesh.primitives.emplace_back(std::move(primitive));
+        asset.meshes.emplace_back(std::move(mesh));
+
+        fastgltf::Node node;
+        node.meshIndex = k;
+        std::string name = "lod" + std::to_string(k);
+        node.name.assign(name.data(), name.size());
+        asset.nodes.emplace_back(std::move(node));
+    }
+    // 场景只含第 0 层：不认识 MSFT_lod 的查看器照常显示完整精度
+    fastgltf::Scene scene;
+    scene.nodeIndices.emplace_back(0);
+    asset.scenes.emplace_back(std::move(scene));
+    asset.defaultScene = 0;
+
+    GlbJsonExporter exporter;
+    exporter.setExtrasWriteCallback(writeLodExtras);
+    exporter.setUserPointer(&glb);
+    std::string json;
+    auto exportError = exporter.writeBinaryJson(asset, json);
+    if (exportError != fastgltf::Error::None) {
+        return SpzResult::error(SpzErrorCode::ConversionFailed,
+            "GLB export failed: " + std::string(fastgltf::getErrorMessage(exportError)));
+    }
+    if (glb.levels.size() > 1) {
+        // fastgltf 不支持 node 上的 MSFT_lod，在第 0 个 node 开头插入：ids 从细到粗
+        const std::string nodes = "\"nodes\":[{";
+        size_t at = json.find(nodes);
+        if (at == std::string::npos) {
+            return SpzResult::error(SpzErrorCode::ConversionFailed, "GLB export failed: nodes not found");
+        }
+        std::string lod = "\"extensions\":{\"MSFT_lod\":{\"ids\":[";
+        for (size_t k = 1; k < glb.levels.size(); ++k) {
+            lod += (k > 1 ? "," : "") + std::to_string(k);
+        }
+        lod += "]}},";
+        json.insert(at + nodes.size(), lod);
+    }
+    if (!finishGlbPreamble(json, binSize, glb.layout, glb.preamble, error)) {
+        return SpzResult::error(SpzErrorCode::ConversionFailed, error);
+    }
+    return SpzResult::ok({});
+}
+
+}  // namespace spz2glb
@@ -0,0 +1,78 @@
+// Copyright (c) 2026 Pu Junhan
+// SPDX-License-Identifier: MIT
+// Project: SPZ-ecosystem
+// Repository: https://github.com/spz-ecosystem/spz2glb
+//
+// 细节层次金字塔（--lod）
+// 把空间上相邻的泼溅点按八叉树单元合并，生成若干更粗的层级；每层是独立的 SPZ 流，
+// 查看器先下载、显示最粗的一层，再逐层细化，缩短首帧时间
+
+#ifndef SPZ2GLB_SPLAT_LOD_H_
+#define SPZ2GLB_SPLAT_LOD_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "glb_writer.h"
+
+struct SpzResult;
+
+namespace spz2glb {
+
+struct ConvertOptions;
+
+// 相邻两层的目标点数之比
+constexpr uint32_t kLodRatio = 4;
+
+// 最多生成的粗层数
+constexpr uint32_t kMaxLodLevels = 8;
+
+// 并行合并时每段的点数（跨段的单元以累加量相加，段内只解码自己的点）
+constexpr size_t kLodPartPoints = 64 * 1024;
+
+/**
+ * 一个细节层次
+ */
+struct LodLevel {
+    uint32_t level = 0;            // 0 为输入本身（最细），越大越粗
+    uint32_t numPoints = 0;
+    uint32_t cellDepth = 0;        // 合并所用八叉树单元的深度（第 0 层为 0，表示未合并）
+    std::vector<uint8_t> payload;  // 该层的 SPZ gzip 流，末尾补零到 4 字节对齐（第 0 层为空，直接引用输入）
+    uint64_t byteLength = 0;       // gzip 流本身的长度
+    uint64_t byteOffset = 0;       // 在 BIN 中的偏移
+};
+
+/**
+ * LOD GLB 的内存表示：segments 指向各粗层的 payload 与输入本身，
+ * BIN 中从最粗的一层排到第 0 层，顺序下载时先拿到最粗的层
+ */
+struct LodGlb : SegmentedGlb {
+    std::vector<LodLevel> levels;  // levels[k] 即第 k 层，对应 bufferView / mesh / node k
+};
+
+/**
+ * 生成 LOD 金字塔 GLB
+ *
+ * 第 0 层是输入的 SPZ 流原样（无损）。第 k 层的目标点数为 N / kLodRatio^k：点按 Morton 键排序，
+ * 取不同单元数不超过目标的最深八叉树层，同一单元内的点合并为一个：
+ * - 权重 = 不透明度 × 体积（三个尺度之积），位置、颜色、球谐为加权平均
+ * - 协方差 = 各点协方差与位置离散度的加权平均，特征分解得到旋转与尺度
+ * - 不透明度按投影面积守恒：sum(a_i × A_i) / A，A 为三个尺度两两乘积之和，上限 1
+ * 单元内只有一个点时直接复制其量化字节。
+ *
+ * 已排序的点切成 kLodPartPoints 个点的段，在 options.pool 上并行合并，跨段的单元以累加量拼接；
+ * 每段只把自己的点解码为 float，解码的峰值内存与段大小（而不是场景大小）成正比。
+ * 点数不再减少时停止生成更粗的层。
+ *
+ * 第 0 层的 node 在场景中，带 MSFT_lod 扩展，ids 依次为更粗层的 node；每个 node 的 extras 为
+ *   {"spz2glb:lod":{"level":k,"points":N}}
+ * 粗层数由 options.lodLevels 给出（1 ~ kMaxLodLevels）
+ */
+SpzResult buildLodGlb(std::span<const uint8_t> spzData, LodGlb& glb, const ConvertOptions& options);
+
+}  // namespace spz2glb
+
+#endif  // SPZ2GLB_SPLAT_LOD_H_
@@ -0,0 +1,801 @@
+// Copyright (c) 2026 Pu Junhan
+// SPDX-License-Identifier: MIT
+// Project: SPZ-ecosystem
+// Repository: https://github.com/spz-ecosystem/spz2glb
+//
+/**
+ * spz2glb 性能基准
+ *
+ * inflate：用每个编译进来的编解码器解压真实的 SPZ 文件，比较吞吐量并确认输出一致
+ * decode：SIMD 与纯标量解码内核的耗时与逐元素比对
+ * suite：在合成 SPZ 语料上测量各阶段的吞吐量、分配次数与峰值 RSS，输出 JSON，可与基线比较
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <simdjson.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+#include "deflate_codec.h"
+#include "glb_writer.h"
+#include "memory_pool.h"
+#include "spz2glb_core.h"
+#include "spz2glb_wasm_c_api.h"
+#include "spz_converter.h"
+#include "spz_decoder.h"
+#include "spz_verifier.h"
+#include "synthetic_spz.h"
+#include "thread_pool.h"
+
+namespace {
+
+/**
+ * 每个编解码器解压 iterations 次，取最快一次
+ *
+ * 吞吐量按解压输出字节数计算（MB/s，1 MB = 2^20 字节）
+ */
+bool benchInflate(const std::vector<std::string>& paths, int iterations) {
+    auto codecs = spz2glb::availableCodecs();
+    std::cout << std::left << std::setw(32) << "file" << std::setw(10) << "codec" << std::right << std::setw(12)
+              << "inflated" << std::setw(12) << "best ms" << std::setw(12) << "MB/s" << "\n";
+
+    bool ok = true;
+    for (const auto& path : paths) {
+        spz2glb::MappedFile file;
+        if (!file.open(path)) {
+            std::cerr << "[ERROR] Cannot open " << path << std::endl;
+            ok = false;
+            continue;
+        }
+
+        std::vector<uint8_t> reference;
+        for (const auto* codec : codecs) {
+            std::vector<uint8_t> out;
+            std::string error;
+            double best = 0;
+            for (int i = 0; i < iterations; ++i) {
+                auto start = std::chrono::steady_clock::now();
+                bool success = codec->gunzip(file.bytes(), out, error);
+                double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+                if (!success) {
+                    std::cerr << "[ERROR] " << codec->name() << ": " << path << ": " << error << std::endl;
+                    ok = false;
+                    break;
+                }
+                best = i == 0 ? ms : std::min(best, ms);
+            }
+            if (!error.empty()) continue;
+
+            if (codec == codecs.front()) {
+                reference = out;
+            } else if (out != reference) {
+                std::cerr << "[ERROR] " << codec->name() << " output differs from " << codecs.front()->name()
+                          << ": " << path << std::endl;
+                ok = false;
+            }
+            double megabytes = static_cast<double>(out.size()) / (1024.0 * 1024.0);
+            std::cout << std::left << std::setw(32) << path.substr(path.find_last_of("/\\") + 1) << std::setw(10)
+                      << codec->name() << std::right << std::setw(12) << out.size() << std::setw(12) << std::fixed
+                      << std::setprecision(2) << best << std::setw(12) << std::setprecision(1)
+                      << (best > 0 ? megabytes / (best / 1000.0) : 0.0) << "\n";
+        }
+    }
+    return ok;
+}
+
+/**
+ * 输出缓冲区只分配一次，之后每次 convertSpzToGlb 都写入同一块缓冲区
+ *
+ * 参考输出按命令行的方式拼出（buildGlbPreamble + 负载 + 零填充）；吞吐量按 GLB 字节数计算
+ */
+bool benchConvert(const std::vector<std::string>& paths, int iterations) {
+    std::cout << std::left << std::setw(32) << "file" << std::right << std::setw(12) << "glb bytes" << std::setw(12)
+              << "best ms" << std::setw(12) << "MB/s" << "\n";
+
+    bool ok = true;
+    for (const auto& path : paths) {
+        spz2glb::MappedFile file;
+        if (!file.open(path)) {
+            std::cerr << "[ERROR] Cannot open " << path << std::endl;
+            ok = false;
+            continue;
+        }
+        std::span<const std::byte> spz = std::as_bytes(file.bytes());
+
+        size_t glbSize = 0;
+        auto planned = spz2glb::glbSizeForSpz(spz, glbSize);
+        if (!planned.success) {
+            std::cerr << "[ERROR] " << path << ": " << planned.errorMessage << std::endl;
+            ok = false;
+            continue;
+        }
+
+        std::vector<std::byte> glb(glbSize);
+        double best = 0;
+        bool converted = true;
+        for (int i = 0; i < iterations && converted; ++i) {
+            size_t written = 0;
+            auto start = std::chrono::steady_clock::now();
+            auto result = spz2glb::convertSpzToGlb(spz, glb, written);
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            if (!result.success || written != glbSize) {
+                std::cerr << "[ERROR] " << path << ": " << (result.success ? "size mismatch" : result.errorMessage)
+                          << std::endl;
+                converted = false;
+            }
+            best = i == 0 ? ms : std::min(best, ms);
+        }
+        if (!converted) {
+            ok = false;
+            continue;
+        }
+
+        spz2glb::GlbLayout layout;
+        auto preamble = buildGlbPreamble(file.bytes(), layout, {.verbose = false});
+        std::vector<std::byte> reference;
+        if (preamble.success) {
+            auto head = std::as_bytes(std::span(preamble.data));
+            reference.assign(head.begin(), head.end());
+            reference.insert(reference.end(), spz.begin(), spz.end());
+            reference.resize(reference.size() + layout.binPadding, std::byte{0});
+        }
+        if (reference != glb) {
+            std::cerr << "[ERROR] convertSpzToGlb output differs from the CLI compressed mode: " << path << std::endl;
+            ok = false;
+        }
+
+        double megabytes = static_cast<double>(glbSize) / (1024.0 * 1024.0);
+        std::cout << std::left << std::setw(32) << path.substr(path.find_last_of("/\\") + 1) << std::right
+                  << std::setw(12) << glbSize << std::setw(12) << std::fixed << std::setprecision(2) << best
+                  << std::setw(12) << std::setprecision(1) << (best > 0 ? megabytes / (best / 1000.0) : 0.0) << "\n";
+    }
+    return ok;
+}
+
+/**
+ * 同一份解压数据分别用 SIMD 与纯标量内核解码（单线程），比较耗时并逐元素比对
+ *
+ * 覆盖位置（v2+ 定点数）、alpha、颜色、尺度、旋转与球谐；两条路径的运算顺序相同，
+ * 只为编译器可能的 FMA 收缩留 1e-6 的相对容差。
+ * v3 旋转按最大分量下标统计，四种下标都必须出现，否则 SIMD 的分量选择没有被完整覆盖
+ */
+bool benchDecode(const std::vector<std::string>& paths, int iterations) {
+    std::cout << std::left << std::setw(32) << "file" << std::right << std::setw(12) << "points" << std::setw(12)
+              << "simd ms" << std::setw(12) << "scalar ms" << "\n";
+
+    bool ok = true;
+    for (const auto& path : paths) {
+        const std::string name = path.substr(path.find_last_of("/\\") + 1);
+        spz2glb::MappedFile file;
+        if (!file.open(path)) {
+            std::cerr << "[ERROR] Cannot open " << path << std::endl;
+            ok = false;
+            continue;
+        }
+        auto inflated = decompressSpzData(file.bytes());
+        if (!inflated.success) {
+            std::cerr << "[ERROR] " << path << ": " << inflated.errorMessage << std::endl;
+            ok = false;
+            continue;
+        }
+
+        spz2glb::SplatData decoded[2];
+        double best[2] = {0, 0};
+        std::string error;
+        const spz2glb::DecodeKernels kernels[2] = {spz2glb::DecodeKernels::Simd, spz2glb::DecodeKernels::Scalar};
+        for (int k = 0; k < 2 && error.empty(); ++k) {
+            for (int i = 0; i < iterations; ++i) {
+                auto start = std::chrono::steady_clock::now();
+                if (!spz2glb::decodeSpz(inflated.data, decoded[k], error, nullptr, kernels[k])) {
+                    break;
+                }
+                double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+                best[k] = i == 0 ? ms : std::min(best[k], ms);
+            }
+        }
+        if (!error.empty()) {
+            std::cerr << "[ERROR] " << path << ": " << error << std::endl;
+            ok = false;
+            continue;
+        }
+
+        const auto& simd = decoded[0];
+        const auto& scalar = decoded[1];
+        bool same = true;
+        auto compare = [&](const char* attribute, const spz2glb::AlignedArray<float>& a,
+                           const spz2glb::AlignedArray<float>& b) {
+            if (a.size() != b.size()) {
+                std::cerr << "[ERROR] " << name << ": " << attribute << " sizes differ" << std::endl;
+                same = false;
+                return;
+            }
+            for (size_t i = 0; i < a.size(); ++i) {
+                if (std::fabs(a[i] - b[i]) > 1e-6f * std::max(1.0f, std::fabs(b[i]))) {
+                    std::cerr << "[ERROR] " << name << ": " << attribute << "[" << i << "] simd " << a[i]
+                              << " scalar " << b[i] << std::endl;
+                    same = false;
+                    return;
+                }
+            }
+        };
+        compare("positions", simd.positions, scalar.positions);
+        compare("alphas", simd.alphas, scalar.alphas);
+        compare("colors", simd.colors, scalar.colors);
+        compare("scales", simd.scales, scalar.scales);
+        compare("rotations", simd.rotations, scalar.rotations);
+        compare("sh", simd.sh, scalar.sh);
+
+        spz2glb::SpzLayout layout;
+        if (!spz2glb::parseSpzLayout(inflated.data, layout, error)) {
+            std::cerr << "[ERROR] " << path << ": " << error << std::endl;
+            ok = false;
+            continue;
+        }
+        std::string coverage;
+        if (layout.version >= 3) {
+            // v3 的旋转为每点 4 字节，最高 2 位是最大分量的下标
+            const uint8_t* rotations = inflated.data.data() + layout.offset(spz2glb::SpzSection::Rotations);
+            uint64_t largest[4] = {0, 0, 0, 0};
+            for (uint32_t i = 0; i < layout.numPoints; ++i) {
+                uint32_t packed;
+                std::memcpy(&packed, rotations + i * 4ull, sizeof(packed));
+                largest[packed >> 30]++;
+            }
+            coverage = ", rotation largest index " + std::to_string(largest[0]) + "/" + std::to_string(largest[1]) +
+                       "/" + std::to_string(largest[2]) + "/" + std::to_string(largest[3]);
+            if (std::find(std::begin(largest), std::end(largest), 0u) != std::end(largest)) {
+                std::cerr << "[ERROR] " << name << ": not every rotation largest index occurs" << coverage
+                          << std::endl;
+                same = false;
+            }
+        }
+        ok &= same;
+
+        std::cout << std::left << std::setw(32) << name << std::right << std::setw(12) << simd.numPoints
+                  << std::setw(12) << std::fixed << std::setprecision(2) << best[0] << std::setw(12) << best[1]
+                  << "\n";
+        if (same) {
+            std::cout << "[OK] " << name << ": SIMD and scalar decode match (v" << layout.version << ", SH "
+                      << layout.shDegree << coverage << ")\n";
+        }
+    }
+    return ok;
+}
+
+// ============================================================
+// suite：合成语料上的分阶段基准
+// ============================================================
+
+constexpr uint64_t kMaxSuitePoints = 50'000'000;
+constexpr uint64_t kWasmAllocLimit = 1024ull * 1024 * 1024;  // spz2glb_alloc 的单次上限
+
+/**
+ * suite 的一条结果；(name, distribution, points, shDegree, level) 标识一个用例
+ */
+struct CaseResult {
+    std::string name;
+    std::string distribution;
+    uint64_t points = 0;
+    uint32_t shDegree = 0;
+    int level = 0;
+    uint64_t bytes = 0;  // 计算吞吐量的字节数（各用例的含义见 runCorpus）
+    double bestMs = 0;
+    double mbPerSec = 0;
+    uint64_t allocations = 0;  // 每次迭代的堆分配次数（memory_tracking.cpp 记账）
+    uint64_t peakRssKb = 0;
+    bool ok = true;
+
+    std::string key() const {
+        return name + "/" + distribution + "/" + std::to_string(points) + "/sh" + std::to_string(shDegree) + "/l" +
+               std::to_string(level);
+    }
+};
+
+struct SuiteOptions {
+    std::vector<uint64_t> points = {1'000, 100'000, 1'000'000};
+    std::vector<uint32_t> shDegrees = {0, 3};
+    std::vector<int> levels = {6};
+    spz2glb::SplatDistribution distribution = spz2glb::SplatDistribution::Clustered;
+    uint32_t version = 2;
+    uint64_t seed = 1;
+    int iterations = 3;
+    std::string jsonPath;
+    std::string comparePath;
+    double threshold = 10.0;  // 百分比
+    // --compare 检查的指标；吞吐量与峰值 RSS 受机器负载影响，只有分配次数是确定的
+    bool compareThroughput = true;
+    bool compareAllocations = true;
+    bool comparePeakRss = true;
+};
+
+/**
+ * 峰值 RSS：Linux 上每个用例前写 /proc/self/clear_refs 重置 VmHWM，
+ * 其他平台只能读到进程生命期内的峰值（getrusage）
+ */
+void resetPeakRss() {
+#if defined(__linux__)
+    if (FILE* file = std::fopen("/proc/self/clear_refs", "w")) {
+        std::fputs("5", file);
+        std::fclose(file);
+    }
+#endif
+}
+
+uint64_t peakRssKb() {
+#if defined(__linux__)
+    if (FILE* file = std::fopen("/proc/self/status", "r")) {
+        char line[256];
+        unsigned long long kb = 0;
+        while (std::fgets(line, sizeof(line), file) != nullptr) {
+            if (std::sscanf(line, "VmHWM: %llu", &kb) == 1) break;
+        }
+        std::fclose(file);
+        if (kb != 0) return kb;
+    }
+#endif
+#if defined(__unix__) || defined(__APPLE__)
+    struct rusage usage = {};
+    getrusage(RUSAGE_SELF, &usage);
+#if defined(__APPLE__)
+    return static_cast<uint64_t>(usage.ru_maxrss) / 1024;  // macOS 以字节为单位
+#else
+    return static_cast<uint64_t>(usage.ru_maxrss);
+#endif
+#else
+    return 0;
+#endif
+}
+
+/**
+ * 运行一个用例 iterations 次，取最快一次；分配次数按迭代平均，峰值 RSS 覆盖全部迭代
+ */
+CaseResult runCase(const spz2glb::SyntheticSpzParams& params, std::string name, uint64_t bytes, int iterations,
+                   const std::function<bool()>& body) {
+    CaseResult result;
+    result.name = std::move(name);
+    result.distribution = spz2glb::splatDistributionName(params.distribution);
+    result.points = params.numPoints;
+    result.shDegree = params.shDegree;
+    result.level = params.gzipLevel;
+    result.bytes = bytes;
+
+    resetPeakRss();
+    uint64_t allocationsBefore = spz2glb::getMemoryStats().total_allocations;
+    int runs = 0;
+    for (; runs < iterations; ++runs) {
+        auto start = std::chrono::steady_clock::now();
+        bool success = body();
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (!success) {
+            std::cerr << "[ERROR] " << result.key() << " failed" << std::endl;
+            result.ok = false;
+            ++runs;
+            break;
+        }
+        result.bestMs = runs == 0 ? ms : std::min(result.bestMs, ms);
+    }
+    result.allocations = (spz2glb::getMemoryStats().total_allocations - allocationsBefore) / std::max(runs, 1);
+    result.peakRssKb = peakRssKb();
+    double megabytes = static_cast<double>(bytes) / (1024.0 * 1024.0);
+    result.mbPerSec = result.bestMs > 0 ? megabytes / (result.bestMs / 1000.0) : 0.0;
+    return result;
+}
+
+void printCase(const CaseResult& result) {
+    std::cout << std::left << std::setw(16) << result.name << std::setw(11) << result.distribution << std::right
+              << std::setw(10) << result.points << std::setw(4) << result.shDegree << std::setw(4) << result.level
+              << std::setw(12) << std::fixed << std::setprecision(2) << result.bestMs << std::setw(11)
+              << std::setprecision(1) << result.mbPerSec << std::setw(10) << result.allocations << std::setw(12)
+              << result.peakRssKb << (result.ok ? "" : "  FAILED") << std::endl;
+}
+
+/**
+ * 一份语料上的全部用例，吞吐量的字节数：
+ * convert / convert_core / verify_* / wasm_c_api 按 GLB 字节数，inflate_* 按解压输出，export 按 SPZ 字节数
+ */
+bool runCorpus(const spz2glb::SyntheticSpzParams& params,
+               const std::vector<uint8_t>& spz,
+               const std::filesystem::path& workDir,
+               int iterations,
+               std::vector<CaseResult>& results) {
+    auto record = [&results](CaseResult result) {
+        printCase(result);
+        results.push_back(std::move(result));
+        return results.back().ok;
+    };
+
+    std::span<const std::byte> spzBytes = std::as_bytes(std::span(spz));
+    size_t glbSize = 0;
+    auto planned = spz2glb::glbSizeForSpz(spzBytes, glbSize);
+    if (!planned.success) {
+        std::cerr << "[ERROR] Synthetic SPZ rejected: " << planned.errorMessage << std::endl;
+        return false;
+    }
+
+    std::string spzPath = (workDir / "corpus.spz").string();
+    std::string glbPath = (workDir / "corpus.glb").string();
+    {
+        std::ofstream out(spzPath, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(spz.data()), static_cast<std::streamsize>(spz.size()));
+        if (!out) {
+            std::cerr << "[ERROR] Cannot write " << spzPath << std::endl;
+            return false;
+        }
+    }
+
+    bool ok = true;
+    ok &= record(runCase(params, "convert", glbSize, iterations, [&] {
+        spz2glb::GlbLayout layout;
+        return convertSpzFile(spzPath, glbPath, layout, {.verbose = false}).success;
+    }));
+
+    {
+        std::vector<std::byte> glb(glbSize);
+        ok &= record(runCase(params, "convert_core", glbSize, iterations, [&] {
+            size_t written = 0;
+            return spz2glb::convertSpzToGlb(spzBytes, glb, written).success && written == glbSize;
+        }));
+    }
+
+    for (const auto* codec : spz2glb::availableCodecs()) {
+        std::vector<uint8_t> out;
+        std::string error;
+        if (!codec->gunzip(spz, out, error)) {
+            std::cerr << "[ERROR] " << codec->name() << ": " << error << std::endl;
+            ok = false;
+            continue;
+        }
+        ok &= record(runCase(params, std::string("inflate_") + codec->name(), out.size(), iterations,
+                             [&] { return codec->gunzip(spz, out, error); }));
+    }
+
+    ok &= record(runCase(params, "export", spz.size(), iterations, [&] {
+        spz2glb::GlbLayout layout;
+        return buildGlbPreamble(spz, layout, {.verbose = false}).success;
+    }));
+
+    std::vector<uint8_t> glb;
+    if (!convertSpzToGlbCore(spz, glb)) {
+        std::cerr << "[ERROR] convertSpzToGlbCore failed" << std::endl;
+        return false;
+    }
+    spz::Verifier verifier;
+    std::string detail;
+    ok &= record(runCase(params, "verify_layer1", glb.size(), iterations,
+                         [&] { return verifier.layer1_validate_glb_structure(glb, detail); }));
+    ok &= record(runCase(params, "verify_layer2", glb.size(), iterations,
+                         [&] { return verifier.layer2_verify_lossless(spz, glb, detail); }));
+    ok &= record(runCase(params, "verify_layer3", glb.size(), iterations,
+                         [&] { return verifier.layer3_verify_decoding(spz, glb, detail); }));
+    glb = {};
+
+    if (glbSize <= kWasmAllocLimit) {
+        ok &= record(runCase(params, "wasm_c_api", glbSize, iterations, [&] {
+            size_t outSize = 0;
+            uint8_t* out = spz2glb_convert(spz.data(), spz.size(), &outSize);
+            spz2glb_free(out);
+            return out != nullptr && outSize == glbSize;
+        }));
+    } else {
+        std::cout << "[INFO] wasm_c_api skipped: GLB exceeds the 1 GB spz2glb_alloc limit" << std::endl;
+    }
+
+    std::error_code ec;
+    std::filesystem::remove(glbPath, ec);
+    std::filesystem::remove(spzPath, ec);
+    return ok;
+}
+
+std::string resultsToJson(const std::vector<CaseResult>& results) {
+    std::ostringstream json;
+    json << "{\n  \"version\": 1,\n  \"cases\": [";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto& r = results[i];
+        json << (i == 0 ? "\n" : ",\n") << "    {\"name\": \"" << r.name << "\", \"distribution\": \""
+             << r.distribution << "\", \"points\": " << r.points << ", \"shDegree\": " << r.shDegree
+             << ", \"level\": " << r.level << ", \"bytes\": " << r.bytes << ", \"bestMs\": " << std::fixed
+             << std::setprecision(3) << r.bestMs << ", \"mbPerSec\": " << std::setprecision(2) << r.mbPerSec
+             << ", \"allocations\": " << r.allocations << ", \"peakRssKb\": " << r.peakRssKb
+             << ", \"ok\": " << (r.ok ? "true" : "false") << "}";
+    }
+    json << "\n  ]\n}\n";
+    return json.str();
+}
+
+/**
+ * 与基线比较：吞吐量下降、分配次数或峰值 RSS 上升超过 threshold% 即为回退（只检查 options 中选中的指标）；
+ * 基线中没有的用例只提示，不算回退
+ *
+ * @return 回退的用例数，基线无法读取时为 -1
+ */
+int compareWithBaseline(const std::vector<CaseResult>& results, const SuiteOptions& options) {
+    const std::string& path = options.comparePath;
+    const double threshold = options.threshold;
+    simdjson::dom::parser parser;
+    simdjson::dom::element root;
+    if (parser.load(path).get(root) != simdjson::SUCCESS) {
+        std::cerr << "[ERROR] Cannot parse baseline: " << path << std::endl;
+        return -1;
+    }
+    simdjson::dom::array cases;
+    if (root["cases"].get(cases) != simdjson::SUCCESS) {
+        std::cerr << "[ERROR] Baseline has no cases array: " << path << std::endl;
+        return -1;
+    }
+
+    std::map<std::string, CaseResult> baseline;
+    for (simdjson::dom::element item : cases) {
+        CaseResult r;
+        std::string_view name;
+        std::string_view distribution;
+        uint64_t shDegree = 0;
+        int64_t level = 0;
+        if (item["name"].get(name) != simdjson::SUCCESS || item["distribution"].get(distribution) ||
+            item["points"].get(r.points) || item["shDegree"].get(shDegree) || item["level"].get(level) ||
+            item["mbPerSec"].get(r.mbPerSec) || item["allocations"].get(r.allocations) ||
+            item["peakRssKb"].get(r.peakRssKb)) {
+            std::cerr << "[ERROR] Malformed baseline case in " << path << std::endl;
+            return -1;
+        }
+        r.name = name;
+        r.distribution = distribution;
+        r.shDegree = static_cast<uint32_t>(shDegree);
+        r.level = static_cast<int>(level);
+        baseline[r.key()] = r;
+    }
+
+    auto exceeds = [threshold](double base, double current) { return current > base * (1.0 + threshold / 100.0); };
+    int regressions = 0;
+    std::cout << "\nComparison with " << path << " (threshold " << threshold << "%)\n";
+    for (const auto& current : results) {
+        auto it = baseline.find(current.key());
+        if (it == baseline.end()) {
+            std::cout << "[INFO] " << current.key() << ": not in baseline\n";
+            continue;
+        }
+        const CaseResult& base = it->second;
+        std::ostringstream why;
+        why << std::fixed << std::setprecision(1);
+        if (!current.ok) {
+            why << " failed";
+        }
+        if (options.compareThroughput && exceeds(current.mbPerSec, base.mbPerSec)) {
+            why << " MB/s " << base.mbPerSec << " -> " << current.mbPerSec;
+        }
+        if (options.compareAllocations &&
+            exceeds(static_cast<double>(base.allocations), static_cast<double>(current.allocations))) {
+            why << " allocations " << base.allocations << " -> " << current.allocations;
+        }
+        if (options.comparePeakRss &&
+            exceeds(static_cast<double>(base.peakRssKb), static_cast<double>(current.peakRssKb))) {
+            why << " peak RSS " << base.peakRssKb << " KB -> " << current.peakRssKb << " KB";
+        }
+        if (!why.str().empty()) {
+            std::cout << "[REGRESSION] " << current.key() << ":" << why.str() << "\n";
+            ++regressions;
+        }
+    }
+    if (regressions == 0) {
+        std::cout << "[PASS] No regressions against " << path << std::endl;
+    } else {
+        std::cout << "[FAIL] " << regressions << " regression(s) against " << path << std::endl;
+    }
+    return regressions;
+}
+
+// "1K,100K,1M" -> {1000, 100000, 1000000}（超出 T 的值由调用方的范围检查拒绝）
+template <typename T>
+bool parseList(const std::string& text, std::vector<T>& values) {
+    values.clear();
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        uint64_t value = 0;
+        if (!spz2glb::parseSplatCount(item, value) || value > kMaxSuitePoints) return false;
+        values.push_back(static_cast<T>(value));
+    }
+    return !values.empty();
+}
+
+// "mbps,allocations,rss" -> 选中的比较指标
+bool parseMetrics(const std::string& text, SuiteOptions& options) {
+    options.compareThroughput = options.compareAllocations = options.comparePeakRss = false;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (item == "mbps") {
+            options.compareThroughput = true;
+        } else if (item == "allocations") {
+            options.compareAllocations = true;
+        } else if (item == "rss") {
+            options.comparePeakRss = true;
+        } else {
+            return false;
+        }
+    }
+    return options.compareThroughput || options.compareAllocations || options.comparePeakRss;
+}
+
+bool parseSuiteOptions(int argc, char** argv, SuiteOptions& options) {
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            std::cerr << "[ERROR] Missing value for " << arg << std::endl;
+            return false;
+        }
+        std::string value = argv[++i];
+        bool valid = true;
+        if (arg == "--points") {
+            valid = parseList(value, options.points) &&
+                    std::all_of(options.points.begin(), options.points.end(),
+                                [](uint64_t n) { return n > 0 && n <= kMaxSuitePoints; });
+        } else if (arg == "--sh") {
+            valid = parseList(value, options.shDegrees) &&
+                    std::all_of(options.shDegrees.begin(), options.shDegrees.end(), [](uint32_t d) { return d <= 3; });
+        } else if (arg == "--levels") {
+            valid = parseList(value, options.levels) &&
+                    std::all_of(options.levels.begin(), options.levels.end(), [](int l) { return l >= 0 && l <= 9; });
+        } else if (arg == "--distribution") {
+            valid = spz2glb::parseSplatDistribution(value, options.distribution);
+        } else if (arg == "--version") {
+            options.version = static_cast<uint32_t>(std::atoi(value.c_str()));
+            valid = options.version == 2 || options.version == 3;
+        } else if (arg == "--seed") {
+            options.seed = std::strtoull(value.c_str(), nullptr, 10);
+        } else if (arg == "--iterations") {
+            options.iterations = std::max(1, std::atoi(value.c_str()));
+        } else if (arg == "--json") {
+            options.jsonPath = value;
+        } else if (arg == "--compare") {
+            options.comparePath = value;
+        } else if (arg == "--threshold") {
+            options.threshold = std::atof(value.c_str());
+            valid = options.threshold >= 0;
+        } else if (arg == "--metrics") {
+            valid = parseMetrics(value, options);
+        } else {
+            std::cerr << "[ERROR] Unknown suite option: " << arg << std::endl;
+            return false;
+        }
+        if (!valid) {
+            std::cerr << "[ERROR] Invalid value for " << arg << ": " << value << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+int runSuite(int argc, char** argv) {
+    SuiteOptions options;
+    if (!parseSuiteOptions(argc, argv, options)) {
+        return 1;
+    }
+
+    std::error_code ec;
+    std::filesystem::path workDir = std::filesystem::temp_directory_path(ec) /
+#if defined(__unix__) || defined(__APPLE__)
+                                    ("spz2glb_bench_" + std::to_string(getpid()));
+#else
+                                    "spz2glb_bench";
+#endif
+    std::filesystem::create_directories(workDir, ec);
+    if (ec) {
+        std::cerr << "[ERROR] Cannot create " << workDir.string() << ": " << ec.message() << std::endl;
+        return 1;
+    }
+
+    std::cout << std::left << std::setw(16) << "case" << std::setw(11) << "dist" << std::right << std::setw(10)
+              << "points" << std::setw(4) << "sh" << std::setw(4) << "lvl" << std::setw(12) << "best ms"
+              << std::setw(11) << "MB/s" << std::setw(10) << "allocs" << std::setw(12) << "peak KB" << std::endl;
+
+    spz2glb::ThreadPool pool;
+    std::vector<CaseResult> results;
+    bool ok = true;
+    for (uint64_t points : options.points) {
+        for (uint32_t shDegree : options.shDegrees) {
+            for (int level : options.levels) {
+                spz2glb::SyntheticSpzParams params;
+                params.seed = options.seed;
+                params.numPoints = points;
+                params.version = options.version;
+                params.shDegree = shDegree;
+                params.distribution = options.distribution;
+                params.gzipLevel = level;
+
+                std::vector<uint8_t> spz;
+                std::string error;
+                if (!spz2glb::generateSyntheticSpz(params, spz, error, &pool)) {
+                    std::cerr << "[ERROR] " << error << std::endl;
+                    ok = false;
+                    continue;
+                }
+                ok &= runCorpus(params, spz, workDir, options.iterations, results);
+            }
+        }
+    }
+    std::filesystem::remove_all(workDir, ec);
+
+    if (!options.jsonPath.empty()) {
+        std::ofstream out(options.jsonPath, std::ios::binary | std::ios::trunc);
+        out << resultsToJson(results);
+        if (!out) {
+            std::cerr << "[ERROR] Cannot write " << options.jsonPath << std::endl;
+            return 1;
+        }
+        std::cout << "[INFO] Results written: " << options.jsonPath << std::endl;
+    }
+    if (!options.comparePath.empty() &&
+        compareWithBaseline(results, options) != 0) {
+        return 1;
+    }
+    return ok ? 0 : 1;
+}
+
+void printUsage(const char* progName) {
+    std::cout << "spz2glb benchmarks\n";
+    std::cout << "Usage: " << progName << " <inflate|convert|decode> <file.spz>... [--iterations <n>]\n";
+    std::cout << "       " << progName << " suite [options]\n\n";
+    std::cout << "Benchmarks:\n";
+    std::cout << "  inflate   Inflate each SPZ file with every compiled-in codec and compare throughput\n";
+    std::cout << "  convert   Convert each SPZ file into a preallocated buffer through the spz2glb_core API\n";
+    std::cout << "  decode    Decode each SPZ file with the SIMD and scalar kernels and compare every element\n";
+    std::cout << "  suite     Benchmark every stage on generated SPZ corpora (MB/s, allocations, peak RSS)\n\n";
+    std::cout << "Suite options:\n";
+    std::cout << "  --points <list>        Point counts, K/M suffixes (default: 1K,100K,1M; max 50M)\n";
+    std::cout << "  --sh <list>            SH degrees 0-3 (default: 0,3)\n";
+    std::cout << "  --levels <list>        gzip levels 0-9 of the corpora (default: 6)\n";
+    std::cout << "  --distribution <name>  uniform, clustered or surface (default: clustered)\n";
+    std::cout << "  --version <2|3>        SPZ version of the corpora (default: 2)\n";
+    std::cout << "  --seed <n>             Generator seed (default: 1)\n";
+    std::cout << "  --iterations <n>       Runs per case, the fastest is reported (default: 3)\n";
+    std::cout << "  --json <file>          Write the results as JSON\n";
+    std::cout << "  --compare <file>       Compare with a baseline JSON, exit 1 on regression\n";
+    std::cout << "  --threshold <percent>  Allowed regression for --compare (default: 10)\n";
+    std::cout << "  --metrics <list>       Metrics --compare checks: mbps, allocations, rss (default: all)\n";
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    std::string benchmark = argc >= 2 ? argv[1] : "";
+    if (benchmark == "suite") {
+        return runSuite(argc, argv);
+    }
+    if ((benchmark != "inflate" && benchmark != "convert" && benchmark != "decode") || argc < 3) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    int iterations = 5;
+    std::vector<std::string> paths;
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--iterations" && i + 1 < argc) {
+            iterations = std::max(1, std::atoi(argv[++i]));
+        } else {
+            paths.push_back(arg);
+        }
+    }
+    bool ok = benchmark == "inflate"  ? benchInflate(paths, iterations)
+              : benchmark == "decode" ? benchDecode(paths, iterations)
+                                      : benchConvert(paths, iterations);
+    return ok ? 0 : 1;
+}
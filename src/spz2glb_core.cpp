@@ -0,0 +1,206 @@
+// Copyright (c) 2026 Pu Junhan
+// SPDX-License-Identifier: MIT
+// Project: SPZ-ecosystem
+// Repository: https://github.com/spz-ecosystem/spz2glb
+//
+// spz2glb_core 库实现
+
+#include "spz2glb_core.h"
+
+#include <charconv>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <zlib.h>
+
+#include "memory_pool.h"
+#include "spz_decoder.h"
+#include "trace.h"
+
+namespace spz2glb {
+
+namespace {
+
+constexpr uint32_t kGlbMagic = 0x46546C67;       // "glTF"
+constexpr uint32_t kJsonChunkType = 0x4E4F534A;  // "JSON"
+constexpr uint32_t kBinChunkType = 0x004E4942;   // "BIN\0"
+
+// zlib 解压 SPZ 头所需的状态与 32 KB 窗口都从这块栈上区域分配
+constexpr size_t kInflateArenaBytes = 64 * 1024;
+
+struct InflateArena {
+    alignas(16) unsigned char bytes[kInflateArenaBytes];
+    size_t used = 0;
+};
+
+voidpf arenaAlloc(voidpf opaque, uInt items, uInt size) {
+    auto* arena = static_cast<InflateArena*>(opaque);
+    size_t bytes = (static_cast<size_t>(items) * size + 15) & ~size_t{15};
+    if (bytes > kInflateArenaBytes - arena->used) {
+        return Z_NULL;
+    }
+    void* ptr = arena->bytes + arena->used;
+    arena->used += bytes;
+    return ptr;
+}
+
+void arenaFree(voidpf, voidpf) {}
+
+// 解压出 SPZ 头（与 inflateSpzPrefix 相同：非 gzip 输入直接取前 16 字节）
+bool readSpzHeader(std::span<const std::byte> spz, SpzHeader& header) {
+    const auto* data = reinterpret_cast<const uint8_t*>(spz.data());
+    if (spz.size() < 2 || data[0] != 0x1f || data[1] != 0x8b) {
+        if (spz.size() < sizeof(SpzHeader)) return false;
+        std::memcpy(&header, data, sizeof(SpzHeader));
+        return header.magic == kSpzMagic;
+    }
+
+    InflateArena arena;
+    z_stream strm = {};
+    strm.zalloc = arenaAlloc;
+    strm.zfree = arenaFree;
+    strm.opaque = &arena;
+    if (inflateInit2(&strm, 16 + MAX_WBITS) != Z_OK) {
+        return false;
+    }
+    uint8_t prefix[sizeof(SpzHeader)];
+    strm.next_in = const_cast<uint8_t*>(data);
+    strm.avail_in = static_cast<uInt>(std::min<size_t>(spz.size(), std::numeric_limits<uInt>::max()));
+    strm.next_out = prefix;
+    strm.avail_out = sizeof(prefix);
+    int ret = Z_OK;
+    while (strm.avail_out > 0 && ret == Z_OK) {
+        ret = inflate(&strm, Z_NO_FLUSH);
+    }
+    bool complete = strm.avail_out == 0;
+    inflateEnd(&strm);
+    if (!complete) return false;
+    std::memcpy(&header, prefix, sizeof(SpzHeader));
+    return header.magic == kSpzMagic;
+}
+
+/**
+ * 压缩模式 GLB 的 JSON 只在 buffer 与 bufferView 的 byteLength 上随输入变化：
+ * 用 fastgltf 以占位长度导出一次，按占位数字切成三段，之后每次只拼接
+ */
+struct JsonTemplate {
+    std::string parts[3];
+    bool valid = false;
+};
+
+const JsonTemplate& compressedJsonTemplate() {
+    static const JsonTemplate tmpl = [] {
+        constexpr uint64_t kPlaceholder = std::numeric_limits<uint32_t>::max();
+        JsonTemplate result;
+        SpzHeader header = {};
+        auto asset = createGltfAsset({}, header);
+        asset.buffers[0].byteLength = kPlaceholder;
+        asset.bufferViews[0].byteLength = kPlaceholder;
+        GlbJsonExporter exporter;
+        std::string json;
+        if (exporter.writeBinaryJson(asset, json) != fastgltf::Error::None) {
+            return result;
+        }
+        const std::string placeholder = std::to_string(kPlaceholder);
+        size_t first = json.find(placeholder);
+        size_t second = first == std::string::npos ? first : json.find(placeholder, first + placeholder.size());
+        if (second == std::string::npos || json.find(placeholder, second + placeholder.size()) != std::string::npos) {
+            return result;
+        }
+        result.parts[0] = json.substr(0, first);
+        result.parts[1] = json.substr(first + placeholder.size(), second - first - placeholder.size());
+        result.parts[2] = json.substr(second + placeholder.size());
+        result.valid = true;
+        return result;
+    }();
+    return tmpl;
+}
+
+// 校验输入并计算布局；length 为 payload 长度的十进制文本
+SpzResult planGlb(std::span<const std::byte> spz, GlbLayout& layout, char (&length)[24], size_t& lengthDigits) {
+    SpzHeader header;
+    if (!readSpzHeader(spz, header)) {
+        return SpzResult::error(SpzErrorCode::ConversionFailed, "Failed to parse SPZ header");
+    }
+    std::span<const uint8_t> bytes(reinterpret_cast<const uint8_t*>(spz.data()), spz.size());
+    auto checked = checkSpzLength(bytes, bytes, bytes.size(), header);
+    if (!checked.success) {
+        return checked;
+    }
+    const JsonTemplate& tmpl = compressedJsonTemplate();
+    if (!tmpl.valid) {
+        return SpzResult::error(SpzErrorCode::ConversionFailed, "GLB export failed: cannot build JSON template");
+    }
+    lengthDigits = static_cast<size_t>(std::to_chars(length, length + sizeof(length), spz.size()).ptr - length);
+    size_t jsonSize = tmpl.parts[0].size() + tmpl.parts[1].size() + tmpl.parts[2].size() + 2 * lengthDigits;
+    if (!computeGlbLayout(jsonSize, spz.size(), layout)) {
+        return SpzResult::error(SpzErrorCode::ConversionFailed, kGlbSizeLimitError);
+    }
+    return SpzResult::ok({});
+}
+
+std::byte* putU32(std::byte* out, uint32_t value) {
+    std::memcpy(out, &value, 4);
+    return out + 4;
+}
+
+std::byte* putBytes(std::byte* out, const void* data, size_t size) {
+    std::memcpy(out, data, size);
+    return out + size;
+}
+
+}  // anonymous namespace
+
+SpzResult glbSizeForSpz(std::span<const std::byte> spz, size_t& glbSize) {
+    GlbLayout layout;
+    char length[24];
+    size_t digits = 0;
+    auto planned = planGlb(spz, layout, length, digits);
+    glbSize = planned.success ? layout.totalLength : 0;
+    return planned;
+}
+
+SpzResult convertSpzToGlb(std::span<const std::byte> spz, std::span<std::byte> glb, size_t& written) {
+    SPZ2GLB_TRACE_SCOPE(trace, "convert");
+    SPZ2GLB_TRACE_BYTES(trace, spz.size());
+    MemoryStageScope memoryStage(MemoryStage::Build);
+    written = 0;
+    GlbLayout layout;
+    char length[24];
+    size_t digits = 0;
+    auto planned = planGlb(spz, layout, length, digits);
+    if (!planned.success) {
+        return planned;
+    }
+    if (glb.size() < layout.totalLength) {
+        return SpzResult::error(SpzErrorCode::CannotOpenOutputFile,
+            "Output buffer too small: " + std::to_string(glb.size()) + " bytes, need " +
+            std::to_string(layout.totalLength));
+    }
+
+    // 与 writeGlbPreamble 相同的布局：GLB 头、JSON Chunk（空格填充）、BIN Chunk（零填充）
+    const JsonTemplate& tmpl = compressedJsonTemplate();
+    std::byte* out = glb.data();
+    out = putU32(out, kGlbMagic);
+    out = putU32(out, 2);
+    out = putU32(out, layout.totalLength);
+    out = putU32(out, layout.jsonChunkLength);
+    out = putU32(out, kJsonChunkType);
+    out = putBytes(out, tmpl.parts[0].data(), tmpl.parts[0].size());
+    out = putBytes(out, length, digits);
+    out = putBytes(out, tmpl.parts[1].data(), tmpl.parts[1].size());
+    out = putBytes(out, length, digits);
+    out = putBytes(out, tmpl.parts[2].data(), tmpl.parts[2].size());
+    std::memset(out, 0x20, layout.jsonPadding);
+    out += layout.jsonPadding;
+    out = putU32(out, layout.binChunkLength);
+    out = putU32(out, kBinChunkType);
+    out = putBytes(out, spz.data(), spz.size());
+    std::memset(out, 0, layout.binPadding);
+    out += layout.binPadding;
+
+    written = static_cast<size_t>(out - glb.data());
+    return SpzResult::ok({});
+}
+
+}  // namespace spz2glb
@@ -0,0 +1,44 @@
+// Copyright (c) 2026 Pu Junhan
+// SPDX-License-Identifier: MIT
+// Project: SPZ-ecosystem
+// Repository: https://github.com/spz-ecosystem/spz2glb
+//
+// spz2glb_core 库接口
+// 供 C++ 服务直接嵌入：输入是只读字节 span，输出写入调用方提供的缓冲区，
+// 转换过程不分配堆内存、负载只复制一次（从输入直接到输出）
+
+#ifndef SPZ2GLB_CORE_H_
+#define SPZ2GLB_CORE_H_
+
+#include <cstddef>
+#include <span>
+
+#include "spz_converter.h"
+
+namespace spz2glb {
+
+/**
+ * SPZ 转 GLB（压缩模式，负载原样）输出的准确字节数
+ *
+ * 只解压 SPZ 头校验输入，不读取其余负载
+ *
+ * @param glbSize 输出：convertSpzToGlb 需要的缓冲区大小
+ * @return 失败时 errorMessage 为原因（不是 SPZ、超过 GLB 的 4 GB 上限等）
+ */
+SpzResult glbSizeForSpz(std::span<const std::byte> spz, size_t& glbSize);
+
+/**
+ * SPZ 转 GLB，写入调用方提供的缓冲区
+ *
+ * 输出与命令行程序的压缩模式逐字节相同。成功路径不分配堆内存：
+ * SPZ 头在栈上的固定区域内解压，JSON 由首次调用时生成的模板拼出（只有两处长度不同），
+ * 直接写入 glb，负载用一次 memcpy 复制
+ *
+ * @param glb 输出缓冲区，至少 glbSizeForSpz 给出的大小
+ * @param written 输出：写入的字节数
+ */
+SpzResult convertSpzToGlb(std::span<const std::byte> spz, std::span<std::byte> glb, size_t& written);
+
+}  // namespace spz2glb
+
+#endif  // SPZ2GLB_CORE_H_
@@ -52,6 +52,33 @@ function createSpz2GlbBindings(wasmInstance) {
         return result;
     }
 
+    /**
+     * Inflate one block of a --repack payload (see "spz2glb:blocks" in the GLB JSON).
+     * Blocks are independent, so callers can spread them over workers.
+     */
+    function inflateBlock(blockBuffer, outSize) {
+        const [inputPtr, inputSize] = writeBuffer(blockBuffer);
+        const outPtr = exports.spz2glb_alloc(outSize);
+
+        const ok = outPtr && exports.spz2glb_inflate_block(inputPtr, inputSize, outPtr, outSize);
+        freeBuffer(inputPtr);
+
+        const result = ok ? readBuffer(outPtr, outSize) : null;
+        freeBuffer(outPtr);
+        return result;
+    }
+
+    /**
+     * Select the inflate implementation: 'zlib' or 'builtin'
+     */
+    function setCodec(name) {
+        const bytes = new TextEncoder().encode(name + '\0');
+        const [ptr] = writeBuffer(bytes);
+        const ok = exports.spz2glb_set_codec(ptr);
+        freeBuffer(ptr);
+        return !!ok;
+    }
+
     function writeBuffer(jsBuffer) {
         const size = jsBuffer.byteLength;
         const ptr = exports.spz2glb_alloc(size);
@@ -86,23 +113,41 @@ function createSpz2GlbBindings(wasmInstance) {
         return `${major}.${minor}.${patch}`;
     }
 
+    // size_t is 32-bit on wasm32, so every field is one Uint32
     function getMemoryStats() {
-        const statsPtr = exports.spz2glb_alloc(40);
+        const statsPtr = exports.spz2glb_alloc(20);
         exports.spz2glb_get_memory_stats(statsPtr);
 
         const heapU32 = new Uint32Array(memory.buffer);
         const stats = {
-            peak_usage: Number(heapU32[statsPtr / 4]) + (Number(heapU32[statsPtr / 4 + 1]) << 32),
-            current_usage: Number(heapU32[statsPtr / 4 + 2]) + (Number(heapU32[statsPtr / 4 + 3]) << 32),
-            total_allocations: heapU32[statsPtr / 4 + 4],
-            total_frees: heapU32[statsPtr / 4 + 5],
-            failed_allocations: heapU32[statsPtr / 4 + 6]
+            peak_usage: heapU32[statsPtr / 4],
+            current_usage: heapU32[statsPtr / 4 + 1],
+            total_allocations: heapU32[statsPtr / 4 + 2],
+            total_frees: heapU32[statsPtr / 4 + 3],
+            failed_allocations: heapU32[statsPtr / 4 + 4]
         };
 
         freeBuffer(statsPtr);
         return stats;
     }
 
+    // { read, inflate, build, write, verify }: { peak_usage, total_allocations, allocated_bytes }
+    function getStageMemoryStats() {
+        const statsPtr = exports.spz2glb_alloc(12);
+        const stages = {};
+        ['read', 'inflate', 'build', 'write', 'verify'].forEach((name, i) => {
+            if (!exports.spz2glb_get_stage_memory_stats(i + 1, statsPtr)) return;
+            const heapU32 = new Uint32Array(memory.buffer);
+            stages[name] = {
+                peak_usage: heapU32[statsPtr / 4],
+                total_allocations: heapU32[statsPtr / 4 + 1],
+                allocated_bytes: heapU32[statsPtr / 4 + 2]
+            };
+        });
+        freeBuffer(statsPtr);
+        return stages;
+    }
+
     function resetMemoryStats() {
         exports.spz2glb_reset_memory_stats();
     }
@@ -110,8 +155,11 @@ function createSpz2GlbBindings(wasmInstance) {
     return {
         validateHeader,
         convert,
+        inflateBlock,
+        setCodec,
         getVersion,
         getMemoryStats,
+        getStageMemoryStats,
         resetMemoryStats,
         exports
     };
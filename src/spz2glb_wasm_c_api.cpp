@@ -10,12 +10,16 @@
 // - No silent failures
 
 #include "spz2glb_wasm_c_api.h"
-#include "spz_to_glb.cpp"
+#include "spz2glb_core.h"
+#include "deflate_codec.h"
+#include "memory_pool.h"
 #include <cstring>
 #include <cstdlib>
+#include <zlib.h>
 
-// Memory tracking
-static Spz2GlbMemoryStats g_stats = {0, 0, 0, 0, 0};
+// Memory tracking lives in memory_pool.cpp (size header per allocation);
+// requests rejected before reaching the allocator are counted here
+static size_t g_rejected_allocations = 0;
 static bool g_initialized = false;
 
 // Debug: track active allocations
@@ -40,32 +44,25 @@ uint8_t* spz2glb_alloc(size_t size) {
     // Check for reasonable size
     if (size == 0) {
         DEBUG_LOG("WARNING: alloc(0) called");
-        g_stats.failed_allocations++;
+        g_rejected_allocations++;
         return NULL;
     }
 
     // Check for excessive size (potential overflow or bug)
     if (size > 1024 * 1024 * 1024) { // 1GB limit
         DEBUG_LOG("ERROR: alloc size too large: %zu", size);
-        g_stats.failed_allocations++;
+        g_rejected_allocations++;
         return NULL;
     }
 
-    uint8_t* ptr = new (std::nothrow) uint8_t[size];
+    // trackedAlloc stores the size in a header so spz2glb_free can decrement current usage
+    uint8_t* ptr = static_cast<uint8_t*>(spz2glb::trackedAlloc(size));
     if (ptr == NULL) {
         DEBUG_LOG("ERROR: allocation failed for size %zu", size);
-        g_stats.failed_allocations++;
         return NULL;
     }
 
-    g_stats.current_usage_bytes += size;
-    g_stats.total_allocations++;
-
-    if (g_stats.current_usage_bytes > g_stats.peak_usage_bytes) {
-        g_stats.peak_usage_bytes = g_stats.current_usage_bytes;
-    }
-
-    DEBUG_LOG("alloc(%zu) = %p, total: %zu", size, (void*)ptr, g_stats.current_usage_bytes);
+    DEBUG_LOG("alloc(%zu) = %p, total: %zu", size, (void*)ptr, spz2glb::getMemoryStats().current_usage);
     return ptr;
 }
 
@@ -76,12 +73,8 @@ void spz2glb_free(uint8_t* ptr) {
         return;
     }
 
-    // Note: We can't track exact size without keeping a map
-    // This is a limitation of simple allocation tracking
-    g_stats.total_frees++;
     DEBUG_LOG("free(%p)", (void*)ptr);
-
-    delete[] ptr;
+    spz2glb::trackedFree(ptr);
 }
 
 uint8_t* spz2glb_convert(const uint8_t* spzData, size_t spzSize, size_t* outSize) {
@@ -107,28 +100,17 @@ uint8_t* spz2glb_convert(const uint8_t* spzData, size_t spzSize, size_t* outSize
 
     DEBUG_LOG("convert: size=%zu", spzSize);
 
-    // Create input vector
-    std::vector<uint8_t> input(spzData, spzData + spzSize);
-
-    // Create output vector
-    std::vector<uint8_t> output;
-
-    // Call core conversion
-    if (!convertSpzToGlbCore(input, output)) {
-        DEBUG_LOG("ERROR: convertSpzToGlbCore failed");
-        *outSize = 0;
-        return NULL;
-    }
-
-    // Check output is valid
-    if (output.empty()) {
-        DEBUG_LOG("ERROR: output is empty");
+    // Size the output exactly, then convert straight into it (no intermediate copies)
+    std::span<const std::byte> input(reinterpret_cast<const std::byte*>(spzData), spzSize);
+    size_t resultSize = 0;
+    SpzResult planned = spz2glb::glbSizeForSpz(input, resultSize);
+    if (!planned.success) {
+        DEBUG_LOG("ERROR: glbSizeForSpz failed");
         *outSize = 0;
         return NULL;
     }
 
     // Allocate result buffer
-    size_t resultSize = output.size();
     uint8_t* result = spz2glb_alloc(resultSize);
     if (result == NULL) {
         DEBUG_LOG("ERROR: failed to allocate result buffer");
@@ -136,14 +118,73 @@ uint8_t* spz2glb_convert(const uint8_t* spzData, size_t spzSize, size_t* outSize
         return NULL;
     }
 
-    // Copy data
-    std::memcpy(result, output.data(), resultSize);
-    *outSize = resultSize;
+    size_t written = 0;
+    SpzResult converted = spz2glb::convertSpzToGlb(
+        input, std::span<std::byte>(reinterpret_cast<std::byte*>(result), resultSize), written);
+    if (!converted.success) {
+        DEBUG_LOG("ERROR: convertSpzToGlb failed");
+        spz2glb_free(result);
+        *outSize = 0;
+        return NULL;
+    }
+    *outSize = written;
 
     DEBUG_LOG("convert: success, output size=%zu", resultSize);
     return result;
 }
 
+bool spz2glb_inflate_block(const uint8_t* block, size_t blockSize, uint8_t* out, size_t outSize) {
+    ensure_initialized();
+
+    // Validate inputs
+    if (block == NULL || out == NULL || blockSize == 0 || outSize == 0) {
+        DEBUG_LOG("ERROR: invalid arguments in inflate_block");
+        return false;
+    }
+    if (blockSize > UINT32_MAX || outSize > UINT32_MAX) {
+        DEBUG_LOG("ERROR: block too large: %zu -> %zu", blockSize, outSize);
+        return false;
+    }
+
+    // Raw deflate: blocks start byte-aligned and never reference earlier data
+    z_stream strm;
+    std::memset(&strm, 0, sizeof(strm));
+    if (inflateInit2(&strm, -MAX_WBITS) != Z_OK) {
+        DEBUG_LOG("ERROR: inflateInit2 failed");
+        return false;
+    }
+    strm.next_in = const_cast<Bytef*>(block);
+    strm.avail_in = static_cast<uInt>(blockSize);
+    strm.next_out = out;
+    strm.avail_out = static_cast<uInt>(outSize);
+
+    // Middle blocks end with a full flush (Z_OK / Z_BUF_ERROR), the last one with Z_STREAM_END
+    int ret = inflate(&strm, Z_FINISH);
+    bool ok = (ret == Z_STREAM_END || ret == Z_OK || ret == Z_BUF_ERROR) && strm.avail_out == 0;
+    inflateEnd(&strm);
+
+    DEBUG_LOG("inflate_block: %zu -> %zu, %s", blockSize, outSize, ok ? "ok" : "failed");
+    return ok;
+}
+
+bool spz2glb_set_codec(const char* name) {
+    ensure_initialized();
+
+    if (name == NULL) {
+        DEBUG_LOG("ERROR: name is NULL in set_codec");
+        return false;
+    }
+
+    const spz2glb::DeflateCodec* codec = spz2glb::findCodec(name);
+    if (codec == NULL) {
+        DEBUG_LOG("ERROR: unknown codec: %s", name);
+        return false;
+    }
+    spz2glb::setActiveCodec(*codec);
+    DEBUG_LOG("set_codec: %s", name);
+    return true;
+}
+
 bool spz2glb_validate_header(const uint8_t* data, size_t size) {
     ensure_initialized();
 
@@ -191,20 +232,37 @@ void spz2glb_get_memory_stats(Spz2GlbMemoryStats* stats) {
     if (stats == NULL) {
         return;
     }
-    *stats = g_stats;
+    spz2glb::MemoryStats current = spz2glb::getMemoryStats();
+    stats->peak_usage_bytes = current.peak_usage;
+    stats->current_usage_bytes = current.current_usage;
+    stats->total_allocations = current.total_allocations;
+    stats->total_frees = current.total_frees;
+    stats->failed_allocations = current.failed_allocations + g_rejected_allocations;
+}
+
+bool spz2glb_get_stage_memory_stats(uint32_t stage, Spz2GlbStageMemoryStats* stats) {
+    if (stats == NULL || stage == 0 || stage >= spz2glb::kMemoryStageCount) {
+        return false;
+    }
+    spz2glb::StageMemoryStats current = spz2glb::getStageMemoryStats(static_cast<spz2glb::MemoryStage>(stage));
+    stats->peak_usage_bytes = current.peak_usage;
+    stats->total_allocations = current.allocations;
+    stats->allocated_bytes = current.allocated_bytes;
+    return true;
 }
 
 void spz2glb_reset_memory_stats(void) {
+#if SPZ2GLB_DEBUG_ALLOC
+    spz2glb::MemoryStats current = spz2glb::getMemoryStats();
     DEBUG_LOG("reset_memory_stats: peak=%zu, current=%zu, allocs=%zu, frees=%zu, failed=%zu",
-              g_stats.peak_usage_bytes,
-              g_stats.current_usage_bytes,
-              g_stats.total_allocations,
-              g_stats.total_frees,
-              g_stats.failed_allocations);
-
-    g_stats.peak_usage_bytes = 0;
-    g_stats.current_usage_bytes = 0;
-    g_stats.total_allocations = 0;
-    g_stats.total_frees = 0;
-    g_stats.failed_allocations = 0;
+              current.peak_usage,
+              current.current_usage,
+              current.total_allocations,
+              current.total_frees,
+              current.failed_allocations + g_rejected_allocations);
+#endif
+
+    // Live allocations stay counted in current usage; the peak restarts from it
+    spz2glb::resetMemoryStats();
+    g_rejected_allocations = 0;
 }
@@ -63,6 +63,26 @@ void spz2glb_free(uint8_t* ptr);
  */
 uint8_t* spz2glb_convert(const uint8_t* spzData, size_t spzSize, size_t* outSize);
 
+/**
+ * Inflate one block of a --repack payload
+ *
+ * Blocks listed in the "spz2glb:blocks" extras are independent raw deflate
+ * streams, so each one can be inflated on its own worker.
+ * @param block Payload bytes [offsets[i], offsets[i + 1]) (last block: up to the payload end)
+ * @param blockSize Size of block in bytes
+ * @param out Output buffer (must be non-NULL)
+ * @param outSize Inflated size of the block: min(blockSize, uncompressedSize - i * blockSize)
+ * @return true if exactly outSize bytes were produced
+ */
+bool spz2glb_inflate_block(const uint8_t* block, size_t blockSize, uint8_t* out, size_t outSize);
+
+/**
+ * Select the inflate implementation used by spz2glb_convert
+ * @param name "zlib" or "builtin" (if compiled in, see SPZ2GLB_BUILTIN_INFLATE)
+ * @return false if the codec is unknown or disabled
+ */
+bool spz2glb_set_codec(const char* name);
+
 /**
  * Validate GLB header
  * @param data Data to validate (must be non-NULL, size >= 12)
@@ -77,7 +97,11 @@ bool spz2glb_validate_header(const uint8_t* data, size_t size);
 void spz2glb_get_version(int* major, int* minor, int* patch);
 
 /**
- * Memory statistics (for debugging)
+ * Memory statistics
+ *
+ * Every heap allocation in the module is tracked with a size header, so
+ * current_usage_bytes goes down on spz2glb_free and on internal frees.
+ * Reset clears the counters and restarts the peak from the current usage.
  */
 typedef struct {
     size_t peak_usage_bytes;
@@ -90,6 +114,22 @@ typedef struct {
 void spz2glb_get_memory_stats(Spz2GlbMemoryStats* stats);
 void spz2glb_reset_memory_stats(void);
 
+/**
+ * Per-stage memory statistics
+ *
+ * Stages: 1 = read, 2 = inflate, 3 = build, 4 = write, 5 = verify.
+ * peak_usage_bytes is the module heap peak seen while the stage ran.
+ *
+ * @return false for an unknown stage or NULL stats
+ */
+typedef struct {
+    size_t peak_usage_bytes;
+    size_t total_allocations;
+    size_t allocated_bytes;
+} Spz2GlbStageMemoryStats;
+
+bool spz2glb_get_stage_memory_stats(uint32_t stage, Spz2GlbStageMemoryStats* stats);
+
 /**
  * Assert macro that always compiles
  */
@@ -0,0 +1,884 @@
+// Copyright (c) 2026 Pu Junhan
+// SPDX-License-Identifier: MIT
+// Project: SPZ-ecosystem
+// Repository: https://github.com/spz-ecosystem/spz2glb
+//
+/**
+ * SPZ 到 GLB 转换器
+ * 
+ * 将 SPZ 文件转换为 glTF 2.0 GLB 格式
+ * 使用 KHR_gaussian_splatting_compression_spz_2 扩展
+ *
+ * 压缩流模式（根据 SPZ_2 规范）：
+ * - SPZ 压缩数据直接存储在 bufferView 中
+ * - 不定义 accessors 或 attributes
+ * - 渲染需要 SPZ 兼容的解码器
+ * 
+ * 这是 SPZ_2 规范推荐的模式：
+ * - 无损（无重新编码，直接复制 SPZ 流）
+ * - 最小文件大小（SPZ 压缩率约 10 倍）
+ * - 最快加载速度
+ */
+
+#include "spz_converter.h"
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <algorithm>
+#include <limits>
+#include <zlib.h>
+
+#include <fastgltf/core.hpp>
+
+#include "deflate_codec.h"
+#include "memory_pool.h"
+#include "spz2glb_core.h"
+#include "spz_decoder.h"
+#include "trace.h"
+
+#ifndef __EMSCRIPTEN__
+#include "attribute_glb.h"
+#include "conversion_cache.h"
+#include "gzip_index.h"
+#include "optimal_deflate.h"
+#include "sh_degree.h"
+#include "spatial_order.h"
+#include "splat_lod.h"
+#include "tiled_glb.h"
+#endif
+
+/**
+ * 解析 SPZ 文件头
+ * 
+ * @param data SPZ 文件的二进制数据（已解压）
+ * @param header 输出参数，存储解析后的头信息
+ * @return true 如果头解析成功，false 如果格式错误
+ * 
+ * 验证步骤：
+ * 1. 检查数据大小是否足够（至少 16 字节）
+ * 2. 复制二进制数据到结构体
+ * 3. 验证魔术数字是否为 "NGSP"
+ */
+bool parseSpzHeader(const std::vector<uint8_t>& data, SpzHeader& header) {
+    SPZ2GLB_TRACE_SCOPE(trace, "header parse");
+    // 数据必须至少包含完整的头结构（16 字节）
+    if (data.size() < sizeof(SpzHeader)) {
+        return false;
+    }
+
+    // 从二进制数据复制头结构
+    memcpy(&header, data.data(), sizeof(SpzHeader));
+
+    // 验证魔术数字：必须是 0x5053474e ("NGSP")
+    if (header.magic != spz2glb::kSpzMagic) {
+        std::cerr << "[ERROR] Invalid SPZ magic number: 0x" << std::hex << header.magic << std::dec << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * 计算 glTF accessor 数量（基于球谐函数阶数）
+ * 
+ * @param shDegree 球谐函数阶数（0-3）
+ * @return 需要的 accessor 总数
+ * 
+ * glTF 高斯泼溅需要以下属性：
+ * - 基础属性（4 个）：POSITION, COLOR_0, SCALE, ROTATION
+ * - 球谐系数（可选）：根据 SH 阶数增加
+ *   - SH 阶数 1: +3 个系数
+ *   - SH 阶数 2: +5 个系数
+ *   - SH 阶数 3: +7 个系数
+ * 
+ * 注意：在压缩流模式（compression stream mode）下，
+ * 这些 accessor 都不需要，因为数据存储在 SPZ 压缩流中
+ */
+int getAccessorCount(int shDegree) {
+    // 基础属性：位置、颜色、缩放、旋转
+    int baseAccessors = 4; // POSITION, COLOR_0, SCALE, ROTATION
+    int shAccessors = 0;
+
+    // 根据 SH 阶数添加球谐系数
+    // 球谐函数用于编码光照方向信息，阶数越高，光照质量越好
+    if (shDegree >= 1) shAccessors += 3;  // 一阶 SH：3 个系数
+    if (shDegree >= 2) shAccessors += 5;  // 二阶 SH：5 个系数
+    if (shDegree >= 3) shAccessors += 7;  // 三阶 SH：7 个系数
+
+    return baseAccessors + shAccessors;
+}
+
+/**
+ * 加载 SPZ 文件（二进制读取）
+ * 
+ * @param spzPath SPZ 文件路径
+ * @return 包含完整 SPZ 二进制数据的 vector
+ * 
+ * 关键点：
+ * - 以二进制模式读取，保持原始字节不变
+ * - 使用 ios::ate 先定位到文件末尾获取大小
+ * - 返回的是 gzip 压缩的原始数据，不解压
+ * 
+ * 为什么保持压缩状态？
+ * - SPZ 压缩率约 10 倍，解压后会变大
+ * - GLB 存储压缩数据，加载时由 SPZ 解码器解压
+ * - 符合 SPZ_2 规范的压缩流模式
+ */
+SpzResult loadSpzFile(const std::string& spzPath) {
+    SPZ2GLB_TRACE_SCOPE(trace, "load");
+    spz2glb::MemoryStageScope memoryStage(spz2glb::MemoryStage::Read);
+    // 以二进制模式打开文件，ios::ate 将读取位置定位到文件末尾
+    std::ifstream file(spzPath, std::ios::binary | std::ios::ate);
+    if (!file) {
+        return SpzResult::error(SpzErrorCode::CannotOpenSpzFile,
+            "Cannot open SPZ file: " + spzPath);
+    }
+
+    // 获取文件大小（tellg 返回当前位置，即文件末尾）
+    auto size = file.tellg();
+    // 重置读取位置到文件开头
+    file.seekg(0, std::ios::beg);
+
+    // 分配缓冲区并调整大小
+    std::vector<uint8_t> rawBuffer;
+    rawBuffer.resize(static_cast<size_t>(size));
+
+    // 一次性读取整个文件到缓冲区
+    if (!file.read(reinterpret_cast<char*>(rawBuffer.data()), static_cast<std::streamsize>(size))) {
+        return SpzResult::error(SpzErrorCode::FailedToReadSpzFile,
+            "Failed to read SPZ file");
+    }
+    SPZ2GLB_TRACE_BYTES(trace, rawBuffer.size());
+
+    // 返回原始 SPZ 数据（保持 gzip 压缩状态）
+    // 重要：不要解压！GLB 必须存储原始压缩数据
+    // SPZ 解码器在加载时会自动解压
+    return SpzResult::ok(std::move(rawBuffer));
+}
+
+/**
+ * 解压完整的 SPZ gzip 数据
+ * 
+ * @param compressedData gzip 压缩的 SPZ 数据
+ * @return 解压后的 SPZ 内部格式数据
+ * 
+ * 用途：
+ * - 需要访问整个 SPZ 负载时使用
+ * - 不用于存储（存储时保持压缩状态）
+ * - 只需要头部时请使用 inflateSpzPrefix，避免解压整个流
+ * 
+ * gzip 格式识别：
+ * - 前两个字节：0x1f 0x8b
+ * - 如果不是 gzip，直接返回原始数据
+ * 
+ * 解压流程：
+ * 1. 检测 gzip 魔数（0x1f8b）
+ * 2. 由 spz2glb::activeCodec() 解压整个 gzip 成员（--codec 选择 zlib 或内置实现）
+ *
+ * 输入以 span 传入（可以直接指向 mmap 的文件），不复制压缩数据
+ */
+SpzResult decompressSpzData(std::span<const uint8_t> compressedData) {
+    // 检查 gzip 魔数：前两个字节必须是 0x1f 0x8b
+    if (compressedData.size() < 2 || compressedData[0] != 0x1f || compressedData[1] != 0x8b) {
+        // 不是 gzip 压缩，直接返回原始数据
+        return SpzResult::ok(std::vector<uint8_t>(compressedData.begin(), compressedData.end()));
+    }
+
+    // 整个流交给当前编解码器（zlib 或内置整块解压，见 deflate_codec.h）
+    SPZ2GLB_TRACE_SCOPE(trace, "inflate");
+    spz2glb::MemoryStageScope memoryStage(spz2glb::MemoryStage::Inflate);
+    std::vector<uint8_t> decompressed;
+    std::string error;
+    if (!spz2glb::activeCodec().gunzip(compressedData, decompressed, error)) {
+        return SpzResult::error(SpzErrorCode::FailedToDecompress, error);
+    }
+    SPZ2GLB_TRACE_BYTES(trace, decompressed.size());
+
+    return SpzResult::ok(std::move(decompressed));
+}
+
+/**
+ * 有界解压：只解压 SPZ gzip 流的前 maxBytes 字节
+ *
+ * @param compressedData gzip 压缩的 SPZ 数据
+ * @param maxBytes 最多输出的解压字节数（例如 sizeof(SpzHeader)）
+ * @return 解压出的前缀（流本身更短时可能少于 maxBytes）
+ *
+ * 与 decompressSpzData 的区别：
+ * - 输出缓冲区固定为 maxBytes，填满后立即停止，不再继续解压
+ * - 不分配 10 倍于输入的缓冲区，内存开销与输入大小无关
+ * - 耗时只取决于 maxBytes，与整个流的长度无关
+ *
+ * 如果不是 gzip，直接返回原始数据的前 maxBytes 字节
+ */
+SpzResult inflateSpzPrefix(std::span<const uint8_t> compressedData, size_t maxBytes) {
+    if (compressedData.size() < 2 || compressedData[0] != 0x1f || compressedData[1] != 0x8b) {
+        size_t n = std::min(maxBytes, compressedData.size());
+        return SpzResult::ok(std::vector<uint8_t>(compressedData.begin(), compressedData.begin() + n));
+    }
+
+    SPZ2GLB_TRACE_SCOPE(trace, "inflate");
+    SPZ2GLB_TRACE_BYTES(trace, maxBytes);
+    spz2glb::MemoryStageScope memoryStage(spz2glb::MemoryStage::Inflate);
+    std::vector<uint8_t> prefix(maxBytes);
+
+    z_stream strm = {};
+    strm.next_in = const_cast<uint8_t*>(compressedData.data());
+    // 前缀解压只会消耗流开头的一小部分，超过 uInt 范围的输入无需全部交给 zlib
+    strm.avail_in = static_cast<uInt>(std::min<size_t>(compressedData.size(), std::numeric_limits<uInt>::max()));
+    strm.next_out = prefix.data();
+    strm.avail_out = static_cast<uInt>(prefix.size());
+
+    if (inflateInit2(&strm, 16 + MAX_WBITS) != Z_OK) {
+        return SpzResult::error(SpzErrorCode::FailedToInitZlib,
+            "Failed to initialize zlib decompression");
+    }
+
+    // 输出缓冲区填满（avail_out == 0）或流结束即停止
+    int ret = Z_OK;
+    while (strm.avail_out > 0 && ret == Z_OK) {
+        ret = inflate(&strm, Z_NO_FLUSH);
+    }
+
+    if (ret != Z_OK && ret != Z_STREAM_END && !(ret == Z_BUF_ERROR && strm.avail_out == 0)) {
+        inflateEnd(&strm);
+        return SpzResult::error(SpzErrorCode::FailedToDecompress,
+            "Failed to decompress SPZ file");
+    }
+
+    prefix.resize(strm.total_out);
+    inflateEnd(&strm);
+
+    return SpzResult::ok(std::move(prefix));
+}
+
+/**
+ * 校验 SPZ 负载长度
+ *
+ * @param head 负载开头的字节（用于识别 gzip）
+ * @param tail 负载末尾的字节（至少包含 gzip 尾部的 4 字节 ISIZE）
+ * @param payloadSize 负载总字节数
+ * @param header 已解析的 SPZ 头
+ *
+ * 压缩模式只解压前 16 字节的头，截断的文件照样能解析出头并"成功"转换。
+ * gzip 尾部的 ISIZE 是解压长度 mod 2^32：文件被截断后末 4 字节落在压缩数据中，
+ * 几乎不可能恰好等于头部（点数、版本、SH 阶数）隐含的长度。
+ * 未压缩输入直接比较长度；版本或 SH 阶数未知时无法推算长度，不做校验
+ */
+SpzResult checkSpzLength(std::span<const uint8_t> head,
+                         std::span<const uint8_t> tail,
+                         uint64_t payloadSize,
+                         const SpzHeader& header) {
+    if (header.version < 1 || header.version > 3 || header.shDegree > 3) {
+        return SpzResult::ok({});
+    }
+    uint64_t expected = spz2glb::kSpzHeaderBytes;
+    for (spz2glb::SpzSection section : spz2glb::kSpzSections) {
+        expected += static_cast<uint64_t>(header.numPoints) *
+                    spz2glb::spzSectionStride(header.version, header.shDegree, section);
+    }
+
+    if (head.size() < 2 || head[0] != 0x1f || head[1] != 0x8b) {
+        if (payloadSize < expected) {
+            return SpzResult::error(SpzErrorCode::FailedToReadSpzFile,
+                "SPZ data truncated: " + std::to_string(payloadSize) + " of " + std::to_string(expected) +
+                " bytes");
+        }
+        return SpzResult::ok({});
+    }
+
+    // gzip 尾：CRC-32 与 ISIZE（解压长度 mod 2^32），小端序；gzip 头 10 字节 + 尾 8 字节
+    if (payloadSize < 18 || tail.size() < 4) {
+        return SpzResult::error(SpzErrorCode::FailedToReadSpzFile, "SPZ gzip stream truncated");
+    }
+    const uint8_t* isizeBytes = tail.data() + tail.size() - 4;
+    uint32_t isize = static_cast<uint32_t>(isizeBytes[0]) | (static_cast<uint32_t>(isizeBytes[1]) << 8) |
+                     (static_cast<uint32_t>(isizeBytes[2]) << 16) | (static_cast<uint32_t>(isizeBytes[3]) << 24);
+    if (isize != static_cast<uint32_t>(expected)) {
+        return SpzResult::error(SpzErrorCode::FailedToReadSpzFile,
+            "SPZ data truncated or corrupt: gzip trailer gives " + std::to_string(isize) +
+            " inflated bytes, header implies " + std::to_string(expected));
+    }
+    return SpzResult::ok({});
+}
+
+/**
+ * 创建 glTF 资产（包含 SPZ 压缩扩展）
+ * 
+ * @param spzData SPZ 压缩数据（保持 gzip 压缩状态），资产只引用不复制，
+ *                调用方必须保证其生命周期覆盖导出过程
+ * @param header SPZ 头部信息（预留未来使用）
+ * @return 完整的 glTF 资产对象
+ * 
+ * glTF 结构：
+ * - Asset: 根对象，包含元数据
+ * - Buffers: 二进制数据（SPZ 压缩流）
+ * - BufferViews: Buffer 的视图（指向整个 SPZ 数据）
+ * - Mesh/Primitive: 点云几何体（使用 SPZ 扩展）
+ * - Node: 场景节点
+ * - Scene: 默认场景
+ * 
+ * 关键扩展：
+ * - KHR_gaussian_splatting: 高斯泼溅支持
+ * - KHR_gaussian_splatting_compression_spz_2: SPZ 压缩格式
+ * 
+ * 压缩流模式特点：
+ * - 没有 accessors（数据在压缩流中）
+ * - 没有 attributes（数据在压缩流中）
+ * - 渲染器需要 SPZ 解码器
+ */
+fastgltf::Asset createGltfAsset(std::span<const uint8_t> spzData, const SpzHeader& header) {
+    SPZ2GLB_TRACE_SCOPE(trace, "asset build");
+    spz2glb::MemoryStageScope memoryStage(spz2glb::MemoryStage::Build);
+    (void)header;
+
+    fastgltf::Asset asset = spz2glb::createSplatAsset(true);
+
+    size_t spzSize = spzData.size();
+
+    // 创建 Buffer（引用 SPZ 压缩数据）
+    // 使用 ByteView 而不是 Vector：只保存指针和长度，不复制负载
+    fastgltf::Buffer buffer;
+    fastgltf::sources::ByteView byteView;
+    byteView.bytes = fastgltf::span<const std::byte>(
+        std::as_bytes(std::span<const uint8_t>(spzData.data(), spzSize)));
+    byteView.mimeType = fastgltf::MimeType::None;
+    buffer.data = byteView;
+    buffer.byteLength = spzSize;
+    asset.buffers.emplace_back(std::move(buffer));
+
+    fastgltf::BufferView spzBufferView;
+    spzBufferView.bufferIndex = 0;
+    spzBufferView.byteOffset = 0;
+    spzBufferView.byteLength = spzSize;
+    asset.bufferViews.emplace_back(std::move(spzBufferView));
+
+    // 创建 Primitive（使用 SPZ 压缩扩展）
+    fastgltf::Primitive primitive;
+    primitive.type = fastgltf::PrimitiveType::Points;  // 点云类型
+
+    // 配置 SPZ 压缩扩展
+    // 这是压缩流模式的核心：通过扩展引用 bufferView 中的压缩数据
+    auto gaussianSplat = std::make_unique<fastgltf::GaussianSplatExtension>();
+    auto spzCompression = std::make_unique<fastgltf::GaussianSplatSpzCompression>();
+    spzCompression->bufferView = 0;  // 引用第 0 个 bufferView
+    gaussianSplat->spzCompression = std::move(spzCompression);
+    primitive.gaussianSplat = std::move(gaussianSplat);
+
+    // 创建 Mesh 并添加 Primitive
+    fastgltf::Mesh mesh;
+    mesh.primitives.emplace_back(std::move(primitive));
+    asset.meshes.emplace_back(std::move(mesh));
+
+    // 创建 Node（场景中的对象）
+    fastgltf::Node node;
+    node.meshIndex = 0;  // 引用第 0 个 Mesh
+    asset.nodes.emplace_back(std::move(node));
+
+    // 创建 Scene（场景根节点）
+    fastgltf::Scene scene;
+    scene.nodeIndices.emplace_back(0);  // 包含第 0 个 Node
+    asset.scenes.emplace_back(std::move(scene));
+    asset.defaultScene = 0;  // 默认显示第 0 个场景
+
+    return asset;
+}
+
+/**
+ * 生成 GLB 前导字节（桌面版和 WASM 共用）
+ *
+ * @param spzData SPZ 压缩数据（不复制，可直接指向 mmap 的输入文件）
+ * @param layout 输出：GLB 布局（BIN 填充字节数等）
+ * @param options 转换选项
+ * @return 成功时 data 为 GLB 头 + JSON Chunk + BIN Chunk 头
+ *
+ * 转换流程：
+ * 1. 有界解压 SPZ 头部（只解压 16 字节，不解压整个流）
+ * 2. 解析 SPZ 头部
+ * 3. 创建 glTF 资产（buffer 0 以 ByteView 引用 spzData）
+ * 4. 只序列化 JSON，预先计算各 Chunk 长度
+ *
+ * 完整 GLB = preamble + spzData + layout.binPadding 个零字节，
+ * 负载由调用方直接写出，不再经过中间缓冲区
+ */
+SpzResult buildGlbPreamble(std::span<const uint8_t> spzData,
+                           spz2glb::GlbLayout& layout,
+                           const spz2glb::ConvertOptions& options,
+                           const std::string& compressionExtras) {
+    return buildGlbPreamble(spzData, spzData.size(), layout, options, compressionExtras);
+}
+
+/**
+ * 生成 GLB 前导字节：JSON 只依赖 SPZ 头与负载长度，负载本身可以还没读到
+ *
+ * @param head 负载开头的字节，需足够解压出 16 字节的 SPZ 头
+ * @param payloadSize 负载总字节数
+ */
+SpzResult buildGlbPreamble(std::span<const uint8_t> head,
+                           uint64_t payloadSize,
+                           spz2glb::GlbLayout& layout,
+                           const spz2glb::ConvertOptions& options,
+                           const std::string& compressionExtras) {
+    // 步骤 1: 只解压头部所需的前 16 字节（只读 span，不复制输入）
+    auto decompressResult = inflateSpzPrefix(head, sizeof(SpzHeader));
+    if (!decompressResult.success) {
+        return decompressResult;
+    }
+    std::vector<uint8_t> decompressedData = std::move(decompressResult.data);
+
+    // 步骤 2: 解析 SPZ 头部（使用解压后数据）
+    SpzHeader header;
+    if (!parseSpzHeader(decompressedData, header)) {
+        return SpzResult::error(SpzErrorCode::ConversionFailed,
+            "Failed to parse SPZ header");
+    }
+
+    // 整个负载都已在内存中时校验长度（流式转换只拿到开头，由调用方另外读出末尾校验）
+    if (head.size() == payloadSize) {
+        auto checked = checkSpzLength(head, head, payloadSize, header);
+        if (!checked.success) {
+            return checked;
+        }
+    }
+
+    // 步骤 3: 打印 SPZ 元数据
+    if (options.verbose) {
+        std::cout << "[INFO] SPZ version: " << (int)header.version << std::endl;
+        std::cout << "[INFO] Num points: " << header.numPoints << std::endl;
+        std::cout << "[INFO] SH degree: " << (int)header.shDegree << std::endl;
+        std::cout << "[INFO] Creating glTF Asset with KHR extensions" << std::endl;
+    }
+
+    // 步骤 4: 创建 glTF 资产（引用原始压缩数据）；GLB 模式下 buffer 0 只导出长度，按负载总长度填写
+    auto asset = createGltfAsset(head, header);
+    asset.buffers[0].byteLength = payloadSize;
+    asset.bufferViews[0].byteLength = payloadSize;
+
+    // 步骤 5: 导出 JSON 并计算布局
+    if (options.verbose) {
+        std::cout << "[INFO] Exporting GLB..." << std::endl;
+    }
+    SPZ2GLB_TRACE_SCOPE(exportTrace, "export");
+    spz2glb::MemoryStageScope memoryStage(spz2glb::MemoryStage::Build);
+    spz2glb::GlbJsonExporter exporter;
+    std::string json;
+    auto error = exporter.writeBinaryJson(asset, json);
+    if (error != fastgltf::Error::None) {
+        return SpzResult::error(SpzErrorCode::ConversionFailed,
+            "GLB export failed: " + std::string(fastgltf::getErrorMessage(error)));
+    }
+    SPZ2GLB_TRACE_BYTES(exportTrace, json.size());
+
+    if (!compressionExtras.empty()) {
+        // fastgltf 不支持扩展对象上的 extras，在导出的 JSON 中该扩展对象末尾插入
+        const std::string extension = "\"KHR_gaussian_splatting_compression_spz_2\":{";
+        size_t begin = json.find(extension);
+        size_t end = begin == std::string::npos ? begin : json.find('}', begin);
+        if (end == std::string::npos) {
+            return SpzResult::error(SpzErrorCode::ConversionFailed,
+                "GLB export failed: SPZ compression extension not found");
+        }
+        json.insert(end, ",\"extras\":" + compressionExtras);
+    }
+
+    if (payloadSize > std::numeric_limits<uint32_t>::max() ||
+        !spz2glb::computeGlbLayout(json.size(), static_cast<size_t>(payloadSize), layout)) {
+        return SpzResult::error(SpzErrorCode::ConversionFailed, spz2glb::kGlbSizeLimitError);
+    }
+
+    return SpzResult::ok(spz2glb::writeGlbPreamble(json, layout));
+}
+
+/**
+ * 核心转换函数（桌面版和 WASM 共用）
+ *
+ * @param spzData SPZ 压缩数据
+ * @param glbData 输出 GLB 数据
+ * @return true 如果转换成功
+ *
+ * 在内存中拼出完整 GLB：前导字节 + SPZ 负载 + 填充，负载只复制一次
+ */
+bool convertSpzToGlbCore(const std::vector<uint8_t>& spzData, std::vector<uint8_t>& glbData) {
+    std::span<const std::byte> input(reinterpret_cast<const std::byte*>(spzData.data()), spzData.size());
+    size_t glbSize = 0;
+    auto planned = spz2glb::glbSizeForSpz(input, glbSize);
+    if (!planned.success) {
+        std::cerr << "[ERROR] " << planned.errorMessage << std::endl;
+        return false;
+    }
+
+    glbData.resize(glbSize);
+    size_t written = 0;
+    auto converted = spz2glb::convertSpzToGlb(input, std::as_writable_bytes(std::span(glbData)), written);
+    if (!converted.success) {
+        std::cerr << "[ERROR] " << converted.errorMessage << std::endl;
+        return false;
+    }
+    return true;
+}
+
+#ifndef __EMSCRIPTEN__
+
+/**
+ * 按 options.spatialCurve 重排已解压的 SPZ 数据（就地替换）
+ *
+ * 解码出位置后计算曲线顺序，再按点搬移各属性段的量化字节；
+ * verbose 时测量重排前后模拟深度排序的耗时（sortMsBefore / sortMsAfter，否则为 0）
+ */
+static SpzResult reorderSpzBody(std::vector<uint8_t>& inflated,
+                                const spz2glb::ConvertOptions& options,
+                                double& sortMsBefore,
+                                double& sortMsAfter) {
+    spz2glb::SplatData splats;
+    std::string error;
+    if (!spz2glb::decodeSpz(inflated, splats, error, options.pool)) {
+        return SpzResult::error(SpzErrorCode::ConversionFailed, "Reorder: " + error);
+    }
+    std::vector<uint32_t> order;
+    spz2glb::computeSpatialOrder(splats.positions.span(), options.spatialCurve, options.pool, order);
+
+    std::vector<uint8_t> reordered;
+    if (!spz2glb::permuteSpzBody(inflated, order, reordered, error)) {
+        return SpzResult::error(SpzErrorCode::ConversionFailed, "Reorder: " + error);
+    }
+    inflated = std::move(reordered);
+
+    sortMsBefore = 0;
+    sortMsAfter = 0;
+    if (options.verbose) {
+        std::vector<float> positions(splats.positions.size());
+        for (size_t i = 0; i < order.size(); ++i) {
+            std::memcpy(&positions[i * 3], &splats.positions[static_cast<size_t>(order[i]) * 3], 3 * sizeof(float));
+        }
+        sortMsBefore = spz2glb::measureDepthSortMs(splats.positions.span());
+        sortMsAfter = spz2glb::measureDepthSortMs(positions);
+    }
+    return SpzResult::ok({});
+}
+
+/**
+ * 重新压缩 SPZ 负载
+ *
+ * 解压整个 SPZ 流后重新压缩，结果仍是单成员 gzip，普通 SPZ 解码器照常顺序读取：
+ * - options.maxShDegree：先丢掉高于该阶的球谐系数（头中 shDegree 随之改写），extras 记
+ *     "spz2glb:shDegree":{"from":3,"to":1}
+ *   输入阶数不高于该值时不改动；截断后不与 repack / recompress 同用时以 zlib 9 级压缩
+ * - options.spatialCurve：压缩前按空间填充曲线重排点（解压内容变为输入的一个点排列），extras 记
+ *     "spz2glb:spatialOrder":{"curve":"morton"|"hilbert"}
+ *   不与 repack / recompress 同用时以 zlib 9 级压缩
+ * - options.repackBlockBytes：切成独立压缩的块，在 options.pool 上并行压缩；
+ *   块表写入扩展 extras（偏移相对于 bufferView 起点）：
+ *     "spz2glb:blocks":{"blockSize":B,"uncompressedSize":U,"crc32":C,"offsets":[...]}
+ *   第 i 块解压后对应 [i * B, min((i + 1) * B, U))，从 offsets[i] 开始按原始 deflate 解压即可
+ * - options.recompress：用 optimalDeflate 压缩（与 repack 同用时逐块压缩），extras 记
+ *     "spz2glb:recompressed":{"iterations":N}
+ *   只重新压缩时如果结果不比输入小，保留输入的 gzip 流，extras 为空
+ * 不重排、不截断球谐时解压内容与输入逐字节相同
+ */
+SpzResult reencodeSpzPayload(std::span<const uint8_t> spzData,
+                             const spz2glb::ConvertOptions& options,
+                             std::vector<uint8_t>& payload,
+                             std::string& extras) {
+    SPZ2GLB_TRACE_SCOPE(trace, "reencode");
+    SPZ2GLB_TRACE_BYTES(trace, spzData.size());
+    spz2glb::MemoryStageScope memoryStage(spz2glb::MemoryStage::Build);
+    auto inflated = decompressSpzData(spzData);
+    if (!inflated.success) {
+        return inflated;
+    }
+
+    std::string error;
+    std::vector<std::string> members;
+    uint32_t fromDegree = 0;
+    const size_t decodedBefore = inflated.data.size();
+    if (!spz2glb::truncateSpzShDegree(inflated.data, options.maxShDegree, options.pool, fromDegree, error)) {
+        return SpzResult::error(SpzErrorCode::ConversionFailed, "SH truncation: " + error);
+    }
+    const bool truncated = fromDegree > options.maxShDegree;
+    if (truncated) {
+        members.push_back("\"spz2glb:shDegree\":{\"from\":" + std::to_string(fromDegree) +
+                          ",\"to\":" + std::to_string(options.maxShDegree) + "}");
+    } else if (options.maxShDegree < spz2glb::kMaxShDegree && options.verbose) {
+        std::cout << "[INFO] SH degree " << fromDegree << " is already at most " << options.maxShDegree
+                  << ", nothing to drop" << std::endl;
+    }
+    if (options.cancelled()) {
+        return SpzResult::error(SpzErrorCode::ConversionFailed, spz2glb::kConversionCancelled);
+    }
+    const bool reorder = options.spatialCurve != spz2glb::SpatialCurve::None;
+    double sortMsBefore = 0;
+    double sortMsAfter = 0;
+    // 与截断球谐同用时，重排的效果相对于截断后、未重排的数据衡量（verbose 时多压缩一次）
+    std::vector<uint8_t> unordered;
+    if (reorder && truncated && options.verbose) {
+        unordered = inflated.data;
+    }
+    if (reorder) {
+        auto reordered = reorderSpzBody(inflated.data, options, sortMsBefore, sortMsAfter);
+        if (!reordered.success) {
+            return reordered;
+        }
+        members.push_back(std::string("\"spz2glb:spatialOrder\":{\"curve\":\"") +
+                          spz2glb::spatialCurveName(options.spatialCurve) + "\"}");
+    }
+
+    // 重排或截断后的压缩方式：分块（repack）或单成员 gzip
+    auto encodeBody = [&](std::span<const uint8_t> body, std::vector<uint8_t>& out, spz2glb::GzipIndex& blocks) {
+        if (options.repackBlockBytes > 0) {
+            int level = options.recompress ? spz2glb::kMaxRatioLevel : Z_DEFAULT_COMPRESSION;
+            return spz2glb::repackGzipBlocks(body, options.repackBlockBytes, level, options.pool, out, blocks, error,
+                                             options.cancel);
+        }
+        int level = options.recompress ? spz2glb::kMaxRatioLevel : Z_BEST_COMPRESSION;
+        return spz2glb::compressGzip(body, level, options.pool, out, error, options.cancel);
+    };
+
+    if (options.repackBlockBytes > 0) {
+        spz2glb::GzipIndex blocks;
+        if (!encodeBody(inflated.data, payload, blocks)) {
+            return SpzResult::error(SpzErrorCode::ConversionFailed, "Repack failed: " + error);
+        }
+        members.push_back(spz2glb::formatGzipBlockTable(blocks));
+        if (options.verbose) {
+            std::cout << "[INFO] Repacked SPZ payload: " << blocks.points.size() << " blocks, "
+                      << spzData.size() << " -> " << payload.size() << " bytes" << std::endl;
+        }
+    } else if (!reorder && !truncated && !options.recompress) {
+        // 只要求截断球谐、而输入阶数本来就不高：负载保持输入的 gzip 流
+        payload.assign(spzData.begin(), spzData.end());
+        extras.clear();
+        return SpzResult::ok({});
+    } else if (!reorder && !truncated) {
+        if (!spz2glb::recompressGzip(inflated.data, options.pool, payload, error, options.cancel)) {
+            return SpzResult::error(SpzErrorCode::ConversionFailed, "Recompress failed: " + error);
+        }
+        if (payload.size() >= spzData.size()) {
+            if (options.verbose) {
+                std::cout << "[INFO] Recompressed SPZ payload is not smaller (" << payload.size()
+                          << " bytes), keeping the original" << std::endl;
+            }
+            payload.assign(spzData.begin(), spzData.end());
+            extras.clear();
+            return SpzResult::ok({});
+        }
+        if (options.verbose) {
+            double saved = 100.0 * static_cast<double>(spzData.size() - payload.size()) / spzData.size();
+            std::cout << "[INFO] Recompressed SPZ payload: " << spzData.size() << " -> " << payload.size()
+                      << " bytes (-" << std::fixed << std::setprecision(1) << saved << "%)"
+                      << std::defaultfloat << std::endl;
+        }
+    } else {
+        spz2glb::GzipIndex blocks;
+        if (!encodeBody(inflated.data, payload, blocks)) {
+            return SpzResult::error(SpzErrorCode::ConversionFailed, "Compress failed: " + error);
+        }
+    }
+    if (options.recompress) {
+        members.push_back("\"spz2glb:recompressed\":{\"iterations\":" +
+                          std::to_string(spz2glb::kOptimalDeflateIterations) + "}");
+    }
+
+    // 两种变换同用时各自报告：截断球谐为输入 -> 未重排的截断结果，重排为该结果 -> 最终负载
+    uint64_t unorderedSize = spzData.size();
+    if (!unordered.empty()) {
+        std::vector<uint8_t> baseline;
+        spz2glb::GzipIndex blocks;
+        if (!encodeBody(unordered, baseline, blocks)) {
+            return SpzResult::error(SpzErrorCode::ConversionFailed, "Compress failed: " + error);
+        }
+        unorderedSize = baseline.size();
+    }
+    if (truncated && options.verbose) {
+        uint64_t shPayload = reorder ? unorderedSize : payload.size();
+        double saved = 100.0 * (static_cast<double>(spzData.size()) - shPayload) / spzData.size();
+        std::cout << "[INFO] SH degree " << fromDegree << " -> " << options.maxShDegree << ": payload "
+                  << spzData.size() << " -> " << shPayload << " bytes (-" << std::fixed << std::setprecision(1)
+                  << saved << "%), decoded " << decodedBefore << " -> " << inflated.data.size() << " bytes"
+                  << std::defaultfloat << std::endl;
+    }
+    if (reorder && options.verbose) {
+        double change = 100.0 * (static_cast<double>(payload.size()) - unorderedSize) / unorderedSize;
+        std::cout << "[INFO] Spatial order (" << spz2glb::spatialCurveName(options.spatialCurve) << "): payload "
+                  << unorderedSize << " -> " << payload.size() << " bytes (" << std::showpos << std::fixed
+                  << std::setprecision(1) << change << std::noshowpos << "%), depth sort " << std::setprecision(2)
+                  << sortMsBefore << " -> " << sortMsAfter << " ms" << std::defaultfloat << std::endl;
+    }
+
+    extras = "{";
+    for (size_t i = 0; i < members.size(); ++i) {
+        extras += (i > 0 ? "," : "") + members[i];
+    }
+    extras += "}";
+    return SpzResult::ok({});
+}
+
+/**
+ * 为输入的 gzip 流建随机访问索引，写到 <outputPath>.zidx
+ *
+ * @param payloadOffset SPZ 负载在输出 GLB 中的偏移（即前导字节长度）
+ */
+static SpzResult writeGzipIndexSidecar(std::span<const uint8_t> spzData,
+                                       const std::string& outputPath,
+                                       uint64_t payloadOffset,
+                                       const spz2glb::ConvertOptions& options) {
+    spz2glb::GzipIndex index;
+    std::string error;
+    if (!spz2glb::buildGzipIndex(spzData, options.gzipIndexSpan, index, error)) {
+        return SpzResult::error(SpzErrorCode::FailedToDecompress, "Gzip index: " + error);
+    }
+    index.payloadOffset = payloadOffset;
+
+    std::string indexPath = outputPath + ".zidx";
+    if (!spz2glb::writeGzipIndex(indexPath, index, error)) {
+        return SpzResult::error(SpzErrorCode::CannotOpenOutputFile, error);
+    }
+    if (options.verbose) {
+        std::cout << "[INFO] Gzip index: " << indexPath << " (" << index.points.size()
+                  << " access points)" << std::endl;
+    }
+    return SpzResult::ok({});
+}
+
+/**
+ * 文件到文件转换（命令行与批量模式共用）
+ *
+ * @param inputPath SPZ 文件路径
+ * @param outputPath GLB 输出路径
+ * @param layout 输出：GLB 布局（totalLength 即输出文件大小）
+ * @param options 转换选项
+ * @return 成功与否及错误信息（data 为空）
+ *
+ * 输入以只读映射打开：负载不读入用户态缓冲区，直接由内核拼接到输出文件
+ */
+SpzResult convertSpzFile(const std::string& inputPath,
+                         const std::string& outputPath,
+                         spz2glb::GlbLayout& layout,
+                         const spz2glb::ConvertOptions& options) {
+    SPZ2GLB_TRACE_SCOPE(convertTrace, "convert");
+    spz2glb::MappedFile spzFile;
+    {
+        SPZ2GLB_TRACE_SCOPE(trace, "load");
+        spz2glb::MemoryStageScope memoryStage(spz2glb::MemoryStage::Read);
+        if (!spzFile.open(inputPath)) {
+            return SpzResult::error(SpzErrorCode::CannotOpenSpzFile,
+                "Cannot open SPZ file: " + inputPath);
+        }
+        SPZ2GLB_TRACE_BYTES(trace, spzFile.size());
+    }
+    SPZ2GLB_TRACE_BYTES(convertTrace, spzFile.size());
+
+    // 重新压缩后负载已不是输入的 gzip 流（重新打包时块表本身就是访问点），不再另写索引
+    const bool indexSidecar = options.gzipIndexSpan > 0 && options.mode == spz2glb::OutputMode::Compressed &&
+                              !options.reencodesPayload();
+
+    // 清单需要分块结果，命中缓存时无从生成，写清单时不使用缓存
+    spz2glb::ConversionCache* cache = options.tileset ? nullptr : options.cache;
+    std::string cacheKey;
+    if (cache != nullptr) {
+        cacheKey = spz2glb::ConversionCache::keyFor(spzFile.bytes(), options);
+        uint64_t glbBytes = 0;
+        if (cache->fetch(cacheKey, outputPath, glbBytes)) {
+            if (options.verbose) {
+                std::cout << "[INFO] Cache hit: " << cacheKey << std::endl;
+            }
+            layout = {};
+            layout.totalLength = static_cast<uint32_t>(glbBytes);
+            if (indexSidecar) {
+                // 缓存只保存 GLB，索引重新生成；负载偏移由前导字节长度给出
+                spz2glb::ConvertOptions quiet = options;
+                quiet.verbose = false;
+                spz2glb::GlbLayout hitLayout;
+                auto preamble = buildGlbPreamble(spzFile.bytes(), hitLayout, quiet);
+                if (!preamble.success) {
+                    return preamble;
+                }
+                return writeGzipIndexSidecar(spzFile.bytes(), outputPath, hitLayout.preambleSize, options);
+            }
+            return SpzResult::ok({});
+        }
+    }
+
+    if (options.verbose) {
+        std::cout << "[INFO] Converting to GLB..." << std::endl;
+    }
+    // 属性模式：解码后由多段 accessor 数组组成 BIN；
+    // 压缩模式：BIN 即输入文件本身，重新打包/重新压缩时为内存中的新 gzip 流，分块时为各块的 gzip 流，
+    // LOD 时为各粗层的 gzip 流加上输入文件本身
+    spz2glb::AttributeGlb attributes;
+    spz2glb::TiledGlb tiled;
+    spz2glb::LodGlb lod;
+    std::vector<uint8_t> repacked;
+    std::vector<std::span<const uint8_t>> segments;  // 为空时 BIN 直接从输入文件拷贝
+    SpzResult preamble;
+    if (options.mode == spz2glb::OutputMode::Attributes) {
+        preamble = spz2glb::buildAttributeGlb(spzFile.bytes(), attributes, options);
+        layout = attributes.layout;
+        preamble.data = std::move(attributes.preamble);
+        segments = attributes.segments;
+    } else if (options.tilePoints > 0) {
+        preamble = spz2glb::buildTiledGlb(spzFile.bytes(), tiled, options);
+        layout = tiled.layout;
+        preamble.data = std::move(tiled.preamble);
+        segments = tiled.segments;
+    } else if (options.lodLevels > 0) {
+        preamble = spz2glb::buildLodGlb(spzFile.bytes(), lod, options);
+        layout = lod.layout;
+        preamble.data = std::move(lod.preamble);
+        segments = lod.segments;
+    } else if (options.reencodesPayload()) {
+        std::string extras;
+        preamble = reencodeSpzPayload(spzFile.bytes(), options, repacked, extras);
+        if (preamble.success) {
+            preamble = buildGlbPreamble(repacked, layout, options, extras);
+            segments.push_back(repacked);
+        }
+    } else {
+        preamble = buildGlbPreamble(spzFile.bytes(), layout, options);
+    }
+    // 取消后各阶段以各自的错误前缀返回，统一报告为取消；写出开始前最后检查一次
+    if (options.cancelled()) {
+        return SpzResult::error(SpzErrorCode::ConversionFailed, spz2glb::kConversionCancelled);
+    }
+    if (!preamble.success) {
+        return preamble;
+    }
+
+    if (options.verbose) {
+        std::cout << "[INFO] Writing GLB: " << outputPath << std::endl;
+    }
+    SPZ2GLB_TRACE_SCOPE(writeTrace, "write");
+    SPZ2GLB_TRACE_BYTES(writeTrace, layout.totalLength);
+    spz2glb::MemoryStageScope memoryStage(spz2glb::MemoryStage::Write);
+    bool written = !segments.empty()
+        ? spz2glb::writeGlbSegments(outputPath, preamble.data, segments, layout)
+        : spz2glb::writeGlbFile(outputPath, preamble.data, spzFile, layout);
+    if (!written) {
+        return SpzResult::error(SpzErrorCode::CannotOpenOutputFile,
+            "Failed to write GLB: " + outputPath);
+    }
+
+    if (cache != nullptr) {
+        cache->store(cacheKey, outputPath);
+    }
+    if (options.tileset && options.tilePoints > 0) {
+        std::string manifestPath = outputPath + ".tileset.json";
+        std::string glbUri = outputPath.substr(outputPath.find_last_of("/\\") + 1);
+        std::string error;
+        if (!spz2glb::writeTilesetManifest(manifestPath, glbUri, tiled, error)) {
+            return SpzResult::error(SpzErrorCode::CannotOpenOutputFile, error);
+        }
+        if (options.verbose) {
+            std::cout << "[INFO] Tileset manifest: " << manifestPath << std::endl;
+        }
+    }
+    if (indexSidecar) {
+        return writeGzipIndexSidecar(spzFile.bytes(), outputPath, layout.preambleSize, options);
+    }
+    return SpzResult::ok({});
+}
+
+#endif  // __EMSCRIPTEN__
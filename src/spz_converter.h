@@ -0,0 +1,175 @@
+// Copyright (c) 2026 Pu Junhan
+// SPDX-License-Identifier: MIT
+// Project: SPZ-ecosystem
+// Repository: https://github.com/spz-ecosystem/spz2glb
+//
+// SPZ 到 GLB 转换核心（命令行、批量模式与 WASM 共用）
+
+#ifndef SPZ2GLB_SPZ_CONVERTER_H_
+#define SPZ2GLB_SPZ_CONVERTER_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <fastgltf/types.hpp>
+
+#include "glb_writer.h"
+#include "sh_degree.h"
+#include "spatial_order.h"
+
+enum class SpzErrorCode {
+    Success = 0,
+    CannotOpenSpzFile = 1,
+    FailedToReadSpzFile = 2,
+    FailedToInitZlib = 3,
+    FailedToDecompress = 4,
+    ConversionFailed = 5,
+    CannotOpenOutputFile = 6
+};
+
+struct SpzResult {
+    bool success;
+    std::string errorMessage;
+    std::vector<uint8_t> data;
+
+    static SpzResult ok(std::vector<uint8_t> data) {
+        return {true, "", std::move(data)};
+    }
+    static SpzResult error(SpzErrorCode code, const std::string& msg) {
+        (void)code;
+        return {false, msg, {}};
+    }
+};
+
+/**
+ * SPZ 文件格式头结构（16 字节）
+ * 
+ * SPZ 文件使用大端序存储，包含高斯泼溅的元数据
+ * Magic: "NGSP" (0x5053474e) - 标识 SPZ 文件
+ */
+struct SpzHeader {
+    uint32_t magic;        // 魔术数字：0x5053474e ("NGSP")，用于标识 SPZ 文件
+    uint32_t version;      // SPZ 规范版本：2 或 3
+    uint32_t numPoints;    // 高斯泼溅点数量，决定渲染质量
+    uint8_t shDegree;      // 球谐函数阶数：0-3（0=无 SH，3=最高质量）
+    uint8_t fractionalBits; // 定点数精度位数
+    uint8_t flags;         // 标志位
+    uint8_t reserved;      // 保留字节（对齐用）
+};
+
+namespace spz2glb {
+
+class ConversionCache;
+class ThreadPool;
+
+/**
+ * 输出模式
+ */
+enum class OutputMode {
+    Compressed,  // SPZ 压缩流原样放入 BIN（KHR_gaussian_splatting_compression_spz_2），默认
+    Attributes   // 解码为未压缩的 KHR_gaussian_splatting accessor
+};
+
+/**
+ * 属性模式下的顶点数据布局
+ */
+enum class AttributeLayout {
+    Planar,      // 每个属性一个 bufferView
+    Interleaved  // 所有属性交错在一个带 byteStride 的 bufferView 中
+};
+
+// 经 ConvertOptions::cancel 取消时的错误信息
+inline constexpr char kConversionCancelled[] = "Conversion cancelled";
+
+/**
+ * 转换选项
+ */
+struct ConvertOptions {
+    bool verbose = true;  // 打印 [INFO] 进度信息（批量模式下关闭，避免多线程输出交错）
+    ConversionCache* cache = nullptr;  // 非空时 convertSpzFile 先查缓存，未命中再转换并写入缓存
+    OutputMode mode = OutputMode::Compressed;
+    AttributeLayout attributeLayout = AttributeLayout::Planar;
+    ThreadPool* pool = nullptr;  // 属性模式下解码与属性变换使用的线程池（为空则单线程）
+    uint64_t gzipIndexSpan = 0;  // 非 0 时在输出旁写出 gzip 随机访问索引 <output>.zidx（压缩模式），访问点间隔字节数
+    uint64_t repackBlockBytes = 0;  // 非 0 时把 SPZ 负载重新压缩为每块该字节数、可并行解压的 gzip 流（压缩模式）
+    bool recompress = false;  // 用 optimalDeflate 重新压缩 SPZ 负载，解压内容不变、体积最小（压缩模式）
+    SpatialCurve spatialCurve = SpatialCurve::None;  // 按空间填充曲线重排点（压缩模式重新压缩负载，属性模式重排 accessor）
+    uint32_t tilePoints = 0;  // 非 0 时按八叉树分块输出，每块最多该点数，各块是独立的 SPZ 流与 node（压缩模式）
+    bool tileset = false;     // 分块时在输出旁写出清单 <output>.tileset.json
+    uint32_t lodLevels = 0;   // 非 0 时在输入之外生成该数量的合并粗层，每层是独立的 SPZ 流与 node（压缩模式）
+    uint32_t maxShDegree = kMaxShDegree;  // 丢掉高于该阶的球谐系数（压缩模式重新压缩负载，属性模式少写 accessor）
+    // 非空时 convertSpzFile 在阶段边界与重新压缩的各段之间检查，置位后以 kConversionCancelled 失败、不写出输出
+    const std::atomic<bool>* cancel = nullptr;
+
+    bool cancelled() const { return cancel != nullptr && cancel->load(std::memory_order_relaxed); }
+
+    // 压缩模式下 BIN 不再是输入的 gzip 流本身（--repack / --recompress / --reorder / --tile / --lod / --max-sh-degree）
+    bool reencodesPayload() const {
+        return repackBlockBytes > 0 || recompress || spatialCurve != SpatialCurve::None || tilePoints > 0 ||
+               lodLevels > 0 || maxShDegree < kMaxShDegree;
+    }
+};
+
+}  // namespace spz2glb
+
+// 解析 SPZ 文件头（输入为已解压数据）
+bool parseSpzHeader(const std::vector<uint8_t>& data, SpzHeader& header);
+
+// 计算 glTF accessor 数量（基于球谐函数阶数）
+int getAccessorCount(int shDegree);
+
+// 加载 SPZ 文件（保持 gzip 压缩状态）
+SpzResult loadSpzFile(const std::string& spzPath);
+
+// 解压完整的 SPZ gzip 数据
+SpzResult decompressSpzData(std::span<const uint8_t> compressedData);
+
+// 有界解压：只解压 SPZ gzip 流的前 maxBytes 字节
+SpzResult inflateSpzPrefix(std::span<const uint8_t> compressedData, size_t maxBytes);
+
+// 校验 SPZ 负载完整：gzip 尾部的 ISIZE 必须等于 SPZ 头隐含的解压长度（只解压头部时发现截断）
+// head 为负载开头，tail 为负载末尾（至少 4 字节），payloadSize 为负载总长度；负载整个在内存中时两者传同一个 span
+SpzResult checkSpzLength(std::span<const uint8_t> head,
+                         std::span<const uint8_t> tail,
+                         uint64_t payloadSize,
+                         const SpzHeader& header);
+
+// 创建 glTF 资产（buffer 0 引用 spzData，不复制）
+fastgltf::Asset createGltfAsset(std::span<const uint8_t> spzData, const SpzHeader& header);
+
+// 生成 GLB 前导字节（GLB 头 + JSON Chunk + BIN Chunk 头），结果在 SpzResult::data 中
+// compressionExtras 非空时作为 KHR_gaussian_splatting_compression_spz_2 扩展对象的 extras（JSON 对象文本）
+SpzResult buildGlbPreamble(std::span<const uint8_t> spzData,
+                           spz2glb::GlbLayout& layout,
+                           const spz2glb::ConvertOptions& options = {},
+                           const std::string& compressionExtras = {});
+
+// 同上，但只给出负载开头的 head（至少包含压缩的 SPZ 头）与负载总长度：负载尚未全部读入时使用（流式转换）
+SpzResult buildGlbPreamble(std::span<const uint8_t> head,
+                           uint64_t payloadSize,
+                           spz2glb::GlbLayout& layout,
+                           const spz2glb::ConvertOptions& options = {},
+                           const std::string& compressionExtras = {});
+
+// 内存中完整转换（embind 使用；按 spz2glb::glbSizeForSpz 定长后由 spz2glb::convertSpzToGlb 一次写入）
+bool convertSpzToGlbCore(const std::vector<uint8_t>& spzData, std::vector<uint8_t>& glbData);
+
+#ifndef __EMSCRIPTEN__
+// 重新压缩 SPZ 负载（options.repackBlockBytes / options.recompress），extras 为写入扩展 extras 的 JSON 对象
+SpzResult reencodeSpzPayload(std::span<const uint8_t> spzData,
+                             const spz2glb::ConvertOptions& options,
+                             std::vector<uint8_t>& payload,
+                             std::string& extras);
+
+// 文件到文件转换：mmap 输入，负载直接拼接到输出文件
+SpzResult convertSpzFile(const std::string& inputPath,
+                         const std::string& outputPath,
+                         spz2glb::GlbLayout& layout,
+                         const spz2glb::ConvertOptions& options = {});
+#endif
+
+#endif  // SPZ2GLB_SPZ_CONVERTER_H_
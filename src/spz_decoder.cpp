@@ -0,0 +1,371 @@
+// Copyright (c) 2026 Pu Junhan
+// SPDX-License-Identifier: MIT
+// Project: SPZ-ecosystem
+// Repository: https://github.com/spz-ecosystem/spz2glb
+//
+// SPZ 负载解码器实现
+// x86-64 上使用 SSE2（SSSE3 可用时位置解包使用 pshufb），其他平台使用标量循环
+
+#include "spz_decoder.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SPZ2GLB_HAVE_SSE2 1
+#include <emmintrin.h>
+#if defined(__SSSE3__)
+#define SPZ2GLB_HAVE_SSSE3 1
+#include <tmmintrin.h>
+#endif
+#endif
+
+#include "memory_pool.h"
+#include "spz_converter.h"
+#include "thread_pool.h"
+#include "trace.h"
+
+namespace spz2glb {
+
+namespace {
+
+constexpr size_t kPointsPerChunk = 64 * 1024;
+constexpr float kColorScale = 0.15f;  // 与 SPZ 参考实现一致
+
+inline uint32_t load32(const uint8_t* p) {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+float halfToFloat(uint16_t h) {
+    uint32_t sign = static_cast<uint32_t>(h & 0x8000) << 16;
+    uint32_t exponent = (h >> 10) & 0x1F;
+    uint32_t mantissa = h & 0x3FF;
+    uint32_t bits;
+    if (exponent == 0) {
+        if (mantissa == 0) {
+            bits = sign;
+        } else {
+            // 非规格化数：规格化后重新计算指数
+            exponent = 113;
+            while ((mantissa & 0x400) == 0) {
+                mantissa <<= 1;
+                exponent--;
+            }
+            bits = sign | (exponent << 23) | ((mantissa & 0x3FF) << 13);
+        }
+    } else if (exponent == 31) {
+        bits = sign | 0x7F800000 | (mantissa << 13);
+    } else {
+        bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+    }
+    float f;
+    std::memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+
+/**
+ * u8 → float 仿射反量化：dst[i] = src[i] * mul + add
+ * alphas、colors、scales、sh 共用（每次 16 个）
+ */
+void dequantizeAffine(const uint8_t* src, float* dst, size_t count, float mul, float add, bool simd) {
+    size_t i = 0;
+#if SPZ2GLB_HAVE_SSE2
+    const __m128 vmul = _mm_set1_ps(mul);
+    const __m128 vadd = _mm_set1_ps(add);
+    const __m128i zero = _mm_setzero_si128();
+    for (; simd && i + 16 <= count; i += 16) {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        __m128i lo = _mm_unpacklo_epi8(bytes, zero);
+        __m128i hi = _mm_unpackhi_epi8(bytes, zero);
+        __m128 f0 = _mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero));
+        __m128 f1 = _mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero));
+        __m128 f2 = _mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero));
+        __m128 f3 = _mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero));
+        _mm_storeu_ps(dst + i, _mm_add_ps(_mm_mul_ps(f0, vmul), vadd));
+        _mm_storeu_ps(dst + i + 4, _mm_add_ps(_mm_mul_ps(f1, vmul), vadd));
+        _mm_storeu_ps(dst + i + 8, _mm_add_ps(_mm_mul_ps(f2, vmul), vadd));
+        _mm_storeu_ps(dst + i + 12, _mm_add_ps(_mm_mul_ps(f3, vmul), vadd));
+    }
+#endif
+    for (; i < count; ++i) {
+        dst[i] = static_cast<float>(src[i]) * mul + add;
+    }
+}
+
+/**
+ * 24 位有符号小端定点数 → float：dst[i] = int24 * scale
+ */
+void dequantizeFixed24(const uint8_t* src, float* dst, size_t count, float scale, bool simd) {
+    size_t i = 0;
+#if SPZ2GLB_HAVE_SSE2
+    const __m128 vscale = _mm_set1_ps(scale);
+#if SPZ2GLB_HAVE_SSSE3
+    // 每 4 个值 12 字节：pshufb 把 3 字节放进每个 32 位的高 3 字节，算术右移 8 位完成符号扩展
+    const __m128i shuffle = _mm_setr_epi8(-1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11);
+    for (; simd && i + 6 <= count; i += 4) {  // 读 16 字节，保证不越过本段末尾
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 3));
+        __m128i v = _mm_srai_epi32(_mm_shuffle_epi8(bytes, shuffle), 8);
+        _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(v), vscale));
+    }
+#else
+    for (; simd && i + 5 <= count; i += 4) {  // 每个值读 4 字节，保证不越过本段末尾
+        const uint8_t* p = src + i * 3;
+        __m128i v = _mm_setr_epi32(static_cast<int>(load32(p)), static_cast<int>(load32(p + 3)),
+                                   static_cast<int>(load32(p + 6)), static_cast<int>(load32(p + 9)));
+        v = _mm_srai_epi32(_mm_slli_epi32(v, 8), 8);
+        _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(v), vscale));
+    }
+#endif
+#endif
+    for (; i < count; ++i) {
+        const uint8_t* p = src + i * 3;
+        int32_t v = static_cast<int32_t>(p[0] | (p[1] << 8) | (p[2] << 16));
+        v = (v ^ 0x800000) - 0x800000;  // 符号扩展
+        dst[i] = static_cast<float>(v) * scale;
+    }
+}
+
+/**
+ * v1/v2 四元数：3 字节 xyz，w = sqrt(max(0, 1 - |xyz|²))
+ */
+void decodeQuatXyz(const uint8_t* src, float* dst, size_t count, bool simd) {
+    constexpr float mul = 1.0f / 127.5f;
+    size_t i = 0;
+#if SPZ2GLB_HAVE_SSE2
+    const __m128 vmul = _mm_set1_ps(mul);
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 zero = _mm_setzero_ps();
+    for (; simd && i + 4 <= count; i += 4) {
+        const uint8_t* p = src + i * 3;
+        __m128 x = _mm_sub_ps(_mm_mul_ps(_mm_setr_ps(p[0], p[3], p[6], p[9]), vmul), one);
+        __m128 y = _mm_sub_ps(_mm_mul_ps(_mm_setr_ps(p[1], p[4], p[7], p[10]), vmul), one);
+        __m128 z = _mm_sub_ps(_mm_mul_ps(_mm_setr_ps(p[2], p[5], p[8], p[11]), vmul), one);
+        __m128 len2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+        __m128 w = _mm_sqrt_ps(_mm_max_ps(zero, _mm_sub_ps(one, len2)));
+        _MM_TRANSPOSE4_PS(x, y, z, w);
+        _mm_storeu_ps(dst + i * 4, x);
+        _mm_storeu_ps(dst + i * 4 + 4, y);
+        _mm_storeu_ps(dst + i * 4 + 8, z);
+        _mm_storeu_ps(dst + i * 4 + 12, w);
+    }
+#endif
+    for (; i < count; ++i) {
+        const uint8_t* p = src + i * 3;
+        float x = p[0] * mul - 1.0f;
+        float y = p[1] * mul - 1.0f;
+        float z = p[2] * mul - 1.0f;
+        float* q = dst + i * 4;
+        q[0] = x;
+        q[1] = y;
+        q[2] = z;
+        q[3] = std::sqrt(std::max(0.0f, 1.0f - (x * x + y * y + z * z)));
+    }
+}
+
+/**
+ * v3 四元数：32 位“最小三分量”编码
+ *
+ * 高 2 位为绝对值最大分量的下标 L，其余三个分量各 10 位（9 位幅值 + 1 位符号），
+ * 从低位起依次属于除 L 外下标从大到小的分量；最大分量 = sqrt(1 - 其余平方和)
+ */
+void decodeQuatSmallestThree(const uint8_t* src, float* dst, size_t count, bool simd) {
+    constexpr float magScale = 0.70710678118654752f / 511.0f;  // sqrt(1/2) / 9 位最大值
+    size_t i = 0;
+#if SPZ2GLB_HAVE_SSE2
+    const __m128i mask9 = _mm_set1_epi32(0x1FF);
+    const __m128i bit9 = _mm_set1_epi32(0x200);
+    const __m128 vscale = _mm_set1_ps(magScale);
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 zero = _mm_setzero_ps();
+
+    auto component = [&](__m128i bits) {
+        __m128 mag = _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(bits, mask9)), vscale);
+        // 符号位（第 9 位）移到 float 的符号位
+        __m128i sign = _mm_slli_epi32(_mm_and_si128(bits, bit9), 22);
+        return _mm_xor_ps(mag, _mm_castsi128_ps(sign));
+    };
+    auto select = [](__m128 mask, __m128 a, __m128 b) {  // mask ? a : b
+        return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+    };
+
+    for (; simd && i + 4 <= count; i += 4) {
+        __m128i packed = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 4));
+        __m128i largest = _mm_srli_epi32(packed, 30);
+        __m128 c0 = component(packed);
+        __m128 c1 = component(_mm_srli_epi32(packed, 10));
+        __m128 c2 = component(_mm_srli_epi32(packed, 20));
+        __m128 sum = _mm_add_ps(_mm_add_ps(_mm_mul_ps(c0, c0), _mm_mul_ps(c1, c1)), _mm_mul_ps(c2, c2));
+        __m128 big = _mm_sqrt_ps(_mm_max_ps(zero, _mm_sub_ps(one, sum)));
+
+        __m128 is0 = _mm_castsi128_ps(_mm_cmpeq_epi32(largest, _mm_set1_epi32(0)));
+        __m128 is1 = _mm_castsi128_ps(_mm_cmpeq_epi32(largest, _mm_set1_epi32(1)));
+        __m128 is2 = _mm_castsi128_ps(_mm_cmpeq_epi32(largest, _mm_set1_epi32(2)));
+        __m128 is3 = _mm_castsi128_ps(_mm_cmpeq_epi32(largest, _mm_set1_epi32(3)));
+
+        // 分量 k 对应的字段序号 = (3 - k) - (L > k ? 1 : 0)
+        __m128 w = select(is3, big, c0);
+        __m128 z = select(is2, big, select(is3, c0, c1));
+        __m128 y = select(is1, big, select(_mm_or_ps(is2, is3), c1, c2));
+        __m128 x = select(is0, big, c2);
+
+        _MM_TRANSPOSE4_PS(x, y, z, w);
+        _mm_storeu_ps(dst + i * 4, x);
+        _mm_storeu_ps(dst + i * 4 + 4, y);
+        _mm_storeu_ps(dst + i * 4 + 8, z);
+        _mm_storeu_ps(dst + i * 4 + 12, w);
+    }
+#endif
+    for (; i < count; ++i) {
+        uint32_t packed = load32(src + i * 4);
+        uint32_t largest = packed >> 30;
+        float* q = dst + i * 4;
+        float sum = 0.0f;
+        for (int k = 3; k >= 0; --k) {
+            if (static_cast<uint32_t>(k) == largest) continue;
+            float value = static_cast<float>(packed & 0x1FF) * magScale;
+            q[k] = (packed & 0x200) ? -value : value;
+            sum += q[k] * q[k];
+            packed >>= 10;
+        }
+        q[largest] = std::sqrt(std::max(0.0f, 1.0f - sum));
+    }
+}
+
+/**
+ * 各属性段在解压数据中的起始指针
+ */
+struct SpzSource {
+    uint32_t version;
+    uint32_t shDim;
+    size_t rotationBytes;  // 每个点
+    const uint8_t* positions;
+    const uint8_t* alphas;
+    const uint8_t* colors;
+    const uint8_t* scales;
+    const uint8_t* rotations;
+    const uint8_t* sh;
+    float positionScale;
+};
+
+void decodeRange(const SpzSource& in, SplatData& out, size_t begin, size_t end, bool simd) {
+    size_t n = end - begin;
+
+    if (in.version == 1) {
+        for (size_t i = begin * 3; i < end * 3; ++i) {
+            uint16_t h = static_cast<uint16_t>(in.positions[i * 2] | (in.positions[i * 2 + 1] << 8));
+            out.positions[i] = halfToFloat(h);
+        }
+    } else {
+        dequantizeFixed24(in.positions + begin * 9, out.positions.data() + begin * 3, n * 3, in.positionScale, simd);
+    }
+
+    dequantizeAffine(in.alphas + begin, out.alphas.data() + begin, n, 1.0f / 255.0f, 0.0f, simd);
+    dequantizeAffine(in.colors + begin * 3, out.colors.data() + begin * 3, n * 3,
+                     1.0f / (255.0f * kColorScale), -0.5f / kColorScale, simd);
+    dequantizeAffine(in.scales + begin * 3, out.scales.data() + begin * 3, n * 3, 1.0f / 16.0f, -10.0f, simd);
+
+    if (in.rotationBytes == 4) {
+        decodeQuatSmallestThree(in.rotations + begin * 4, out.rotations.data() + begin * 4, n, simd);
+    } else {
+        decodeQuatXyz(in.rotations + begin * 3, out.rotations.data() + begin * 4, n, simd);
+    }
+
+    if (in.shDim > 0) {
+        size_t perPoint = static_cast<size_t>(in.shDim) * 3;
+        dequantizeAffine(in.sh + begin * perPoint, out.sh.data() + begin * perPoint, n * perPoint,
+                         1.0f / 128.0f, -1.0f, simd);
+    }
+}
+
+/**
+ * 校验 SPZ 头并定位各属性段
+ */
+bool parseSource(std::span<const uint8_t> inflated, SpzHeader& header, SpzSource& source, std::string& error) {
+    static_assert(sizeof(SpzHeader) == kSpzHeaderBytes);
+    SpzLayout layout;
+    if (!parseSpzLayout(inflated, layout, error)) {
+        return false;
+    }
+    std::memcpy(&header, inflated.data(), sizeof(SpzHeader));
+
+    source.version = layout.version;
+    source.shDim = SplatData::shDimForDegree(layout.shDegree);
+    source.rotationBytes = layout.stride(SpzSection::Rotations);
+    source.positionScale = 1.0f / static_cast<float>(1u << std::min<uint32_t>(layout.fractionalBits, 31));
+    auto at = [&](SpzSection section) { return inflated.data() + layout.offset(section); };
+    source.positions = at(SpzSection::Positions);
+    source.alphas = at(SpzSection::Alphas);
+    source.colors = at(SpzSection::Colors);
+    source.scales = at(SpzSection::Scales);
+    source.rotations = at(SpzSection::Rotations);
+    source.sh = at(SpzSection::Sh);
+    return true;
+}
+
+}  // anonymous namespace
+
+bool decodeSpz(std::span<const uint8_t> inflated, SplatData& splats, std::string& error, ThreadPool* pool,
+               DecodeKernels kernels) {
+    SPZ2GLB_TRACE_SCOPE(trace, "decode");
+    SPZ2GLB_TRACE_BYTES(trace, inflated.size());
+    MemoryStageScope memoryStage(MemoryStage::Inflate);
+    SpzHeader header;
+    SpzSource source;
+    if (!parseSource(inflated, header, source, error)) {
+        return false;
+    }
+
+    splats.allocate(header.numPoints, header.shDegree);
+    splats.antialiased = (header.flags & 0x1) != 0;
+
+    const size_t n = header.numPoints;
+    size_t chunks = (n + kPointsPerChunk - 1) / kPointsPerChunk;
+    parallelFor(pool, chunks, [&](size_t chunk) {
+        size_t begin = chunk * kPointsPerChunk;
+        size_t end = std::min<size_t>(begin + kPointsPerChunk, n);
+        decodeRange(source, splats, begin, end, kernels == DecodeKernels::Simd);
+    });
+    return true;
+}
+
+bool decodeSpzPositions(std::span<const uint8_t> inflated, AlignedArray<float>& positions, std::string& error,
+                        ThreadPool* pool) {
+    SpzHeader header;
+    SpzSource source;
+    if (!parseSource(inflated, header, source, error)) {
+        return false;
+    }
+
+    const size_t n = header.numPoints;
+    positions.resize(n * 3);
+    size_t chunks = (n + kPointsPerChunk - 1) / kPointsPerChunk;
+    parallelFor(pool, chunks, [&](size_t chunk) {
+        size_t begin = chunk * kPointsPerChunk;
+        size_t end = std::min<size_t>(begin + kPointsPerChunk, n);
+        if (source.version == 1) {
+            for (size_t i = begin * 3; i < end * 3; ++i) {
+                uint16_t h = static_cast<uint16_t>(source.positions[i * 2] | (source.positions[i * 2 + 1] << 8));
+                positions[i] = halfToFloat(h);
+            }
+        } else {
+            dequantizeFixed24(source.positions + begin * 9, positions.data() + begin * 3, (end - begin) * 3,
+                              source.positionScale, true);
+        }
+    });
+    return true;
+}
+
+bool decodeCompressedSpz(std::span<const uint8_t> spzData, SplatData& splats, std::string& error,
+                         ThreadPool* pool) {
+    auto inflated = decompressSpzData(spzData);
+    if (!inflated.success) {
+        error = inflated.errorMessage;
+        return false;
+    }
+    return decodeSpz(inflated.data, splats, error, pool);
+}
+
+}  // namespace spz2glb
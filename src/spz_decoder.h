@@ -0,0 +1,152 @@
+// Copyright (c) 2026 Pu Junhan
+// SPDX-License-Identifier: MIT
+// Project: SPZ-ecosystem
+// Repository: https://github.com/spz-ecosystem/spz2glb
+//
+// SPZ 负载解码器
+// 把解压后的 SPZ 流（头 + 各属性段）解码为 SplatData
+
+#ifndef SPZ2GLB_SPZ_DECODER_H_
+#define SPZ2GLB_SPZ_DECODER_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string>
+
+#include "splat_data.h"
+
+namespace spz2glb {
+
+class ThreadPool;
+
+constexpr uint32_t kSpzMagic = 0x5053474e;  // "NGSP"
+constexpr size_t kSpzHeaderBytes = 16;      // sizeof(SpzHeader)
+
+/**
+ * SPZ 解压数据的属性段（按文件中的顺序）
+ */
+enum class SpzSection { Positions, Alphas, Colors, Scales, Rotations, Sh };
+constexpr SpzSection kSpzSections[] = {SpzSection::Positions, SpzSection::Alphas, SpzSection::Colors,
+                                       SpzSection::Scales,    SpzSection::Rotations, SpzSection::Sh};
+constexpr size_t kSpzSectionCount = std::size(kSpzSections);
+
+// 每个点在该段中的字节数（version 1~3，shDegree 0~3）
+constexpr size_t spzSectionStride(uint32_t version, uint32_t shDegree, SpzSection section) {
+    switch (section) {
+        case SpzSection::Positions: return version == 1 ? 6 : 9;
+        case SpzSection::Alphas: return 1;
+        case SpzSection::Colors: return 3;
+        case SpzSection::Scales: return 3;
+        case SpzSection::Rotations: return version >= 3 ? 4 : 3;
+        case SpzSection::Sh: return static_cast<size_t>(SplatData::shDimForDegree(shDegree)) * 3;
+    }
+    return 0;
+}
+
+/**
+ * 解压 SPZ 数据中各属性段的位置（相对数据开头）与每点字节数，下标为 SpzSection
+ */
+struct SpzLayout {
+    uint32_t version = 0;
+    uint32_t numPoints = 0;
+    uint32_t shDegree = 0;
+    uint32_t fractionalBits = 0;
+    std::array<uint64_t, kSpzSectionCount> offsets = {};
+    std::array<size_t, kSpzSectionCount> strides = {};
+    uint64_t end = 0;  // 最后一段之后，即头所要求的解压长度
+
+    uint64_t offset(SpzSection section) const { return offsets[static_cast<size_t>(section)]; }
+    size_t stride(SpzSection section) const { return strides[static_cast<size_t>(section)]; }
+};
+
+/**
+ * 读取解压数据开头的 SPZ 头并计算布局；长度全部按 64 位计算，避免恶意的 numPoints 溢出
+ *
+ * 只依赖头里的字节（不需要 SpzHeader 的定义），spz_verify 等不链接解码器的工具也可以使用
+ *
+ * @return 头不受支持，或数据短于 layout.end（"SPZ data truncated"）时返回 false
+ */
+inline bool parseSpzLayout(std::span<const uint8_t> inflated, SpzLayout& layout, std::string& error) {
+    if (inflated.size() < kSpzHeaderBytes) {
+        error = "SPZ data too short for header";
+        return false;
+    }
+    uint32_t magic;
+    std::memcpy(&magic, inflated.data(), 4);
+    std::memcpy(&layout.version, inflated.data() + 4, 4);
+    std::memcpy(&layout.numPoints, inflated.data() + 8, 4);
+    layout.shDegree = inflated[12];
+    layout.fractionalBits = inflated[13];
+    if (magic != kSpzMagic) {
+        error = "Invalid SPZ magic number";
+        return false;
+    }
+    if (layout.version < 1 || layout.version > 3) {
+        error = "Unsupported SPZ version: " + std::to_string(layout.version);
+        return false;
+    }
+    if (layout.shDegree > 3) {
+        error = "Unsupported SH degree: " + std::to_string(layout.shDegree);
+        return false;
+    }
+
+    uint64_t offset = kSpzHeaderBytes;
+    for (size_t s = 0; s < kSpzSectionCount; ++s) {
+        layout.strides[s] = spzSectionStride(layout.version, layout.shDegree, kSpzSections[s]);
+        layout.offsets[s] = offset;
+        offset += static_cast<uint64_t>(layout.numPoints) * layout.strides[s];
+    }
+    layout.end = offset;
+    if (layout.end > inflated.size()) {
+        error = "SPZ data truncated: expected " + std::to_string(layout.end - kSpzHeaderBytes) + " body bytes";
+        return false;
+    }
+    return true;
+}
+
+// 反量化内核：SIMD（默认，平台不支持时等同于标量）或纯标量（用于逐元素比对 SIMD 路径）
+enum class DecodeKernels {
+    Simd,
+    Scalar
+};
+
+/**
+ * 解码已解压的 SPZ 数据
+ *
+ * SPZ 流布局（头之后各属性段依次排列，段内按点顺序）：
+ * - positions：v1 为 3 个 float16；v2+ 为 3 个 24 位有符号定点数（fractionalBits 位小数）
+ * - alphas：1 字节
+ * - colors：3 字节
+ * - scales：3 字节，对数尺度 = byte / 16 - 10
+ * - rotations：v1/v2 为 3 字节 xyz（w 由单位长度推出）；v3 为 4 字节“最小三分量”编码
+ * - sh：shDim * 3 字节，(byte - 128) / 128
+ *
+ * 按 64K 个点分块，pool 非空时在线程池上并行解码；各属性的反量化使用 SIMD 内核
+ *
+ * @param inflated 解压后的 SPZ 数据（含 16 字节头）
+ * @param splats 输出
+ * @param error 失败原因
+ * @param pool 可选线程池
+ * @param kernels 反量化内核，Scalar 跳过全部 SIMD 循环
+ */
+bool decodeSpz(std::span<const uint8_t> inflated, SplatData& splats, std::string& error,
+               ThreadPool* pool = nullptr, DecodeKernels kernels = DecodeKernels::Simd);
+
+/**
+ * 只解码位置（每个点 xyz），用于只需要空间信息的处理（分块等），不为其余属性分配内存
+ */
+bool decodeSpzPositions(std::span<const uint8_t> inflated, AlignedArray<float>& positions, std::string& error,
+                        ThreadPool* pool = nullptr);
+
+/**
+ * 解压并解码 gzip 压缩的 SPZ 文件内容
+ */
+bool decodeCompressedSpz(std::span<const uint8_t> spzData, SplatData& splats, std::string& error,
+                         ThreadPool* pool = nullptr);
+
+}  // namespace spz2glb
+
+#endif  // SPZ2GLB_SPZ_DECODER_H_
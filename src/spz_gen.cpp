@@ -0,0 +1,166 @@
+// Copyright (c) 2026 Pu Junhan
+// SPDX-License-Identifier: MIT
+// Project: SPZ-ecosystem
+// Repository: https://github.com/spz-ecosystem/spz2glb
+//
+/**
+ * spz_gen：确定性合成 SPZ 生成器
+ *
+ * 同样的参数（种子、点数、SH 阶数、分布、版本、压缩级别）总是生成逐字节相同的文件，
+ * 与线程数无关。生成是流式的：任何时刻只有 2 × 线程数个 4 MB 块在内存中，可以直接写出数 GB 的文件
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+#include "synthetic_spz.h"
+#include "thread_pool.h"
+
+namespace {
+
+void printUsage(const char* progName) {
+    std::cout << "spz_gen - deterministic synthetic SPZ generator\n";
+    std::cout << "Usage: " << progName << " <output.spz | -> [options]\n\n";
+    std::cout << "Options:\n";
+    std::cout << "  --points <n>           Number of splats, K/M suffixes allowed (default: 1M)\n";
+    std::cout << "  --sh <0-3>             Spherical harmonics degree (default: 0)\n";
+    std::cout << "  --distribution <name>  uniform, clustered or surface (default: clustered)\n";
+    std::cout << "  --version <2|3>        SPZ version; v3 uses smallest-three rotations (default: 2)\n";
+    std::cout << "  --level <0-9>          gzip compression level (default: 6)\n";
+    std::cout << "  --seed <n>             Random seed (default: 1)\n";
+    std::cout << "  --threads <n>          Worker threads, 0 = all cores (default: 0)\n";
+    std::cout << "  -h, --help             Show this help\n\n";
+    std::cout << "Examples:\n";
+    std::cout << "  " << progName << " bench.spz --points 10M --sh 3\n";
+    std::cout << "  " << progName << " - --points 500K --version 3 | spz2glb - - > bench.glb\n";
+}
+
+bool parseUnsigned(const std::string& text, uint64_t max, uint64_t& value) {
+    if (text.empty() || text.find_first_not_of("0123456789") != std::string::npos || text.size() > 19) {
+        return false;
+    }
+    value = std::strtoull(text.c_str(), nullptr, 10);
+    return value <= max;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    spz2glb::SyntheticSpzParams params;
+    params.numPoints = 1'000'000;
+    params.distribution = spz2glb::SplatDistribution::Clustered;
+    uint64_t threads = 0;
+    std::string outputPath;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "-h" || arg == "--help") {
+            printUsage(argv[0]);
+            return 0;
+        }
+        if (arg.size() > 2 && arg.compare(0, 2, "--") == 0) {
+            if (i + 1 >= argc) {
+                std::cerr << "[ERROR] Missing value for " << arg << std::endl;
+                return 1;
+            }
+            std::string value = argv[++i];
+            uint64_t number = 0;
+            bool valid = true;
+            if (arg == "--points") {
+                valid = spz2glb::parseSplatCount(value, params.numPoints) && params.numPoints > 0 &&
+                        params.numPoints <= UINT32_MAX;
+            } else if (arg == "--sh") {
+                valid = parseUnsigned(value, 3, number);
+                params.shDegree = static_cast<uint32_t>(number);
+            } else if (arg == "--distribution") {
+                valid = spz2glb::parseSplatDistribution(value, params.distribution);
+            } else if (arg == "--version") {
+                valid = parseUnsigned(value, 3, number) && number >= 2;
+                params.version = static_cast<uint32_t>(number);
+            } else if (arg == "--level") {
+                valid = parseUnsigned(value, 9, number);
+                params.gzipLevel = static_cast<int>(number);
+            } else if (arg == "--seed") {
+                valid = parseUnsigned(value, UINT64_MAX, params.seed);
+            } else if (arg == "--threads") {
+                valid = parseUnsigned(value, 1024, threads);
+            } else {
+                std::cerr << "[ERROR] Unknown option: " << arg << std::endl;
+                return 1;
+            }
+            if (!valid) {
+                std::cerr << "[ERROR] Invalid value for " << arg << ": " << value << std::endl;
+                return 1;
+            }
+        } else if (outputPath.empty()) {
+            outputPath = arg;
+        } else {
+            std::cerr << "[ERROR] Unexpected argument: " << arg << std::endl;
+            return 1;
+        }
+    }
+    if (outputPath.empty()) {
+        std::cerr << "[ERROR] Missing output file\n";
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    FILE* out = nullptr;
+    if (outputPath == "-") {
+        // stdout 承载 SPZ 时，进度信息改写到 stderr
+        std::cout.rdbuf(std::cerr.rdbuf());
+#ifdef _WIN32
+        _setmode(_fileno(stdout), _O_BINARY);
+#endif
+        out = stdout;
+    } else {
+        out = std::fopen(outputPath.c_str(), "wb");
+    }
+    if (out == nullptr) {
+        std::cerr << "[ERROR] Cannot open output file: " << outputPath << std::endl;
+        return 1;
+    }
+
+    uint64_t inflatedSize = spz2glb::syntheticInflatedSize(params);
+    std::cout << "[INFO] Generating " << params.numPoints << " splats (SPZ v" << params.version << ", SH degree "
+              << params.shDegree << ", " << spz2glb::splatDistributionName(params.distribution) << ", seed "
+              << params.seed << ", level " << params.gzipLevel << ", " << (inflatedSize / 1024.0 / 1024.0)
+              << " MB inflated)" << std::endl;
+
+    auto start = std::chrono::steady_clock::now();
+    spz2glb::ThreadPool pool(static_cast<size_t>(threads));
+    uint64_t written = 0;
+    std::string error;
+    bool ok = spz2glb::writeSyntheticSpz(params, &pool, [out, &written](std::span<const uint8_t> bytes) {
+        written += bytes.size();
+        return std::fwrite(bytes.data(), 1, bytes.size(), out) == bytes.size();
+    }, error);
+    bool closed = out == stdout ? std::fflush(out) == 0 : std::fclose(out) == 0;
+    if (!ok || !closed) {
+        std::cerr << "[ERROR] " << (ok ? "Failed to write " + outputPath : error) << std::endl;
+        if (out != stdout) {
+            std::remove(outputPath.c_str());
+        }
+        return 1;
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "[SUCCESS] SPZ written: " << (outputPath == "-" ? "<stdout>" : outputPath) << std::endl;
+    std::cout << "[INFO] SPZ size: " << (written / 1024.0 / 1024.0) << " MB in " << seconds << " s ("
+              << pool.size() << " threads)" << std::endl;
+    return 0;
+}
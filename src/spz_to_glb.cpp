@@ -4,350 +4,391 @@
 // Repository: https://github.com/spz-ecosystem/spz2glb
 //
 /**
- * SPZ 到 GLB 转换器
- * 
- * 将 SPZ 文件转换为 glTF 2.0 GLB 格式
- * 使用 KHR_gaussian_splatting_compression_spz_2 扩展
+ * SPZ 到 GLB 转换器入口
  *
- * 压缩流模式（根据 SPZ_2 规范）：
- * - SPZ 压缩数据直接存储在 bufferView 中
- * - 不定义 accessors 或 attributes
- * - 渲染需要 SPZ 兼容的解码器
- * 
- * 这是 SPZ_2 规范推荐的模式：
- * - 无损（无重新编码，直接复制 SPZ 流）
- * - 最小文件大小（SPZ 压缩率约 10 倍）
- * - 最快加载速度
+ * 桌面版：命令行程序（单文件转换、批量转换）
+ * WASM 版：Embind 导出函数
+ *
+ * 转换核心见 spz_converter.h
  */
 
 #include <iostream>
 #include <fstream>
+#include <filesystem>
 #include <vector>
 #include <string>
 #include <cstring>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
 #include <memory>
-#include <optional>
-#include <zlib.h>
 
+#include "spz_converter.h"
 #include "memory_pool.h"
 
-#include <fastgltf/core.hpp>
-#include <fastgltf/types.hpp>
-
 #ifdef __EMSCRIPTEN__
 #include <emscripten/bind.h>
 #include "emscripten_utils.h"
 #endif
 
-enum class SpzErrorCode {
-    Success = 0,
-    CannotOpenSpzFile = 1,
-    FailedToReadSpzFile = 2,
-    FailedToInitZlib = 3,
-    FailedToDecompress = 4,
-    ConversionFailed = 5,
-    CannotOpenOutputFile = 6
-};
+#ifdef __EMSCRIPTEN__
 
-struct SpzResult {
-    bool success;
-    std::string errorMessage;
-    std::vector<uint8_t> data;
+/**
+ * WASM 导出函数：SPZ 转 GLB
+ *
+ * @param spzBuffer JavaScript Uint8Array (SPZ 文件数据)
+ * @return JavaScript Uint8Array (GLB 文件数据)，失败返回 null
+ *
+ * JavaScript 使用示例：
+ * const Module = await createSpz2GlbModule();
+ * const spzData = new Uint8Array([...]);
+ * const glbData = Module.convertSpzToGlb(spzData);
+ */
+emscripten::val convertSpzToGlb(const emscripten::val& spzBuffer) {
+    // JavaScript Uint8Array 转 C++ vector（Embind 标准做法）
+    std::vector<uint8_t> spzData = spz2glb::vectorFromJsArray(spzBuffer);
 
-    static SpzResult ok(std::vector<uint8_t> data) {
-        return {true, "", std::move(data)};
-    }
-    static SpzResult error(SpzErrorCode code, const std::string& msg) {
-        (void)code;
-        return {false, msg, {}};
+    // 调用核心转换函数
+    std::vector<uint8_t> glbData;
+    if (!convertSpzToGlbCore(spzData, glbData)) {
+        return emscripten::val::null();
     }
-};
+
+    // 返回 JavaScript Uint8Array
+    return spz2glb::jsUint8ArrayFromVector(glbData);
+}
 
 /**
- * SPZ 文件格式头结构（16 字节）
- * 
- * SPZ 文件使用大端序存储，包含高斯泼溅的元数据
- * Magic: "NGSP" (0x5053474e) - 标识 SPZ 文件
+ * WASM 导出函数：一个阶段的内存统计
+ *
+ * @param stage 1 = read, 2 = inflate, 3 = build, 4 = write, 5 = verify；其他值返回全 0
  */
-struct SpzHeader {
-    uint32_t magic;        // 魔术数字：0x5053474e ("NGSP")，用于标识 SPZ 文件
-    uint32_t version;      // SPZ 规范版本：2 或 3
-    uint32_t numPoints;    // 高斯泼溅点数量，决定渲染质量
-    uint8_t shDegree;      // 球谐函数阶数：0-3（0=无 SH，3=最高质量）
-    uint8_t fractionalBits; // 定点数精度位数
-    uint8_t flags;         // 标志位
-    uint8_t reserved;      // 保留字节（对齐用）
-};
+spz2glb::StageMemoryStats getStageMemoryStats(uint32_t stage) {
+    if (stage == 0 || stage >= spz2glb::kMemoryStageCount) {
+        return {0, 0, 0};
+    }
+    return spz2glb::getStageMemoryStats(static_cast<spz2glb::MemoryStage>(stage));
+}
+
+EMSCRIPTEN_BINDINGS(spz2glb_module) {
+    emscripten::value_object<spz2glb::MemoryStats>("MemoryStats")
+        .field("peakUsage", &spz2glb::MemoryStats::peak_usage)
+        .field("currentUsage", &spz2glb::MemoryStats::current_usage)
+        .field("totalAllocations", &spz2glb::MemoryStats::total_allocations)
+        .field("totalFrees", &spz2glb::MemoryStats::total_frees)
+        .field("failedAllocations", &spz2glb::MemoryStats::failed_allocations);
+    emscripten::value_object<spz2glb::StageMemoryStats>("StageMemoryStats")
+        .field("peakUsage", &spz2glb::StageMemoryStats::peak_usage)
+        .field("allocations", &spz2glb::StageMemoryStats::allocations)
+        .field("allocatedBytes", &spz2glb::StageMemoryStats::allocated_bytes);
+
+    emscripten::function("convertSpzToGlb", &convertSpzToGlb);
+    emscripten::function("getMemoryStats", &spz2glb::getMemoryStats);
+    emscripten::function("getStageMemoryStats", &getStageMemoryStats);
+    emscripten::function("resetMemoryStats", &spz2glb::resetMemoryStats);
+}
+
+#else  // __EMSCRIPTEN__
+
+#include "async_convert.h"
+#include "batch_convert.h"
+#include "conversion_cache.h"
+#include "conversion_server.h"
+#include "deflate_codec.h"
+#include "glb_extract.h"
+#include "scene_assembly.h"
+#include "splat_lod.h"
+#include "spz_verifier.h"
+#include "stream_convert.h"
+#include "thread_pool.h"
+#include "trace.h"
+
+#include <csignal>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+void printUsage(const char* progName) {
+    std::cout << "SPZ to GLB Converter\n";
+    std::cout << "Usage: " << progName << " <input.spz> <output.glb> [options]\n";
+#ifndef _WIN32
+    std::cout << "       " << progName << " - - [--input-size <bytes>]   (SPZ from stdin, GLB to stdout)\n";
+#endif
+    std::cout << "       " << progName << " --batch <dir|glob|manifest> [--output-dir <dir>] [--jobs <n>]\n";
+    std::cout << "       " << progName << " --scene <output.glb> <input.spz> [--translate x,y,z] [--rotate x,y,z,w]"
+                 " [--scale s] [<input.spz> ...]\n";
+    std::cout << "       " << progName << " extract <input.glb> [<output.spz>]\n";
+    std::cout << "       " << progName << " extract --batch <dir|glob|manifest> [--output-dir <dir>] [--jobs <n>]\n";
+#ifndef _WIN32
+    std::cout << "       " << progName << " --serve <socket> [--jobs <n>] [--idle-timeout <s>]\n";
+#endif
+    std::cout << "\n";
+    std::cout << "Options:\n";
+    std::cout << "  --verify            Run three-layer verification after conversion\n";
+    std::cout << "  --trace <file>      Write per-stage timings as Chrome trace / Perfetto JSON\n";
+    std::cout << "  --memory-stats      Print heap peak, allocation counts and per-stage peaks to stderr on exit\n";
+    std::cout << "  --progress          Print per-stage progress to stderr; Ctrl-C cancels and removes the partial output\n";
+    std::cout << "  --mode <mode>       Output: compressed (SPZ stream, default), attributes (decoded accessors)\n";
+    std::cout << "  --layout <layout>   Attribute layout: planar (default), interleaved\n";
+    std::cout << "  --gzip-index <MB>   Write a random-access index <output>.zidx, one access point per <MB> of SPZ data\n";
+    std::cout << "  --repack <MB>       Re-compress the SPZ payload as independently inflatable <MB> blocks\n";
+    std::cout << "  --recompress        Re-compress the SPZ payload for the smallest size (slow, same decoded bytes)\n";
+    std::cout << "  --reorder <curve>   Sort splats along a space-filling curve: morton, hilbert (default: none)\n";
+    std::cout << "  --tile <points>     Split splats with an octree into tiles of at most <points>, one node per tile\n";
+    std::cout << "  --tileset           With --tile, also write a tile manifest <output>.tileset.json\n";
+    std::cout << "  --lod <levels>      Add up to <levels> (1-8) merged coarser levels, each about 1/4 the points\n";
+    std::cout << "  --max-sh-degree <N> Drop spherical-harmonics bands above degree N (0-3) and re-encode\n";
+    std::cout << "  --codec <name>      Inflate/deflate implementation:";
+    for (const auto* codec : spz2glb::availableCodecs()) {
+        std::cout << (codec == spz2glb::availableCodecs().front() ? " " : ", ") << codec->name();
+    }
+    std::cout << " (default: " << spz2glb::availableCodecs().front()->name() << ")\n";
+    std::cout << "  --batch <source>    Convert a directory, a quoted glob or a manifest file\n";
+    std::cout << "  --output-dir <dir>  Batch output directory (default: next to each input)\n";
+    std::cout << "  --scene <output>    Assemble all inputs into one GLB, one node per input\n";
+    std::cout << "  --translate x,y,z   Scene: translation of the preceding input's node\n";
+    std::cout << "  --rotate x,y,z,w    Scene: rotation quaternion of the preceding input's node\n";
+    std::cout << "  --scale <s|x,y,z>   Scene: uniform or per-axis scale of the preceding input's node\n";
+    std::cout << "  --jobs <n>          Worker threads for batch, attribute decoding and re-compression (default: all CPUs)\n";
+    std::cout << "  --io <mode>         Batch I/O: splice (default), uring, posix\n";
+    std::cout << "  --cache <dir>       Reuse GLBs from a content-addressed cache directory\n";
+    std::cout << "  --cache-size <MB>   Cache size limit, least recently used entries are evicted (default: 1024)\n";
+#ifndef _WIN32
+    std::cout << "  --input-size <n>    With stdin input (-): its length in bytes, streamed without a temporary file\n";
+#endif
+#ifndef _WIN32
+    std::cout << "  --serve <socket>    Run as a daemon on a Unix domain socket\n";
+    std::cout << "  --idle-timeout <s>  Serve: close connections idle this long, 0 keeps them open (default: 300)\n";
+#endif
+    std::cout << "  --help              Show this help message\n";
+}
 
 /**
- * 解析 SPZ 文件头
- * 
- * @param data SPZ 文件的二进制数据（已解压）
- * @param header 输出参数，存储解析后的头信息
- * @return true 如果头解析成功，false 如果格式错误
- * 
- * 验证步骤：
- * 1. 检查数据大小是否足够（至少 16 字节）
- * 2. 复制二进制数据到结构体
- * 3. 验证魔术数字是否为 "NGSP"
+ * 解析逗号分隔的 count 个浮点数（--translate / --rotate / --scale）
  */
-bool parseSpzHeader(const std::vector<uint8_t>& data, SpzHeader& header) {
-    // 数据必须至少包含完整的头结构（16 字节）
-    if (data.size() < sizeof(SpzHeader)) {
-        return false;
+bool parseFloats(const char* text, float* values, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        char* end = nullptr;
+        values[i] = std::strtof(text, &end);
+        if (end == text || *end != (i + 1 < count ? ',' : '\0')) {
+            return false;
+        }
+        text = end + 1;
     }
+    return true;
+}
 
-    // 从二进制数据复制头结构
-    memcpy(&header, data.data(), sizeof(SpzHeader));
+// --jobs 的上限：线程数远超 CPU 数时只增加调度开销
+constexpr uint64_t kMaxJobs = 1024;
 
-    // 验证魔术数字：必须是 0x5053474e ("NGSP")
-    if (header.magic != 0x5053474e) {
-        std::cerr << "[ERROR] Invalid SPZ magic number: 0x" << std::hex << header.magic << std::dec << std::endl;
+/**
+ * 解析不大于 max 的十进制无符号整数；空串、符号、尾随字符与溢出都视为无效
+ */
+bool parseUnsigned(const char* text, uint64_t max, uint64_t& value) {
+    if (*text < '0' || *text > '9') {
         return false;
     }
-
+    char* end = nullptr;
+    errno = 0;
+    unsigned long long parsed = std::strtoull(text, &end, 10);
+    if (*end != '\0' || errno == ERANGE || parsed > max) {
+        return false;
+    }
+    value = parsed;
     return true;
 }
 
 /**
- * 计算 glTF accessor 数量（基于球谐函数阶数）
- * 
- * @param shDegree 球谐函数阶数（0-3）
- * @return 需要的 accessor 总数
- * 
- * glTF 高斯泼溅需要以下属性：
- * - 基础属性（4 个）：POSITION, COLOR_0, SCALE, ROTATION
- * - 球谐系数（可选）：根据 SH 阶数增加
- *   - SH 阶数 1: +3 个系数
- *   - SH 阶数 2: +5 个系数
- *   - SH 阶数 3: +7 个系数
- * 
- * 注意：在压缩流模式（compression stream mode）下，
- * 这些 accessor 都不需要，因为数据存储在 SPZ 压缩流中
+ * 解析以 MB 为单位的正数大小（可带小数），拒绝尾随字符
  */
-int getAccessorCount(int shDegree) {
-    // 基础属性：位置、颜色、缩放、旋转
-    int baseAccessors = 4; // POSITION, COLOR_0, SCALE, ROTATION
-    int shAccessors = 0;
-
-    // 根据 SH 阶数添加球谐系数
-    // 球谐函数用于编码光照方向信息，阶数越高，光照质量越好
-    if (shDegree >= 1) shAccessors += 3;  // 一阶 SH：3 个系数
-    if (shDegree >= 2) shAccessors += 5;  // 二阶 SH：5 个系数
-    if (shDegree >= 3) shAccessors += 7;  // 三阶 SH：7 个系数
-
-    return baseAccessors + shAccessors;
+bool parseMegabytes(const char* text, double& megabytes) {
+    char* end = nullptr;
+    megabytes = std::strtod(text, &end);
+    return end != text && *end == '\0' && std::isfinite(megabytes) && megabytes > 0;
 }
 
 /**
- * 加载 SPZ 文件（二进制读取）
- * 
- * @param spzPath SPZ 文件路径
- * @return 包含完整 SPZ 二进制数据的 vector
- * 
- * 关键点：
- * - 以二进制模式读取，保持原始字节不变
- * - 使用 ios::ate 先定位到文件末尾获取大小
- * - 返回的是 gzip 压缩的原始数据，不解压
- * 
- * 为什么保持压缩状态？
- * - SPZ 压缩率约 10 倍，解压后会变大
- * - GLB 存储压缩数据，加载时由 SPZ 解码器解压
- * - 符合 SPZ_2 规范的压缩流模式
+ * extract 子命令：从 GLB 取回嵌入的 SPZ 流（单个文件或 --batch）
  */
-SpzResult loadSpzFile(const std::string& spzPath) {
-    // 以二进制模式打开文件，ios::ate 将读取位置定位到文件末尾
-    std::ifstream file(spzPath, std::ios::binary | std::ios::ate);
-    if (!file) {
-        return SpzResult::error(SpzErrorCode::CannotOpenSpzFile,
-            "Cannot open SPZ file: " + spzPath);
+int runExtract(int argc, char** argv, const char* progName) {
+    std::string inputPath;
+    std::string outputPath;
+    spz2glb::BatchOptions batchOptions;
+    batchOptions.extract = true;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--batch" && hasValue) {
+            batchOptions.source = argv[++i];
+        } else if (arg == "--output-dir" && hasValue) {
+            batchOptions.outputDir = argv[++i];
+        } else if (arg == "--jobs" && hasValue) {
+            uint64_t jobs = 0;
+            if (!parseUnsigned(argv[++i], kMaxJobs, jobs)) {
+                std::cerr << "[ERROR] --jobs must be between 0 (all CPUs) and " << kMaxJobs << std::endl;
+                return 1;
+            }
+            batchOptions.jobs = static_cast<size_t>(jobs);
+        } else if (arg == "--help" || arg == "-h") {
+            printUsage(progName);
+            return 0;
+        } else if (arg[0] != '-' && inputPath.empty()) {
+            inputPath = arg;
+        } else if (arg[0] != '-' && outputPath.empty()) {
+            outputPath = arg;
+        } else {
+            std::cerr << "[ERROR] Unknown extract option: " << arg << std::endl;
+            printUsage(progName);
+            return 1;
+        }
     }
 
-    // 获取文件大小（tellg 返回当前位置，即文件末尾）
-    auto size = file.tellg();
-    // 重置读取位置到文件开头
-    file.seekg(0, std::ios::beg);
-
-    // 分配缓冲区并调整大小
-    std::vector<uint8_t> rawBuffer;
-    rawBuffer.resize(static_cast<size_t>(size));
+    if (!batchOptions.source.empty()) {
+        std::vector<spz2glb::BatchJob> jobs;
+        std::string error;
+        if (!spz2glb::collectBatchJobs(batchOptions, jobs, error)) {
+            std::cerr << "[ERROR] " << error << std::endl;
+            return 1;
+        }
+        auto summary = spz2glb::runBatch(std::move(jobs), batchOptions);
+        return summary.failed == 0 ? 0 : 1;
+    }
 
-    // 一次性读取整个文件到缓冲区
-    if (!file.read(reinterpret_cast<char*>(rawBuffer.data()), static_cast<std::streamsize>(size))) {
-        return SpzResult::error(SpzErrorCode::FailedToReadSpzFile,
-            "Failed to read SPZ file");
+    if (inputPath.empty()) {
+        std::cerr << "[ERROR] Missing input GLB file\n";
+        printUsage(progName);
+        return 1;
+    }
+    if (outputPath.empty()) {
+        outputPath = std::filesystem::path(inputPath).replace_extension(".spz").string();
     }
+    std::vector<spz2glb::ExtractedSpz> outputs;
+    auto result = spz2glb::extractSpzFile(inputPath, outputPath, outputs);
+    if (!result.success) {
+        std::cerr << "[ERROR] " << result.errorMessage << std::endl;
+        return 1;
+    }
+    for (const auto& output : outputs) {
+        std::cout << "[SUCCESS] SPZ extracted: " << output.path << " (" << (output.bytes / 1024.0 / 1024.0)
+                  << " MB)" << std::endl;
+    }
+    return 0;
+}
 
-    // 返回原始 SPZ 数据（保持 gzip 压缩状态）
-    // 重要：不要解压！GLB 必须存储原始压缩数据
-    // SPZ 解码器在加载时会自动解压
-    return SpzResult::ok(std::move(rawBuffer));
+/**
+ * 打印三层校验结果，全部通过返回 0，否则返回 2
+ */
+int reportVerification(const spz::VerifyResult& result) {
+    std::cout << result.layer1_detail << "\n";
+    std::cout << result.layer2_detail << "\n";
+    std::cout << result.layer3_detail << "\n";
+
+    std::cout << "============================================================\n";
+    std::cout << "Summary:\n";
+    std::cout << "  Layer 1 (GLB Structure): " << (result.layer1_passed ? "PASSED" : "FAILED") << "\n";
+    std::cout << "  Layer 2 (Binary Lossless): " << (result.layer2_passed ? "PASSED" : "FAILED") << "\n";
+    std::cout << "  Layer 3 (Decoding): " << (result.layer3_passed ? "PASSED" : "FAILED") << "\n";
+    std::cout << "============================================================\n";
+
+    if (result.all_passed()) {
+        std::cout << "\n[SUCCESS] All verifications PASSED!\n";
+        return 0;
+    }
+    std::cout << "\n[WARNING] Some verifications FAILED!\n";
+    return 2;
 }
 
 /**
- * 解压 SPZ gzip 数据（仅用于头解析）
- * 
- * @param compressedData gzip 压缩的 SPZ 数据
- * @return 解压后的 SPZ 内部格式数据
- * 
- * 用途：
- * - 仅用于解析 SPZ 头部元数据
- * - 不用于存储（存储时保持压缩状态）
- * 
- * gzip 格式识别：
- * - 前两个字节：0x1f 0x8b
- * - 如果不是 gzip，直接返回原始数据
- * 
- * 解压流程：
- * 1. 检测 gzip 魔数（0x1f8b）
- * 2. 初始化 zlib 解压流（16 + MAX_WBITS 表示 gzip 格式）
- * 3. 动态扩展输出缓冲区（按需 2 倍增长）
- * 4. 循环解压直到 Z_STREAM_END
- * 5. 调整最终大小并返回
+ * --trace：从参数解析完成起记录，main 返回时（任何退出路径）写出 JSON
  */
-SpzResult decompressSpzData(std::vector<uint8_t> compressedData) {
-    // 检查 gzip 魔数：前两个字节必须是 0x1f 0x8b
-    if (compressedData.size() < 2 || compressedData[0] != 0x1f || compressedData[1] != 0x8b) {
-        // 不是 gzip 压缩，直接返回原始数据（使用移动语义）
-        return SpzResult::ok(std::move(compressedData));
-    }
-
-    // 预分配解压缓冲区（假设压缩率约 10 倍）
-    std::vector<uint8_t> decompressed;
-    decompressed.resize(compressedData.size() * 10);
-
-    // 初始化 zlib 流结构
-    z_stream strm = {};
-    strm.next_in = const_cast<uint8_t*>(compressedData.data());        // 输入数据指针
-    strm.avail_in = static_cast<uInt>(compressedData.size());          // 输入数据大小
-    strm.next_out = decompressed.data();                                // 输出缓冲区指针
-    strm.avail_out = static_cast<uInt>(decompressed.size());            // 输出缓冲区大小
-
-    // 初始化解压：16 + MAX_WBITS 表示使用 gzip 格式（而不是 zlib）
-    if (inflateInit2(&strm, 16 + MAX_WBITS) != Z_OK) {
-        return SpzResult::error(SpzErrorCode::FailedToInitZlib,
-            "Failed to initialize zlib decompression");
-    }
-
-    // 循环解压直到完成
-    int ret;
-    do {
-        // 如果输出缓冲区满了，扩展 2 倍
-        if (strm.avail_out == 0) {
-            size_t oldSize = decompressed.size();
-            decompressed.resize(oldSize * 2);
-            // 设置新的输出位置到扩展后的位置
-            strm.next_out = decompressed.data() + oldSize;
-            strm.avail_out = static_cast<uInt>(oldSize);
+class TraceSession {
+public:
+    explicit TraceSession(std::string path) : path_(std::move(path)) {
+#if SPZ2GLB_ENABLE_TRACE
+        if (!path_.empty()) spz2glb::trace::start();
+#endif
+    }
+    ~TraceSession() {
+#if SPZ2GLB_ENABLE_TRACE
+        if (path_.empty()) return;
+        std::string error;
+        if (spz2glb::trace::writeChromeTrace(path_, error)) {
+            std::cerr << "[INFO] Trace written: " << path_ << std::endl;
+        } else {
+            std::cerr << "[ERROR] " << error << std::endl;
         }
-        // 解压一块数据
-        ret = inflate(&strm, Z_NO_FLUSH);
-    } while (ret == Z_OK);  // Z_OK 表示还有更多数据
+#endif
+    }
 
-    // 检查解压结果：必须是 Z_STREAM_END
-    if (ret != Z_STREAM_END) {
-        inflateEnd(&strm);
-        return SpzResult::error(SpzErrorCode::FailedToDecompress,
-            "Failed to decompress SPZ file");
+private:
+    std::string path_;
+};
+
+/**
+ * --memory-stats：程序结束时把堆用量与各阶段峰值打印到 stderr（RAII，任何退出路径都会打印）
+ */
+class MemoryStatsReport {
+public:
+    explicit MemoryStatsReport(bool enabled) : enabled_(enabled) {}
+    ~MemoryStatsReport() {
+        if (!enabled_) return;
+        auto megabytes = [](size_t bytes) { return bytes / 1024.0 / 1024.0; };
+        spz2glb::MemoryStats stats = spz2glb::getMemoryStats();
+        std::cerr << "[MEMORY] peak " << megabytes(stats.peak_usage) << " MB, current "
+                  << megabytes(stats.current_usage) << " MB, " << stats.total_allocations << " allocations, "
+                  << stats.total_frees << " frees, " << stats.failed_allocations << " failed" << std::endl;
+        for (size_t i = 1; i < spz2glb::kMemoryStageCount; ++i) {
+            auto stage = static_cast<spz2glb::MemoryStage>(i);
+            spz2glb::StageMemoryStats stageStats = spz2glb::getStageMemoryStats(stage);
+            if (stageStats.allocations == 0 && stageStats.peak_usage == 0) continue;
+            std::cerr << "[MEMORY] " << spz2glb::memoryStageName(stage) << ": peak "
+                      << megabytes(stageStats.peak_usage) << " MB, " << stageStats.allocations << " allocations ("
+                      << megabytes(stageStats.allocated_bytes) << " MB)" << std::endl;
+        }
     }
 
-    // 调整到实际解压的大小
-    decompressed.resize(strm.total_out);
-    // 释放 zlib 资源
-    inflateEnd(&strm);
+private:
+    bool enabled_;
+};
 
-    return SpzResult::ok(std::move(decompressed));
-}
+volatile std::sig_atomic_t g_interrupted = 0;
 
 /**
- * 创建 glTF 资产（包含 SPZ 压缩扩展）
- * 
- * @param spzData SPZ 压缩数据（保持 gzip 压缩状态）
- * @param header SPZ 头部信息（预留未来使用）
- * @return 完整的 glTF 资产对象
- * 
- * glTF 结构：
- * - Asset: 根对象，包含元数据
- * - Buffers: 二进制数据（SPZ 压缩流）
- * - BufferViews: Buffer 的视图（指向整个 SPZ 数据）
- * - Mesh/Primitive: 点云几何体（使用 SPZ 扩展）
- * - Node: 场景节点
- * - Scene: 默认场景
- * 
- * 关键扩展：
- * - KHR_gaussian_splatting: 高斯泼溅支持
- * - KHR_gaussian_splatting_compression_spz_2: SPZ 压缩格式
- * 
- * 压缩流模式特点：
- * - 没有 accessors（数据在压缩流中）
- * - 没有 attributes（数据在压缩流中）
- * - 渲染器需要 SPZ 解码器
+ * --progress：经异步接口转换，每个阶段的百分比变化时打印到 stderr，SIGINT 取消转换
  */
-fastgltf::Asset createGltfAsset(std::vector<uint8_t> spzData, const SpzHeader& header) {
-    (void)header;
-
-    fastgltf::Asset asset;
-
-    asset.extensionsUsed.emplace_back("KHR_gaussian_splatting");
-    asset.extensionsUsed.emplace_back("KHR_gaussian_splatting_compression_spz_2");
-    asset.extensionsRequired.emplace_back("KHR_gaussian_splatting");
-    asset.extensionsRequired.emplace_back("KHR_gaussian_splatting_compression_spz_2");
-
-    asset.assetInfo.emplace();
-    asset.assetInfo->gltfVersion = "2.0";
-    asset.assetInfo->copyright = "";
-    asset.assetInfo->generator = "spz_to_glb_fastgltf";
-
-    size_t spzSize = spzData.size();
-
-    // 创建 Buffer（存储 SPZ 压缩数据）
-    // 使用 Vector 而不是 Array，因为 Vector 有 std::vector<std::byte>
-    fastgltf::Buffer buffer;
-    fastgltf::sources::Vector vectorData;
-    vectorData.bytes.reserve(spzSize);
-    for (size_t i = 0; i < spzSize; i++) {
-        vectorData.bytes.push_back(static_cast<std::byte>(spzData[i]));
-    }
-    vectorData.mimeType = fastgltf::MimeType::None;
-    buffer.data = std::move(vectorData);
-    buffer.byteLength = spzSize;
-    asset.buffers.emplace_back(std::move(buffer));
-
-    fastgltf::BufferView spzBufferView;
-    spzBufferView.bufferIndex = 0;
-    spzBufferView.byteOffset = 0;
-    spzBufferView.byteLength = spzSize;
-    asset.bufferViews.emplace_back(std::move(spzBufferView));
-
-    // 创建 Primitive（使用 SPZ 压缩扩展）
-    fastgltf::Primitive primitive;
-    primitive.type = fastgltf::PrimitiveType::Points;  // 点云类型
-
-    // 配置 SPZ 压缩扩展
-    // 这是压缩流模式的核心：通过扩展引用 bufferView 中的压缩数据
-    auto gaussianSplat = std::make_unique<fastgltf::GaussianSplatExtension>();
-    auto spzCompression = std::make_unique<fastgltf::GaussianSplatSpzCompression>();
-    spzCompression->bufferView = 0;  // 引用第 0 个 bufferView
-    gaussianSplat->spzCompression = std::move(spzCompression);
-    primitive.gaussianSplat = std::move(gaussianSplat);
-
-    // 创建 Mesh 并添加 Primitive
-    fastgltf::Mesh mesh;
-    mesh.primitives.emplace_back(std::move(primitive));
-    asset.meshes.emplace_back(std::move(mesh));
-
-    // 创建 Node（场景中的对象）
-    fastgltf::Node node;
-    node.meshIndex = 0;  // 引用第 0 个 Mesh
-    asset.nodes.emplace_back(std::move(node));
-
-    // 创建 Scene（场景根节点）
-    fastgltf::Scene scene;
-    scene.nodeIndices.emplace_back(0);  // 包含第 0 个 Node
-    asset.scenes.emplace_back(std::move(scene));
-    asset.defaultScene = 0;  // 默认显示第 0 个场景
-
-    return asset;
+SpzResult convertWithProgress(const std::string& inputPath,
+                              const std::string& outputPath,
+                              const spz2glb::ConvertOptions& convertOptions,
+                              spz2glb::GlbLayout& layout) {
+    spz2glb::AsyncConvertOptions options;
+    options.convert = convertOptions;
+    int lastStage = -1;
+    int lastPercent = -1;
+    options.progress = [&](const spz2glb::ConversionProgress& progress) {
+        int percent = progress.bytesTotal > 0 ? static_cast<int>(progress.bytesDone * 100 / progress.bytesTotal)
+                                              : (progress.bytesDone > 0 ? 100 : 0);
+        if (static_cast<int>(progress.stage) == lastStage && percent == lastPercent) {
+            return;
+        }
+        lastStage = static_cast<int>(progress.stage);
+        lastPercent = percent;
+        std::cerr << "[PROGRESS] " << spz2glb::stageName(progress.stage) << " " << percent << "% ("
+                  << progress.bytesDone << " / " << progress.bytesTotal << " bytes)" << std::endl;
+    };
+
+    auto handler = std::signal(SIGINT, [](int) { g_interrupted = 1; });
+    auto handle = spz2glb::convertSpzFileAsync(inputPath, outputPath, std::move(options));
+    while (!handle.waitFor(std::chrono::milliseconds(50))) {
+        if (g_interrupted && !handle.cancelRequested()) {
+            handle.cancel();
+        }
+    }
+    std::signal(SIGINT, handler);
+    layout = handle.layout();
+    return handle.get();
 }
 
 /**
@@ -368,120 +409,204 @@ fastgltf::Asset createGltfAsset(std::vector<uint8_t> spzData, const SpzHeader& h
  * - SPZ 文件大小（压缩后）
  * - GLB 文件大小
  */
-
-/**
- * 核心转换函数（桌面版和 WASM 共用）
- *
- * @param spzData SPZ 压缩数据
- * @param glbData 输出 GLB 数据
- * @return true 如果转换成功
- *
- * 转换流程：
- * 1. 解压副本用于解析头部
- * 2. 解析 SPZ 头部
- * 3. 创建 glTF 资产
- * 4. 导出 GLB
- */
-bool convertSpzToGlbCore(std::vector<uint8_t> spzData, std::vector<uint8_t>& glbData) {
-    // 步骤 1: 解压（传引用，因为后面还需要 spzData）
-    auto decompressResult = decompressSpzData(spzData);  // 不 move，保留 spzData
-    if (!decompressResult.success) {
-        std::cerr << "[ERROR] " << decompressResult.errorMessage << std::endl;
-        return false;
-    }
-    std::vector<uint8_t> decompressedData = std::move(decompressResult.data);
-
-    // 步骤 2: 解析 SPZ 头部（使用解压后数据）
-    SpzHeader header;
-    if (!parseSpzHeader(decompressedData, header)) {
-        std::cerr << "[ERROR] Failed to parse SPZ header" << std::endl;
-        return false;
-    }
-
-    // 步骤 3: 打印 SPZ 元数据
-    std::cout << "[INFO] SPZ version: " << (int)header.version << std::endl;
-    std::cout << "[INFO] Num points: " << header.numPoints << std::endl;
-    std::cout << "[INFO] SH degree: " << (int)header.shDegree << std::endl;
-
-    // 步骤 4: 创建 glTF 资产（存储原始压缩数据）
-    std::cout << "[INFO] Creating glTF Asset with KHR extensions" << std::endl;
-    auto asset = createGltfAsset(spzData, header);
-
-    // 步骤 5: 导出 GLB
-    std::cout << "[INFO] Exporting GLB..." << std::endl;
-    fastgltf::Exporter exporter;
-
-    auto result = exporter.writeGltfBinary(asset);
-    if (result.error() != fastgltf::Error::None) {
-        std::cerr << "[ERROR] GLB export failed: " << std::string(fastgltf::getErrorMessage(result.error())) << std::endl;
-        return false;
-    }
-
-    // 步骤 6: 获取 GLB 数据（移动语义，避免拷贝）
-    std::vector<std::byte> output = std::move(result.get().output);
-    glbData.resize(output.size());
-    std::memcpy(glbData.data(), output.data(), output.size());
-
-    return true;
-}
-
-#ifdef __EMSCRIPTEN__
-
-/**
- * WASM 导出函数：SPZ 转 GLB
- *
- * @param spzBuffer JavaScript Uint8Array (SPZ 文件数据)
- * @return JavaScript Uint8Array (GLB 文件数据)，失败返回 null
- *
- * JavaScript 使用示例：
- * const Module = await createSpz2GlbModule();
- * const spzData = new Uint8Array([...]);
- * const glbData = Module.convertSpzToGlb(spzData);
- */
-emscripten::val convertSpzToGlb(const emscripten::val& spzBuffer) {
-    // JavaScript Uint8Array 转 C++ vector（Embind 标准做法）
-    std::vector<uint8_t> spzData = spz2glb::vectorFromJsArray(spzBuffer);
-
-    // 调用核心转换函数
-    std::vector<uint8_t> glbData;
-    if (!convertSpzToGlbCore(spzData, glbData)) {
-        return emscripten::val::null();
-    }
-
-    // 返回 JavaScript Uint8Array
-    return spz2glb::jsUint8ArrayFromVector(glbData);
-}
-
-EMSCRIPTEN_BINDINGS(spz2glb_module) {
-    emscripten::function("convertSpzToGlb", &convertSpzToGlb);
-    emscripten::function("getMemoryStats", &spz2glb::getMemoryStats);
-}
-
-#else  // __EMSCRIPTEN__
-
-#include "spz_verifier.h"
-
-void printUsage(const char* progName) {
-    std::cout << "SPZ to GLB Converter\n";
-    std::cout << "Usage: " << progName << " <input.spz> <output.glb> [options]\n\n";
-    std::cout << "Options:\n";
-    std::cout << "  --verify    Run three-layer verification after conversion\n";
-    std::cout << "  --help      Show this help message\n";
-}
-
 int main(int argc, char** argv) {
     bool doVerify = false;
+    bool showProgress = false;
+    bool memoryStats = false;
+    std::string tracePath;
     std::string inputPath;
     std::string outputPath;
+    spz2glb::BatchOptions batchOptions;
+    spz2glb::ConvertOptions convertOptions;
+    std::string servePath;
+    unsigned idleTimeoutSeconds = 300;
+    std::string cacheDir;
+    uint64_t cacheMegabytes = 1024;
+    std::string scenePath;
+    std::vector<spz2glb::SceneInput> sceneInputs;  // 所有位置参数，--scene 时即各输入
+    bool sceneTransforms = false;
+    uint64_t streamInputSize = 0;  // --input-size，0 表示 stdin 长度未知
+
+    if (argc > 1 && std::string(argv[1]) == "extract") {
+        return runExtract(argc - 1, argv + 1, argv[0]);
+    }
     
     for (int i = 1; i < argc; i++) {
         std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
         if (arg == "--verify") {
             doVerify = true;
+        } else if (arg == "--progress") {
+            showProgress = true;
+        } else if (arg == "--memory-stats") {
+            memoryStats = true;
+        } else if (arg == "--trace" && hasValue) {
+            tracePath = argv[++i];
+        } else if (arg == "--mode" && hasValue) {
+            std::string mode = argv[++i];
+            if (mode == "compressed") {
+                convertOptions.mode = spz2glb::OutputMode::Compressed;
+            } else if (mode == "attributes") {
+                convertOptions.mode = spz2glb::OutputMode::Attributes;
+            } else {
+                std::cerr << "[ERROR] Unknown output mode: " << mode << std::endl;
+                printUsage(argv[0]);
+                return 1;
+            }
+        } else if (arg == "--layout" && hasValue) {
+            std::string layout = argv[++i];
+            if (layout == "planar") {
+                convertOptions.attributeLayout = spz2glb::AttributeLayout::Planar;
+            } else if (layout == "interleaved") {
+                convertOptions.attributeLayout = spz2glb::AttributeLayout::Interleaved;
+            } else {
+                std::cerr << "[ERROR] Unknown attribute layout: " << layout << std::endl;
+                printUsage(argv[0]);
+                return 1;
+            }
+        } else if (arg == "--gzip-index" && hasValue) {
+            double megabytes = 0;
+            if (!parseMegabytes(argv[++i], megabytes) || megabytes > 1024 * 1024) {
+                std::cerr << "[ERROR] Invalid --gzip-index span: " << argv[i] << std::endl;
+                return 1;
+            }
+            convertOptions.gzipIndexSpan = static_cast<uint64_t>(megabytes * 1024 * 1024);
+            if (convertOptions.gzipIndexSpan < 32 * 1024) {
+                std::cerr << "[ERROR] --gzip-index span must be at least 32 KB" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--repack" && hasValue) {
+            // 块大小向上取整到 64 KB
+            double megabytes = 0;
+            bool valid = parseMegabytes(argv[++i], megabytes) && megabytes <= 1024;
+            uint64_t bytes = valid ? static_cast<uint64_t>(megabytes * 1024 * 1024) : 0;
+            convertOptions.repackBlockBytes = (bytes + 65535) / 65536 * 65536;
+            if (convertOptions.repackBlockBytes == 0 || convertOptions.repackBlockBytes > (1u << 30)) {
+                std::cerr << "[ERROR] --repack block size must be between 64 KB and 1024 MB" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--recompress") {
+            convertOptions.recompress = true;
+        } else if (arg == "--reorder" && hasValue) {
+            if (!spz2glb::parseSpatialCurve(argv[++i], convertOptions.spatialCurve)) {
+                std::cerr << "[ERROR] Unknown curve: " << argv[i] << std::endl;
+                printUsage(argv[0]);
+                return 1;
+            }
+        } else if (arg == "--tile" && hasValue) {
+            uint64_t points = 0;
+            if (!parseUnsigned(argv[++i], 0xffffffffULL, points) || points == 0) {
+                std::cerr << "[ERROR] --tile point count must be between 1 and 4294967295" << std::endl;
+                return 1;
+            }
+            convertOptions.tilePoints = static_cast<uint32_t>(points);
+        } else if (arg == "--tileset") {
+            convertOptions.tileset = true;
+        } else if (arg == "--lod" && hasValue) {
+            uint64_t levels = 0;
+            if (!parseUnsigned(argv[++i], spz2glb::kMaxLodLevels, levels) || levels == 0) {
+                std::cerr << "[ERROR] --lod level count must be between 1 and " << spz2glb::kMaxLodLevels
+                          << std::endl;
+                return 1;
+            }
+            convertOptions.lodLevels = static_cast<uint32_t>(levels);
+        } else if (arg == "--max-sh-degree" && hasValue) {
+            uint64_t degree = 0;
+            if (!parseUnsigned(argv[++i], spz2glb::kMaxShDegree, degree)) {
+                std::cerr << "[ERROR] --max-sh-degree must be between 0 and " << spz2glb::kMaxShDegree << std::endl;
+                return 1;
+            }
+            convertOptions.maxShDegree = static_cast<uint32_t>(degree);
+        } else if (arg == "--codec" && hasValue) {
+            const spz2glb::DeflateCodec* codec = spz2glb::findCodec(argv[++i]);
+            if (codec == nullptr) {
+                std::cerr << "[ERROR] Unknown or disabled codec: " << argv[i] << std::endl;
+                printUsage(argv[0]);
+                return 1;
+            }
+            spz2glb::setActiveCodec(*codec);
+        } else if (arg == "--batch" && hasValue) {
+            batchOptions.source = argv[++i];
+        } else if (arg == "--output-dir" && hasValue) {
+            batchOptions.outputDir = argv[++i];
+        } else if (arg == "--jobs" && hasValue) {
+            uint64_t jobs = 0;
+            if (!parseUnsigned(argv[++i], kMaxJobs, jobs)) {
+                std::cerr << "[ERROR] --jobs must be between 0 (all CPUs) and " << kMaxJobs << std::endl;
+                return 1;
+            }
+            batchOptions.jobs = static_cast<size_t>(jobs);
+        } else if (arg == "--io" && hasValue) {
+            std::string io = argv[++i];
+            if (io == "splice") {
+                batchOptions.io = spz2glb::BatchIo::Splice;
+            } else if (io == "uring") {
+                batchOptions.io = spz2glb::BatchIo::IoUring;
+            } else if (io == "posix") {
+                batchOptions.io = spz2glb::BatchIo::Posix;
+            } else {
+                std::cerr << "[ERROR] Unknown I/O mode: " << io << std::endl;
+                printUsage(argv[0]);
+                return 1;
+            }
+        } else if (arg == "--cache" && hasValue) {
+            cacheDir = argv[++i];
+        } else if (arg == "--cache-size" && hasValue) {
+            // 上限保证换算成字节时不溢出
+            if (!parseUnsigned(argv[++i], std::numeric_limits<uint64_t>::max() >> 20, cacheMegabytes)) {
+                std::cerr << "[ERROR] Invalid --cache-size: " << argv[i] << " (expected megabytes, 0 for unlimited)"
+                          << std::endl;
+                return 1;
+            }
+        } else if (arg == "--input-size" && hasValue) {
+            const uint64_t maxSize = std::numeric_limits<uint64_t>::max();
+            if (!parseUnsigned(argv[++i], maxSize, streamInputSize) || streamInputSize == 0) {
+                std::cerr << "[ERROR] Invalid --input-size: " << argv[i] << " (expected a positive byte count)"
+                          << std::endl;
+                return 1;
+            }
+        } else if (arg == "--serve" && hasValue) {
+            servePath = argv[++i];
+        } else if (arg == "--idle-timeout" && hasValue) {
+            uint64_t seconds = 0;
+            if (!parseUnsigned(argv[++i], std::numeric_limits<unsigned>::max(), seconds)) {
+                std::cerr << "[ERROR] Invalid --idle-timeout: " << argv[i] << " (expected seconds, 0 to disable)"
+                          << std::endl;
+                return 1;
+            }
+            idleTimeoutSeconds = static_cast<unsigned>(seconds);
+        } else if (arg == "--scene" && hasValue) {
+            scenePath = argv[++i];
+        } else if ((arg == "--translate" || arg == "--rotate" || arg == "--scale") && hasValue) {
+            // 作用于前一个输入
+            if (sceneInputs.empty()) {
+                std::cerr << "[ERROR] " << arg << " must follow a scene input" << std::endl;
+                return 1;
+            }
+            spz2glb::SceneInput& input = sceneInputs.back();
+            const char* value = argv[++i];
+            bool parsed;
+            if (arg == "--translate") {
+                parsed = parseFloats(value, input.translation.data(), 3);
+            } else if (arg == "--rotate") {
+                parsed = parseFloats(value, input.rotation.data(), 4);
+            } else {
+                parsed = parseFloats(value, input.scale.data(), 3);
+                if (!parsed && parseFloats(value, input.scale.data(), 1)) {
+                    input.scale = {input.scale[0], input.scale[0], input.scale[0]};
+                    parsed = true;
+                }
+            }
+            if (!parsed) {
+                std::cerr << "[ERROR] Invalid " << arg << " value: " << value << std::endl;
+                return 1;
+            }
+            sceneTransforms = true;
         } else if (arg == "--help" || arg == "-h") {
             printUsage(argv[0]);
             return 0;
-        } else if (arg[0] != '-') {
+        } else if (arg[0] != '-' || arg == "-") {
+            sceneInputs.push_back({arg});
             if (inputPath.empty()) {
                 inputPath = arg;
             } else if (outputPath.empty()) {
@@ -494,63 +619,241 @@ int main(int argc, char** argv) {
         }
     }
     
-    if (inputPath.empty() || outputPath.empty()) {
-        std::cerr << "[ERROR] Missing input or output file\n";
-        printUsage(argv[0]);
+#if !SPZ2GLB_ENABLE_TRACE
+    if (!tracePath.empty()) {
+        std::cerr << "[ERROR] --trace requires a build with -DSPZ2GLB_TRACE=ON" << std::endl;
         return 1;
     }
+#endif
+    TraceSession traceSession(tracePath);
+    MemoryStatsReport memoryReport(memoryStats);
 
-    std::cout << "[INFO] Loading SPZ: " << inputPath << std::endl;
-    auto spzResult = loadSpzFile(inputPath);
-    if (!spzResult.success) {
-        std::cerr << "[ERROR] " << spzResult.errorMessage << std::endl;
+    if (sceneTransforms && scenePath.empty()) {
+        std::cerr << "[ERROR] --translate, --rotate and --scale require --scene" << std::endl;
+        return 1;
+    }
+    if (!scenePath.empty() &&
+        (convertOptions.mode != spz2glb::OutputMode::Compressed || convertOptions.reencodesPayload() ||
+         convertOptions.gzipIndexSpan > 0 || !batchOptions.source.empty() || !servePath.empty() || !cacheDir.empty())) {
+        // 各输入的 SPZ 流原样写入
+        std::cerr << "[ERROR] --scene keeps each input's SPZ stream as is and cannot be combined with --mode, "
+                     "--gzip-index, --repack, --recompress, --reorder, --tile, --lod, --max-sh-degree, --batch, "
+                     "--serve or --cache" << std::endl;
         return 1;
     }
 
-    std::cout << "[INFO] Converting to GLB..." << std::endl;
-    std::vector<uint8_t> glbData;
-    if (!convertSpzToGlbCore(spzResult.data, glbData)) {
-        std::cerr << "[ERROR] Conversion failed" << std::endl;
+    const bool streaming = inputPath == "-" || outputPath == "-";
+    if (streamInputSize > 0 && inputPath != "-") {
+        std::cerr << "[ERROR] --input-size requires stdin input (-)" << std::endl;
+        return 1;
+    }
+    if (streaming &&
+        (convertOptions.mode != spz2glb::OutputMode::Compressed || convertOptions.reencodesPayload() ||
+         convertOptions.gzipIndexSpan > 0 || !cacheDir.empty() || doVerify || !scenePath.empty())) {
+        // 流式转换只在固定窗口内搬运输入的 gzip 流，不能整体解压或回读输出
+        std::cerr << "[ERROR] stdin/stdout streaming passes the SPZ stream through as is and cannot be combined "
+                     "with --mode, --gzip-index, --cache, --verify, --scene or options that re-encode the payload"
+                  << std::endl;
         return 1;
     }
 
-    std::cout << "[INFO] Writing GLB: " << outputPath << std::endl;
-    std::ofstream file(outputPath, std::ios::binary);
-    if (!file) {
-        std::cerr << "[ERROR] Cannot open output file: " << outputPath << std::endl;
+    if (showProgress && (streaming || !batchOptions.source.empty() || !servePath.empty() || !scenePath.empty())) {
+        std::cerr << "[ERROR] --progress applies to single-file conversion only" << std::endl;
         return 1;
     }
 
-    file.write(reinterpret_cast<const char*>(glbData.data()), glbData.size());
+    if (doVerify && convertOptions.mode != spz2glb::OutputMode::Compressed) {
+        // 第 2、3 层校验比对 BIN 中的 SPZ 压缩流（重新压缩时比对解压内容）与输入文件
+        std::cerr << "[ERROR] --verify requires --mode compressed" << std::endl;
+        return 1;
+    }
+
+    if (convertOptions.gzipIndexSpan > 0 && convertOptions.mode != spz2glb::OutputMode::Compressed) {
+        // 索引描述的是 BIN 中的 SPZ gzip 流，属性模式下不存在
+        std::cerr << "[ERROR] --gzip-index requires --mode compressed" << std::endl;
+        return 1;
+    }
+    if (convertOptions.repackBlockBytes > 0 && (convertOptions.mode != spz2glb::OutputMode::Compressed ||
+                                                convertOptions.gzipIndexSpan > 0)) {
+        // 重新打包后的块表已写入 GLB，可直接作为访问点
+        std::cerr << "[ERROR] --repack requires --mode compressed and replaces --gzip-index" << std::endl;
+        return 1;
+    }
+    if (convertOptions.recompress && (convertOptions.mode != spz2glb::OutputMode::Compressed ||
+                                      convertOptions.gzipIndexSpan > 0)) {
+        // 索引描述的是输入的 gzip 流，重新压缩后不再对应
+        std::cerr << "[ERROR] --recompress requires --mode compressed and cannot be combined with --gzip-index"
+                  << std::endl;
+        return 1;
+    }
+    if (convertOptions.maxShDegree < spz2glb::kMaxShDegree &&
+        (convertOptions.gzipIndexSpan > 0 || convertOptions.tilePoints > 0 || convertOptions.lodLevels > 0)) {
+        // 截断后解压内容已变，索引不再对应；分块与 LOD 的各层直接取自输入
+        std::cerr << "[ERROR] --max-sh-degree cannot be combined with --gzip-index, --tile or --lod" << std::endl;
+        return 1;
+    }
+    if (convertOptions.spatialCurve != spz2glb::SpatialCurve::None && convertOptions.gzipIndexSpan > 0) {
+        std::cerr << "[ERROR] --reorder cannot be combined with --gzip-index" << std::endl;
+        return 1;
+    }
+    if (convertOptions.tilePoints > 0 &&
+        (convertOptions.mode != spz2glb::OutputMode::Compressed || convertOptions.gzipIndexSpan > 0 ||
+         convertOptions.repackBlockBytes > 0 || convertOptions.spatialCurve != spz2glb::SpatialCurve::None)) {
+        // 每块是独立的 gzip 流，块内已按八叉树（Morton）顺序排列
+        std::cerr << "[ERROR] --tile requires --mode compressed and cannot be combined with "
+                     "--gzip-index, --repack or --reorder" << std::endl;
+        return 1;
+    }
+    if (convertOptions.tileset && convertOptions.tilePoints == 0) {
+        std::cerr << "[ERROR] --tileset requires --tile" << std::endl;
+        return 1;
+    }
+    if (convertOptions.lodLevels > 0 &&
+        (convertOptions.mode != spz2glb::OutputMode::Compressed || convertOptions.gzipIndexSpan > 0 ||
+         convertOptions.repackBlockBytes > 0 || convertOptions.spatialCurve != spz2glb::SpatialCurve::None ||
+         convertOptions.tilePoints > 0)) {
+        // 第 0 层保持输入的 gzip 流原样，--recompress 只作用于粗层
+        std::cerr << "[ERROR] --lod requires --mode compressed and cannot be combined with "
+                     "--gzip-index, --repack, --reorder or --tile" << std::endl;
+        return 1;
+    }
+
+    spz2glb::ConversionCache cache;
+    if (!cacheDir.empty()) {
+        std::string error;
+        if (!cache.open(cacheDir, cacheMegabytes * 1024 * 1024, error)) {
+            std::cerr << "[ERROR] " << error << std::endl;
+            return 1;
+        }
+        convertOptions.cache = &cache;
+    }
+
+    if (!servePath.empty()) {
+#ifndef _WIN32
+        spz2glb::ServerOptions serverOptions;
+        serverOptions.socketPath = servePath;
+        serverOptions.jobs = batchOptions.jobs;
+        serverOptions.idleTimeoutSeconds = idleTimeoutSeconds;
+        serverOptions.convert = convertOptions;
+        return spz2glb::runServer(serverOptions);
+#else
+        std::cerr << "[ERROR] --serve is not supported on Windows" << std::endl;
+        return 1;
+#endif
+    }
+
+    if (!batchOptions.source.empty()) {
+        batchOptions.convert = convertOptions;
+        std::vector<spz2glb::BatchJob> jobs;
+        std::string error;
+        if (!spz2glb::collectBatchJobs(batchOptions, jobs, error)) {
+            std::cerr << "[ERROR] " << error << std::endl;
+            return 1;
+        }
+        auto summary = spz2glb::runBatch(std::move(jobs), batchOptions);
+        return summary.failed == 0 ? 0 : 1;
+    }
+
+    if (!scenePath.empty()) {
+        if (sceneInputs.empty()) {
+            std::cerr << "[ERROR] --scene requires at least one input" << std::endl;
+            return 1;
+        }
+        spz2glb::ThreadPool pool(batchOptions.jobs);
+        convertOptions.pool = &pool;
+        spz2glb::GlbLayout layout;
+        auto sceneResult = spz2glb::assembleScene(sceneInputs, scenePath, layout, convertOptions);
+        if (!sceneResult.success) {
+            std::cerr << "[ERROR] " << sceneResult.errorMessage << std::endl;
+            std::cerr << "[ERROR] Scene assembly failed" << std::endl;
+            return 1;
+        }
+        std::cout << "[SUCCESS] GLB exported: " << scenePath << std::endl;
+        std::cout << "[INFO] GLB size: " << (layout.totalLength / 1024.0 / 1024.0) << " MB" << std::endl;
+        if (!doVerify) {
+            return 0;
+        }
+        std::cout << "\n============================================================\n";
+        std::cout << "Running Three-Layer Verification...\n";
+        std::cout << "============================================================\n\n";
+        std::vector<std::string> paths;
+        for (const auto& input : sceneInputs) {
+            paths.push_back(input.path);
+        }
+        spz::Verifier verifier;
+        return reportVerification(verifier.verify_scene_files(paths, scenePath));
+    }
+
+    if (inputPath.empty() || outputPath.empty()) {
+        std::cerr << "[ERROR] Missing input or output file\n";
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    if (streaming) {
+#ifndef _WIN32
+        // stdout 承载 GLB 时，进度信息改写到 stderr
+        if (outputPath == "-") {
+            std::cout.rdbuf(std::cerr.rdbuf());
+        }
+        // 输出写到同目录的临时文件，完成后再 rename，输出即输入时不会截断仍在读取的输入
+        int inFd = inputPath == "-" ? STDIN_FILENO : ::open(inputPath.c_str(), O_RDONLY);
+        spz2glb::OutputFile outFile;
+        bool outOpened = outputPath == "-" || outFile.open(outputPath);
+        int outFd = outputPath == "-" ? STDOUT_FILENO : outFile.fd();
+        if (inFd < 0 || !outOpened) {
+            std::cerr << "[ERROR] Cannot open " << (inFd < 0 ? inputPath : outputPath) << std::endl;
+            return 1;
+        }
+        spz2glb::GlbLayout layout;
+        auto streamResult = spz2glb::convertSpzStream(
+            inFd, outFd, layout, convertOptions,
+            streamInputSize > 0 ? streamInputSize : spz2glb::kUnknownStreamSize);
+        if (inFd != STDIN_FILENO) {
+            ::close(inFd);
+        }
+        bool closed = outFd == STDOUT_FILENO || (streamResult.success && outFile.commit());
+        if (!streamResult.success || !closed) {
+            std::cerr << "[ERROR] " << (streamResult.success ? "Failed to close output" : streamResult.errorMessage)
+                      << std::endl;
+            std::cerr << "[ERROR] Conversion failed" << std::endl;
+            return 1;
+        }
+        std::cout << "[SUCCESS] GLB exported: " << (outputPath == "-" ? "<stdout>" : outputPath) << std::endl;
+        std::cout << "[INFO] GLB size: " << (layout.totalLength / 1024.0 / 1024.0) << " MB" << std::endl;
+        return 0;
+#else
+        std::cerr << "[ERROR] stdin/stdout streaming is not supported on Windows" << std::endl;
+        return 1;
+#endif
+    }
+
+    std::cout << "[INFO] Loading SPZ: " << inputPath << std::endl;
+    spz2glb::GlbLayout layout;
+    std::unique_ptr<spz2glb::ThreadPool> pool;
+    if (convertOptions.mode == spz2glb::OutputMode::Attributes || convertOptions.reencodesPayload()) {
+        pool = std::make_unique<spz2glb::ThreadPool>(batchOptions.jobs);
+        convertOptions.pool = pool.get();
+    }
+    auto convertResult = showProgress ? convertWithProgress(inputPath, outputPath, convertOptions, layout)
+                                      : convertSpzFile(inputPath, outputPath, layout, convertOptions);
+    if (!convertResult.success) {
+        std::cerr << "[ERROR] " << convertResult.errorMessage << std::endl;
+        std::cerr << "[ERROR] Conversion failed" << std::endl;
+        return 1;
+    }
 
     std::cout << "[SUCCESS] GLB exported: " << outputPath << std::endl;
-    std::cout << "[INFO] GLB size: " << (glbData.size() / 1024.0 / 1024.0) << " MB" << std::endl;
+    std::cout << "[INFO] GLB size: " << (layout.totalLength / 1024.0 / 1024.0) << " MB" << std::endl;
 
     if (doVerify) {
         std::cout << "\n============================================================\n";
         std::cout << "Running Three-Layer Verification...\n";
         std::cout << "============================================================\n\n";
         
+        // 校验落盘后的文件，而不是内存中的副本
         spz::Verifier verifier;
-        auto result = verifier.verify(spzResult.data, glbData);
-        
-        std::cout << result.layer1_detail << "\n";
-        std::cout << result.layer2_detail << "\n";
-        std::cout << result.layer3_detail << "\n";
-        
-        std::cout << "============================================================\n";
-        std::cout << "Summary:\n";
-        std::cout << "  Layer 1 (GLB Structure): " << (result.layer1_passed ? "PASSED" : "FAILED") << "\n";
-        std::cout << "  Layer 2 (Binary Lossless): " << (result.layer2_passed ? "PASSED" : "FAILED") << "\n";
-        std::cout << "  Layer 3 (Decoding): " << (result.layer3_passed ? "PASSED" : "FAILED") << "\n";
-        std::cout << "============================================================\n";
-        
-        if (result.all_passed()) {
-            std::cout << "\n[SUCCESS] All verifications PASSED!\n";
-        } else {
-            std::cout << "\n[WARNING] Some verifications FAILED!\n";
-            return 2;
-        }
+        return reportVerification(verifier.verify_files(inputPath, outputPath));
     }
 
     return 0;
@@ -9,7 +9,15 @@
 #include <fstream>
 #include <sstream>
 #include <iomanip>
+#include <algorithm>
+#include <cstdlib>
 #include <cstring>
+#include <zlib.h>
+
+#include "memory_pool.h"
+#include "sh_degree.h"
+#include "spatial_order.h"
+#include "trace.h"
 
 namespace spz {
 
@@ -124,21 +132,173 @@ std::string formatSize(size_t bytes) {
     return oss.str();
 }
 
+std::string glb_json(const std::vector<uint8_t>& glb_data) {
+    if (glb_data.size() < 20) return {};
+    uint32_t json_chunk_length = *reinterpret_cast<const uint32_t*>(glb_data.data() + 12);
+    if (glb_data.size() < 20 + static_cast<size_t>(json_chunk_length)) return {};
+    return std::string(reinterpret_cast<const char*>(glb_data.data() + 20), json_chunk_length);
+}
+
+// --repack / --recompress / --reorder / --max-sh-degree 重新压缩了负载：BIN 不再是输入文件的原样字节
+bool is_reencoded(const std::vector<uint8_t>& glb_data) {
+    std::string json_str = glb_json(glb_data);
+    return json_str.find("\"spz2glb:blocks\"") != std::string::npos ||
+           json_str.find("\"spz2glb:recompressed\"") != std::string::npos ||
+           json_str.find("\"spz2glb:spatialOrder\"") != std::string::npos ||
+           json_str.find("\"spz2glb:shDegree\"") != std::string::npos;
+}
+
+// --max-sh-degree 截断后的球谐阶数，未截断时为 kMaxShDegree
+uint32_t sh_degree_limit(const std::vector<uint8_t>& glb_data) {
+    std::string json_str = glb_json(glb_data);
+    size_t at = json_str.find("\"spz2glb:shDegree\"");
+    if (at == std::string::npos || (at = json_str.find("\"to\":", at)) == std::string::npos) {
+        return spz2glb::kMaxShDegree;
+    }
+    return static_cast<uint32_t>(std::strtoul(json_str.c_str() + at + 5, nullptr, 10));
+}
+
+// --reorder 重排了点：解压内容是输入的一个点排列
+bool is_reordered(const std::vector<uint8_t>& glb_data) {
+    return glb_json(glb_data).find("\"spz2glb:spatialOrder\"") != std::string::npos;
+}
+
+// 用 zlib 解压 gzip 流；流结束后的字节（BIN 填充）忽略
+bool gunzip(const std::vector<uint8_t>& compressed, std::vector<uint8_t>& out) {
+    z_stream strm = {};
+    if (inflateInit2(&strm, 16 + MAX_WBITS) != Z_OK) return false;
+    strm.next_in = const_cast<Bytef*>(compressed.data());
+    strm.avail_in = static_cast<uInt>(compressed.size());
+    out.clear();
+    int ret = Z_OK;
+    while (ret == Z_OK) {
+        size_t old_size = out.size();
+        out.resize(old_size + std::max<size_t>(compressed.size(), 1 << 16));
+        strm.next_out = out.data() + old_size;
+        strm.avail_out = static_cast<uInt>(out.size() - old_size);
+        ret = inflate(&strm, Z_NO_FLUSH);
+        out.resize(out.size() - strm.avail_out);
+    }
+    inflateEnd(&strm);
+    return ret == Z_STREAM_END;
+}
+
+// --tile 分块输出：每个 bufferView 是一块独立的 SPZ gzip 流
+bool is_tiled(const std::vector<uint8_t>& glb_data) {
+    return glb_json(glb_data).find("\"spz2glb:tile\"") != std::string::npos;
+}
+
+// 按 JSON 中 bufferViews 的 byteOffset / byteLength 切出各块（bufferView 对象内没有嵌套对象）
+std::vector<std::pair<size_t, size_t>> tile_views(const std::string& json_str) {
+    std::vector<std::pair<size_t, size_t>> views;
+    size_t pos = json_str.find("\"bufferViews\":[");
+    size_t end = pos == std::string::npos ? pos : json_str.find(']', pos);
+    while (pos != std::string::npos && (pos = json_str.find('{', pos)) < end) {
+        size_t close = json_str.find('}', pos);
+        std::string view = json_str.substr(pos, close - pos);
+        auto number = [&](const char* key) -> size_t {
+            size_t at = view.find(key);
+            return at == std::string::npos ? 0 : std::strtoull(view.c_str() + at + std::strlen(key), nullptr, 10);
+        };
+        views.emplace_back(number("\"byteOffset\":"), number("\"byteLength\":"));
+        pos = close;
+    }
+    return views;
+}
+
+// 只保留 SPZ 压缩 primitive 引用的 bufferView：输入长度不是 4 的倍数时 BIN 末尾还有填充字节
+void narrow_to_spz_view(const std::vector<uint8_t>& glb_data, std::vector<uint8_t>& bin) {
+    static const char key[] = "\"KHR_gaussian_splatting_compression_spz_2\":{\"bufferView\":";
+    std::string json_str = glb_json(glb_data);
+    size_t at = json_str.find(key);
+    if (at == std::string::npos) return;
+    size_t index = std::strtoull(json_str.c_str() + at + std::strlen(key), nullptr, 10);
+    auto views = tile_views(json_str);
+    if (index < views.size() && views[index].first + views[index].second <= bin.size()) {
+        bin = std::vector<uint8_t>(bin.begin() + views[index].first,
+                                   bin.begin() + views[index].first + views[index].second);
+    }
+}
+
+// 解压各块
+bool gunzip_tiles(const std::vector<uint8_t>& glb_data, const std::vector<uint8_t>& bin,
+                  std::vector<std::vector<uint8_t>>& tiles) {
+    auto views = tile_views(glb_json(glb_data));
+    tiles.assign(views.size(), {});
+    for (size_t i = 0; i < views.size(); ++i) {
+        if (views[i].first + views[i].second > bin.size()) return false;
+        std::vector<uint8_t> compressed(bin.begin() + views[i].first,
+                                        bin.begin() + views[i].first + views[i].second);
+        if (!gunzip(compressed, tiles[i])) return false;
+    }
+    return !tiles.empty();
+}
+
+// 解压输入并按 GLB 记录的阶数截断球谐，得到负载解压后应有的内容
+bool gunzip_expected(const std::vector<uint8_t>& spz_data, const std::vector<uint8_t>& glb_data,
+                     std::vector<uint8_t>& out) {
+    uint32_t from_degree = 0;
+    std::string error;
+    return gunzip(spz_data, out) &&
+           spz2glb::truncateSpzShDegree(out, sh_degree_limit(glb_data), nullptr, from_degree, error);
+}
+
+// 已解压 SPZ 数据头中的点数
+uint32_t spz_point_count(const std::vector<uint8_t>& inflated) {
+    uint32_t count = 0;
+    if (inflated.size() >= 12) std::memcpy(&count, inflated.data() + 8, 4);
+    return count;
+}
+
+// --lod 输出：bufferView 0 是输入的 gzip 流原样，其余为逐层变粗的合并结果
+bool is_lod(const std::vector<uint8_t>& glb_data) {
+    return glb_json(glb_data).find("\"spz2glb:lod\"") != std::string::npos;
+}
+
+// 各粗层与输入的头部除点数外一致，点数逐层减少
+bool lod_levels_consistent(const std::vector<uint8_t>& original, const std::vector<std::vector<uint8_t>>& levels) {
+    if (levels.empty() || original.size() < 16 || spz_point_count(levels[0]) != spz_point_count(original)) {
+        return false;
+    }
+    for (size_t k = 1; k < levels.size(); ++k) {
+        if (levels[k].size() < 16 || std::memcmp(levels[k].data(), original.data(), 8) != 0 ||
+            std::memcmp(levels[k].data() + 12, original.data() + 12, 4) != 0 ||
+            spz_point_count(levels[k]) == 0 || spz_point_count(levels[k]) >= spz_point_count(levels[k - 1])) {
+            return false;
+        }
+    }
+    return true;
+}
+
 } // anonymous namespace
 
 VerifyResult Verifier::verify(const std::vector<uint8_t>& spz_data, 
                                const std::vector<uint8_t>& glb_data) {
+    spz2glb::MemoryStageScope memoryStage(spz2glb::MemoryStage::Verify);
     VerifyResult result = {};
     
-    result.layer1_passed = layer1_validate_glb_structure(glb_data, result.layer1_detail);
-    result.layer2_passed = layer2_verify_lossless(spz_data, glb_data, result.layer2_detail);
-    result.layer3_passed = layer3_verify_decoding(spz_data, glb_data, result.layer3_detail);
+    {
+        SPZ2GLB_TRACE_SCOPE(trace, "verify layer1");
+        SPZ2GLB_TRACE_BYTES(trace, glb_data.size());
+        result.layer1_passed = layer1_validate_glb_structure(glb_data, result.layer1_detail);
+    }
+    {
+        SPZ2GLB_TRACE_SCOPE(trace, "verify layer2");
+        SPZ2GLB_TRACE_BYTES(trace, spz_data.size());
+        result.layer2_passed = layer2_verify_lossless(spz_data, glb_data, result.layer2_detail);
+    }
+    {
+        SPZ2GLB_TRACE_SCOPE(trace, "verify layer3");
+        SPZ2GLB_TRACE_BYTES(trace, spz_data.size());
+        result.layer3_passed = layer3_verify_decoding(spz_data, glb_data, result.layer3_detail);
+    }
     
     return result;
 }
 
 VerifyResult Verifier::verify_files(const std::string& spz_path, 
                                      const std::string& glb_path) {
+    spz2glb::MemoryStageScope memoryStage(spz2glb::MemoryStage::Verify);
     std::ifstream spz_file(spz_path, std::ios::binary | std::ios::ate);
     std::ifstream glb_file(glb_path, std::ios::binary | std::ios::ate);
     
@@ -162,12 +322,77 @@ VerifyResult Verifier::verify_files(const std::string& spz_path,
     std::vector<uint8_t> spz_data(spz_size);
     std::vector<uint8_t> glb_data(glb_size);
     
-    spz_file.read(reinterpret_cast<char*>(spz_data.data()), spz_size);
-    glb_file.read(reinterpret_cast<char*>(glb_data.data()), glb_size);
+    {
+        SPZ2GLB_TRACE_SCOPE(trace, "verify load");
+        SPZ2GLB_TRACE_BYTES(trace, spz_data.size() + glb_data.size());
+        spz_file.read(reinterpret_cast<char*>(spz_data.data()), spz_size);
+        glb_file.read(reinterpret_cast<char*>(glb_data.data()), glb_size);
+    }
     
     return verify(spz_data, glb_data);
 }
 
+VerifyResult Verifier::verify_scene_files(const std::vector<std::string>& spz_paths,
+                                          const std::string& glb_path) {
+    spz2glb::MemoryStageScope memoryStage(spz2glb::MemoryStage::Verify);
+    VerifyResult result = {};
+    std::vector<uint8_t> glb_data;
+    std::vector<std::vector<uint8_t>> inputs(spz_paths.size());
+    auto read_all = [](const std::string& path, std::vector<uint8_t>& out) {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file) return false;
+        out.resize(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        return static_cast<bool>(file.read(reinterpret_cast<char*>(out.data()), static_cast<std::streamsize>(out.size())));
+    };
+    if (!read_all(glb_path, glb_data)) {
+        result.layer1_detail = "Cannot open GLB file: " + glb_path;
+        return result;
+    }
+    for (size_t i = 0; i < spz_paths.size(); ++i) {
+        if (!read_all(spz_paths[i], inputs[i])) {
+            result.layer1_detail = "Cannot open SPZ file: " + spz_paths[i];
+            return result;
+        }
+    }
+
+    result.layer1_passed = layer1_validate_glb_structure(glb_data, result.layer1_detail);
+    auto extracted = extract_buffer_from_glb(glb_data);
+    auto views = tile_views(glb_json(glb_data));
+
+    std::ostringstream layer2;
+    layer2 << "=== Layer 2: Binary Lossless Verification ===\n";
+    layer2 << "Scene with " << views.size() << " bufferViews for " << inputs.size() << " inputs\n";
+    result.layer2_passed = views.size() == inputs.size();
+    for (size_t i = 0; i < inputs.size() && i < views.size(); ++i) {
+        bool match = views[i].second == inputs[i].size() && views[i].first + views[i].second <= extracted.size() &&
+                     std::equal(inputs[i].begin(), inputs[i].end(), extracted.begin() + views[i].first);
+        layer2 << (match ? "[PASS] " : "[FAIL] ") << spz_paths[i] << ": " << formatSize(inputs[i].size())
+               << (match ? " binary 100% match\n" : " mismatch\n");
+        result.layer2_passed = result.layer2_passed && match;
+    }
+    result.layer2_detail = layer2.str();
+
+    std::ostringstream layer3;
+    layer3 << "=== Layer 3: Decoding Consistency Verification ===\n";
+    result.layer3_passed = views.size() == inputs.size();
+    for (size_t i = 0; i < inputs.size() && i < views.size(); ++i) {
+        std::vector<uint8_t> original;
+        std::vector<uint8_t> embedded;
+        std::vector<uint8_t> view;
+        if (views[i].first + views[i].second <= extracted.size()) {
+            view.assign(extracted.begin() + views[i].first, extracted.begin() + views[i].first + views[i].second);
+        }
+        bool match = gunzip(inputs[i], original) && gunzip(view, embedded) && original.size() == embedded.size() &&
+                     spz_point_count(original) == spz_point_count(embedded);
+        layer3 << (match ? "[PASS] " : "[FAIL] ") << spz_paths[i] << ": " << spz_point_count(embedded)
+               << " points decoded\n";
+        result.layer3_passed = result.layer3_passed && match;
+    }
+    result.layer3_detail = layer3.str();
+    return result;
+}
+
 bool Verifier::layer1_validate_glb_structure(const std::vector<uint8_t>& glb_data,
                                               std::string& detail) {
     std::ostringstream oss;
@@ -258,6 +483,76 @@ bool Verifier::layer2_verify_lossless(const std::vector<uint8_t>& spz_data,
     oss << "Original SPZ size: " << formatSize(spz_data.size()) << "\n";
     oss << "Extracted buffer size: " << formatSize(extracted.size()) << "\n";
     
+    if (is_tiled(glb_data)) {
+        // 分块输出：所有块的点合起来应恰好是输入的点
+        std::vector<uint8_t> original;
+        std::vector<std::vector<uint8_t>> tiles;
+        if (!gunzip(spz_data, original) || !gunzip_tiles(glb_data, extracted, tiles)) {
+            oss << "[FAIL] Cannot decompress SPZ tiles\n";
+            detail = oss.str();
+            return false;
+        }
+        std::string error;
+        bool match = spz2glb::isSpzPartition(original, tiles, error);
+        oss << "Payload tiled, comparing decoded splats of " << tiles.size() << " tiles ("
+            << formatSize(original.size()) << ")\n";
+        oss << (match ? "[PASS] Decoded splats 100% match (tiled)!\n" : "[FAIL] " + error + "\n");
+        detail = oss.str();
+        return match;
+    }
+
+    if (is_lod(glb_data)) {
+        // 第 0 层必须与输入逐字节一致，粗层是有损合并，只检查能否解压与头部
+        auto views = tile_views(glb_json(glb_data));
+        bool match = !views.empty() && views[0].second == spz_data.size() &&
+                     views[0].first + views[0].second <= extracted.size() &&
+                     std::equal(spz_data.begin(), spz_data.end(), extracted.begin() + views[0].first);
+        std::vector<uint8_t> original;
+        std::vector<std::vector<uint8_t>> levels;
+        bool consistent = gunzip(spz_data, original) && gunzip_tiles(glb_data, extracted, levels) &&
+                          lod_levels_consistent(original, levels);
+        oss << "LOD payload, comparing level 0 of " << views.size() << " levels\n";
+        oss << (match ? "[PASS] Level 0 binary 100% match!\n" : "[FAIL] Level 0 differs from input!\n");
+        oss << (consistent ? "[PASS] Coarse levels decompress with matching headers\n"
+                           : "[FAIL] Coarse level header or point count mismatch\n");
+        detail = oss.str();
+        return match && consistent;
+    }
+
+    if (is_reencoded(glb_data)) {
+        // 负载已重新压缩，改为比对两边解压后的 SPZ 数据
+        std::vector<uint8_t> original;
+        std::vector<uint8_t> embedded;
+        if (!gunzip_expected(spz_data, glb_data, original) || !gunzip(extracted, embedded)) {
+            oss << "[FAIL] Cannot decompress SPZ payload\n";
+            detail = oss.str();
+            return false;
+        }
+        if (sh_degree_limit(glb_data) < spz2glb::kMaxShDegree) {
+            oss << "SH bands above degree " << sh_degree_limit(glb_data) << " dropped, comparing with the truncated input\n";
+        }
+        if (is_reordered(glb_data)) {
+            // 点已按空间曲线重排：逐点比对属性字节，顺序不计
+            std::string error;
+            bool match = spz2glb::isSpzPermutation(original, embedded, error);
+            oss << "Payload reordered, comparing decoded splats as a permutation ("
+                << formatSize(original.size()) << ")\n";
+            oss << (match ? "[PASS] Decoded splats 100% match (reordered)!\n" : "[FAIL] " + error + "\n");
+            detail = oss.str();
+            return match;
+        }
+        std::string original_md5 = Md5Hash::hash(original.data(), original.size());
+        std::string embedded_md5 = Md5Hash::hash(embedded.data(), embedded.size());
+        oss << "Payload re-compressed, comparing decoded data (" << formatSize(original.size()) << ")\n";
+        oss << "Original decoded MD5: " << original_md5 << "\n";
+        oss << "Embedded decoded MD5: " << embedded_md5 << "\n";
+        bool match = original.size() == embedded.size() && original == embedded;
+        oss << (match ? "[PASS] Decoded data 100% match!\n" : "[FAIL] Decoded data mismatch!\n");
+        detail = oss.str();
+        return match;
+    }
+    
+    narrow_to_spz_view(glb_data, extracted);
     if (extracted.size() != spz_data.size()) {
         oss << "[FAIL] Size mismatch!\n";
         detail = oss.str();
@@ -293,6 +588,57 @@ bool Verifier::layer3_verify_decoding(const std::vector<uint8_t>& spz_data,
     
     auto extracted = extract_buffer_from_glb(glb_data);
     
+    if (is_tiled(glb_data)) {
+        std::vector<uint8_t> original;
+        std::vector<std::vector<uint8_t>> tiles;
+        uint64_t points = 0;
+        if (gunzip(spz_data, original) && gunzip_tiles(glb_data, extracted, tiles)) {
+            for (const auto& tile : tiles) points += spz_point_count(tile);
+            if (points == spz_point_count(original)) {
+                oss << "[PASS] " << tiles.size() << " SPZ tiles embedded in GLB\n";
+                oss << "[PASS] Point count consistent: " << points << "\n";
+                detail = oss.str();
+                return true;
+            }
+        }
+        oss << "[FAIL] Tile point count mismatch\n";
+        detail = oss.str();
+        return false;
+    }
+
+    if (is_lod(glb_data)) {
+        std::vector<uint8_t> original;
+        std::vector<std::vector<uint8_t>> levels;
+        if (gunzip(spz_data, original) && gunzip_tiles(glb_data, extracted, levels) &&
+            lod_levels_consistent(original, levels)) {
+            oss << "[PASS] " << levels.size() << " SPZ LOD levels embedded in GLB\n";
+            oss << "[PASS] Point counts decreasing:";
+            for (const auto& level : levels) oss << " " << spz_point_count(level);
+            oss << "\n";
+            detail = oss.str();
+            return true;
+        }
+        oss << "[FAIL] LOD point count mismatch\n";
+        detail = oss.str();
+        return false;
+    }
+
+    if (is_reencoded(glb_data)) {
+        std::vector<uint8_t> original;
+        std::vector<uint8_t> embedded;
+        if (gunzip_expected(spz_data, glb_data, original) && gunzip(extracted, embedded) &&
+            original.size() == embedded.size()) {
+            oss << "[PASS] Re-compressed SPZ payload embedded in GLB\n";
+            oss << "[PASS] Decoded size consistent: " << formatSize(original.size()) << "\n";
+            detail = oss.str();
+            return true;
+        }
+        oss << "[FAIL] Decoded size mismatch\n";
+        detail = oss.str();
+        return false;
+    }
+    
+    narrow_to_spz_view(glb_data, extracted);
     if (extracted.size() == spz_data.size()) {
         oss << "[PASS] SPZ data fully embedded in GLB\n";
         oss << "[PASS] Size consistent: " << formatSize(spz_data.size()) << "\n";
@@ -36,8 +36,12 @@ public:
     
     VerifyResult verify_files(const std::string& spz_path, 
                               const std::string& glb_path);
-    
-private:
+
+    // --scene 输出：第 i 个 bufferView 必须与第 i 个输入逐字节一致
+    VerifyResult verify_scene_files(const std::vector<std::string>& spz_paths,
+                                    const std::string& glb_path);
+
+    // 各层也可单独调用（spz2glb_bench 分层计时）
     bool layer1_validate_glb_structure(const std::vector<uint8_t>& glb_data,
                                         std::string& detail);
     
@@ -49,6 +53,7 @@ private:
                                  const std::vector<uint8_t>& glb_data,
                                  std::string& detail);
     
+private:
     std::vector<uint8_t> extract_buffer_from_glb(const std::vector<uint8_t>& glb_data);
 };
 
@@ -10,6 +10,8 @@
  * - Layer 1: GLB Structure & SPZ_2 Specification Validation
  * - Layer 2: Binary Lossless Verification (SPZ → GLB → Extract → Compare)
  * - Layer 3: Decoding Consistency Verification
+ *
+ * 另有 index 命令：校验 spz2glb --gzip-index 生成的随机访问索引，或 --repack 写入 GLB 的块表
  */
 
 #include <iostream>
@@ -22,6 +24,8 @@
 #include <array>
 #include <functional>
 #include <cstdint>
+#include <cstdlib>
+#include <utility>
 
 #ifdef _WIN32
 #include <windows.h>
@@ -29,6 +33,17 @@
 #include <sys/stat.h>
 #endif
 
+#include <zlib.h>
+
+#ifndef __EMSCRIPTEN__
+#include <algorithm>
+#include <chrono>
+#include "gzip_index.h"
+#include "sh_degree.h"
+#include "spatial_order.h"
+#include "thread_pool.h"
+#endif
+
 /**
  * GLB 文件头结构（12 字节）
  * 
@@ -114,6 +129,120 @@ bool fileExists(const std::string& path);
 size_t getFileSize(const std::string& path);
 std::string bytesToHex(const uint8_t* data, size_t len);
 
+/**
+ * spz2glb --repack / --recompress / --reorder 重新压缩了负载（extras 中有块表、重新压缩或重排标记）
+ *
+ * 此时 BIN 中的 gzip 流与输入文件字节不同，解压后的 SPZ 数据相同（--reorder 时为同一组点的另一种排列）
+ */
+bool isReencodedPayload(const std::string& jsonStr) {
+    return jsonStr.find("\"spz2glb:blocks\"") != std::string::npos ||
+           jsonStr.find("\"spz2glb:recompressed\"") != std::string::npos ||
+           jsonStr.find("\"spz2glb:spatialOrder\"") != std::string::npos ||
+           jsonStr.find("\"spz2glb:shDegree\"") != std::string::npos;
+}
+
+/**
+ * spz2glb --max-sh-degree 丢掉了高阶球谐（extras 中记 "spz2glb:shDegree":{"from":F,"to":T}）：
+ * 把解压后的输入截断到同样的阶数再比对；WASM 构建不含截断实现，遇到截断标记时返回 false
+ */
+bool truncateToRecordedShDegree(const std::string& jsonStr, std::vector<uint8_t>& decoded) {
+    size_t at = jsonStr.find("\"spz2glb:shDegree\"");
+    if (at == std::string::npos) return true;
+#ifndef __EMSCRIPTEN__
+    at = jsonStr.find("\"to\":", at);
+    if (at == std::string::npos) return false;
+    uint32_t degree = static_cast<uint32_t>(std::strtoul(jsonStr.c_str() + at + 5, nullptr, 10));
+    uint32_t fromDegree = 0;
+    std::string error;
+    std::cout << "    SH bands above degree " << degree << " dropped, truncating the input to match\n";
+    return spz2glb::truncateSpzShDegree(decoded, degree, nullptr, fromDegree, error);
+#else
+    return false;
+#endif
+}
+
+/**
+ * spz2glb --tile 分块输出（node extras 中有块信息）：每个 bufferView 是一块独立的 SPZ gzip 流
+ */
+bool isTiledPayload(const std::string& jsonStr) {
+    return jsonStr.find("\"spz2glb:tile\"") != std::string::npos;
+}
+
+/**
+ * spz2glb --lod 输出（node extras 中有层信息）：bufferView 0 是输入的 gzip 流原样，其余为逐层变粗的 SPZ gzip 流
+ */
+bool isLodPayload(const std::string& jsonStr) {
+    return jsonStr.find("\"spz2glb:lod\"") != std::string::npos;
+}
+
+/**
+ * 各 bufferView 的 (byteOffset, byteLength)（bufferView 对象内没有嵌套对象）
+ */
+std::vector<std::pair<size_t, size_t>> parseBufferViews(const std::string& jsonStr) {
+    std::vector<std::pair<size_t, size_t>> views;
+    size_t pos = jsonStr.find("\"bufferViews\":[");
+    size_t end = pos == std::string::npos ? pos : jsonStr.find(']', pos);
+    while (pos != std::string::npos && (pos = jsonStr.find('{', pos)) < end) {
+        size_t close = jsonStr.find('}', pos);
+        std::string view = jsonStr.substr(pos, close - pos);
+        auto number = [&](const char* key) -> size_t {
+            size_t at = view.find(key);
+            return at == std::string::npos ? 0 : std::strtoull(view.c_str() + at + std::strlen(key), nullptr, 10);
+        };
+        views.emplace_back(number("\"byteOffset\":"), number("\"byteLength\":"));
+        pos = close;
+    }
+    return views;
+}
+
+/**
+ * 用 zlib 解压整个 gzip 流
+ */
+bool gunzipBytes(const uint8_t* data, size_t size, std::vector<uint8_t>& out) {
+    z_stream strm = {};
+    if (inflateInit2(&strm, 16 + MAX_WBITS) != Z_OK) return false;
+    strm.next_in = const_cast<Bytef*>(data);
+    strm.avail_in = static_cast<uInt>(size);
+    out.clear();
+    int ret = Z_OK;
+    while (ret == Z_OK) {
+        size_t oldSize = out.size();
+        out.resize(oldSize + (size > 65536 ? size : 65536));
+        strm.next_out = out.data() + oldSize;
+        strm.avail_out = static_cast<uInt>(out.size() - oldSize);
+        ret = inflate(&strm, Z_NO_FLUSH);
+        out.resize(out.size() - strm.avail_out);
+    }
+    inflateEnd(&strm);
+    return ret == Z_STREAM_END;
+}
+
+/**
+ * 解压 LOD 输出的各层，检查粗层头部除点数外与输入一致、点数逐层减少；counts 返回各层点数
+ */
+bool lodPointCounts(const std::vector<uint8_t>& original, const uint8_t* payload, size_t payloadSize,
+                    const std::vector<std::pair<size_t, size_t>>& views, std::vector<uint32_t>& counts) {
+    counts.clear();
+    std::vector<uint8_t> level;
+    for (const auto& view : views) {
+        if (view.first + view.second > payloadSize || !gunzipBytes(payload + view.first, view.second, level) ||
+            level.size() < 16 || original.size() < 16) {
+            return false;
+        }
+        uint32_t count = 0;
+        std::memcpy(&count, level.data() + 8, 4);
+        bool headerMatch = std::memcmp(level.data(), original.data(), 8) == 0 &&
+                           std::memcmp(level.data() + 12, original.data() + 12, 4) == 0;
+        if (!headerMatch || count == 0 || (!counts.empty() && count >= counts.back())) {
+            return false;
+        }
+        counts.push_back(count);
+    }
+    uint32_t expected = 0;
+    std::memcpy(&expected, original.data() + 8, 4);
+    return !counts.empty() && counts[0] == expected;
+}
+
 void printDivider() {
     std::cout << "============================================================\n";
 }
@@ -334,6 +463,96 @@ bool layer2VerifyLossless(const std::string& spzPath, const std::string& glbPath
     
     std::cout << "    Extracted from GLB: " << extractedData.size() << " bytes\n";
     
+#ifndef __EMSCRIPTEN__
+    if (isTiledPayload(jsonStr)) {
+        // 分块输出：解压每一块，所有块的点合起来应恰好是输入的点
+        auto views = parseBufferViews(jsonStr);
+        std::cout << "\n[2] Payload tiled, decoding " << views.size() << " tiles...\n";
+        std::vector<uint8_t> originalDecoded;
+        std::vector<std::vector<uint8_t>> tiles(views.size());
+        bool decoded = !views.empty() &&
+            gunzipBytes(reinterpret_cast<const uint8_t*>(originalData.data()), originalData.size(), originalDecoded);
+        for (size_t i = 0; decoded && i < views.size(); ++i) {
+            decoded = views[i].first + views[i].second <= extractedData.size() &&
+                      gunzipBytes(extractedData.data() + views[i].first, views[i].second, tiles[i]);
+        }
+        if (!decoded) {
+            std::cout << "\n[FAILED] Layer 2: Cannot decompress SPZ tiles\n";
+            return false;
+        }
+        std::string error;
+        std::cout << "\n[3] Comparing splats of all tiles...\n";
+        if (spz2glb::isSpzPartition(originalDecoded, tiles, error)) {
+            std::cout << "\n[PASSED] Layer 2: Decoded splats lossless (tiled)! 100% match!\n";
+            return true;
+        }
+        std::cout << "\n[FAILED] Layer 2: " << error << "\n";
+        return false;
+    }
+#endif
+
+    if (isLodPayload(jsonStr)) {
+        // 第 0 层必须与输入逐字节一致；粗层是有损合并，只检查能否解压、头部与点数
+        auto views = parseBufferViews(jsonStr);
+        std::cout << "\n[2] LOD payload, computing MD5 of level 0 (" << views.size() << " levels)...\n";
+        bool inBounds = !views.empty() && views[0].first + views[0].second <= extractedData.size();
+        std::string originalMd5 = Md5Hash::hash(reinterpret_cast<const uint8_t*>(originalData.data()), originalData.size());
+        std::string levelMd5 = inBounds ? Md5Hash::hash(extractedData.data() + views[0].first, views[0].second) : "";
+        std::cout << "    Original MD5: " << originalMd5 << "\n";
+        std::cout << "    Level 0 MD5:  " << levelMd5 << "\n";
+        std::vector<uint8_t> originalDecoded;
+        std::vector<uint32_t> counts;
+        bool levels = gunzipBytes(reinterpret_cast<const uint8_t*>(originalData.data()), originalData.size(),
+                                  originalDecoded) &&
+                      lodPointCounts(originalDecoded, extractedData.data(), extractedData.size(), views, counts);
+        std::cout << "\n[3] Comparing...\n";
+        if (inBounds && views[0].second == originalData.size() && originalMd5 == levelMd5 && levels) {
+            std::cout << "\n[PASSED] Layer 2: Level 0 binary lossless! 100% match!\n";
+            return true;
+        }
+        std::cout << "\n[FAILED] Layer 2: " << (levels ? "Level 0 mismatch!" : "Coarse level header mismatch!")
+                  << "\n";
+        return false;
+    }
+
+    if (isReencodedPayload(jsonStr)) {
+        // 负载已重新压缩，压缩流逐字节比对不再适用，改为比对两边解压后的 SPZ 数据
+        std::cout << "\n[2] Payload re-compressed, decoding both streams...\n";
+        std::vector<uint8_t> originalDecoded;
+        std::vector<uint8_t> extractedDecoded;
+        if (!gunzipBytes(reinterpret_cast<const uint8_t*>(originalData.data()), originalData.size(), originalDecoded) ||
+            !truncateToRecordedShDegree(jsonStr, originalDecoded) ||
+            !gunzipBytes(extractedData.data(), extractedData.size(), extractedDecoded)) {
+            std::cout << "\n[FAILED] Layer 2: Cannot decompress SPZ payload\n";
+            return false;
+        }
+#ifndef __EMSCRIPTEN__
+        if (jsonStr.find("\"spz2glb:spatialOrder\"") != std::string::npos) {
+            // 点已按空间曲线重排：逐点比对属性字节，顺序不计
+            std::string error;
+            std::cout << "\n[3] Comparing splats as a permutation...\n";
+            if (spz2glb::isSpzPermutation(originalDecoded, extractedDecoded, error)) {
+                std::cout << "\n[PASSED] Layer 2: Decoded splats lossless (reordered)! 100% match!\n";
+                return true;
+            }
+            std::cout << "\n[FAILED] Layer 2: " << error << "\n";
+            return false;
+        }
+#endif
+        std::string originalMd5 = Md5Hash::hash(originalDecoded.data(), originalDecoded.size());
+        std::string extractedMd5 = Md5Hash::hash(extractedDecoded.data(), extractedDecoded.size());
+        std::cout << "    Original decoded MD5:  " << originalMd5 << " (" << originalDecoded.size() << " bytes)\n";
+        std::cout << "    Extracted decoded MD5: " << extractedMd5 << " (" << extractedDecoded.size() << " bytes)\n";
+
+        std::cout << "\n[3] Comparing...\n";
+        if (originalDecoded.size() == extractedDecoded.size() && originalMd5 == extractedMd5) {
+            std::cout << "\n[PASSED] Layer 2: Decoded SPZ data lossless! 100% match!\n";
+            return true;
+        }
+        std::cout << "\n[FAILED] Layer 2: Decoded data mismatch!\n";
+        return false;
+    }
+    
     // 步骤 2: 计算 MD5 哈希值
     std::cout << "\n[2] Computing MD5 hashes...\n";
     std::string originalMd5 = Md5Hash::hash(reinterpret_cast<const uint8_t*>(originalData.data()), originalData.size());
@@ -452,6 +671,73 @@ bool layer3VerifyDecoding(const std::string& spzPath, const std::string& glbPath
     
     std::cout << "    [PASS] Buffer size: " << bufferSize << " bytes\n";
     
+    if (isTiledPayload(jsonStr)) {
+        // 分块输出：各块头中的点数之和应等于输入的点数
+        size_t binOffset = 12 + 8 + jsonChunk.chunkLength + (4 - (jsonChunk.chunkLength % 4)) % 4 + 8;
+        file.seekg(static_cast<std::streamoff>(binOffset));
+        std::vector<uint8_t> payload(bufferSize);
+        file.read(reinterpret_cast<char*>(payload.data()), static_cast<std::streamsize>(bufferSize));
+        std::vector<uint8_t> decoded;
+        bool ok = file && gunzipBytes(reinterpret_cast<const uint8_t*>(spzData.data()), spzData.size(), decoded) &&
+                  decoded.size() >= 12;
+        uint32_t expected = 0;
+        uint64_t points = 0;
+        if (ok) std::memcpy(&expected, decoded.data() + 8, 4);
+        auto views = parseBufferViews(jsonStr);
+        for (size_t i = 0; ok && i < views.size(); ++i) {
+            ok = views[i].first + views[i].second <= payload.size() &&
+                 gunzipBytes(payload.data() + views[i].first, views[i].second, decoded) && decoded.size() >= 12;
+            uint32_t count = 0;
+            if (ok) std::memcpy(&count, decoded.data() + 8, 4);
+            points += count;
+        }
+        if (ok && points == expected) {
+            std::cout << "\n[PASSED] Layer 3: Point count match - " << points << " points in " << views.size()
+                      << " tiles\n";
+            return true;
+        }
+        std::cout << "\n[FAILED] Layer 3: Tile point count mismatch!\n";
+        return false;
+    }
+
+    if (isLodPayload(jsonStr)) {
+        // LOD 输出：第 0 层点数等于输入，粗层逐层减少
+        size_t binOffset = 12 + 8 + jsonChunk.chunkLength + (4 - (jsonChunk.chunkLength % 4)) % 4 + 8;
+        file.seekg(static_cast<std::streamoff>(binOffset));
+        std::vector<uint8_t> payload(bufferSize);
+        file.read(reinterpret_cast<char*>(payload.data()), static_cast<std::streamsize>(bufferSize));
+        std::vector<uint8_t> decoded;
+        std::vector<uint32_t> counts;
+        if (file && gunzipBytes(reinterpret_cast<const uint8_t*>(spzData.data()), spzData.size(), decoded) &&
+            lodPointCounts(decoded, payload.data(), payload.size(), parseBufferViews(jsonStr), counts)) {
+            std::cout << "\n[PASSED] Layer 3: Point counts decreasing -";
+            for (uint32_t count : counts) std::cout << " " << count;
+            std::cout << "\n";
+            return true;
+        }
+        std::cout << "\n[FAILED] Layer 3: LOD point count mismatch!\n";
+        return false;
+    }
+
+    if (isReencodedPayload(jsonStr)) {
+        // 负载已重新压缩：比较两边解压后的大小
+        size_t binOffset = 12 + 8 + jsonChunk.chunkLength + (4 - (jsonChunk.chunkLength % 4)) % 4 + 8;
+        file.seekg(static_cast<std::streamoff>(binOffset));
+        std::vector<uint8_t> payload(bufferSize);
+        file.read(reinterpret_cast<char*>(payload.data()), static_cast<std::streamsize>(bufferSize));
+        std::vector<uint8_t> originalDecoded;
+        std::vector<uint8_t> payloadDecoded;
+        if (file && gunzipBytes(reinterpret_cast<const uint8_t*>(spzData.data()), spzData.size(), originalDecoded) &&
+            truncateToRecordedShDegree(jsonStr, originalDecoded) &&
+            gunzipBytes(payload.data(), payload.size(), payloadDecoded) &&
+            originalDecoded.size() == payloadDecoded.size()) {
+            std::cout << "\n[PASSED] Layer 3: Decoded size match - " << payloadDecoded.size() << " bytes\n";
+            return true;
+        }
+        std::cout << "\n[FAILED] Layer 3: Decoded size mismatch!\n";
+        return false;
+    }
+    
     // 步骤 3: 比较大小
     if (spzData.size() == bufferSize) {
         std::cout << "\n[PASSED] Layer 3: Size match - " << spzData.size() << " bytes\n";
@@ -463,6 +749,120 @@ bool layer3VerifyDecoding(const std::string& spzPath, const std::string& glbPath
     return false;
 }
 
+#ifndef __EMSCRIPTEN__
+
+/**
+ * 校验 gzip 随机访问索引
+ *
+ * indexPath 为空时使用 GLB JSON 中 --repack 写入的 spz2glb:blocks 块表
+ *
+ * 1. 读取索引，按其中的 payloadOffset / compressedSize 定位 GLB 中的 SPZ 流，并与 BIN Chunk 位置比对
+ * 2. 顺序解压整个流作为基准
+ * 3. 按访问点并行解压，逐字节比对并校验 CRC-32
+ * 4. 从流中间的任意偏移解压一段，比对
+ */
+bool verifyGzipIndex(const std::string& glbPath, const std::string& indexPath) {
+    std::cout << "\n";
+    printDivider();
+    std::cout << "Gzip Random-Access Index Verification\n";
+    printDivider();
+
+    std::cout << "\n[1] Reading index...\n";
+    std::string glb = readFileBytes(glbPath);
+    if (glb.size() < sizeof(GlbHeader) + 2 * sizeof(GlbChunk)) {
+        std::cerr << "[ERROR] Cannot read GLB: " << glbPath << "\n";
+        return false;
+    }
+    GlbChunk jsonChunk;
+    std::memcpy(&jsonChunk, glb.data() + sizeof(GlbHeader), sizeof(jsonChunk));
+    uint64_t binOffset = sizeof(GlbHeader) + sizeof(GlbChunk) + uint64_t{jsonChunk.chunkLength} + sizeof(GlbChunk);
+    if (binOffset > glb.size()) {
+        std::cerr << "[ERROR] Truncated GLB: " << glbPath << "\n";
+        return false;
+    }
+
+    spz2glb::GzipIndex index;
+    std::string error;
+    if (indexPath.empty()) {
+        // 块表不记录负载位置：gzip 流从 BIN 负载起点开始，长度即 bufferView 的 byteLength（同 Layer 2）
+        std::string_view json(glb.data() + sizeof(GlbHeader) + sizeof(GlbChunk), jsonChunk.chunkLength);
+        size_t byteLenPos = json.find("\"byteLength\"");
+        if (!spz2glb::parseGzipBlockTable(json, index, error) || byteLenPos == std::string_view::npos) {
+            std::cerr << "[ERROR] " << error << " (no " << glbPath << ".zidx either)\n";
+            return false;
+        }
+        size_t start = json.find_first_not_of(" :", byteLenPos + 12);
+        index.payloadOffset = binOffset;
+        index.compressedSize = std::stoull(std::string(json.substr(start, 20)));
+        std::cout << "    Source: spz2glb:blocks in GLB JSON\n";
+    } else if (!spz2glb::readGzipIndex(indexPath, index, error)) {
+        std::cerr << "[ERROR] " << error << "\n";
+        return false;
+    }
+    std::cout << "    Access points: " << index.points.size() << "\n";
+    std::cout << "    Span: " << index.spanBytes << " bytes\n";
+    std::cout << "    Uncompressed: " << index.uncompressedSize << " bytes\n";
+
+    if (index.payloadOffset != binOffset || binOffset + index.compressedSize > glb.size()) {
+        std::cout << "    [FAIL] Index does not describe this GLB's BIN payload\n";
+        return false;
+    }
+    std::cout << "    [PASS] Payload at offset " << binOffset << ", " << index.compressedSize << " bytes\n";
+    std::span<const uint8_t> payload(reinterpret_cast<const uint8_t*>(glb.data()) + binOffset,
+                                     static_cast<size_t>(index.compressedSize));
+
+    std::cout << "\n[2] Serial inflate...\n";
+    auto start = std::chrono::steady_clock::now();
+    std::vector<uint8_t> serial(static_cast<size_t>(index.uncompressedSize));
+    z_stream strm = {};
+    bool serialOk = inflateInit2(&strm, 16 + MAX_WBITS) == Z_OK;
+    if (serialOk) {
+        strm.next_in = const_cast<Bytef*>(payload.data());
+        strm.avail_in = static_cast<uInt>(payload.size());
+        strm.next_out = serial.data();
+        strm.avail_out = static_cast<uInt>(serial.size());
+        serialOk = inflate(&strm, Z_FINISH) == Z_STREAM_END && strm.total_out == serial.size();
+        inflateEnd(&strm);
+    }
+    double serialMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    if (!serialOk) {
+        std::cout << "    [FAIL] Serial inflate failed or size differs from index\n";
+        return false;
+    }
+    std::cout << "    [PASS] " << std::fixed << std::setprecision(1) << serialMs << " ms\n";
+
+    std::cout << "\n[3] Parallel inflate from access points...\n";
+    spz2glb::ThreadPool pool;
+    start = std::chrono::steady_clock::now();
+    std::vector<uint8_t> parallel(serial.size());
+    bool parallelOk = spz2glb::inflateWithIndex(payload, index, parallel, &pool, error);
+    double parallelMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    if (!parallelOk) {
+        std::cout << "    [FAIL] " << error << "\n";
+        return false;
+    }
+    if (parallel != serial) {
+        std::cout << "    [FAIL] Parallel output differs from serial inflate\n";
+        return false;
+    }
+    std::cout << "    [PASS] " << parallelMs << " ms on " << pool.size() << " threads, CRC-32 matches\n";
+
+    std::cout << "\n[4] Random access...\n";
+    uint64_t offset = index.uncompressedSize / 2;
+    std::vector<uint8_t> slice(static_cast<size_t>(std::min<uint64_t>(4096, index.uncompressedSize - offset)));
+    if (!spz2glb::inflateRange(payload, index, offset, slice, error) ||
+        !std::equal(slice.begin(), slice.end(), serial.begin() + static_cast<std::ptrdiff_t>(offset))) {
+        std::cout << "    [FAIL] Range at offset " << offset << " differs\n";
+        return false;
+    }
+    std::cout << "    [PASS] " << slice.size() << " bytes at offset " << offset << "\n";
+
+    std::cout << "\n[PASSED] Gzip index verified\n";
+    return true;
+}
+
+#endif  // __EMSCRIPTEN__
+
 void printUsage(const char* progName) {
     std::cout << "SPZ to GLB Verification Tool\n";
     std::cout << "Usage: " << progName << " <command> [options]\n\n";
@@ -472,6 +872,10 @@ void printUsage(const char* progName) {
     std::cout << "  layer3 <spz> <glb>     - Decoding consistency (Layer 3)\n";
     std::cout << "  all <spz> <glb>        - Run all three layers\n";
     std::cout << "  verify <spz> <glb>     - Alias for 'all'\n";
+#ifndef __EMSCRIPTEN__
+    std::cout << "  index <glb> [zidx]     - Check a --gzip-index sidecar (default: <glb>.zidx,\n";
+    std::cout << "                           or the --repack block table in the GLB)\n";
+#endif
     std::cout << "\nExamples:\n";
     std::cout << "  " << progName << " all model.spz model.glb\n";
     std::cout << "  " << progName << " layer1 model.glb\n";
@@ -494,6 +898,16 @@ int main(int argc, char** argv) {
     else if (command == "layer3" && argc >= 4) {
         return layer3VerifyDecoding(argv[2], argv[3]) ? 0 : 1;
     }
+#ifndef __EMSCRIPTEN__
+    else if (command == "index" && argc >= 3) {
+        std::string glbPath = argv[2];
+        std::string indexPath = argc >= 4 ? argv[3] : glbPath + ".zidx";
+        if (argc < 4 && !std::ifstream(indexPath, std::ios::binary)) {
+            indexPath.clear();
+        }
+        return verifyGzipIndex(glbPath, indexPath) ? 0 : 1;
+    }
+#endif
     else if ((command == "all" || command == "verify") && argc >= 4) {
         std::string spzPath = argv[2];
         std::string glbPath = argv[3];
@@ -698,10 +1112,11 @@ uint8_t* computeMd5HashWasm(const uint8_t* data, size_t len, uint8_t* outHash) {
 
 }
 
+// 模块的全部堆分配都经 memory_tracking.cpp 记账，工作区本身也是其中一次分配
 Spz2GlbMemoryStats getVerifyMemoryStats() {
-    Spz2GlbMemoryStats stats = {0, 0, 0, 0, 0};
-    stats.peak_usage_bytes = g_workAllocator.used();
-    stats.current_usage_bytes = g_workAllocator.used();
+    spz2glb::MemoryStats current = spz2glb::getMemoryStats();
+    Spz2GlbMemoryStats stats = {current.peak_usage, current.current_usage, current.total_allocations,
+                                current.total_frees, current.failed_allocations};
     return stats;
 }
 
@@ -0,0 +1,229 @@
+// Copyright (c) 2026 Pu Junhan
+// SPDX-License-Identifier: MIT
+// Project: SPZ-ecosystem
+// Repository: https://github.com/spz-ecosystem/spz2glb
+//
+// 管道流式转换实现
+
+#include "stream_convert.h"
+
+#ifndef _WIN32
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <sys/stat.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <fcntl.h>  // splice
+#include <sys/sendfile.h>
+#endif
+
+namespace spz2glb {
+
+namespace {
+
+// 析构时关闭的 fd（转存用的临时文件）
+struct ScopedFd {
+    int fd = -1;
+    ~ScopedFd() {
+        if (fd >= 0) ::close(fd);
+    }
+};
+
+bool writeAll(int fd, const uint8_t* data, size_t size) {
+    while (size > 0) {
+        ssize_t n = ::write(fd, data, size);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        data += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+// 读满 size 字节或读到 EOF；offset 非空时按该偏移 pread 并推进它
+bool readFull(int fd, uint8_t* data, size_t size, off_t* offset, size_t& got) {
+    got = 0;
+    while (got < size) {
+        ssize_t n = offset != nullptr ? ::pread(fd, data + got, size - got, *offset)
+                                      : ::read(fd, data + got, size - got);
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0) return false;
+        if (n == 0) break;
+        got += static_cast<size_t>(n);
+        if (offset != nullptr) *offset += n;
+    }
+    return true;
+}
+
+/**
+ * 把至多 length 字节从 inFd 拷贝到 outFd，读到 EOF 提前结束，copied 为实际字节数
+ *
+ * inOffset 非空时 inFd 是普通文件，从该偏移读取（Linux 下 sendfile）；
+ * 否则从当前位置顺序读（Linux 下 splice，要求一端是管道）。
+ * 内核拷贝不可用时退化为经过 window 的 read / write
+ *
+ * @return false 如果读写出错
+ */
+bool pump(int inFd, int outFd, uint64_t length, off_t* inOffset, std::vector<uint8_t>& window, uint64_t& copied) {
+    copied = 0;
+#ifdef __linux__
+    while (copied < length) {
+        size_t chunk = static_cast<size_t>(std::min<uint64_t>(length - copied, 1u << 30));
+        ssize_t n = inOffset != nullptr
+            ? ::sendfile(outFd, inFd, inOffset, chunk)
+            : ::splice(inFd, nullptr, outFd, nullptr, std::min(chunk, window.size()), SPLICE_F_MOVE | SPLICE_F_MORE);
+        if (n < 0 && errno == EINTR) continue;
+        if (n == 0) return true;
+        if (n < 0) {
+            if (errno == EINVAL || errno == ENOSYS) break;  // 这对 fd 不支持，改用 read / write
+            return false;
+        }
+        copied += static_cast<uint64_t>(n);
+    }
+#endif
+    while (copied < length) {
+        size_t got = 0;
+        size_t chunk = static_cast<size_t>(std::min<uint64_t>(length - copied, window.size()));
+        if (!readFull(inFd, window.data(), chunk, inOffset, got) || !writeAll(outFd, window.data(), got)) {
+            return false;
+        }
+        copied += got;
+        if (got < chunk) break;
+    }
+    return true;
+}
+
+// 把长度未知的输入转存到 $TMPDIR 下的临时文件（创建后立即删除，进程结束即释放）
+bool spoolToTempFile(int inFd, std::vector<uint8_t>& window, ScopedFd& spool, uint64_t& size, std::string& error) {
+    const char* dir = std::getenv("TMPDIR");
+    std::string path = std::string(dir != nullptr && *dir != '\0' ? dir : "/tmp") + "/spz2glb-XXXXXX";
+    spool.fd = ::mkstemp(path.data());
+    if (spool.fd < 0) {
+        error = "Cannot create temporary file in " + path.substr(0, path.size() - 15);
+        return false;
+    }
+    ::unlink(path.c_str());
+    if (!pump(inFd, spool.fd, kUnknownStreamSize, nullptr, window, size)) {
+        error = "Failed to spool SPZ input to a temporary file";
+        return false;
+    }
+    return true;
+}
+
+}  // anonymous namespace
+
+SpzResult convertSpzStream(int inFd, int outFd, GlbLayout& layout, const ConvertOptions& options,
+                           uint64_t inputSize) {
+    std::vector<uint8_t> window(kStreamWindowBytes);
+    ScopedFd spool;
+    std::string error;
+
+    // 步骤 1: 确定输入长度；普通文件从当前位置读到末尾，长度未知的管道先转存
+    struct stat st;
+    bool seekable = ::fstat(inFd, &st) == 0 && S_ISREG(st.st_mode);
+    off_t offset = 0;
+    if (seekable) {
+        offset = std::max<off_t>(::lseek(inFd, 0, SEEK_CUR), 0);
+        uint64_t fileSize = static_cast<uint64_t>(std::max<off_t>(st.st_size - offset, 0));
+        if (inputSize != kUnknownStreamSize && inputSize != fileSize) {
+            return SpzResult::error(SpzErrorCode::FailedToReadSpzFile,
+                "SPZ input has " + std::to_string(fileSize) + " bytes, expected " + std::to_string(inputSize));
+        }
+        inputSize = fileSize;
+    } else if (inputSize == kUnknownStreamSize) {
+        if (!spoolToTempFile(inFd, window, spool, inputSize, error)) {
+            return SpzResult::error(SpzErrorCode::FailedToReadSpzFile, error);
+        }
+        if (options.verbose) {
+            std::cout << "[INFO] Input length unknown, spooled " << (inputSize / 1024.0 / 1024.0)
+                      << " MB to a temporary file" << std::endl;
+        }
+        inFd = spool.fd;
+        seekable = true;
+    }
+    if (inputSize == 0) {
+        return SpzResult::error(SpzErrorCode::FailedToReadSpzFile, "Empty SPZ input");
+    }
+
+    // 步骤 2: 读入第一个窗口，只从中解压 SPZ 头，生成前导字节
+    size_t headSize = static_cast<size_t>(std::min<uint64_t>(inputSize, window.size()));
+    size_t got = 0;
+    off_t headOffset = offset;
+    if (!readFull(inFd, window.data(), headSize, seekable ? &headOffset : nullptr, got)) {
+        return SpzResult::error(SpzErrorCode::FailedToReadSpzFile, "Failed to read SPZ input");
+    }
+    if (got < headSize) {
+        return SpzResult::error(SpzErrorCode::FailedToReadSpzFile,
+            "SPZ input ended after " + std::to_string(got) + " of " + std::to_string(inputSize) + " bytes");
+    }
+    std::span<const uint8_t> head(window.data(), headSize);
+    if (seekable && headSize < inputSize) {
+        // 只解压头部时发现不了截断：先读出末尾的 gzip ISIZE 与头部隐含的长度比较，再开始写出
+        uint8_t tail[4];
+        size_t tailGot = 0;
+        off_t tailOffset = offset + static_cast<off_t>(inputSize - sizeof(tail));
+        auto prefix = inflateSpzPrefix(head, sizeof(SpzHeader));
+        SpzHeader header;
+        if (!readFull(inFd, tail, sizeof(tail), &tailOffset, tailGot) || tailGot < sizeof(tail)) {
+            return SpzResult::error(SpzErrorCode::FailedToReadSpzFile, "Failed to read SPZ input");
+        }
+        if (prefix.success && parseSpzHeader(prefix.data, header)) {
+            auto checked = checkSpzLength(head, tail, inputSize, header);
+            if (!checked.success) {
+                return checked;
+            }
+        }
+    }
+    auto preamble = buildGlbPreamble(head, inputSize, layout, options);
+    if (!preamble.success) {
+        return preamble;
+    }
+    if (options.verbose) {
+        std::cout << "[INFO] Streaming " << (inputSize / 1024.0 / 1024.0) << " MB of SPZ data" << std::endl;
+    }
+
+    // 步骤 3: 前导字节 + 负载 + BIN 填充；普通文件从头再拷贝，管道先写出已读的窗口再接着拷贝
+    auto writeFailed = [] {
+        return SpzResult::error(SpzErrorCode::CannotOpenOutputFile, "Failed to write GLB stream");
+    };
+    if (!writeAll(outFd, preamble.data.data(), preamble.data.size())) {
+        return writeFailed();
+    }
+    uint64_t copied = 0;
+    if (seekable) {
+        if (!pump(inFd, outFd, inputSize, &offset, window, copied)) {
+            return writeFailed();
+        }
+    } else {
+        if (!writeAll(outFd, window.data(), headSize) ||
+            !pump(inFd, outFd, inputSize - headSize, nullptr, window, copied)) {
+            return writeFailed();
+        }
+        copied += headSize;
+        uint8_t extra = 0;
+        size_t extraBytes = 0;
+        if (copied == inputSize && readFull(inFd, &extra, 1, nullptr, extraBytes) && extraBytes > 0) {
+            return SpzResult::error(SpzErrorCode::FailedToReadSpzFile,
+                "SPZ input is longer than the given size of " + std::to_string(inputSize) + " bytes");
+        }
+    }
+    if (copied != inputSize) {
+        return SpzResult::error(SpzErrorCode::FailedToReadSpzFile,
+            "SPZ input ended after " + std::to_string(copied) + " of " + std::to_string(inputSize) + " bytes");
+    }
+    static const uint8_t zeros[4] = {0, 0, 0, 0};
+    if (!writeAll(outFd, zeros, layout.binPadding)) {
+        return writeFailed();
+    }
+    return SpzResult::ok({});
+}
+
+}  // namespace spz2glb
+
+#endif  // _WIN32
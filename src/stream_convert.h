@@ -0,0 +1,46 @@
+// Copyright (c) 2026 Pu Junhan
+// SPDX-License-Identifier: MIT
+// Project: SPZ-ecosystem
+// Repository: https://github.com/spz-ecosystem/spz2glb
+//
+// 管道流式转换（spz2glb - -）
+// 从 stdin 读 SPZ、向 stdout 写 GLB，内存中只保留固定大小的窗口，
+// 多 GB 的输入也不会整个读入内存；适用于从对象存储经管道拉取数据的流水线
+
+#ifndef SPZ2GLB_STREAM_CONVERT_H_
+#define SPZ2GLB_STREAM_CONVERT_H_
+
+#ifndef _WIN32
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#include "spz_converter.h"
+
+namespace spz2glb {
+
+constexpr size_t kStreamWindowBytes = 1 << 20;  // 读写窗口，也是用于解析 SPZ 头的最大前缀
+constexpr uint64_t kUnknownStreamSize = std::numeric_limits<uint64_t>::max();
+
+/**
+ * 从 inFd 读 SPZ 压缩流，向 outFd 写 GLB（压缩模式，负载原样）
+ *
+ * GLB 头里要先写出 BIN 长度，之后才是负载，因此需要在写出前知道输入长度：
+ * - inFd 是普通文件：长度由 fstat 得到，负载用 sendfile 直接从 inFd 拷贝
+ * - 管道且 inputSize 已知（如对象存储的 Content-Length）：读入第一个窗口解析 SPZ 头，写出前导字节后
+ *   边读边写（Linux 下 splice，不经过用户态），读到的字节数与 inputSize 不符时报错
+ * - 管道且长度未知：先以窗口为单位转存到 $TMPDIR 下已删除的临时文件，再按普通文件处理
+ *
+ * 无论哪种情况，用户态只分配一个 kStreamWindowBytes 的窗口
+ *
+ * @param inputSize 输入字节数，kUnknownStreamSize 表示未知
+ */
+SpzResult convertSpzStream(int inFd, int outFd, GlbLayout& layout, const ConvertOptions& options = {},
+                           uint64_t inputSize = kUnknownStreamSize);
+
+}  // namespace spz2glb
+
+#endif  // _WIN32
+
+#endif  // SPZ2GLB_STREAM_CONVERT_H_
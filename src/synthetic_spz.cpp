@@ -0,0 +1,344 @@
+// Copyright (c) 2026 Pu Junhan
+// SPDX-License-Identifier: MIT
+// Project: SPZ-ecosystem
+// Repository: https://github.com/spz-ecosystem/spz2glb
+//
+// 确定性合成 SPZ 数据实现
+
+#include "synthetic_spz.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <zlib.h>
+
+#include "deflate_codec.h"
+#include "splat_data.h"
+#include "thread_pool.h"
+
+namespace spz2glb {
+
+namespace {
+
+constexpr uint32_t kFractionalBits = 12;
+constexpr uint32_t kGroups = 64;  // 团簇 / 曲面 / 颜色基调的数量
+
+// 每个属性使用独立的随机流，互不影响
+enum Stream : uint64_t { kGroup = 1, kPosition, kAlpha, kColor, kScale, kRotation, kSh, kGroupShape };
+
+inline uint64_t splitmix64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+/**
+ * 计数器式随机数：只取决于 (seed, index, stream, k)，与生成顺序无关
+ */
+inline uint64_t random64(uint64_t seed, uint64_t index, uint64_t stream, uint64_t k = 0) {
+    return splitmix64(splitmix64(seed ^ (stream << 56) ^ (k << 48)) ^ index);
+}
+
+// [0, 1)
+inline float uniform(uint64_t seed, uint64_t index, uint64_t stream, uint64_t k = 0) {
+    return static_cast<float>(random64(seed, index, stream, k) >> 40) * (1.0f / 16777216.0f);
+}
+
+// 近似标准正态（4 个均匀数之和）
+inline float gaussian(uint64_t seed, uint64_t index, uint64_t stream, uint64_t k = 0) {
+    uint64_t r = random64(seed, index, stream, k);
+    float sum = 0;
+    for (int i = 0; i < 4; ++i) {
+        sum += static_cast<float>((r >> (i * 16)) & 0xFFFF) * (1.0f / 65536.0f);
+    }
+    return (sum - 2.0f) * 1.7320508f;
+}
+
+inline uint8_t clampByte(float value) {
+    return static_cast<uint8_t>(std::clamp(std::lround(value), 0l, 255l));
+}
+
+uint32_t groupOf(const SyntheticSpzParams& params, uint64_t index) {
+    return static_cast<uint32_t>(random64(params.seed, index, kGroup) % kGroups);
+}
+
+void pointPosition(const SyntheticSpzParams& params, uint64_t index, float xyz[3]) {
+    const uint64_t seed = params.seed;
+    switch (params.distribution) {
+        case SplatDistribution::Uniform:
+            for (int a = 0; a < 3; ++a) xyz[a] = uniform(seed, index, kPosition, a) * 20.0f - 10.0f;
+            return;
+        case SplatDistribution::Clustered: {
+            uint32_t group = groupOf(params, index);
+            for (int a = 0; a < 3; ++a) {
+                float center = uniform(seed, group, kGroupShape, a) * 40.0f - 20.0f;
+                xyz[a] = center + gaussian(seed, index, kPosition, a) * 0.6f;
+            }
+            return;
+        }
+        case SplatDistribution::Surface: {
+            // 球面上的点，法向方向有少量噪声
+            uint32_t group = groupOf(params, index);
+            float radius = 1.0f + uniform(seed, group, kGroupShape, 3) * 5.0f;
+            float dir[3];
+            float norm = 0;
+            for (int a = 0; a < 3; ++a) {
+                dir[a] = gaussian(seed, index, kPosition, a);
+                norm += dir[a] * dir[a];
+            }
+            norm = norm > 0 ? 1.0f / std::sqrt(norm) : 0.0f;
+            float r = radius * (1.0f + 0.01f * gaussian(seed, index, kPosition, 3));
+            for (int a = 0; a < 3; ++a) {
+                float center = uniform(seed, group, kGroupShape, a) * 40.0f - 20.0f;
+                xyz[a] = center + dir[a] * norm * r;
+            }
+            return;
+        }
+    }
+}
+
+void writeRotation(const SyntheticSpzParams& params, uint64_t index, uint8_t* out) {
+    float q[4];
+    float norm = 0;
+    for (int k = 0; k < 4; ++k) {
+        q[k] = gaussian(params.seed, index, kRotation, k);
+        norm += q[k] * q[k];
+    }
+    norm = norm > 0 ? 1.0f / std::sqrt(norm) : 0.0f;
+    for (float& c : q) c *= norm;
+
+    if (params.version < 3) {
+        // xyz 各 1 字节，w 由解码器按单位长度恢复，因此取 w >= 0 的那一个
+        float sign = q[3] < 0 ? -1.0f : 1.0f;
+        for (int k = 0; k < 3; ++k) out[k] = clampByte((q[k] * sign + 1.0f) * 127.5f);
+        return;
+    }
+    // 最小三分量：最大分量取正并省略，其余三个从高下标到低下标各占 10 位（9 位幅值 + 符号）
+    int largest = 0;
+    for (int k = 1; k < 4; ++k) {
+        if (std::fabs(q[k]) > std::fabs(q[largest])) largest = k;
+    }
+    float sign = q[largest] < 0 ? -1.0f : 1.0f;
+    uint32_t packed = static_cast<uint32_t>(largest) << 30;
+    int shift = 0;
+    for (int k = 3; k >= 0; --k) {
+        if (k == largest) continue;
+        float value = q[k] * sign;
+        uint32_t magnitude = static_cast<uint32_t>(
+            std::min(511l, std::lround(std::fabs(value) / 0.70710678f * 511.0f)));
+        packed |= (magnitude | (value < 0 ? 0x200u : 0u)) << shift;
+        shift += 10;
+    }
+    std::memcpy(out, &packed, 4);
+}
+
+}  // anonymous namespace
+
+bool parseSplatDistribution(const std::string& name, SplatDistribution& distribution) {
+    if (name == "uniform") {
+        distribution = SplatDistribution::Uniform;
+    } else if (name == "clustered") {
+        distribution = SplatDistribution::Clustered;
+    } else if (name == "surface") {
+        distribution = SplatDistribution::Surface;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char* splatDistributionName(SplatDistribution distribution) {
+    switch (distribution) {
+        case SplatDistribution::Uniform: return "uniform";
+        case SplatDistribution::Clustered: return "clustered";
+        case SplatDistribution::Surface: return "surface";
+    }
+    return "unknown";
+}
+
+bool parseSplatCount(const std::string& text, uint64_t& count) {
+    if (text.empty()) return false;
+    std::string digits = text;
+    uint64_t scale = 1;
+    char suffix = static_cast<char>(std::toupper(static_cast<unsigned char>(digits.back())));
+    if (suffix == 'K' || suffix == 'M') {
+        scale = suffix == 'K' ? 1'000 : 1'000'000;
+        digits.pop_back();
+    }
+    if (digits.empty() || digits.find_first_not_of("0123456789") != std::string::npos || digits.size() > 12) {
+        return false;
+    }
+    count = std::stoull(digits) * scale;
+    return true;
+}
+
+size_t sectionBytesPerPoint(const SyntheticSpzParams& params, SpzSection section) {
+    return spzSectionStride(params.version, params.shDegree, section);
+}
+
+std::vector<uint8_t> syntheticSpzHeader(const SyntheticSpzParams& params) {
+    std::vector<uint8_t> header(kSpzHeaderBytes, 0);
+    uint32_t words[3] = {kSpzMagic, params.version, static_cast<uint32_t>(params.numPoints)};
+    std::memcpy(header.data(), words, sizeof(words));
+    header[12] = static_cast<uint8_t>(params.shDegree);
+    header[13] = static_cast<uint8_t>(kFractionalBits);
+    return header;
+}
+
+void synthesizeSection(const SyntheticSpzParams& params, SpzSection section, uint64_t first, size_t count,
+                       uint8_t* out) {
+    const uint64_t seed = params.seed;
+    const size_t stride = sectionBytesPerPoint(params, section);
+    for (size_t i = 0; i < count; ++i) {
+        const uint64_t index = first + i;
+        uint8_t* p = out + i * stride;
+        switch (section) {
+            case SpzSection::Positions: {
+                float xyz[3];
+                pointPosition(params, index, xyz);
+                for (int a = 0; a < 3; ++a) {
+                    int32_t fixed = static_cast<int32_t>(std::clamp<long>(
+                        std::lround(xyz[a] * (1 << kFractionalBits)), -0x7FFFFF, 0x7FFFFF));
+                    p[a * 3] = static_cast<uint8_t>(fixed);
+                    p[a * 3 + 1] = static_cast<uint8_t>(fixed >> 8);
+                    p[a * 3 + 2] = static_cast<uint8_t>(fixed >> 16);
+                }
+                break;
+            }
+            case SpzSection::Alphas:
+                p[0] = clampByte(160.0f + gaussian(seed, index, kAlpha) * 50.0f);
+                break;
+            case SpzSection::Colors: {
+                // 每组一个基调色，加少量噪声
+                uint32_t group = groupOf(params, index);
+                for (int c = 0; c < 3; ++c) {
+                    float base = 40.0f + uniform(seed, group, kGroupShape, 4 + c) * 175.0f;
+                    p[c] = clampByte(base + gaussian(seed, index, kColor, c) * 12.0f);
+                }
+                break;
+            }
+            case SpzSection::Scales:
+                // 对数尺度 (byte / 16 - 10) 约在 -5 ± 1 之间
+                for (int a = 0; a < 3; ++a) p[a] = clampByte((5.0f + gaussian(seed, index, kScale, a)) * 16.0f);
+                break;
+            case SpzSection::Rotations:
+                writeRotation(params, index, p);
+                break;
+            case SpzSection::Sh:
+                // 高阶系数量化为 128 ± 小幅度，与真实场景一样集中在零附近
+                for (size_t k = 0; k < stride; ++k) p[k] = clampByte(128.0f + gaussian(seed, index, kSh, k) * 6.0f);
+                break;
+        }
+    }
+}
+
+uint64_t syntheticInflatedSize(const SyntheticSpzParams& params) {
+    uint64_t bytesPerPoint = 0;
+    for (SpzSection section : kSpzSections) bytesPerPoint += sectionBytesPerPoint(params, section);
+    return kSpzHeaderBytes + params.numPoints * bytesPerPoint;
+}
+
+void synthesizeRange(const SyntheticSpzParams& params, uint64_t offset, size_t size, uint8_t* out) {
+    const uint64_t end = offset + size;
+    if (offset < kSpzHeaderBytes) {
+        auto header = syntheticSpzHeader(params);
+        size_t n = static_cast<size_t>(std::min<uint64_t>(end, kSpzHeaderBytes) - offset);
+        std::memcpy(out, header.data() + offset, n);
+    }
+
+    std::vector<uint8_t> edge;
+    uint64_t sectionBegin = kSpzHeaderBytes;
+    for (SpzSection section : kSpzSections) {
+        const uint64_t stride = sectionBytesPerPoint(params, section);
+        const uint64_t sectionEnd = sectionBegin + params.numPoints * stride;
+        const uint64_t lo = std::max(offset, sectionBegin);
+        const uint64_t hi = std::min(end, sectionEnd);
+        if (lo < hi) {
+            // 覆盖到的点（首尾可能只覆盖一部分）生成到临时区，再复制需要的字节
+            uint64_t firstPoint = (lo - sectionBegin) / stride;
+            uint64_t lastPoint = (hi - sectionBegin + stride - 1) / stride;
+            edge.resize(static_cast<size_t>((lastPoint - firstPoint) * stride));
+            synthesizeSection(params, section, firstPoint, static_cast<size_t>(lastPoint - firstPoint), edge.data());
+            std::memcpy(out + (lo - offset), edge.data() + (lo - sectionBegin - firstPoint * stride),
+                        static_cast<size_t>(hi - lo));
+        }
+        sectionBegin = sectionEnd;
+    }
+}
+
+bool writeSyntheticSpz(const SyntheticSpzParams& params, ThreadPool* pool,
+                       const std::function<bool(std::span<const uint8_t>)>& sink, std::string& error) {
+    if (params.version < 2 || params.version > 3 || params.shDegree > 3 || params.gzipLevel < 0 ||
+        params.gzipLevel > 9 || params.numPoints > std::numeric_limits<uint32_t>::max()) {
+        error = "Invalid synthetic SPZ parameters";
+        return false;
+    }
+
+    const uint64_t total = syntheticInflatedSize(params);
+    const uint64_t chunks = (total + kSyntheticChunkBytes - 1) / kSyntheticChunkBytes;
+    // 一批并行处理的块数：内存中最多保留这么多块的解压与压缩数据
+    const size_t batch = pool != nullptr ? std::max<size_t>(pool->size(), 1) * 2 : 1;
+
+    // gzip 头：无文件名、mtime 为 0、OS 未知（同 repackGzipBlocks），输出只由参数决定
+    static const uint8_t kGzipHeader[10] = {0x1f, 0x8b, 8, 0, 0, 0, 0, 0, 0, 0xff};
+    if (!sink(kGzipHeader)) {
+        error = "Failed to write synthetic SPZ data";
+        return false;
+    }
+
+    std::vector<std::vector<uint8_t>> packed(batch);
+    std::vector<uLong> crcs(batch);
+    std::vector<std::string> errors(batch);
+    uLong crc = ::crc32(0L, Z_NULL, 0);
+    for (uint64_t first = 0; first < chunks; first += batch) {
+        const size_t count = static_cast<size_t>(std::min<uint64_t>(batch, chunks - first));
+        parallelFor(pool, count, [&](size_t i) {
+            uint64_t chunk = first + i;
+            uint64_t offset = chunk * kSyntheticChunkBytes;
+            size_t size = static_cast<size_t>(std::min<uint64_t>(kSyntheticChunkBytes, total - offset));
+            std::vector<uint8_t> inflated(size);
+            synthesizeRange(params, offset, size, inflated.data());
+            crcs[i] = ::crc32(::crc32(0L, Z_NULL, 0), inflated.data(), static_cast<uInt>(size));
+            packed[i].clear();
+            zlibCodec().deflateRaw(inflated, params.gzipLevel, chunk + 1 == chunks, packed[i], errors[i]);
+        });
+        for (size_t i = 0; i < count; ++i) {
+            if (!errors[i].empty()) {
+                error = errors[i];
+                return false;
+            }
+            uint64_t size = std::min<uint64_t>(kSyntheticChunkBytes, total - (first + i) * kSyntheticChunkBytes);
+            crc = crc32_combine(crc, crcs[i], static_cast<z_off_t>(size));
+            if (!sink(packed[i])) {
+                error = "Failed to write synthetic SPZ data";
+                return false;
+            }
+        }
+    }
+
+    // gzip 尾：CRC-32 与 ISIZE（解压长度 mod 2^32），小端序
+    uint8_t trailer[8];
+    for (int b = 0; b < 4; ++b) {
+        trailer[b] = static_cast<uint8_t>(crc >> (8 * b));
+        trailer[4 + b] = static_cast<uint8_t>(total >> (8 * b));
+    }
+    if (!sink(trailer)) {
+        error = "Failed to write synthetic SPZ data";
+        return false;
+    }
+    return true;
+}
+
+bool generateSyntheticSpz(const SyntheticSpzParams& params, std::vector<uint8_t>& spz, std::string& error,
+                          ThreadPool* pool) {
+    spz.clear();
+    return writeSyntheticSpz(params, pool, [&spz](std::span<const uint8_t> bytes) {
+        spz.insert(spz.end(), bytes.begin(), bytes.end());
+        return true;
+    }, error);
+}
+
+}  // namespace spz2glb
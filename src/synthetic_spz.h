@@ -0,0 +1,92 @@
+// Copyright (c) 2026 Pu Junhan
+// SPDX-License-Identifier: MIT
+// Project: SPZ-ecosystem
+// Repository: https://github.com/spz-ecosystem/spz2glb
+//
+// 确定性合成 SPZ 数据（基准测试与压力测试用，不依赖真实采集）
+// 每个点的每个属性只由 (seed, 点下标) 决定，可以任意分段、并行生成，结果逐字节相同
+
+#ifndef SPZ2GLB_SYNTHETIC_SPZ_H_
+#define SPZ2GLB_SYNTHETIC_SPZ_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "spz_decoder.h"
+
+namespace spz2glb {
+
+class ThreadPool;
+
+/**
+ * 点的空间分布
+ */
+enum class SplatDistribution {
+    Uniform,    // 立方体内均匀分布
+    Clustered,  // 围绕若干中心的团簇
+    Surface     // 贴近若干曲面（类似真实场景的物体表面）
+};
+
+bool parseSplatDistribution(const std::string& name, SplatDistribution& distribution);
+const char* splatDistributionName(SplatDistribution distribution);
+
+// 点数，可带 K / M 后缀（"250K"、"50M"）
+bool parseSplatCount(const std::string& text, uint64_t& count);
+
+struct SyntheticSpzParams {
+    uint64_t seed = 1;
+    uint64_t numPoints = 1000;
+    uint32_t version = 2;  // 2 或 3（v3 旋转为 32 位最小三分量编码）
+    uint32_t shDegree = 0;
+    SplatDistribution distribution = SplatDistribution::Uniform;
+    int gzipLevel = 6;  // zlib 压缩级别 0-9
+};
+
+// 每个点在该段中的字节数
+size_t sectionBytesPerPoint(const SyntheticSpzParams& params, SpzSection section);
+
+// 16 字节 SPZ 头（小端，与 SpzHeader 相同布局）
+std::vector<uint8_t> syntheticSpzHeader(const SyntheticSpzParams& params);
+
+/**
+ * 生成 section 段中点 [first, first + count) 的字节，写入 out（count * sectionBytesPerPoint 字节）
+ */
+void synthesizeSection(const SyntheticSpzParams& params, SpzSection section, uint64_t first, size_t count,
+                       uint8_t* out);
+
+// 解压后的 SPZ 数据总字节数（16 字节头 + 各段）
+uint64_t syntheticInflatedSize(const SyntheticSpzParams& params);
+
+/**
+ * 生成解压数据中 [offset, offset + size) 的字节，写入 out；范围可以跨越头与各段的边界
+ */
+void synthesizeRange(const SyntheticSpzParams& params, uint64_t offset, size_t size, uint8_t* out);
+
+// 流式生成时每块的解压字节数
+constexpr uint64_t kSyntheticChunkBytes = 4 << 20;
+
+/**
+ * 流式生成 SPZ 文件（gzip 压缩），按顺序把输出交给 sink
+ *
+ * 每 kSyntheticChunkBytes 解压字节一块，在 pool 上并行生成并压缩为独立的 raw deflate 块
+ * （同 repackGzipBlocks），拼成单成员 gzip。内存中最多同时保留 2 × 线程数块，
+ * 输出只由参数决定，与线程数无关
+ *
+ * @return sink 返回 false 或压缩失败时为 false
+ */
+bool writeSyntheticSpz(const SyntheticSpzParams& params, ThreadPool* pool,
+                       const std::function<bool(std::span<const uint8_t>)>& sink, std::string& error);
+
+/**
+ * 在内存中生成完整的 SPZ 文件，与 writeSyntheticSpz 的输出相同
+ */
+bool generateSyntheticSpz(const SyntheticSpzParams& params, std::vector<uint8_t>& spz, std::string& error,
+                          ThreadPool* pool = nullptr);
+
+}  // namespace spz2glb
+
+#endif  // SPZ2GLB_SYNTHETIC_SPZ_H_
@@ -0,0 +1,158 @@
+// Copyright (c) 2026 Pu Junhan
+// SPDX-License-Identifier: MIT
+// Project: SPZ-ecosystem
+// Repository: https://github.com/spz-ecosystem/spz2glb
+//
+// 工作窃取线程池实现
+
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <latch>
+
+#include "memory_pool.h"
+
+namespace spz2glb {
+
+ThreadPool::ThreadPool(size_t threads) {
+    if (threads == 0) {
+        threads = std::thread::hardware_concurrency();
+        if (threads == 0) threads = 1;
+    }
+
+    queues_.reserve(threads);
+    for (size_t i = 0; i < threads; ++i) {
+        queues_.push_back(std::make_unique<WorkerQueue>());
+    }
+
+    workers_.reserve(threads);
+    for (size_t i = 0; i < threads; ++i) {
+        workers_.emplace_back([this, i] { workerLoop(i); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(stateMutex_);
+        stopping_ = true;
+    }
+    workAvailable_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+void ThreadPool::submit(Task task) {
+    size_t index = nextQueue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+    {
+        std::lock_guard<std::mutex> lock(queues_[index]->mutex);
+        queues_[index]->tasks.push_back(std::move(task));
+    }
+    pending_.fetch_add(1);
+    queued_.fetch_add(1);
+    // 与 workerLoop 中先登记 sleeping_ 再检查 queued_ 配对（均为顺序一致）：
+    // 要么这里看到有线程在休眠并唤醒它，要么该线程入睡前就能看到新任务
+    if (sleeping_.load() > 0) {
+        std::lock_guard<std::mutex> lock(stateMutex_);
+        workAvailable_.notify_one();
+    }
+}
+
+void parallelFor(ThreadPool* pool, size_t count, const std::function<void(size_t)>& body) {
+    if (pool == nullptr || count <= 1) {
+        for (size_t i = 0; i < count; ++i) body(i);
+        return;
+    }
+
+    // 共享状态由 shared_ptr 持有：领不到下标的辅助任务可能在本函数返回后才开始执行
+    struct State {
+        std::atomic<size_t> next{0};
+        size_t count = 0;
+        const std::function<void(size_t)>* body = nullptr;
+        MemoryStage stage = MemoryStage::None;  // 辅助任务的分配计入调用方所在的阶段
+        std::latch done;                        // 每完成一个下标减一
+
+        explicit State(size_t n) : count(n), done(static_cast<std::ptrdiff_t>(n)) {}
+    };
+    auto state = std::make_shared<State>(count);
+    state->body = &body;
+    state->stage = currentMemoryStage();
+
+    auto work = [](State& s) {
+        MemoryStageScope memoryStage(s.stage);
+        size_t finished = 0;
+        for (size_t i; (i = s.next.fetch_add(1, std::memory_order_relaxed)) < s.count;) {
+            (*s.body)(i);
+            finished++;
+        }
+        if (finished > 0) {
+            s.done.count_down(static_cast<std::ptrdiff_t>(finished));
+        }
+    };
+
+    size_t helpers = std::min(pool->size(), count - 1);
+    for (size_t h = 0; h < helpers; ++h) {
+        pool->submit([state, work] { work(*state); });
+    }
+    work(*state);
+    state->done.wait();
+}
+
+void ThreadPool::wait() {
+    std::unique_lock<std::mutex> lock(stateMutex_);
+    allDone_.wait(lock, [this] { return pending_.load() == 0; });
+}
+
+bool ThreadPool::reserveTask() {
+    size_t queued = queued_.load();
+    while (queued > 0) {
+        if (queued_.compare_exchange_weak(queued, queued - 1)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ThreadPool::popTask(size_t index, Task& task) {
+    // 先取自己的队列，再按顺序窃取其他队列
+    for (size_t offset = 0; offset < queues_.size(); ++offset) {
+        auto& queue = *queues_[(index + offset) % queues_.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.tasks.empty()) {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::workerLoop(size_t index) {
+    for (;;) {
+        if (!reserveTask()) {
+            std::unique_lock<std::mutex> lock(stateMutex_);
+            sleeping_.fetch_add(1);
+            bool reserved = false;
+            workAvailable_.wait(lock, [&] { return (reserved = reserveTask()) || stopping_; });
+            sleeping_.fetch_sub(1);
+            if (!reserved) {
+                return;  // stopping_ 且已无任务
+            }
+        }
+
+        // 已预留一个任务，队列中必然能取到
+        Task task;
+        while (!popTask(index, task)) {
+            std::this_thread::yield();
+        }
+        task();
+
+        if (pending_.fetch_sub(1) == 1) {
+            // 只有最后一个任务完成时才加锁，唤醒 wait()
+            std::lock_guard<std::mutex> lock(stateMutex_);
+            allDone_.notify_all();
+        }
+    }
+}
+
+}  // namespace spz2glb
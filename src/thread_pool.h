@@ -0,0 +1,90 @@
+// Copyright (c) 2026 Pu Junhan
+// SPDX-License-Identifier: MIT
+// Project: SPZ-ecosystem
+// Repository: https://github.com/spz-ecosystem/spz2glb
+//
+// 工作窃取线程池
+// 每个工作线程有自己的任务队列，空闲线程从其他线程的队列中窃取任务
+
+#ifndef SPZ2GLB_THREAD_POOL_H_
+#define SPZ2GLB_THREAD_POOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace spz2glb {
+
+/**
+ * 工作窃取线程池
+ *
+ * 调度规则：
+ * - submit() 按轮转把任务放到各工作线程队列的尾部
+ * - 工作线程从自己队列的头部取任务
+ * - 自己队列为空时，从其他线程队列的头部窃取
+ *
+ * 头部取、头部窃取意味着任务大致按提交顺序开始执行：
+ * 调用方按优先级（例如文件大小降序）提交，最重要的任务最先被处理，
+ * 不会因为窃取而被推迟到最后
+ */
+class ThreadPool {
+public:
+    using Task = std::function<void()>;
+
+    // threads 为 0 时使用 std::thread::hardware_concurrency()
+    explicit ThreadPool(size_t threads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void submit(Task task);
+
+    // 阻塞直到所有已提交任务执行完毕
+    void wait();
+
+    size_t size() const { return workers_.size(); }
+
+private:
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void workerLoop(size_t index);
+    bool reserveTask();  // queued_ 大于 0 时减一并返回 true
+    bool popTask(size_t index, Task& task);
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues_;
+    std::vector<std::thread> workers_;
+
+    // 计数都是原子量，提交与完成任务不加全局锁；stateMutex_ 只在线程休眠 / 唤醒时使用
+    std::mutex stateMutex_;
+    std::condition_variable workAvailable_;
+    std::condition_variable allDone_;
+    std::atomic<size_t> queued_{0};    // 已提交但尚未被取走的任务数
+    std::atomic<size_t> pending_{0};   // 已提交但尚未执行完毕的任务数
+    std::atomic<size_t> sleeping_{0};  // 正在等待任务的工作线程数
+    bool stopping_ = false;
+
+    std::atomic<size_t> nextQueue_{0};
+};
+
+/**
+ * 把 [0, count) 分给线程池与调用线程并行执行 body(i)，返回时全部完成
+ *
+ * 调用线程自己也领取下标，因此即使线程池的工作线程都在忙
+ * （例如在池内任务中再次调用）也不会死锁，只是退化为串行；
+ * pool 为空时直接在调用线程中串行执行
+ */
+void parallelFor(ThreadPool* pool, size_t count, const std::function<void(size_t)>& body);
+
+}  // namespace spz2glb
+
+#endif  // SPZ2GLB_THREAD_POOL_H_
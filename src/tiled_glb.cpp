@@ -0,0 +1,246 @@
+// Copyright (c) 2026 Pu Junhan
+// SPDX-License-Identifier: MIT
+// Project: SPZ-ecosystem
+// Repository: https://github.com/spz-ecosystem/spz2glb
+//
+// 分块 GLB 实现
+
+#include "tiled_glb.h"
+
+#include <algorithm>
+#include <charconv>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <optional>
+#include <zlib.h>
+
+#include <fastgltf/core.hpp>
+
+#include "gzip_index.h"
+#include "optimal_deflate.h"
+#include "spatial_order.h"
+#include "spz_converter.h"
+#include "spz_decoder.h"
+#include "thread_pool.h"
+
+namespace spz2glb {
+
+namespace {
+
+constexpr uint32_t kOctreeMaxDepth = 21;  // 与 Morton 键每轴的位数相同
+
+/**
+ * 把已排序键区间 [begin, end) 对应的八叉树节点细分到叶子，叶子按 Morton 顺序追加到 tiles
+ *
+ * 叶子只记录 path、点数与区间起点（暂存在 byteOffset），包围盒与负载之后并行生成
+ */
+void splitOctree(const std::vector<uint64_t>& keys, size_t begin, size_t end, uint32_t maxPoints,
+                 std::string& path, std::vector<SplatTile>& tiles) {
+    const uint32_t depth = static_cast<uint32_t>(path.size());
+    if (end - begin <= maxPoints || depth == kOctreeMaxDepth) {
+        SplatTile tile;
+        tile.path = path;
+        tile.numPoints = static_cast<uint32_t>(end - begin);
+        tile.byteOffset = begin;
+        tiles.push_back(std::move(tile));
+        return;
+    }
+    const unsigned shift = 3 * (kOctreeMaxDepth - 1 - depth);
+    size_t childBegin = begin;
+    for (uint32_t child = 0; child < 8 && childBegin < end; ++child) {
+        auto childEnd = std::partition_point(keys.begin() + childBegin, keys.begin() + end,
+                                             [&](uint64_t key) { return ((key >> shift) & 7) <= child; });
+        size_t next = static_cast<size_t>(childEnd - keys.begin());
+        if (next > childBegin) {
+            path.push_back(static_cast<char>('0' + child));
+            splitOctree(keys, childBegin, next, maxPoints, path, tiles);
+            path.pop_back();
+        }
+        childBegin = next;
+    }
+}
+
+void appendFloats(std::string& json, const std::array<float, 3>& values) {
+    json += '[';
+    for (size_t c = 0; c < 3; ++c) {
+        char buffer[32];
+        auto result = std::to_chars(buffer, buffer + sizeof(buffer), values[c]);
+        if (c > 0) json += ',';
+        json.append(buffer, result.ptr);
+    }
+    json += ']';
+}
+
+// 块信息 JSON 成员（node extras 与清单共用）
+std::string formatTile(const SplatTile& tile) {
+    std::string json = "\"path\":\"" + tile.path + "\",\"points\":" + std::to_string(tile.numPoints) + ",\"min\":";
+    appendFloats(json, tile.min);
+    json += ",\"max\":";
+    appendFloats(json, tile.max);
+    return json;
+}
+
+std::optional<std::string> writeTileExtras(std::size_t index, fastgltf::Category category, void* userPointer) {
+    const auto* glb = static_cast<const TiledGlb*>(userPointer);
+    if (category != fastgltf::Category::Nodes || index >= glb->tiles.size()) {
+        return std::nullopt;
+    }
+    return "{\"spz2glb:tile\":{" + formatTile(glb->tiles[index]) + "}}";
+}
+
+}  // anonymous namespace
+
+SpzResult buildTiledGlb(std::span<const uint8_t> spzData, TiledGlb& glb, const ConvertOptions& options) {
+    auto inflated = decompressSpzData(spzData);
+    if (!inflated.success) {
+        return inflated;
+    }
+    std::string error;
+    AlignedArray<float> positions;
+    if (!decodeSpzPositions(inflated.data, positions, error, options.pool)) {
+        return SpzResult::error(SpzErrorCode::ConversionFailed, "Tiling: " + error);
+    }
+    const size_t n = positions.size() / 3;
+    if (n == 0) {
+        return SpzResult::error(SpzErrorCode::ConversionFailed, "Tiling requires at least one point");
+    }
+    glb.numPoints = static_cast<uint32_t>(n);
+
+    std::vector<uint32_t> order;
+    std::vector<uint64_t> keys;
+    computeSpatialOrder(positions.span(), SpatialCurve::Morton, options.pool, order, &keys);
+
+    glb.tiles.clear();
+    std::string path;
+    splitOctree(keys, 0, n, std::max<uint32_t>(options.tilePoints, 1), path, glb.tiles);
+    keys = std::vector<uint64_t>();
+
+    // 每块：包围盒、收集点、压缩，块之间并行（单块内部串行压缩）
+    const int level = options.recompress ? kMaxRatioLevel : Z_BEST_COMPRESSION;
+    std::vector<std::string> errors(glb.tiles.size());
+    parallelFor(options.pool, glb.tiles.size(), [&](size_t t) {
+        SplatTile& tile = glb.tiles[t];
+        std::span<const uint32_t> indices(order.data() + tile.byteOffset, tile.numPoints);
+        tile.min.fill(std::numeric_limits<float>::max());
+        tile.max.fill(std::numeric_limits<float>::lowest());
+        for (uint32_t i : indices) {
+            for (size_t c = 0; c < 3; ++c) {
+                tile.min[c] = std::min(tile.min[c], positions[static_cast<size_t>(i) * 3 + c]);
+                tile.max[c] = std::max(tile.max[c], positions[static_cast<size_t>(i) * 3 + c]);
+            }
+        }
+        std::vector<uint8_t> body;
+        if (!extractSpzPoints(inflated.data, indices, body, errors[t]) ||
+            !compressGzip(body, level, nullptr, tile.payload, errors[t], options.cancel)) {
+            return;
+        }
+        tile.byteLength = tile.payload.size();
+        tile.payload.resize((tile.payload.size() + 3) & ~size_t{3}, 0);
+    });
+    for (const auto& message : errors) {
+        if (!message.empty()) {
+            return SpzResult::error(SpzErrorCode::ConversionFailed, "Tiling: " + message);
+        }
+    }
+
+    glb.min.fill(std::numeric_limits<float>::max());
+    glb.max.fill(std::numeric_limits<float>::lowest());
+    glb.segments.clear();
+    uint64_t binSize = 0;
+    for (auto& tile : glb.tiles) {
+        for (size_t c = 0; c < 3; ++c) {
+            glb.min[c] = std::min(glb.min[c], tile.min[c]);
+            glb.max[c] = std::max(glb.max[c], tile.max[c]);
+        }
+        tile.byteOffset = binSize;
+        binSize += tile.payload.size();
+        glb.segments.push_back(tile.payload);
+    }
+    if (options.verbose) {
+        std::cout << "[INFO] Tiled " << n << " points into " << glb.tiles.size() << " tiles (max "
+                  << options.tilePoints << " points per tile): " << spzData.size() << " -> " << binSize
+                  << " bytes" << std::endl;
+    }
+
+    // glTF 资产：每块一个 bufferView / mesh / node
+    fastgltf::Asset asset = createSplatAsset(true);
+    addGlbBinBuffer(asset, binSize);
+
+    fastgltf::Scene scene;
+    for (size_t t = 0; t < glb.tiles.size(); ++t) {
+        const SplatTile& tile = glb.tiles[t];
+        fastgltf::BufferView view;
+        view.bufferIndex = 0;
+        view.byteOffset = tile.byteOffset;
+        view.byteLength = tile.byteLength;
+        asset.bufferViews.emplace_back(std::move(view));
+
+        fastgltf::Primitive primitive;
+        primitive.type = fastgltf::PrimitiveType::Points;
+        auto gaussianSplat = std::make_unique<fastgltf::GaussianSplatExtension>();
+        auto spzCompression = std::make_unique<fastgltf::GaussianSplatSpzCompression>();
+        spzCompression->bufferView = t;
+        gaussianSplat->spzCompression = std::move(spzCompression);
+        primitive.gaussianSplat = std::move(gaussianSplat);
+
+        fastgltf::Mesh mesh;
+        mesh.primitives.emplace_back(std::move(primitive));
+        asset.meshes.emplace_back(std::move(mesh));
+
+        fastgltf::Node node;
+        node.meshIndex = t;
+        std::string name = "tile" + (tile.path.empty() ? std::string() : "_" + tile.path);
+        node.name.assign(name.data(), name.size());
+        asset.nodes.emplace_back(std::move(node));
+        scene.nodeIndices.emplace_back(t);
+    }
+    asset.scenes.emplace_back(std::move(scene));
+    asset.defaultScene = 0;
+
+    GlbJsonExporter exporter;
+    exporter.setExtrasWriteCallback(writeTileExtras);
+    exporter.setUserPointer(&glb);
+    std::string json;
+    auto exportError = exporter.writeBinaryJson(asset, json);
+    if (exportError != fastgltf::Error::None) {
+        return SpzResult::error(SpzErrorCode::ConversionFailed,
+            "GLB export failed: " + std::string(fastgltf::getErrorMessage(exportError)));
+    }
+    if (!finishGlbPreamble(json, binSize, glb.layout, glb.preamble, error)) {
+        return SpzResult::error(SpzErrorCode::ConversionFailed, error);
+    }
+    return SpzResult::ok({});
+}
+
+bool writeTilesetManifest(const std::string& path, const std::string& glbUri, const TiledGlb& glb,
+                          std::string& error) {
+    std::string json = "{\"asset\":{\"generator\":\"spz2glb\"},\"glb\":\"";
+    for (char c : glbUri) {
+        if (c == '"' || c == '\\') json += '\\';
+        json += c;
+    }
+    json += "\",\"points\":" + std::to_string(glb.numPoints) + ",\"min\":";
+    appendFloats(json, glb.min);
+    json += ",\"max\":";
+    appendFloats(json, glb.max);
+    json += ",\"tiles\":[";
+    for (size_t t = 0; t < glb.tiles.size(); ++t) {
+        const SplatTile& tile = glb.tiles[t];
+        json += t > 0 ? ",\n" : "\n";
+        // byteOffset 相对于 GLB 文件开头，可以直接用于 Range 请求
+        json += "{\"node\":" + std::to_string(t) + "," + formatTile(tile) +
+                ",\"byteOffset\":" + std::to_string(glb.layout.preambleSize + tile.byteOffset) +
+                ",\"byteLength\":" + std::to_string(tile.byteLength) + "}";
+    }
+    json += "\n]}\n";
+
+    std::ofstream file(path, std::ios::binary);
+    if (!file || !file.write(json.data(), static_cast<std::streamsize>(json.size()))) {
+        error = "Failed to write tileset manifest: " + path;
+        return false;
+    }
+    return true;
+}
+
+}  // namespace spz2glb
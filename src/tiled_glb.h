@@ -0,0 +1,76 @@
+// Copyright (c) 2026 Pu Junhan
+// SPDX-License-Identifier: MIT
+// Project: SPZ-ecosystem
+// Repository: https://github.com/spz-ecosystem/spz2glb
+//
+// 分块 GLB（--tile）
+// 按八叉树把泼溅点切成若干块，每块是独立的 SPZ 压缩流、独立的 primitive 与 node，
+// 查看器可以只下载、解码视野内的块，大场景不必整体加载后才开始渲染
+
+#ifndef SPZ2GLB_TILED_GLB_H_
+#define SPZ2GLB_TILED_GLB_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "glb_writer.h"
+
+struct SpzResult;
+
+namespace spz2glb {
+
+struct ConvertOptions;
+
+/**
+ * 一个八叉树叶子块
+ */
+struct SplatTile {
+    std::string path;             // 从根到该叶子每层的子节点序号（'0'~'7'），只有一块时为空
+    uint32_t numPoints = 0;
+    std::array<float, 3> min = {};  // 块内点位置的紧包围盒
+    std::array<float, 3> max = {};
+    std::vector<uint8_t> payload;  // 该块的 SPZ gzip 流，末尾补零到 4 字节对齐
+    uint64_t byteLength = 0;       // gzip 流本身的长度（不含对齐填充）
+    uint64_t byteOffset = 0;       // 在 BIN 中的偏移
+};
+
+/**
+ * 分块 GLB 的内存表示：segments 依次指向各块的 payload
+ */
+struct TiledGlb : SegmentedGlb {
+    uint32_t numPoints = 0;
+    std::array<float, 3> min = {};
+    std::array<float, 3> max = {};
+    std::vector<SplatTile> tiles;  // 按 Morton 顺序，第 i 块对应 bufferView / mesh / node i
+};
+
+/**
+ * 解压 SPZ 并生成分块 GLB
+ *
+ * 点按 Morton 键排序后自顶向下细分八叉树：节点点数超过 options.tilePoints 时分为 8 个子节点
+ * （同一 Morton 键前缀的点在排序后连续，子节点是父节点区间的连续子区间），最多 21 层。
+ * 每个叶子收集自己的点组成一份 SPZ 数据重新压缩，各叶子在 options.pool 上并行处理。
+ *
+ * 每块一个 bufferView、一个带 KHR_gaussian_splatting_compression_spz_2 的 primitive、一个 node，
+ * 场景直接列出所有块的 node；node 的 extras 记录块信息：
+ *   {"spz2glb:tile":{"path":"035","points":N,"min":[x,y,z],"max":[x,y,z]}}
+ * 块内的点保持 Morton 顺序
+ */
+SpzResult buildTiledGlb(std::span<const uint8_t> spzData, TiledGlb& glb, const ConvertOptions& options);
+
+/**
+ * 写出分块清单（JSON）：整个场景与每块的包围盒、点数，以及 payload 在 GLB 文件中的绝对字节区间，
+ * 查看器据此用 HTTP Range 请求只取需要的块，无需先解析 GLB
+ *
+ * @param glbUri 清单中记录的 GLB 文件名
+ */
+bool writeTilesetManifest(const std::string& path, const std::string& glbUri, const TiledGlb& glb,
+                          std::string& error);
+
+}  // namespace spz2glb
+
+#endif  // SPZ2GLB_TILED_GLB_H_
@@ -0,0 +1,142 @@
+// Copyright (c) 2026 Pu Junhan
+// SPDX-License-Identifier: MIT
+// Project: SPZ-ecosystem
+// Repository: https://github.com/spz-ecosystem/spz2glb
+//
+// 阶段跟踪实现
+
+#include "trace.h"
+
+#if SPZ2GLB_ENABLE_TRACE
+
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace spz2glb::trace {
+
+namespace {
+
+struct Event {
+    const char* name;
+    int64_t startNs;  // 相对 start() 的时间
+    int64_t durationNs;
+    uint64_t bytes;
+};
+
+/**
+ * 每个线程一个事件缓冲区，记录时只有本线程访问自己的缓冲区；
+ * 缓冲区登记在全局列表中，线程退出后仍保留到导出
+ */
+struct ThreadBuffer {
+    uint32_t tid;
+    std::mutex mutex;  // 只在导出与 start() 清空时与记录线程竞争
+    std::vector<Event> events;
+};
+
+std::mutex g_registryMutex;
+std::vector<std::shared_ptr<ThreadBuffer>> g_buffers;
+// start() 的时刻（steady_clock 纳秒）：记录线程与 start() 并发读写，用原子量
+std::atomic<int64_t> g_originNs{0};
+uint32_t g_mainTid = 0;  // 调用 start() 的线程
+
+ThreadBuffer& threadBuffer() {
+    thread_local std::shared_ptr<ThreadBuffer> buffer = [] {
+        auto created = std::make_shared<ThreadBuffer>();
+        std::lock_guard<std::mutex> lock(g_registryMutex);
+        created->tid = static_cast<uint32_t>(g_buffers.size() + 1);
+        g_buffers.push_back(created);
+        return created;
+    }();
+    return *buffer;
+}
+
+void appendJsonString(std::string& out, const char* text) {
+    out += '"';
+    for (; *text != '\0'; ++text) {
+        if (*text == '"' || *text == '\\') out += '\\';
+        out += *text;
+    }
+    out += '"';
+}
+
+}  // anonymous namespace
+
+namespace detail {
+
+std::atomic<bool> g_recording{false};
+
+void record(const char* name, std::chrono::steady_clock::time_point start, uint64_t bytes) {
+    auto end = std::chrono::steady_clock::now();
+    ThreadBuffer& buffer = threadBuffer();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    const int64_t originNs = g_originNs.load(std::memory_order_relaxed);
+    buffer.events.push_back({name,
+                             std::chrono::duration_cast<std::chrono::nanoseconds>(start.time_since_epoch()).count() -
+                                 originNs,
+                             std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count(), bytes});
+}
+
+}  // namespace detail
+
+void start() {
+    uint32_t mainTid = threadBuffer().tid;
+    std::lock_guard<std::mutex> lock(g_registryMutex);
+    g_mainTid = mainTid;
+    for (auto& buffer : g_buffers) {
+        std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+        buffer->events.clear();
+    }
+    g_originNs.store(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                         std::chrono::steady_clock::now().time_since_epoch()).count(),
+                     std::memory_order_relaxed);
+    detail::g_recording.store(true, std::memory_order_release);
+}
+
+bool writeChromeTrace(const std::string& path, std::string& error) {
+    detail::g_recording.store(false, std::memory_order_release);
+
+    std::string json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    char number[160];
+    std::lock_guard<std::mutex> lock(g_registryMutex);
+    for (auto& buffer : g_buffers) {
+        std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+        // 线程名元数据事件，Perfetto 按此标注各轨道
+        std::snprintf(number, sizeof(number),
+                      "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s%u\"}}",
+                      first ? "" : ",", buffer->tid, buffer->tid == g_mainTid ? "main-" : "worker-", buffer->tid);
+        json += number;
+        first = false;
+        for (const auto& event : buffer->events) {
+            json += ",{\"name\":";
+            appendJsonString(json, event.name);
+            std::snprintf(number, sizeof(number),
+                          ",\"cat\":\"spz2glb\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,"
+                          "\"args\":{\"bytes\":%llu}}",
+                          buffer->tid, static_cast<double>(event.startNs) / 1000.0,
+                          static_cast<double>(event.durationNs) / 1000.0,
+                          static_cast<unsigned long long>(event.bytes));
+            json += number;
+        }
+    }
+    json += "]}\n";
+
+    FILE* file = std::fopen(path.c_str(), "wb");
+    if (file == nullptr) {
+        error = "Cannot open trace file: " + path;
+        return false;
+    }
+    bool written = std::fwrite(json.data(), 1, json.size(), file) == json.size();
+    written = std::fclose(file) == 0 && written;
+    if (!written) {
+        error = "Failed to write trace file: " + path;
+    }
+    return written;
+}
+
+}  // namespace spz2glb::trace
+
+#endif  // SPZ2GLB_ENABLE_TRACE
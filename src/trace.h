@@ -0,0 +1,71 @@
+// Copyright (c) 2026 Pu Junhan
+// SPDX-License-Identifier: MIT
+// Project: SPZ-ecosystem
+// Repository: https://github.com/spz-ecosystem/spz2glb
+//
+// 阶段跟踪（spz2glb --trace）
+// 各阶段用 SPZ2GLB_TRACE_SCOPE 标记，结果导出为 Chrome trace / Perfetto 可读的 JSON；
+// 编译时未定义 SPZ2GLB_ENABLE_TRACE（CMake 选项 SPZ2GLB_TRACE=OFF、WASM 构建）则宏展开为空
+
+#ifndef SPZ2GLB_TRACE_H_
+#define SPZ2GLB_TRACE_H_
+
+#include <cstdint>
+#include <string>
+
+#if SPZ2GLB_ENABLE_TRACE
+
+#include <atomic>
+#include <chrono>
+
+namespace spz2glb::trace {
+
+namespace detail {
+extern std::atomic<bool> g_recording;
+void record(const char* name, std::chrono::steady_clock::time_point start, uint64_t bytes);
+}  // namespace detail
+
+// 开始记录；之前的记录会被丢弃
+void start();
+
+// 停止记录，把所有线程的记录写成 Chrome trace JSON（"X" 完整事件，ts/dur 为微秒，args.bytes 为处理字节数）
+bool writeChromeTrace(const std::string& path, std::string& error);
+
+/**
+ * 作用域计时：构造时记下开始时间，析构时记录一个事件
+ *
+ * 未在记录时只有一次原子读；name 必须是字符串字面量（只保存指针）
+ */
+class Scope {
+public:
+    explicit Scope(const char* name) : name_(detail::g_recording.load(std::memory_order_relaxed) ? name : nullptr) {
+        if (name_ != nullptr) start_ = std::chrono::steady_clock::now();
+    }
+    ~Scope() {
+        if (name_ != nullptr) detail::record(name_, start_, bytes_);
+    }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+    void setBytes(uint64_t bytes) { bytes_ = bytes; }
+
+private:
+    const char* name_;
+    std::chrono::steady_clock::time_point start_;
+    uint64_t bytes_ = 0;
+};
+
+}  // namespace spz2glb::trace
+
+#define SPZ2GLB_TRACE_SCOPE(var, name) ::spz2glb::trace::Scope var(name)
+#define SPZ2GLB_TRACE_BYTES(var, bytes) var.setBytes(bytes)
+
+#else
+
+#define SPZ2GLB_TRACE_SCOPE(var, name) ((void)0)
+#define SPZ2GLB_TRACE_BYTES(var, bytes) ((void)0)
+
+#endif  // SPZ2GLB_ENABLE_TRACE
+
+#endif  // SPZ2GLB_TRACE_H_